@@ -0,0 +1,101 @@
+/**
+ ** Benchmarking ropes against flat strings.
+ **
+ ** Run as `bench-rope [N]': concatenation loops of N pieces, and
+ ** 1000 * N comparisons of equal string literals.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <misc/rope.hh>
+
+namespace
+{
+  /// The strings before ropes: shared, and copied by concatenation.
+  using flat_string = std::shared_ptr<const std::string>;
+
+  /// Run \a f, and return its duration in milliseconds.
+  template <typename F> double time(F f)
+  {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    std::chrono::duration<double, std::milli> res =
+      std::chrono::steady_clock::now() - start;
+    return res.count();
+  }
+
+  /// Discard \a n, so that its computation is not optimized away.
+  volatile std::size_t sink;
+
+  void report(const std::string& title, double flat, double rope)
+  {
+    std::cout << std::left << std::setw(36) << title << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10) << flat
+              << " ms" << std::setw(10) << rope << " ms" << std::setw(8)
+              << std::setprecision(1) << flat / rope << "x\n";
+  }
+
+  /// Append \a n times \a piece, then read the characters once.
+  void concat(unsigned n, const std::string& piece)
+  {
+    double flat = time([&] {
+      flat_string s = std::make_shared<const std::string>();
+      flat_string p = std::make_shared<const std::string>(piece);
+      for (unsigned i = 0; i < n; ++i)
+        s = std::make_shared<const std::string>(*s + *p);
+      sink = (*s)[s->size() / 2];
+    });
+    double rope = time([&] {
+      misc::rope s;
+      misc::rope p(piece);
+      for (unsigned i = 0; i < n; ++i)
+        s = s + p;
+      sink = s[s.size() / 2];
+    });
+    report("concat " + std::to_string(n) + " x " + std::to_string(piece.size())
+             + " chars",
+           flat, rope);
+  }
+
+  /// Compare two equal literals \a n times.
+  void compare(unsigned n, const std::string& literal)
+  {
+    double flat = time([&] {
+      flat_string l = std::make_shared<const std::string>(literal);
+      flat_string r = std::make_shared<const std::string>(literal);
+      std::size_t equal = 0;
+      for (unsigned i = 0; i < n; ++i)
+        equal += *l == *r;
+      sink = equal;
+    });
+    double rope = time([&] {
+      misc::rope l = misc::rope::intern(literal);
+      misc::rope r = misc::rope::intern(literal);
+      std::size_t equal = 0;
+      for (unsigned i = 0; i < n; ++i)
+        equal += l == r;
+      sink = equal;
+    });
+    report("streq " + std::to_string(n) + " x "
+             + std::to_string(literal.size()) + " chars",
+           flat, rope);
+  }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  unsigned n = 1 < argc ? std::atoi(argv[1]) : 20000;
+  std::cout << "/* Rope benchmarks: flat strings, then ropes.  */\n";
+  concat(n, "ab");
+  concat(n, std::string(40, 'x'));
+  concat(n / 10, std::string(1000, 'y'));
+  compare(n * 1000, "literal");
+  compare(n * 1000, std::string(64, 'z'));
+  compare(n * 1000, std::string(1024, 'w'));
+}
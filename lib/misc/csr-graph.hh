@@ -0,0 +1,91 @@
+/**
+ ** \file misc/csr-graph.hh
+ ** \brief csr_graph: a frozen directed graph in compressed sparse rows.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace misc
+{
+  /** \brief A read-only directed graph, stored in compressed sparse rows.
+
+      The vertices are numbered from 0 to vertex_count() - 1.  The
+      successors of all the vertices are stored in a single contiguous
+      array, and so are the predecessors: the neighbors of a vertex
+      are a slice of these arrays, delimited by an offset table.
+
+      Compared to misc::directed_graph, there is no per-vertex
+      allocation, so traversals are cache friendly and the memory
+      footprint is a few words per vertex and per edge.  The price is
+      that the graph cannot be modified once built.
+  */
+  template <typename VertexLabel> class csr_graph
+  {
+  public:
+    /// Vertex identifier.
+    using vertex_type = unsigned;
+    /// An edge, from its source to its target.
+    using edge_type = std::pair<vertex_type, vertex_type>;
+    /// The neighbors of a vertex.
+    using neighbors_type = std::span<const vertex_type>;
+
+    /// An empty graph.
+    csr_graph() = default;
+    /// \brief Build the graph whose vertex i is labeled \a labels[i].
+    ///
+    /// Duplicate edges are merged.
+    csr_graph(std::vector<VertexLabel> labels, std::vector<edge_type> edges);
+
+    /// \name Accessors.
+    /// \{
+    /// Number of vertices.
+    std::size_t vertex_count() const;
+    /// Number of (distinct) edges.
+    std::size_t edge_count() const;
+    /// Label of \a v.
+    const VertexLabel& operator[](vertex_type v) const;
+    /// Labels of all the vertices, indexed by vertex.
+    const std::vector<VertexLabel>& labels_get() const;
+    /// Targets of the edges leaving \a v, in increasing order.
+    neighbors_type successors_get(vertex_type v) const;
+    /// Sources of the edges reaching \a v, in increasing order.
+    neighbors_type predecessors_get(vertex_type v) const;
+    /// Whether there is an edge from \a u to \a v.
+    bool has_edge(vertex_type u, vertex_type v) const;
+    /// \}
+
+    /// \brief Strongly connected components (Tarjan's algorithm).
+    ///
+    /// Return the component of each vertex.  Components are numbered
+    /// in reverse topological order: the successors of a vertex are
+    /// either in its component, or in a component with a smaller
+    /// number.
+    std::vector<vertex_type> components_get() const;
+
+  private:
+    /// Fill a row table from \a edges, sorted by source.
+    static void rows_build(std::size_t n,
+                           const std::vector<edge_type>& edges,
+                           bool reverse,
+                           std::vector<vertex_type>& offsets,
+                           std::vector<vertex_type>& targets);
+
+    /// Vertex labels.
+    std::vector<VertexLabel> labels_;
+    /// The successors of v are out_targets_[out_offsets_[v],
+    /// out_offsets_[v + 1]).
+    std::vector<vertex_type> out_offsets_ = {0};
+    std::vector<vertex_type> out_targets_;
+    /// Likewise for the predecessors.
+    std::vector<vertex_type> in_offsets_ = {0};
+    std::vector<vertex_type> in_targets_;
+  };
+
+} // namespace misc
+
+#include <misc/csr-graph.hxx>
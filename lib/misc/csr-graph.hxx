@@ -0,0 +1,172 @@
+/**
+ ** \file misc/csr-graph.hxx
+ ** \brief Implementation of misc::csr_graph.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+
+#include <misc/contract.hh>
+#include <misc/csr-graph.hh>
+
+namespace misc
+{
+  template <typename VertexLabel>
+  csr_graph<VertexLabel>::csr_graph(std::vector<VertexLabel> labels,
+                                    std::vector<edge_type> edges)
+    : labels_(std::move(labels))
+  {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    rows_build(labels_.size(), edges, false, out_offsets_, out_targets_);
+    rows_build(labels_.size(), edges, true, in_offsets_, in_targets_);
+  }
+
+  template <typename VertexLabel>
+  void csr_graph<VertexLabel>::rows_build(std::size_t n,
+                                          const std::vector<edge_type>& edges,
+                                          bool reverse,
+                                          std::vector<vertex_type>& offsets,
+                                          std::vector<vertex_type>& targets)
+  {
+    // Counting sort: since the edges are sorted, so are the rows.
+    offsets.assign(n + 1, 0);
+    for (const auto& [u, v] : edges)
+      {
+        precondition(u < n && v < n);
+        ++offsets[(reverse ? v : u) + 1];
+      }
+    for (std::size_t i = 0; i < n; ++i)
+      offsets[i + 1] += offsets[i];
+
+    std::vector<vertex_type> fill(offsets.begin(), offsets.end() - 1);
+    targets.resize(edges.size());
+    for (const auto& [u, v] : edges)
+      if (reverse)
+        targets[fill[v]++] = u;
+      else
+        targets[fill[u]++] = v;
+  }
+
+  template <typename VertexLabel>
+  inline std::size_t csr_graph<VertexLabel>::vertex_count() const
+  {
+    return labels_.size();
+  }
+
+  template <typename VertexLabel>
+  inline std::size_t csr_graph<VertexLabel>::edge_count() const
+  {
+    return out_targets_.size();
+  }
+
+  template <typename VertexLabel>
+  inline const VertexLabel&
+  csr_graph<VertexLabel>::operator[](vertex_type v) const
+  {
+    precondition(v < vertex_count());
+    return labels_[v];
+  }
+
+  template <typename VertexLabel>
+  inline const std::vector<VertexLabel>&
+  csr_graph<VertexLabel>::labels_get() const
+  {
+    return labels_;
+  }
+
+  template <typename VertexLabel>
+  inline typename csr_graph<VertexLabel>::neighbors_type
+  csr_graph<VertexLabel>::successors_get(vertex_type v) const
+  {
+    precondition(v < vertex_count());
+    return {out_targets_.data() + out_offsets_[v],
+            out_targets_.data() + out_offsets_[v + 1]};
+  }
+
+  template <typename VertexLabel>
+  inline typename csr_graph<VertexLabel>::neighbors_type
+  csr_graph<VertexLabel>::predecessors_get(vertex_type v) const
+  {
+    precondition(v < vertex_count());
+    return {in_targets_.data() + in_offsets_[v],
+            in_targets_.data() + in_offsets_[v + 1]};
+  }
+
+  template <typename VertexLabel>
+  bool csr_graph<VertexLabel>::has_edge(vertex_type u, vertex_type v) const
+  {
+    neighbors_type succs = successors_get(u);
+    return std::binary_search(succs.begin(), succs.end(), v);
+  }
+
+  template <typename VertexLabel>
+  std::vector<typename csr_graph<VertexLabel>::vertex_type>
+  csr_graph<VertexLabel>::components_get() const
+  {
+    constexpr vertex_type none = std::numeric_limits<vertex_type>::max();
+    const std::size_t n = vertex_count();
+
+    std::vector<vertex_type> index(n, none);
+    std::vector<vertex_type> low(n);
+    std::vector<vertex_type> component(n, none);
+    // The Tarjan stack.
+    std::vector<vertex_type> stack;
+    // The explicit call stack: a vertex, and the next edge to follow.
+    std::vector<std::pair<vertex_type, vertex_type>> calls;
+    vertex_type next_index = 0;
+    vertex_type next_component = 0;
+
+    for (vertex_type root = 0; root < n; ++root)
+      {
+        if (index[root] != none)
+          continue;
+        index[root] = low[root] = next_index++;
+        stack.emplace_back(root);
+        calls.emplace_back(root, out_offsets_[root]);
+
+        while (!calls.empty())
+          {
+            auto& [v, e] = calls.back();
+            if (e < out_offsets_[v + 1])
+              {
+                vertex_type w = out_targets_[e++];
+                if (index[w] == none)
+                  {
+                    index[w] = low[w] = next_index++;
+                    stack.emplace_back(w);
+                    calls.emplace_back(w, out_offsets_[w]);
+                  }
+                // Visited but not yet in a component: on the stack.
+                else if (component[w] == none)
+                  low[v] = std::min(low[v], index[w]);
+                continue;
+              }
+
+            vertex_type done = v;
+            calls.pop_back();
+            if (low[done] == index[done])
+              {
+                vertex_type w;
+                do
+                  {
+                    w = stack.back();
+                    stack.pop_back();
+                    component[w] = next_component;
+                  }
+                while (w != done);
+                ++next_component;
+              }
+            if (!calls.empty())
+              {
+                vertex_type parent = calls.back().first;
+                low[parent] = std::min(low[parent], low[done]);
+              }
+          }
+      }
+    return component;
+  }
+
+} // namespace misc
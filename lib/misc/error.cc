@@ -5,6 +5,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <utility>
 
 #include <misc/contract.hh>
 #include <misc/error.hh>
@@ -15,42 +16,109 @@ namespace misc
   | error.  |
   `--------*/
 
+  int error::max_errors = 0;
+
   error::error()
     : status_(error_type::success)
   {}
 
   error::error(const error& e) { *this = e; }
 
+  error::error(error&& e) noexcept = default;
+
   error& error::operator=(const error& rhs)
   {
-    status_ = rhs.status_get();
-    stream_.str(rhs.stream_get().str());
+    status_ = rhs.status_;
+    diagnostics_ = rhs.diagnostics_;
+    errors_ = rhs.errors_;
+    dropped_ = rhs.dropped_;
     return *this;
   }
 
+  error& error::operator=(error&& rhs) noexcept = default;
+
+  void error::flush()
+  {
+    if (diagnostics_.empty())
+      diagnostics_.emplace_back(diagnostic{error_type::success, {}});
+    diagnostics_.back().message += stream_.str();
+    stream_.str({});
+  }
+
+  void error::import(diagnostic&& d)
+  {
+    if (d.kind != error_type::success)
+      {
+        if (max_errors > 0 && errors_ >= static_cast<unsigned>(max_errors))
+          {
+            ++dropped_;
+            return;
+          }
+        ++errors_;
+      }
+    diagnostics_.emplace_back(std::move(d));
+  }
+
   /*----------------------------.
   | Filling the error handler.  |
   `----------------------------*/
 
-  error& error::operator<<(error_type e)
+  void error::status_merge(error_type e)
   {
     auto status_value = static_cast<unsigned>(status_);
     auto e_value = static_cast<unsigned>(e);
     if ((e_value && e_value < status_value) || (!status_value))
       status_ = e;
+  }
+
+  error& error::operator<<(error_type e)
+  {
+    status_merge(e);
+    if (static_cast<unsigned>(e))
+      {
+        // Stop the pass rather than piling up diagnostics.
+        if (max_errors > 0 && errors_ >= static_cast<unsigned>(max_errors))
+          {
+            ++dropped_;
+            exit();
+          }
+        ++errors_;
+      }
+    diagnostics_.emplace_back(diagnostic{e, {}});
     return *this;
   }
 
   // Import errors.
   error& error::operator<<(const error& rhs)
   {
-    *this << rhs.status_get() << rhs.stream_get().str();
+    status_merge(rhs.status_);
+    for (const diagnostic& d : rhs.diagnostics_)
+      import(diagnostic(d));
+    dropped_ += rhs.dropped_;
+    return *this;
+  }
+
+  error& error::operator<<(error&& rhs)
+  {
+    status_merge(rhs.status_);
+    if (diagnostics_.empty())
+      {
+        diagnostics_ = std::move(rhs.diagnostics_);
+        errors_ = rhs.errors_;
+      }
+    else
+      for (diagnostic& d : rhs.diagnostics_)
+        import(std::move(d));
+    dropped_ += rhs.dropped_;
+    rhs.diagnostics_.clear();
+    rhs.errors_ = rhs.dropped_ = 0;
     return *this;
   }
 
   error& error::operator<<(std::ostream& (*f)(std::ostream&))
   {
     stream_ << f;
+    flush();
     return *this;
   }
 
@@ -68,7 +136,7 @@ namespace misc
 
   void error::ice(const char* file, int line) const
   {
-    std::cerr << stream_.str();
+    std::cerr << *this;
     __Terminate(file, line, "Internal Compiler error");
   }
 
@@ -81,7 +149,9 @@ namespace misc
   void error::clear()
   {
     status_ = error_type::success;
-    stream_.clear();
+    diagnostics_.clear();
+    errors_ = dropped_ = 0;
+    stream_.str({});
   }
 
   /*------------.
@@ -97,11 +167,20 @@ namespace misc
     return static_cast<unsigned>(status_);
   }
 
-  const std::ostringstream& error::stream_get() const { return stream_; }
+  const std::vector<error::diagnostic>& error::diagnostics_get() const
+  {
+    return diagnostics_;
+  }
+
+  unsigned error::dropped_get() const { return dropped_; }
 
   std::ostream& operator<<(std::ostream& o, const error& e)
   {
-    return o << e.stream_get().str();
+    for (const error::diagnostic& d : e.diagnostics_get())
+      o << d.message;
+    if (e.dropped_get())
+      o << "too many errors (limit " << error::max_errors << ")\n";
+    return o;
   }
 
 } // namespace misc
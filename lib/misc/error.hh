@@ -7,6 +7,8 @@
 
 #include <iosfwd>
 #include <sstream>
+#include <string>
+#include <vector>
 
 /// Shortcuts.
 /// \{
@@ -22,6 +24,9 @@ namespace misc
    ** described in the enum below.
    **
    ** Several versions of operator<< are used to fill the handler.
+   ** Each diagnostic starts with its kind (an error_type), and is
+   ** kept as a separate record: merging handlers moves the records,
+   ** and at most max_errors of them are recorded.
    **
    ** A global variable is defined to centralize all the error uses.
    */
@@ -31,9 +36,12 @@ namespace misc
   public:
     error();
     error(const error& e);
+    error(error&& e) noexcept;
 
     /// Copy an error.
     error& operator=(const error& e);
+    /// Move an error.
+    error& operator=(error&& e) noexcept;
 
     /// \name Filling the error handler.
     /// \{
@@ -55,10 +63,27 @@ namespace misc
       type = 5
     };
 
+    /// A diagnostic.
+    struct diagnostic
+    {
+      /// Its kind, success if it was given none.
+      error_type kind;
+      /// The message, with its location.
+      std::string message;
+    };
+
+    /// \brief The maximum number of diagnostics of a handler, 0 for no
+    /// limit.
+    ///
+    /// Starting one more diagnostic stops the current pass: the
+    /// handler is thrown, as by exit().
+    static int max_errors;
+
     /// General method: put the parameter in stream_.
     template <typename T> error& operator<<(const T& t);
 
-    /// Set the status if \a e is lower than the current status.
+    /// Set the status if \a e is lower than the current status, and
+    /// start a new diagnostic.
     error& operator<<(error_type e);
 
     /// Accept std::endl etc.
@@ -66,6 +91,8 @@ namespace misc
 
     /// Import errors.
     error& operator<<(const error& rhs);
+    /// Import errors, without copying them.
+    error& operator<<(error&& rhs);
 
     /// Member manipulator signature.
     using member_manip_type = void (error::*)();
@@ -112,16 +139,38 @@ namespace misc
     /// Get the current status value.
     unsigned status_get_value() const;
 
-    /// Get the stream associated with the class.
-    const std::ostringstream& stream_get() const;
+    /// Get the diagnostics, in the order they were reported.
+    const std::vector<diagnostic>& diagnostics_get() const;
+
+    /// Number of diagnostics which were not recorded.
+    unsigned dropped_get() const;
 
     /// \}
 
   private:
+    /// Set the status to \a e if it is lower than the current one.
+    void status_merge(error_type e);
+
+    /// Append what was formatted in stream_ to the last diagnostic.
+    void flush();
+
+    /// Append \a d, unless there are max_errors diagnostics already.
+    void import(diagnostic&& d);
+
     /// The current exit status.
     error_type status_;
 
-    /// The current error message.
+    /// The diagnostics.
+    std::vector<diagnostic> diagnostics_;
+
+    /// Number of diagnostics with a kind.
+    unsigned errors_ = 0;
+
+    /// Number of diagnostics which were not recorded.
+    unsigned dropped_ = 0;
+
+    /// Format the pieces of the current diagnostic, keeping the
+    /// indentation level from one diagnostic to the other.
     std::ostringstream stream_;
   };
 
@@ -12,6 +12,7 @@ namespace misc
   template <class T> error& error::operator<<(const T& t)
   {
     stream_ << t;
+    flush();
     return *this;
   }
 
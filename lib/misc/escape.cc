@@ -6,6 +6,7 @@
 #include <cctype>
 #include <iomanip>
 #include <ios>
+#include <string>
 #include <unordered_map>
 
 #include <misc/escape.hh>
@@ -57,4 +58,41 @@ namespace misc
     return o;
   }
 
+  std::string unescape(const std::string& s)
+  {
+    static const std::unordered_map<char, char> escapes = {
+      {'a', '\a'}, {'b', '\b'}, {'f', '\f'},   {'n', '\n'}, {'r', '\r'},
+      {'t', '\t'}, {'v', '\v'}, {'\\', '\\'}, {'"', '"'}};
+
+    std::string res;
+    res.reserve(s.size());
+    for (size_t i = 0; i < s.size(); ++i)
+      {
+        if (s[i] != '\\' || i + 1 == s.size())
+          {
+            res += s[i];
+            continue;
+          }
+        char c = s[++i];
+        if (const auto it = escapes.find(c); it != escapes.end())
+          res += it->second;
+        else if (c == 'x' && i + 2 < s.size())
+          {
+            int code = std::stoi(s.substr(i + 1, 2), nullptr, 16);
+            res += static_cast<char>(code);
+            i += 2;
+          }
+        else if ('0' <= c && c <= '3' && i + 2 < s.size())
+          {
+            int code = std::stoi(s.substr(i, 3), nullptr, 8);
+            res += static_cast<char>(code);
+            i += 2;
+          }
+        else
+          // The scanner rejects the other escapes.
+          res += {'\\', c};
+      }
+    return res;
+  }
+
 } // namespace misc
@@ -31,6 +31,14 @@ namespace misc
 
   std::ostream& operator<<(std::ostream& o, const escaped&);
 
+  /// \brief Decode the escapes of the contents \a s of a string literal.
+  ///
+  /// `\a', `\b', `\f', `\n', `\r', `\t', `\v', `\\' and `\"', and the
+  /// character codes `\ddd' (in octal) and `\xhh' (in hexadecimal).
+  /// The scanner keeps them as is, so that the literals are printed as
+  /// they were written.
+  std::string unescape(const std::string& s);
+
 } // namespace misc
 
 #include <misc/escape.hxx>
@@ -3,9 +3,15 @@
  ** \brief Implements misc::file_library.
  */
 
+#include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <stdexcept>
+#include <system_error>
+#include <unordered_set>
 #include <sys/param.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -15,6 +21,121 @@
 
 namespace misc
 {
+  namespace
+  {
+    /// The entries of a directory, as last read.
+    struct listing
+    {
+      /// The modification time of the directory when it was read.
+      std::filesystem::file_time_type mtime;
+      /// Whether the directory was read within the granularity of its
+      /// modification time, and may have changed since without it.
+      bool racy = false;
+      /// When the modification time was last checked on schedule.
+      std::chrono::steady_clock::time_point checked;
+      /// Whether a miss checked it since.
+      bool rechecked = false;
+      /// Whether the directory could be read.
+      bool readable = false;
+      /// The names of the entries.
+      std::unordered_set<std::string> names;
+    };
+
+    /// How long a listing is trusted without checking its directory.
+    std::chrono::steady_clock::duration listing_ttl = std::chrono::seconds(1);
+
+    /// The coarsest granularity of the modification times.
+    constexpr std::chrono::seconds mtime_granularity(2);
+
+    /// The listings, shared by all the libraries.
+    std::map<path, listing> listings;
+    std::mutex listings_mutex;
+
+    /// The number of accesses to the filesystem.
+    std::atomic<unsigned long> probes = 0;
+
+    /// Check the modification time of \a dir, and read it again into
+    /// \a l if it changed, or if \a l is \a fresh or racy.
+    void refresh(const path& dir, listing& l, bool fresh)
+    {
+      ++probes;
+      std::error_code ec;
+      auto mtime = std::filesystem::last_write_time(dir, ec);
+      if (ec)
+        {
+          l.readable = false;
+          l.names.clear();
+        }
+      else if (fresh || l.racy || !l.readable || mtime != l.mtime)
+        {
+          // The modification time is taken before the read, so that
+          // a change during the read is noticed next time.  But an
+          // entry created within the same tick leaves it unchanged.
+          l.mtime = mtime;
+          l.racy = std::filesystem::file_time_type::clock::now() - mtime
+            < mtime_granularity;
+          l.names.clear();
+          ++probes;
+          std::filesystem::directory_iterator entry(dir, ec);
+          for (; !ec && entry != std::filesystem::directory_iterator();
+               entry.increment(ec))
+            l.names.insert(entry->path().filename().string());
+          l.readable = !ec;
+        }
+    }
+
+    /// Whether the directory \a dir has an entry \a name.
+    bool listed(const path& dir, const std::string& name)
+    {
+      auto now = std::chrono::steady_clock::now();
+      std::lock_guard<std::mutex> lock(listings_mutex);
+      auto [i, inserted] = listings.try_emplace(dir);
+      listing& l = i->second;
+      bool checked = inserted || now - l.checked >= listing_ttl;
+      if (checked)
+        {
+          l.checked = now;
+          l.rechecked = false;
+          refresh(dir, l, inserted);
+        }
+      if (l.names.contains(name))
+        return true;
+      // The entry may have been created since the directory was
+      // checked: the first miss until the listing expires checks its
+      // modification time again, and reads it if it changed.  The
+      // next misses trust the listing.
+      if (!checked && !l.rechecked)
+        {
+          l.rechecked = true;
+          refresh(dir, l, false);
+          if (l.names.contains(name))
+            return true;
+        }
+      // A listing read long enough after the last change of its
+      // directory is complete until its modification time changes.
+      if (!l.readable || !l.racy)
+        return false;
+
+      // The entry may have been created since the racy listing was
+      // read: check it directly.
+      ++probes;
+      std::error_code ec;
+      if (!std::filesystem::exists(dir / name, ec))
+        return false;
+      l.names.insert(name);
+      return true;
+    }
+
+  } // namespace
+
+  void file_library::listing_ttl_set(std::chrono::steady_clock::duration ttl)
+  {
+    std::lock_guard<std::mutex> lock(listings_mutex);
+    listing_ttl = ttl;
+  }
+
+  unsigned long file_library::probes_get() { return probes; }
+
   void file_library::push_cwd()
   {
     // Store the working directory
@@ -92,12 +213,12 @@ namespace misc
   {
     // Split file in two components, basename and basedir.
     path p = path(file);
-    path directory = p.filename();
+    path directory = p.parent_path();
 
     if (directory.is_absolute())
       {
         // If file is absolute, just check that it exists.
-        if (!std::filesystem::exists(path(file)))
+        if (!find_in_directory(directory, p.filename().string()))
           return path();
       }
     else
@@ -115,7 +236,9 @@ namespace misc
   bool file_library::find_in_directory(const path& dir,
                                        const std::string& file) const
   {
-    return std::filesystem::exists(path(dir / file));
+    // FILE may have directory components.
+    path full = dir / file;
+    return listed(full.parent_path(), full.filename().string());
   }
 
   path file_library::find_in_search_path(const path& relative_path,
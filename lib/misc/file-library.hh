@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <filesystem>
 #include <string>
 #include <vector>
@@ -16,7 +17,18 @@ namespace misc
   /** \brief Manage search path.
 
       Store search path and all informations used for handling
-      paths when processing import directives. */
+      paths when processing import directives.
+
+      The files are looked up in listings of the directories, read once
+      and shared by all the libraries of the process.  A listing is
+      trusted for a while (a second by default), after which the
+      modification time of its directory is checked again, and the
+      directory read again if it changed, or if it was read too soon
+      after it changed for its modification time to tell.  The first
+      file missing from a listing until then checks its directory at
+      once, so that the files created since are found; the next misses
+      trust it.  Only a file missing from a racy listing is looked for
+      directly.  */
 
   class file_library
   {
@@ -31,8 +43,11 @@ namespace misc
 
     /// \name Managing inclusion paths.
     /// \{
+    using path_list_type = std::vector<path>;
+
     void append_dir(path p);
     void prepend_dir(path p);
+    const path_list_type& search_path_get() const;
     /// \}
 
     /// \name current directory.
@@ -54,6 +69,14 @@ namespace misc
 
     /// \brief Check if \a file exists in directory \a dir.
     bool find_in_directory(const path& dir, const std::string& file) const;
+
+    /// The number of accesses to the filesystem made by all the
+    /// libraries: directory modification times, directory reads, and
+    /// files missing from the listings.
+    static unsigned long probes_get();
+
+    /// Trust the listings for \a ttl before checking their directory.
+    static void listing_ttl_set(std::chrono::steady_clock::duration ttl);
     /// \}
 
     /// \name Printing.
@@ -79,8 +102,6 @@ namespace misc
         directory if necessary */
     path ensure_absolute_path(path p) const;
 
-    using path_list_type = std::vector<path>;
-
     /// Inclusion path list.
     path_list_type search_path_;
 
@@ -9,6 +9,12 @@
 
 namespace misc
 {
+  inline const file_library::path_list_type&
+  file_library::search_path_get() const
+  {
+    return search_path_;
+  }
+
   inline std::ostream& operator<<(std::ostream& ostr, const file_library& l)
   {
     return l.dump(ostr);
@@ -7,6 +7,9 @@
 
 namespace misc
 {
+  // From csr-graph.hh.
+  template <typename VertexLabel> class csr_graph;
+
   // From file-library.hh.
   class file_library;
 
@@ -28,6 +31,9 @@ namespace misc
   // From xalloc.hh.
   template <class StoredType> class xalloc;
 
+  // From thread-pool.hh
+  class thread_pool;
+
   // From timer.hh
   class timer;
 
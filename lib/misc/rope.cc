@@ -0,0 +1,224 @@
+/**
+ ** \file misc/rope.cc
+ ** \brief Implementation of misc::rope.
+ */
+
+#include <cstring>
+#include <ostream>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <misc/contract.hh>
+#include <misc/rope.hh>
+
+namespace misc
+{
+  /// The shared part of a large rope.
+  struct rope::node
+  {
+    /// The number of ropes referring to it.
+    std::size_t refs = 1;
+    /// Its characters, once flat; empty while a concatenation.
+    std::string chars;
+    /// The concatenated ropes, until flattened.
+    rope left;
+    rope right;
+  };
+
+  rope::rope(std::string_view s)
+    : size_(s.size())
+  {
+    if (small_p())
+      {
+        if (size_)
+          std::memcpy(chars_, s.data(), size_);
+      }
+    else
+      {
+        node_ = new node;
+        node_->chars = s;
+      }
+  }
+
+  rope::rope(node* n, std::size_t size)
+    : size_(size)
+    , node_(n)
+  {}
+
+  rope rope::intern(std::string_view s)
+  {
+    if (s.size() <= small_max)
+      return rope(s);
+    // The keys are the characters of the leaves, which never change.
+    static std::unordered_map<std::string_view, rope> table;
+    auto i = table.find(s);
+    if (i == table.end())
+      {
+        rope res(s);
+        std::string_view key = res.node_->chars;
+        i = table.emplace(key, std::move(res)).first;
+      }
+    return i->second;
+  }
+
+  rope::rope(const rope& r)
+    : size_(r.size_)
+  {
+    if (small_p())
+      std::memcpy(chars_, r.chars_, small_max);
+    else
+      {
+        node_ = r.node_;
+        ++node_->refs;
+      }
+  }
+
+  rope::rope(rope&& r) noexcept
+    : size_(r.size_)
+  {
+    if (small_p())
+      std::memcpy(chars_, r.chars_, small_max);
+    else
+      node_ = r.node_;
+    r.size_ = 0;
+  }
+
+  rope& rope::operator=(const rope& r)
+  {
+    rope copy(r);
+    return *this = std::move(copy);
+  }
+
+  rope& rope::operator=(rope&& r) noexcept
+  {
+    if (this != &r)
+      {
+        if (!small_p())
+          release(node_);
+        size_ = r.size_;
+        if (small_p())
+          std::memcpy(chars_, r.chars_, small_max);
+        else
+          node_ = r.node_;
+        r.size_ = 0;
+      }
+    return *this;
+  }
+
+  rope::~rope()
+  {
+    if (!small_p())
+      release(node_);
+  }
+
+  void rope::release(node* n)
+  {
+    // Without recursion: the concatenations may be deep.
+    std::vector<node*> todo;
+    for (;;)
+      {
+        if (!--n->refs)
+          {
+            for (rope* child : {&n->left, &n->right})
+              if (!child->small_p())
+                {
+                  todo.emplace_back(child->node_);
+                  child->size_ = 0;
+                }
+            delete n;
+          }
+        if (todo.empty())
+          return;
+        n = todo.back();
+        todo.pop_back();
+      }
+  }
+
+  bool rope::flat_p() const { return small_p() || !node_->chars.empty(); }
+
+  std::string_view rope::flat() const
+  {
+    if (small_p())
+      return {chars_, size_};
+    if (node_->chars.empty())
+      flatten();
+    return node_->chars;
+  }
+
+  void rope::flatten() const
+  {
+    std::string res;
+    res.reserve(size_);
+    // Append the leaves from left to right, without recursion.
+    std::vector<const rope*> todo = {&node_->right, &node_->left};
+    while (!todo.empty())
+      {
+        const rope* r = todo.back();
+        todo.pop_back();
+        if (r->small_p())
+          res.append(r->chars_, r->size_);
+        else if (!r->node_->chars.empty())
+          res += r->node_->chars;
+        else
+          {
+            todo.emplace_back(&r->node_->right);
+            todo.emplace_back(&r->node_->left);
+          }
+      }
+    node_->chars = std::move(res);
+    node_->left = rope();
+    node_->right = rope();
+  }
+
+  rope rope::substr(std::size_t pos, std::size_t count) const
+  {
+    precondition(pos + count <= size_);
+    return rope(flat().substr(pos, count));
+  }
+
+  int rope::compare(const rope& r) const
+  {
+    if (!small_p() && !r.small_p() && node_ == r.node_)
+      return 0;
+    return flat().compare(r.flat());
+  }
+
+  rope operator+(const rope& l, const rope& r)
+  {
+    if (l.empty())
+      return r;
+    if (r.empty())
+      return l;
+    std::size_t size = l.size_ + r.size_;
+    if (size <= rope::leaf_max && l.flat_p() && r.flat_p())
+      {
+        std::string res;
+        res.reserve(size);
+        res += l.flat();
+        res += r.flat();
+        return rope(res);
+      }
+    auto n = new rope::node;
+    // Appending a short string extends the last leaf, rather than
+    // adding a node per string.
+    if (!l.flat_p() && l.node_->right.flat_p() && r.flat_p()
+        && l.node_->right.size_ + r.size_ <= rope::leaf_max)
+      {
+        n->left = l.node_->left;
+        n->right = l.node_->right + r;
+      }
+    else
+      {
+        n->left = l;
+        n->right = r;
+      }
+    return rope(n, size);
+  }
+
+  std::ostream& operator<<(std::ostream& o, const rope& r)
+  {
+    return o << r.flat();
+  }
+
+} // namespace misc
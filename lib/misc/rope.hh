@@ -0,0 +1,115 @@
+/**
+ ** \file misc/rope.hh
+ ** \brief rope: an immutable string with a constant time concatenation.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+
+namespace misc
+{
+  /** \brief An immutable string, cheap to copy and to concatenate.
+
+      The strings of at most small_max characters are stored in the
+      rope itself.  The longer ones are shared nodes: either a leaf
+      holding the characters, or the concatenation of two ropes.
+      Concatenating two ropes thus allocates a node instead of copying
+      their characters, and a sequence of concatenations costs linear
+      time instead of quadratic.
+
+      The concatenations are flattened lazily, the first time the
+      characters are needed contiguously (flat(), operator[], substr(),
+      printing), and the node keeps the flat string afterwards.
+
+      The ropes made by intern() from equal strings share their node,
+      so comparing them compares pointers.
+
+      The reference counts are not atomic: the ropes must not be shared
+      between threads.  */
+  class rope
+  {
+  public:
+    /// The longest strings stored in the rope itself.
+    static constexpr std::size_t small_max = 15;
+    /// The longest strings copied when concatenating, rather than
+    /// linked by a node.
+    static constexpr std::size_t leaf_max = 256;
+
+    /// The empty string.
+    rope() = default;
+    /// A copy of \a s.
+    explicit rope(std::string_view s);
+    /// The rope of \a s, sharing its node with the other interned
+    /// ropes equal to \a s.
+    static rope intern(std::string_view s);
+
+    rope(const rope& r);
+    rope(rope&& r) noexcept;
+    rope& operator=(const rope& r);
+    rope& operator=(rope&& r) noexcept;
+    ~rope();
+
+    /// \name Accessors.
+    /// \{
+    /// The number of characters.
+    std::size_t size() const;
+    /// Whether there are no characters.
+    bool empty() const;
+    /// Whether the characters are contiguous already.
+    bool flat_p() const;
+    /// The characters, flattened if needed.  Valid as long as the rope.
+    std::string_view flat() const;
+    /// The character \a i.
+    char operator[](std::size_t i) const;
+    /// The \a count characters from \a pos.
+    rope substr(std::size_t pos, std::size_t count) const;
+    /// A copy of the characters.
+    std::string str() const;
+    /// \}
+
+    /// \name Comparisons.
+    /// \{
+    /// Negative, zero or positive as this is before, equal to, or
+    /// after \a r in the lexicographic order.
+    int compare(const rope& r) const;
+    bool operator==(const rope& r) const;
+    /// \}
+
+    /// The concatenation of \a l and \a r.
+    friend rope operator+(const rope& l, const rope& r);
+
+  private:
+    struct node;
+
+    /// A rope of \a size characters owning \a n.
+    rope(node* n, std::size_t size);
+
+    /// Whether the characters are stored in the rope itself.
+    bool small_p() const;
+    /// Replace the concatenation of the node by its characters.
+    void flatten() const;
+    /// Drop a reference to \a n, freeing it and its children if it
+    /// was the last one.
+    static void release(node* n);
+
+    /// The number of characters.
+    std::size_t size_ = 0;
+    union
+    {
+      /// The node of the large strings.
+      node* node_ = nullptr;
+      /// The characters of the small ones.
+      char chars_[small_max];
+    };
+  };
+
+  /// Print the characters of \a r on \a o.
+  std::ostream& operator<<(std::ostream& o, const rope& r);
+
+} // namespace misc
+
+#include <misc/rope.hxx>
@@ -0,0 +1,33 @@
+/**
+ ** \file misc/rope.hxx
+ ** \brief Inline implementation of misc::rope.
+ */
+
+#pragma once
+
+#include <cstring>
+
+#include <misc/rope.hh>
+
+namespace misc
+{
+  inline std::size_t rope::size() const { return size_; }
+
+  inline bool rope::empty() const { return !size_; }
+
+  inline bool rope::small_p() const { return size_ <= small_max; }
+
+  inline char rope::operator[](std::size_t i) const { return flat()[i]; }
+
+  inline std::string rope::str() const { return std::string(flat()); }
+
+  inline bool rope::operator==(const rope& r) const
+  {
+    if (size_ != r.size_)
+      return false;
+    if (small_p())
+      return !std::memcmp(chars_, r.chars_, size_);
+    return node_ == r.node_ || flat() == r.flat();
+  }
+
+} // namespace misc
@@ -3,6 +3,7 @@
  ** \brief Implementation of misc::symbol.
  */
 
+#include <atomic>
 #include <sstream>
 #include <string>
 
@@ -23,10 +24,8 @@ namespace misc
   symbol symbol::fresh(const symbol& s)
   {
     /// Counter of unique symbols.
-    static unsigned counter_ = 0;
-    std::string str = s.get() + "_" + std::to_string(counter_);
-    ++counter_;
-    return symbol(str);
+    static std::atomic<unsigned> counter_ = 0;
+    return symbol(s.get() + "_" + std::to_string(counter_++));
   }
 
 } // namespace misc
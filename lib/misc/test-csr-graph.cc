@@ -0,0 +1,38 @@
+/**
+ ** Testing compressed sparse row graphs.
+ */
+
+#include <string>
+
+#include <misc/contract.hh>
+#include <misc/csr-graph.hh>
+
+using graph_type = misc::csr_graph<std::string>;
+
+int main()
+{
+  // a -> b -> c -> b, c -> d, with a duplicate edge.
+  graph_type g({"a", "b", "c", "d"}, {{0, 1}, {1, 2}, {2, 1}, {2, 3}, {0, 1}});
+
+  assertion(g.vertex_count() == 4);
+  assertion(g.edge_count() == 4);
+  assertion(g[2] == "c");
+
+  graph_type::neighbors_type succs = g.successors_get(2);
+  assertion(succs.size() == 2 && succs[0] == 1 && succs[1] == 3);
+  graph_type::neighbors_type preds = g.predecessors_get(1);
+  assertion(preds.size() == 2 && preds[0] == 0 && preds[1] == 2);
+  assertion(g.successors_get(3).empty());
+  assertion(g.has_edge(0, 1) && !g.has_edge(1, 0));
+
+  // {b, c} is a component; d comes before it, a after it.
+  std::vector<graph_type::vertex_type> comps = g.components_get();
+  assertion(comps[1] == comps[2]);
+  assertion(comps[0] != comps[1] && comps[3] != comps[1]);
+  assertion(comps[3] < comps[1] && comps[1] < comps[0]);
+
+  // The empty graph.
+  graph_type empty;
+  assertion(empty.vertex_count() == 0 && empty.edge_count() == 0);
+  assertion(empty.components_get().empty());
+}
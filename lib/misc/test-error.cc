@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <sstream>
+#include <utility>
 
 #include <misc/contract.hh>
 #include <misc/error.hh>
@@ -51,4 +52,45 @@ int main()
     assertion(ostr.str() == ref.str());
   }
   postcondition(e.status_get() == misc::error::error_type::scan);
+
+  // Each diagnostic is a record, which starts with its kind.
+  misc::error e6;
+  e6 << misc::error::error_type::bind << "a" << std::endl;
+  e6 << misc::error::error_type::type << 42 << std::endl;
+  e6 << misc::error::error_type::type << "b" << std::endl;
+  postcondition(e6.diagnostics_get().size() == 3);
+  postcondition(e6.diagnostics_get()[1].kind == misc::error::error_type::type);
+  postcondition(e6.diagnostics_get()[1].message == "42\n");
+
+  // Merging moves the records.
+  misc::error e3;
+  e3 << std::move(e6);
+  postcondition(e3.diagnostics_get().size() == 3);
+  postcondition(e6.diagnostics_get().empty());
+  postcondition(e3.status_get() == misc::error::error_type::bind);
+
+  // Starting one diagnostic too many stops.
+  misc::error::max_errors = 2;
+  misc::error e4;
+  e4 << misc::error::error_type::type << "one\n";
+  e4 << misc::error::error_type::type << "two\n";
+  bool stopped = false;
+  try
+    {
+      e4 << misc::error::error_type::type << "three\n";
+    }
+  catch (const misc::error& stop)
+    {
+      stopped = true;
+      postcondition(stop.diagnostics_get().size() == 2);
+      postcondition(stop.dropped_get() == 1);
+    }
+  postcondition(stopped);
+
+  // Importing is bounded too.
+  misc::error e5;
+  e5 << e3;
+  postcondition(e5.diagnostics_get().size() == 2);
+  postcondition(e5.dropped_get() == 1);
+  misc::error::max_errors = 0;
 }
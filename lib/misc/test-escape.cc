@@ -17,4 +17,8 @@ int main()
   s << escape("\a\b\f\n\r\t\v\\\"") << escape('\a');
 
   postcondition(s.str() == "\\007\\b\\f\\n\\r\\t\\v\\\\\\\"\\007");
+
+  // Decoding what was escaped gives back the original.
+  postcondition(misc::unescape(s.str()) == "\a\b\f\n\r\t\v\\\"\a");
+  postcondition(misc::unescape("\\x41\\102C\\\\n") == "ABC\\n");
 }
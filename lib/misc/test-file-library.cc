@@ -0,0 +1,78 @@
+/**
+ ** Test the file library, and its directory listings.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include <misc/contract.hh>
+#include <misc/file-library.hh>
+
+namespace fs = std::filesystem;
+
+int main()
+{
+  fs::path dir = fs::temp_directory_path()
+    / ("test-file-library-" + std::to_string(getpid()));
+  fs::create_directories(dir / "lib");
+  std::ofstream(dir / "lib" / "a.tih");
+
+  misc::file_library library(dir);
+
+  // Found through the search path, in a subdirectory.
+  assertion(library.find_file("lib/a.tih") == dir / "lib");
+  assertion(library.find_file("lib/b.tih").empty());
+
+  // The directories are not probed again for the files they list.
+  // From DIR, so that the lookups do not miss in the working directory.
+  library.push_current_directory(dir);
+  misc::file_library::listing_ttl_set(std::chrono::hours(1));
+  assertion(library.find_file("lib/a.tih") == dir / "lib");
+  unsigned long probes = misc::file_library::probes_get();
+  for (int i = 0; i < 100; ++i)
+    assertion(library.find_file("lib/a.tih") == dir / "lib");
+  assertion(misc::file_library::probes_get() == probes);
+
+  // A new file is found at once while the listing is racy: LIB
+  // changed too recently for its modification time to tell.
+  std::ofstream(dir / "lib" / "b.tih");
+  assertion(library.find_file("lib/b.tih") == dir / "lib");
+  assertion(misc::file_library::probes_get() > probes);
+
+  // Once LIB is listed long enough after its last change, the missing
+  // files are not probed either: until the listing expires, only the
+  // first miss checks the modification time of LIB again, once even
+  // though it is searched from both the current directory and the
+  // search path.
+  fs::last_write_time(dir / "lib",
+                      fs::file_time_type::clock::now() - std::chrono::hours(1));
+  misc::file_library::listing_ttl_set(std::chrono::seconds(0));
+  assertion(library.find_file("lib/c.tih").empty());
+  misc::file_library::listing_ttl_set(std::chrono::hours(1));
+  probes = misc::file_library::probes_get();
+  for (int i = 0; i < 100; ++i)
+    {
+      assertion(library.find_file("lib/a.tih") == dir / "lib");
+      assertion(library.find_file("lib/c.tih").empty());
+    }
+  assertion(misc::file_library::probes_get() == probes + 1);
+
+  // So a file created while the listing is trusted is found once it
+  // expired.
+  std::ofstream(dir / "lib" / "c.tih");
+  assertion(library.find_file("lib/c.tih").empty());
+  misc::file_library::listing_ttl_set(std::chrono::seconds(0));
+  assertion(library.find_file("lib/c.tih") == dir / "lib");
+
+  // A removed file is noticed once the listing expired, even if the
+  // directory changed within the granularity of its modification time.
+  misc::file_library::listing_ttl_set(std::chrono::seconds(0));
+  fs::remove(dir / "lib" / "a.tih");
+  assertion(library.find_file("lib/a.tih").empty());
+  misc::file_library::listing_ttl_set(std::chrono::seconds(1));
+
+  fs::remove_all(dir);
+}
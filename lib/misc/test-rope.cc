@@ -0,0 +1,62 @@
+/**
+ ** Testing ropes.
+ */
+
+#include <sstream>
+#include <string>
+
+#include <misc/contract.hh>
+#include <misc/rope.hh>
+
+using misc::rope;
+
+int main()
+{
+  // Small strings.
+  rope empty;
+  rope ab("ab");
+  assertion(empty.empty() && empty.flat_p());
+  assertion(ab.size() == 2 && ab.flat() == "ab" && ab[1] == 'b');
+  assertion(empty + ab == ab && ab + empty == ab);
+
+  // Long concatenations, flattened lazily.
+  std::string expected;
+  rope s;
+  for (int i = 0; i < 10000; ++i)
+    {
+      std::string piece = std::to_string(i) + ",";
+      expected += piece;
+      s = s + rope(piece);
+    }
+  assertion(s.size() == expected.size());
+  assertion(!s.flat_p());
+  rope copy = s;
+  assertion(s.substr(10, 5).str() == expected.substr(10, 5));
+  assertion(s.flat_p() && copy.flat_p());
+  assertion(s.str() == expected);
+
+  // Prepending, which builds a deep rope.
+  rope deep;
+  for (int i = 0; i < 100000; ++i)
+    deep = rope("xy") + deep;
+  assertion(deep.size() == 200000 && deep[199999] == 'y');
+
+  // Comparisons.
+  rope long1(std::string(100, 'a'));
+  rope long2 = rope(std::string(50, 'a')) + rope(std::string(50, 'a'));
+  assertion(long1 == long2 && !long1.compare(long2));
+  assertion(rope("abc").compare(rope("abd")) < 0);
+  assertion(rope("b").compare(rope("abc")) > 0);
+  assertion(!(long1 == rope(std::string(100, 'b'))));
+
+  // Interned strings share their node.
+  std::string text(40, 'z');
+  rope i1 = rope::intern(text);
+  rope i2 = rope::intern(std::string(40, 'z'));
+  assertion(i1 == i2 && i1.flat().data() == i2.flat().data());
+  assertion(rope::intern("short") == rope("short"));
+
+  std::ostringstream o;
+  o << rope("12") + rope(std::string(300, '3'));
+  assertion(o.str() == "12" + std::string(300, '3'));
+}
@@ -0,0 +1,51 @@
+/**
+ ** Testing the work-stealing thread pool.
+ */
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <misc/contract.hh>
+#include <misc/thread-pool.hh>
+
+int main()
+{
+  misc::thread_pool pool(4);
+  assertion(pool.size_get() == 4);
+
+  // Every index is visited exactly once.
+  {
+    std::vector<int> v(1000, 0);
+    pool.parallel_for(v.size(), [&v](std::size_t i) { v[i] += i; });
+    for (std::size_t i = 0; i < v.size(); ++i)
+      assertion(v[i] == static_cast<int>(i));
+  }
+
+  // Nested batches do not deadlock.
+  {
+    std::atomic<int> count = 0;
+    pool.parallel_for(16, [&pool, &count](std::size_t) {
+      pool.parallel_for(16, [&count](std::size_t) { ++count; });
+    });
+    assertion(count == 16 * 16);
+  }
+
+  // The first exception is propagated to the caller.
+  {
+    bool caught = false;
+    try
+      {
+        pool.parallel_for(8, [](std::size_t i) {
+          if (i == 3)
+            throw std::runtime_error("three");
+        });
+      }
+    catch (const std::runtime_error&)
+      {
+        caught = true;
+      }
+    assertion(caught);
+  }
+}
@@ -21,6 +21,8 @@ int main()
   t.name(Two, "Two");
   t.name(Three, "Three");
 
+  t.counter("Counter", [] { return 42ul; });
+
   t.start();
 
   t.push(One);
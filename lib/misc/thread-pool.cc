@@ -0,0 +1,105 @@
+/**
+ ** \file misc/thread-pool.cc
+ ** \brief Implementation for misc/thread-pool.hh.
+ */
+
+#include <algorithm>
+
+#include <misc/contract.hh>
+#include <misc/thread-pool.hh>
+
+namespace misc
+{
+  thread_pool::thread_pool(unsigned workers)
+  {
+    if (workers == 0)
+      workers = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 0; i < workers; ++i)
+      queues_.emplace_back(std::make_unique<queue>());
+    for (unsigned i = 0; i < workers; ++i)
+      threads_.emplace_back([this, i]() { run(i); });
+  }
+
+  thread_pool::~thread_pool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (std::thread& t : threads_)
+      t.join();
+    postcondition(queued_ == 0);
+  }
+
+  void thread_pool::push(unsigned i, job_type job)
+  {
+    // Account for the job before it becomes visible, so that the
+    // counter never underflows.
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++queued_;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queues_[i]->mutex);
+      queues_[i]->jobs.emplace_back(std::move(job));
+    }
+    cv_.notify_one();
+  }
+
+  bool thread_pool::pop(unsigned self, job_type& job)
+  {
+    // Our own jobs first, LIFO: they are the hottest in the cache.
+    if (self < queues_.size())
+      {
+        queue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.jobs.empty())
+          {
+            job = std::move(q.jobs.back());
+            q.jobs.pop_back();
+            --queued_;
+            return true;
+          }
+      }
+
+    // Then steal, FIFO, from the others.
+    for (unsigned n = 1; n <= queues_.size(); ++n)
+      {
+        unsigned victim = (self + n) % queues_.size();
+        if (victim == self)
+          continue;
+        queue& q = *queues_[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.jobs.empty())
+          {
+            job = std::move(q.jobs.front());
+            q.jobs.pop_front();
+            --queued_;
+            return true;
+          }
+      }
+    return false;
+  }
+
+  void thread_pool::run(unsigned self)
+  {
+    job_type job;
+    while (true)
+      {
+        if (pop(self, job))
+          {
+            job();
+            job = nullptr;
+            continue;
+          }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return stop_ || queued_ != 0; });
+        if (stop_ && queued_ == 0)
+          return;
+      }
+  }
+
+} // namespace misc
@@ -0,0 +1,89 @@
+/**
+ ** \file misc/thread-pool.hh
+ ** \brief thread_pool: a work-stealing pool of worker threads.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace misc
+{
+  /** \brief A pool of worker threads with work stealing.
+
+      Each worker owns a deque of jobs.  A worker pops jobs from the
+      back of its own deque, and when it runs dry, steals from the
+      front of the deques of the other workers.  The thread waiting
+      for a batch of jobs helps running them instead of blocking, so
+      nested calls to parallel_for (e.g., from a job) never deadlock.
+  */
+  class thread_pool
+  {
+  public:
+    /// A unit of work.
+    using job_type = std::function<void()>;
+
+    /// Start \a workers threads.  If \a workers is 0, use the number
+    /// of hardware threads.
+    explicit thread_pool(unsigned workers = 0);
+    /// Wait for the pending jobs, and join the worker threads.
+    ~thread_pool();
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    /// Number of worker threads.
+    unsigned size_get() const;
+
+    /// \brief Run \a f(i) for every i in [0, n), and wait for completion.
+    ///
+    /// Jobs are spread over the worker deques in round robin.  If some
+    /// of the calls throw, the first exception is rethrown once all
+    /// the jobs of the batch are done.
+    template <typename F> void parallel_for(std::size_t n, F&& f);
+
+  private:
+    /// A deque of jobs, owned by a worker.
+    struct queue
+    {
+      std::mutex mutex;
+      std::deque<job_type> jobs;
+    };
+
+    /// Push \a job on the deque of worker \a i.
+    void push(unsigned i, job_type job);
+    /// Pop a job, first from the back of the deque of \a self, then
+    /// from the front of the others'.
+    bool pop(unsigned self, job_type& job);
+    /// Main loop of worker \a self.
+    void run(unsigned self);
+
+    /// The per-worker deques.
+    std::vector<std::unique_ptr<queue>> queues_;
+    /// The workers.
+    std::vector<std::thread> threads_;
+    /// Where to push the next job.
+    std::atomic<unsigned> next_ = 0;
+    /// Number of jobs pushed but not popped yet.
+    std::atomic<std::size_t> queued_ = 0;
+
+    /// Protect sleeping workers.
+    std::mutex mutex_;
+    /// Wake up sleeping workers.
+    std::condition_variable cv_;
+    /// Whether the pool is being destroyed.
+    bool stop_ = false;
+  };
+
+} // namespace misc
+
+#include <misc/thread-pool.hxx>
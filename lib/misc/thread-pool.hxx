@@ -0,0 +1,65 @@
+/**
+ ** \file misc/thread-pool.hxx
+ ** \brief Inline methods for misc/thread-pool.hh.
+ */
+
+#pragma once
+
+#include <misc/thread-pool.hh>
+
+namespace misc
+{
+  inline unsigned thread_pool::size_get() const { return threads_.size(); }
+
+  template <typename F> void thread_pool::parallel_for(std::size_t n, F&& f)
+  {
+    if (n == 0)
+      return;
+
+    // The state of the batch, shared with the jobs.
+    struct batch
+    {
+      std::atomic<std::size_t> remaining;
+      std::mutex mutex;
+      std::condition_variable done;
+      std::exception_ptr error;
+    } b;
+    b.remaining = n;
+
+    for (std::size_t i = 0; i < n; ++i)
+      push(next_++ % queues_.size(), [&b, &f, i]() {
+        try
+          {
+            f(i);
+          }
+        catch (...)
+          {
+            std::lock_guard<std::mutex> lock(b.mutex);
+            if (!b.error)
+              b.error = std::current_exception();
+          }
+        // Decrement under the lock: once the count reaches zero, the
+        // waiting thread may destroy the batch.
+        std::lock_guard<std::mutex> lock(b.mutex);
+        if (--b.remaining == 0)
+          b.done.notify_all();
+      });
+
+    // Help instead of blocking: steal jobs until the batch is over.
+    job_type job;
+    while (b.remaining != 0)
+      if (pop(queues_.size(), job))
+        job();
+      else
+        {
+          std::unique_lock<std::mutex> lock(b.mutex);
+          b.done.wait(lock, [&b]() { return b.remaining == 0; });
+        }
+
+    // Synchronize with the last job before destroying the batch.
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (b.error)
+      std::rethrow_exception(b.error);
+  }
+
+} // namespace misc
@@ -63,6 +63,7 @@ namespace misc
   // Duplicate a timer.  No tasks should be running.
   timer::timer(const timer& rhs)
     : intmap(rhs.intmap)
+    , counters(rhs.counters)
     , total(rhs.total)
     , dump_stream(rhs.dump_stream)
   {
@@ -95,6 +96,12 @@ namespace misc
       delete p.second;
   }
 
+  void timer::counter(const std::string& counter_name,
+                      std::function<unsigned long()> read)
+  {
+    counters[counter_name] = std::move(read);
+  }
+
   void timer::name(int i, const std::string& task_name)
   {
     intmap[i] = task_name;
@@ -146,6 +153,15 @@ namespace misc
       }
     out << '\n';
 
+    if (!counters.empty())
+      {
+        out << "Counters\n";
+        for (const counter_map_type::value_type& p : counters)
+          out << " " << p.first << std::setw(26 - p.first.length()) << ": "
+              << p.second() << '\n';
+        out << '\n';
+      }
+
     out << " TOTAL (seconds)" << std::setw(11) << ": "
 
         << std::setiosflags(std::ios::left) << std::setw(7)
@@ -200,6 +216,7 @@ namespace misc
         tasksmap[p.first] = new time_var(*p.second);
 
     intmap.insert(rhs.intmap.begin(), rhs.intmap.end());
+    counters.insert(rhs.counters.begin(), rhs.counters.end());
     return *this;
   }
 
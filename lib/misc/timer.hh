@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <functional>
 #include <iosfwd>
 #include <iostream>
 #include <map>
@@ -50,6 +51,11 @@ namespace misc
     /// timer on stream \a out.
     void dump_on_destruction(std::ostream& out);
 
+    /// Report the value returned by \a read when the results are
+    /// written, under the name \a counter_name.
+    void counter(const std::string& counter_name,
+                 std::function<unsigned long()> read);
+
     /// Assign name \a task_name to task number \a i.
     void name(int i, const std::string& task_name);
 
@@ -119,6 +125,12 @@ namespace misc
     /// \see push(int)
     std::map<int, std::string> intmap;
 
+    using counter_map_type =
+      std::map<const std::string, std::function<unsigned long()>>;
+
+    /// Counters reported with the times.
+    counter_map_type counters;
+
     /// Total time measured by the timer.
     /// \see start()
     /// \see stop()
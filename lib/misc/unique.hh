@@ -6,6 +6,7 @@
 #pragma once
 
 #include <iosfwd>
+#include <mutex>
 #include <set>
 
 namespace misc
@@ -68,6 +69,8 @@ namespace misc
   protected:
     /// Return the set of uniques.
     static object_set_type& object_set_instance();
+    /// Return the lock of the set of uniques.
+    static std::mutex& object_set_mutex();
 
     /// Pointer to the unique referenced object.
     const data_type* obj_;
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <mutex>
+
 #include <misc/contract.hh>
 #include <misc/unique.hh>
 
@@ -13,18 +15,11 @@ namespace misc
   template <typename T, class C> unique<T, C>::unique(const data_type& s)
   {
     //DONE
-    static object_set_type set;
-    auto it = set.find(s);
-    if (it != set.end())
-      {
-        obj_ = &(*it);
-      }
-    else
-      {
-        set.insert(s);
-        it = set.find(s);
-        obj_ = &(*it);
-      }
+    // The bodies of the functions are type-checked concurrently, and
+    // build symbols as they go.  The nodes of a std::set are stable, so
+    // obj_ remains valid once the lock is released.
+    std::lock_guard<std::mutex> lock(object_set_mutex());
+    obj_ = &*object_set_instance().insert(s).first;
   }
 
   template <typename T, class C>
@@ -35,12 +30,18 @@ namespace misc
     return set;
   }
 
+  template <typename T, class C> std::mutex& unique<T, C>::object_set_mutex()
+  {
+    static std::mutex mutex;
+    return mutex;
+  }
+
   template <typename T, class C>
   typename unique<T, C>::object_size_type unique<T, C>::object_map_size()
   {
     //DONE
-    static object_set_type set;
-    return set.size();
+    std::lock_guard<std::mutex> lock(object_set_mutex());
+    return object_set_instance().size();
   }
 
   template <typename T, class C>
@@ -9,6 +9,7 @@ AST_NODES =  \
   src/ast/chunk-list.hh src/ast/chunk-list.hxx src/ast/chunk-list.cc \
   src/ast/class-ty.hh src/ast/class-ty.hxx src/ast/class-ty.cc \
   src/ast/dec.hh src/ast/dec.hxx src/ast/dec.cc \
+  src/ast/effectful.hh src/ast/effectful.hxx src/ast/effectful.cc \
   src/ast/escapable.hh src/ast/escapable.hxx src/ast/escapable.cc \
   src/ast/exp.hh src/ast/exp.hxx src/ast/exp.cc \
   src/ast/field.hh src/ast/field.hxx src/ast/field.cc \
@@ -99,7 +99,8 @@ namespace ast
   {
     e.get_test().accept(*this);
     e.get_thenclause().accept(*this);
-    e.get_elseclause().accept(*this);
+    if (&e.get_elseclause())
+      e.get_elseclause().accept(*this);
   }
 
   template <template <typename> class Const>
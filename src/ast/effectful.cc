@@ -0,0 +1,6 @@
+/**
+ ** \file ast/effectful.cc
+ ** \brief Implementation of ast::Effectful.
+ */
+
+#include <ast/effectful.hh>
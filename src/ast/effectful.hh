@@ -0,0 +1,46 @@
+/**
+ ** \file ast/effectful.hh
+ ** \brief Declaration of ast::Effectful.
+ */
+
+#pragma once
+
+#include <ast/fwd.hh>
+
+namespace ast
+{
+  /// Effectful.
+  class Effectful
+  {
+  public:
+    /// The effects a function may have, as a set of bits.
+    enum effect : unsigned
+    {
+      /// Reads a non local variable, a field or an array element.
+      reads = 1 << 0,
+      /// Writes a non local variable, a field or an array element.
+      writes = 1 << 1,
+      /// Performs input or output.
+      io = 1 << 2,
+      /// May not return normally: may loop forever, fail, or exit.
+      diverges = 1 << 3,
+      /// Allocates a record or an array: two evaluations yield distinct
+      /// values.
+      allocates = 1 << 4,
+    };
+    /// No effect.
+    static constexpr unsigned pure = 0;
+    /// Any effect.
+    static constexpr unsigned any = reads | writes | io | diverges | allocates;
+
+    unsigned effects_get() const;
+    void effects_set(unsigned effects);
+
+  protected:
+    /// Until they are computed, anything may happen.
+    unsigned effects_ = any;
+  };
+
+} // namespace ast
+
+#include <ast/effectful.hxx>
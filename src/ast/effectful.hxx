@@ -0,0 +1,14 @@
+/**
+ ** \file ast/effectful.hxx
+ ** \brief Inline methods of ast::Effectful.
+ */
+
+#pragma once
+
+#include <ast/effectful.hh>
+
+namespace ast
+{
+  inline unsigned Effectful::effects_get() const { return effects_; }
+  inline void Effectful::effects_set(unsigned effects) { effects_ = effects; }
+} // namespace ast
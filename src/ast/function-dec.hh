@@ -7,6 +7,7 @@
 
 #include <ast/chunk.hh>
 #include <ast/dec.hh>
+#include <ast/effectful.hh>
 #include <ast/exp.hh>
 #include <ast/name-ty.hh>
 #include <ast/type-constructor.hh>
@@ -17,6 +18,7 @@ namespace ast
   /// FunctionDec.
   class FunctionDec
     : public Dec
+    , public Effectful
     , public TypeConstructor
   {
   public:
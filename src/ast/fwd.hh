@@ -23,6 +23,7 @@ namespace ast
   class ChunkList;
   class ClassTy;
   class Dec;
+  class Effectful;
   class Escapable;
   class Exp;
   class Field;
@@ -18,6 +18,8 @@ namespace ast
 
   /// xalloc slot to enable escapes display in Ast display.
   const misc::xalloc<bool> escapes_display;
+  /// xalloc slot to enable effects display in Ast display.
+  const misc::xalloc<bool> effects_display;
   /// xalloc slot to enable bindings display in Ast display.
   const misc::xalloc<bool> bindings_display;
 
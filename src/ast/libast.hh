@@ -15,6 +15,7 @@
 namespace ast
 {
   extern const misc::xalloc<bool> escapes_display;
+  extern const misc::xalloc<bool> effects_display;
   extern const misc::xalloc<bool> bindings_display;
 
   /// Output \a a on \a ostr.
@@ -5,6 +5,7 @@
 
 #include <cstddef>
 #include <typeinfo>
+#include <utility>
 #include <ast/all.hh>
 #include <ast/libast.hh>
 #include <ast/pretty-printer.hh>
@@ -27,6 +28,26 @@ namespace ast
       return ostr;
     }
 
+    /// Output the effects of \a e on \a ostr.
+    std::ostream& effects_print(std::ostream& ostr, const Effectful& e)
+    {
+      unsigned effects = e.effects_get();
+      if (effects == Effectful::pure)
+        return ostr << "pure";
+      const char* sep = "";
+      for (auto [effect, name] : {std::pair{Effectful::reads, "reads"},
+                                  {Effectful::writes, "writes"},
+                                  {Effectful::io, "io"},
+                                  {Effectful::diverges, "diverges"},
+                                  {Effectful::allocates, "allocates"}})
+        if (effects & effect)
+          {
+            ostr << sep << name;
+            sep = " ";
+          }
+      return ostr;
+    }
+
     /// \brief Output \a e on \a ostr.
     ///
     /// Used to factor the output of the name declared,
@@ -154,6 +175,11 @@ namespace ast
               ostr_ << " /* " << e.result_get()->def_get() << " */";
           }
       }
+    if (effects_display(ostr_))
+      {
+        ostr_ << " /* ";
+        effects_print(ostr_, e) << " */";
+      }
     if (e.body_get() != nullptr)
       {
         ostr_ << " =" << misc::incendl << *(e.body_get()) << misc::decendl;
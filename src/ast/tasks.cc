@@ -5,15 +5,37 @@
 
 #include <ast/libast.hh>
 #include <misc/contract.hh>
+#include <type/type-arena.hh>
 #define DEFINE_TASKS 1
 #include <ast/tasks.hh>
 #undef DEFINE_TASKS
 
 namespace ast::tasks
 {
+  namespace
+  {
+    /// The types of the abstract syntax tree, which are those of the
+    /// current compilation.  Defined before the tree, so that they
+    /// are destroyed after it.
+    struct program_types
+    {
+      program_types() { type::default_arena_set(&arena); }
+      ~program_types() { type::default_arena_set(nullptr); }
+
+      type::TypeArena arena;
+    } types;
+
+  } // namespace
+
   // The abstract syntax tree.
   std::unique_ptr<ast::ChunkList> the_program(nullptr);
 
+  void program_drop()
+  {
+    the_program.reset();
+    types.arena.clear();
+  }
+
   void ast_display()
   {
     precondition(the_program);
@@ -13,6 +13,10 @@ namespace ast::tasks
   /// Global root node of abstract syntax tree.
   extern std::unique_ptr<ast::ChunkList> the_program;
 
+  /// Drop the_program, and destroy the types of the compilation (see
+  /// type::default_arena).
+  void program_drop();
+
   TASK_GROUP("2. Abstract Syntax Tree");
 
   /// Display the abstract syntax tree.
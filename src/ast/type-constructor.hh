@@ -24,7 +24,7 @@ namespace ast
     virtual void accept(Visitor& v) = 0;
 
   private:
-    const type::Type* type_;
+    const type::Type* type_ = nullptr;
   };
 } // namespace ast
 #include <ast/type-constructor.hxx>
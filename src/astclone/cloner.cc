@@ -43,11 +43,10 @@ namespace astclone
 
   void Cloner::operator()(const ast::BreakExp& e)
   {
+    // Do not clone the loop: it is the one enclosing the clone, and
+    // the binder links them again.
     const Location& location = e.location_get();
-    Exp* exp = recurse(e.def_get());
-    auto breakExp= new BreakExp(location);
-    breakExp->def_set(exp);
-    result_ = breakExp;
+    result_ = new BreakExp(location);
   }
 
   void Cloner::operator()(const ast::CallExp& e)
@@ -130,7 +129,7 @@ namespace astclone
     const Location& location = e.location_get();
     Exp* test = recurse(e.get_test());
     Exp* thenclause = recurse(e.get_thenclause());
-    Exp* elseclause = recurse(e.get_elseclause());
+    Exp* elseclause = recurse(&e.get_elseclause());
     result_ = new IfExp(location, test, thenclause, elseclause);
   }
 
@@ -257,7 +256,7 @@ namespace astclone
     misc::symbol name = e.name_get();
     NameTy* type_name = recurse(e.type_name_get());
     Exp* init = recurse(e.init_get());
-    // FIXME: Some code was deleted here (Cloned node instantiation).
+    result_ = new VarDec(location, name, type_name, init);
   }
 
   void Cloner::operator()(const ast::WhileExp& e)
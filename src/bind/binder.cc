@@ -323,36 +323,10 @@ namespace bind
   | Visiting FunctionChunk. |
   `------------------------*/
 
-  void Binder::operator()(ast::FunctionChunk& e)
-  {
-    for (auto& dec : e)
-      {
-        auto name = scope_fun_.get(dec->name_get());
-        if (name != nullptr)
-          Binder::redefinition(name, dec);
-        else
-          {
-            scope_fun_.put(dec->name_get(), dec);
-            dec->accept(*this);
-          }
-      }
-  }
+  void Binder::operator()(ast::FunctionChunk& e) { chunk_visit(e); }
 
   /*--------------------.
   | Visiting TypeChunk. |
   `--------------------*/
-  void Binder::operator()(ast::TypeChunk& e)
-  {
-    for (auto& dec : e)
-      {
-        auto name = scope_type_.get(dec->name_get());
-        if (name != nullptr)
-          Binder::redefinition(name, dec);
-        else
-          {
-            scope_type_.put(dec->name_get(), dec);
-            dec->accept(*this);
-          }
-      }
-  }
+  void Binder::operator()(ast::TypeChunk& e) { chunk_visit(e); }
 } // namespace bind
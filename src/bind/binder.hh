@@ -130,8 +130,6 @@ namespace bind
 
     /// Check a Function or Type declaration body.
     template <class D> void visit_dec_body(D& e);
-
-    // FIXME: Some code was deleted here.
     /// \}
 
     /// \name Error handling
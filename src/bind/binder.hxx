@@ -46,18 +46,58 @@ namespace bind
   | Visiting /ChunkInterface/.  |
   `----------------------------*/
 
-  template <class D> void Binder::chunk_visit(ast::Chunk<D>& e)
+  /* These specializations are in bind/binder.hxx, so that derived
+     visitors can use them (otherwise, they wouldn't see them).  */
+
+  // A variable is bound in a single step.
+  template <> inline void Binder::visit_dec_header<ast::VarDec>(ast::VarDec&)
+  {}
+
+  template <> inline void Binder::visit_dec_body<ast::VarDec>(ast::VarDec& e)
   {
-    // Shorthand.
-    using chunk_type = ast::Chunk<D>;
-    for (const auto& dec : e)
-      dec->accept(*this);
-    // FIXME make for loop for body.
+    e.accept(*this);
   }
 
-  /* These specializations are in bind/binder.hxx, so that derived
-     visitors can use them (otherwise, they wouldn't see them).  */
+  // Introduce the function, so that the chunk can call it.
+  template <>
+  inline void Binder::visit_dec_header<ast::FunctionDec>(ast::FunctionDec& e)
+  {
+    auto name = scope_fun_.get(e.name_get());
+    if (name != nullptr && name != &e)
+      Binder::redefinition(name, &e);
+    else
+      scope_fun_.put(e.name_get(), &e);
+  }
 
-  // FIXME: Some code was deleted here.
+  template <>
+  inline void Binder::visit_dec_body<ast::FunctionDec>(ast::FunctionDec& e)
+  {
+    e.accept(*this);
+  }
+
+  // Introduce the type, so that the chunk can refer to it.
+  template <>
+  inline void Binder::visit_dec_header<ast::TypeDec>(ast::TypeDec& e)
+  {
+    auto name = scope_type_.get(e.name_get());
+    if (name != nullptr && name != &e)
+      Binder::redefinition(name, &e);
+    else
+      scope_type_.put(e.name_get(), &e);
+  }
+
+  template <>
+  inline void Binder::visit_dec_body<ast::TypeDec>(ast::TypeDec& e)
+  {
+    e.accept(*this);
+  }
+
+  template <class D> void Binder::chunk_visit(ast::Chunk<D>& e)
+  {
+    for (D* dec : e)
+      visit_dec_header<D>(*dec);
+    for (D* dec : e)
+      visit_dec_body<D>(*dec);
+  }
 
 } // namespace bind
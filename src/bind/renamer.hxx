@@ -42,6 +42,11 @@ namespace bind
     return new_name;
   }
 
+  /// `_main' and the primitives keep their name (see renamer.cc).
+  template <>
+  misc::symbol
+  Renamer::new_name_compute<ast::FunctionDec>(const ast::FunctionDec& e);
+
   template <typename Def> misc::symbol Renamer::new_name(const Def& e)
   {
     auto it = new_names_.find(e);
@@ -14,9 +14,8 @@ namespace bind::tasks
   DISJUNCTIVE_TASK_DECLARE("bound",
                            "default the computation of bindings to Tiger"
                            "(without objects nor overloading)",
-                           "bindings-compute");
-
-  //OBJECT AFTER biding-compute in DISJONCTIVE TASK
+                           "bindings-compute"
+                           " object-bindings-compute");
 
   TASK_DECLARE("b|bindings-compute",
                "bind the identifiers ",
@@ -6,24 +6,79 @@
 #include <ast/call-exp.hh>
 #include <ast/function-dec.hh>
 #include <callgraph/call-graph-visitor.hh>
+#include <misc/thread-pool.hh>
 
 namespace callgraph
 {
-  const CallGraph* CallGraphVisitor::create(const ast::Ast& tree)
+  const CallGraph* CallGraphVisitor::create(const ast::Ast& tree,
+                                            unsigned jobs)
   {
     // Create a new empty callgraph
     callgraph = new CallGraph();
 
     // Launch visitor.
+    this->jobs = jobs;
     tree.accept(*this);
 
     // Return created callgraph.
     return callgraph;
   }
 
-  CallGraph* CallGraphVisitor::create(ast::Ast& tree)
+  CallGraph* CallGraphVisitor::create(ast::Ast& tree, unsigned jobs)
   {
-    return const_cast<CallGraph*>(create(const_cast<const ast::Ast&>(tree)));
+    return const_cast<CallGraph*>(
+      create(const_cast<const ast::Ast&>(tree), jobs));
+  }
+
+  /*-----------.
+  | Sharding.  |
+  `-----------*/
+
+  void CallGraphVisitor::shard_compute(const ast::FunctionDec& e, Shard& s)
+  {
+    shard = &s;
+    e.accept(*this);
+    shard = nullptr;
+  }
+
+  void CallGraphVisitor::chunk_parallel(const ast::FunctionChunk& e)
+  {
+    if (!pool)
+      pool = std::make_shared<misc::thread_pool>(jobs);
+
+    const auto& fundecs = e.decs_get();
+    std::vector<Shard> shards(fundecs.size());
+    pool->parallel_for(fundecs.size(), [&fundecs, &shards](std::size_t i) {
+      CallGraphVisitor v;
+      v.shard_compute(*fundecs[i], shards[i]);
+    });
+
+    // Merge, so that the vertices are numbered as in a sequential
+    // traversal.
+    for (const Shard& s : shards)
+      {
+        for (ast::FunctionDec* f : s.fundecs)
+          callgraph->fundec_add(f);
+        for (auto [fu, fv] : s.links)
+          callgraph->fundec_link(fu, fv);
+      }
+  }
+
+  void CallGraphVisitor::fundec_add(ast::FunctionDec* f)
+  {
+    if (shard)
+      shard->fundecs.emplace_back(f);
+    else
+      callgraph->fundec_add(f);
+  }
+
+  void CallGraphVisitor::fundec_link(ast::FunctionDec* fu,
+                                     ast::FunctionDec* fv)
+  {
+    if (shard)
+      shard->links.emplace_back(fu, fv);
+    else
+      callgraph->fundec_link(fu, fv);
   }
 
   /*-----------.
@@ -32,16 +87,24 @@ namespace callgraph
 
   void CallGraphVisitor::operator()(const ast::CallExp& e)
   {
-    // FIXME: Some code was deleted here (Link the Caller with the CallExp's declaration).
+    super_type::operator()(e);
+    // Calls outside of any function (e.g., in the initialization of a
+    // top-level variable) have no caller.
+    if (caller && e.def_get())
+      fundec_link(caller, const_cast<ast::FunctionDec*>(e.def_get()));
   }
 
   void CallGraphVisitor::operator()(const ast::FunctionChunk& e)
   {
     // First define the nodes for each defined function.
     for (ast::FunctionDec* f : e)
-      callgraph->fundec_add(f);
-    // Now bind callers and callees.
-    super_type::operator()(e);
+      fundec_add(f);
+    // Now bind callers and callees.  Within a shard, the nested
+    // chunks are visited sequentially.
+    if (1 < jobs && !shard && 2 <= e.decs_get().size())
+      chunk_parallel(e);
+    else
+      super_type::operator()(e);
   }
 
   void CallGraphVisitor::operator()(const ast::FunctionDec& e)
@@ -4,9 +4,14 @@
  **/
 #pragma once
 
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include <ast/default-visitor.hh>
 #include <ast/non-object-visitor.hh>
 #include <callgraph/fundec-graph.hh>
+#include <misc/fwd.hh>
 
 namespace callgraph
 {
@@ -18,19 +23,52 @@ namespace callgraph
   public:
     using super_type = ast::DefaultConstVisitor;
     using super_type::operator();
-    const CallGraph* create(const ast::Ast& tree);
-    CallGraph* create(ast::Ast& tree);
+    /// \brief Build the call graph of \a tree.
+    ///
+    /// If \a jobs is greater than 1, the functions of a chunk declaring
+    /// several of them are visited in parallel, and the results are
+    /// merged in the order of a sequential traversal.  This applies to
+    /// the outermost such chunks: the top-level ones, and the ones
+    /// nested in the body of a lone `_main'.
+    const CallGraph* create(const ast::Ast& tree, unsigned jobs = 1);
+    CallGraph* create(ast::Ast& tree, unsigned jobs = 1);
+
+    /// The part of the call graph local to a function visited in
+    /// parallel.
+    struct Shard
+    {
+      /// The nested functions, in the order they are met.
+      std::vector<ast::FunctionDec*> fundecs;
+      /// The calls, as (caller, callee) pairs.
+      std::vector<std::pair<ast::FunctionDec*, ast::FunctionDec*>> links;
+    };
 
   protected:
     void operator()(const ast::CallExp& e) override;
     void operator()(const ast::FunctionChunk& e) override;
     void operator()(const ast::FunctionDec& e) override;
 
+    /// Compute the shard of the function \a e.
+    void shard_compute(const ast::FunctionDec& e, Shard& s);
+    /// Visit the functions of \a e in parallel.
+    void chunk_parallel(const ast::FunctionChunk& e);
+
+    /// Record the definition of \a f.
+    void fundec_add(ast::FunctionDec* f);
+    /// Record a call from \a fu to \a fv.
+    void fundec_link(ast::FunctionDec* fu, ast::FunctionDec* fv);
+
   protected:
+    /// The shard being computed, if any.
+    Shard* shard = nullptr;
     /// Current function.
     ast::FunctionDec* caller = nullptr;
     /// Call graph.
     CallGraph* callgraph = nullptr;
+    /// Number of threads allowed to visit functions.
+    unsigned jobs = 1;
+    /// The threads, created on demand.
+    std::shared_ptr<misc::thread_pool> pool;
   };
 
 } // namespace callgraph
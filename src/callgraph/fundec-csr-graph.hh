@@ -0,0 +1,50 @@
+/**
+ ** \file callgraph/fundec-csr-graph.hh
+ ** \brief Declare and define the frozen fundec graph.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <ast/function-dec.hh>
+#include <misc/csr-graph.hh>
+
+namespace callgraph
+{
+  /*-----------------.
+  | FundecCsrGraph.  |
+  `-----------------*/
+
+  /// \brief A frozen FundecGraph.
+  ///
+  /// Built once the FundecGraph is complete (see FundecGraph::freeze),
+  /// it provides compact successor and predecessor arrays, and a
+  /// constant time mapping from a FunctionDec to its vertex.
+  class FundecCsrGraph : public misc::csr_graph<ast::FunctionDec*>
+  {
+  public:
+    using super_type = misc::csr_graph<ast::FunctionDec*>;
+
+    FundecCsrGraph() = default;
+    /// Build the graph whose vertex i is \a fundecs[i].
+    FundecCsrGraph(std::vector<ast::FunctionDec*> fundecs,
+                   std::vector<edge_type> edges);
+
+    /// Whether \a f is a vertex of the graph.
+    bool has_fundec(const ast::FunctionDec* f) const;
+    /// Retrieve the vertex corresponding to a FunctionDec.
+    vertex_type hfundec_get(const ast::FunctionDec* f) const;
+
+  protected:
+    using hfundecs_type =
+      std::unordered_map<const ast::FunctionDec*, vertex_type>;
+    hfundecs_type hfundecs;
+  };
+
+  using FrozenCallGraph = FundecCsrGraph;
+
+} // namespace callgraph
+
+#include <callgraph/fundec-csr-graph.hxx>
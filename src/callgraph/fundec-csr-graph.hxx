@@ -0,0 +1,35 @@
+/**
+ ** \file callgraph/fundec-csr-graph.hxx
+ ** \brief Inline methods for callgraph/fundec-csr-graph.hh.
+ */
+
+#pragma once
+
+#include <callgraph/fundec-csr-graph.hh>
+#include <misc/contract.hh>
+
+namespace callgraph
+{
+  inline FundecCsrGraph::FundecCsrGraph(std::vector<ast::FunctionDec*> fundecs,
+                                        std::vector<edge_type> edges)
+    : super_type(std::move(fundecs), std::move(edges))
+  {
+    hfundecs.reserve(vertex_count());
+    for (vertex_type v = 0; v < vertex_count(); ++v)
+      hfundecs.emplace((*this)[v], v);
+  }
+
+  inline bool FundecCsrGraph::has_fundec(const ast::FunctionDec* f) const
+  {
+    return hfundecs.contains(f);
+  }
+
+  inline FundecCsrGraph::vertex_type
+  FundecCsrGraph::hfundec_get(const ast::FunctionDec* f) const
+  {
+    hfundecs_type::const_iterator i = hfundecs.find(f);
+    assertion(i != hfundecs.end());
+    return i->second;
+  }
+
+} // namespace callgraph
@@ -10,6 +10,7 @@
 #include <boost/graph/adjacency_list.hpp>
 
 #include <ast/function-dec.hh>
+#include <callgraph/fundec-csr-graph.hh>
 #include <misc/graph.hh>
 
 namespace callgraph
@@ -30,6 +31,11 @@ namespace callgraph
     /// Retrieve the vertex handle corresponding to a FunctionDec.
     vertex_descriptor hfundec_get(ast::FunctionDec* f) const;
 
+    /// \brief Convert into a compact, read-only graph.
+    ///
+    /// Vertices keep their numbers.
+    FundecCsrGraph freeze() const;
+
   protected:
     /// Print the label of vertex of a graph.
     std::ostream& vertex_print(vertex_descriptor v,
@@ -30,6 +30,21 @@ namespace callgraph
     return i->second;
   }
 
+  inline FundecCsrGraph FundecGraph::freeze() const
+  {
+    std::vector<ast::FunctionDec*> fundecs;
+    fundecs.reserve(boost::num_vertices(*this));
+    for (auto [i, i_end] = boost::vertices(*this); i != i_end; ++i)
+      fundecs.emplace_back((*this)[*i]);
+
+    std::vector<FundecCsrGraph::edge_type> edges;
+    edges.reserve(boost::num_edges(*this));
+    for (auto [i, i_end] = boost::edges(*this); i != i_end; ++i)
+      edges.emplace_back(boost::source(*i, *this), boost::target(*i, *this));
+
+    return FundecCsrGraph(std::move(fundecs), std::move(edges));
+  }
+
   inline std::ostream& FundecGraph::vertex_print(vertex_descriptor v,
                                                  std::ostream& ostr) const
   {
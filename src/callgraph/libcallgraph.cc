@@ -13,16 +13,16 @@ namespace callgraph
 {
 
   // Build the callgraph.
-  const CallGraph* callgraph_compute(const ast::Ast& tree)
+  const CallGraph* callgraph_compute(const ast::Ast& tree, unsigned jobs)
   {
     CallGraphVisitor callgraph_visitor;
-    return callgraph_visitor.create(tree);
+    return callgraph_visitor.create(tree, jobs);
   }
 
-  CallGraph* callgraph_compute(ast::Ast& tree)
+  CallGraph* callgraph_compute(ast::Ast& tree, unsigned jobs)
   {
     CallGraphVisitor callgraph_visitor;
-    return callgraph_visitor.create(tree);
+    return callgraph_visitor.create(tree, jobs);
   }
 
 } // namespace callgraph
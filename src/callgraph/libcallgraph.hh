@@ -15,8 +15,9 @@ namespace callgraph
 #ifdef SWIG
   %newobject callgraph_compute;
 #endif
-  /// Build the callgraph.
-  const CallGraph* callgraph_compute(const ast::Ast& tree);
-  CallGraph* callgraph_compute(ast::Ast& tree);
+  /// Build the callgraph, visiting the functions of the outermost
+  /// chunks (see CallGraphVisitor::create) on \a jobs threads.
+  const CallGraph* callgraph_compute(const ast::Ast& tree, unsigned jobs = 1);
+  CallGraph* callgraph_compute(ast::Ast& tree, unsigned jobs = 1);
 
 } // namespace callgraph
@@ -11,6 +11,7 @@
 #include <callgraph/tasks.hh>
 #undef DEFINE_TASKS
 #include <callgraph/libcallgraph.hh>
+#include <task/tasks.hh>
 
 namespace callgraph::tasks
 {
@@ -22,7 +23,8 @@ namespace callgraph::tasks
 
   void callgraph_compute()
   {
-    callgraph.reset(::callgraph::callgraph_compute(*ast::tasks::the_program));
+    callgraph.reset(::callgraph::callgraph_compute(*ast::tasks::the_program,
+                                                   ::task::tasks::jobs));
   }
 
   void callgraph_dump()
@@ -0,0 +1,742 @@
+/**
+ ** \file cemit/emitter.cc
+ ** \brief Implementation of cemit::Emitter.
+ */
+
+#include <climits>
+#include <ostream>
+
+#include <ast/all.hh>
+#include <cemit/emitter.hh>
+#include <cemit/runtime.hh>
+#include <misc/contract.hh>
+#include <misc/escape.hh>
+#include <misc/indent.hh>
+#include <type/array.hh>
+#include <type/builtin-types.hh>
+#include <type/field.hh>
+#include <type/function.hh>
+#include <type/record.hh>
+
+namespace cemit
+{
+  namespace
+  {
+    /// Whether evaluating \a e cannot change a variable.
+    bool leaf_p(const ast::Exp& e)
+    {
+      return dynamic_cast<const ast::IntExp*>(&e)
+        || dynamic_cast<const ast::StringExp*>(&e)
+        || dynamic_cast<const ast::NilExp*>(&e)
+        || dynamic_cast<const ast::SimpleVar*>(&e);
+    }
+
+    /// Whether \a e is a literal.
+    bool literal_p(const ast::Exp& e)
+    {
+      return dynamic_cast<const ast::IntExp*>(&e)
+        || dynamic_cast<const ast::StringExp*>(&e)
+        || dynamic_cast<const ast::NilExp*>(&e);
+    }
+
+    /// Whether one of the expressions from \a i on is not a leaf.
+    template <typename It> bool later_p(It i, It end)
+    {
+      for (; i != end; ++i)
+        if (!leaf_p(**i))
+          return true;
+      return false;
+    }
+
+    /// \a s as the contents of a C string literal.
+    std::string c_escape(const std::string& s)
+    {
+      static const char digits[] = "01234567";
+      std::string res;
+      for (unsigned char c : s)
+        if (c == '\\' || c == '"' || c == '?')
+          res += {'\\', static_cast<char>(c)};
+        else if (32 <= c && c < 127)
+          res += static_cast<char>(c);
+        else
+          // Always three digits, not to swallow the next character.
+          res += {'\\', digits[c >> 6], digits[(c >> 3) & 7], digits[c & 7]};
+      return res;
+    }
+
+    /// The C comparison operator of \a oper.
+    const char* comparison_get(ast::OpExp::Oper oper)
+    {
+      using Oper = ast::OpExp::Oper;
+      switch (oper)
+        {
+        case Oper::eq:
+          return "==";
+        case Oper::ne:
+          return "!=";
+        case Oper::lt:
+          return "<";
+        case Oper::le:
+          return "<=";
+        case Oper::gt:
+          return ">";
+        case Oper::ge:
+          return ">=";
+        default:
+          unreachable();
+        }
+    }
+
+  } // namespace
+
+  Emitter::Emitter(std::ostream& ostr)
+    : ostr_(ostr)
+  {}
+
+  void Emitter::operator()(const ast::ChunkList& e)
+  {
+    interpret::layout layout = interpret::layout_compute(e);
+    indices_ = std::move(layout.indices);
+    for (interpret::layout::function& fun : layout.functions)
+      {
+        std::string name = name_make("fun", fun.dec->name_get());
+        const function& f =
+          functions_.emplace_back(function{std::move(fun), std::move(name)});
+        for (const ast::VarDec* dec : f.variables)
+          variables_[dec] = variable{layout.slots.at(dec),
+                                     pointer_p(type_of(*dec)),
+                                     name_make("var", dec->name_get())};
+      }
+
+    // Translate the functions first, to collect the record types and
+    // the string literals.
+    std::vector<std::string> definitions;
+    for (unsigned i = 0; i < functions_.size(); ++i)
+      definitions.emplace_back(emit(i));
+
+    ostr_ << "/* Tiger program compiled into C99.  */\n\n" << runtime
+          << "\n/*-------------.\n| The program. |\n`-------------*/\n\n";
+
+    // The frames, and their map.
+    for (const function& fun : functions_)
+      if (!fun.escaping.empty())
+        {
+          std::string pointers;
+          ostr_ << "\nstruct frame_" << fun.name << "\n{\n";
+          if (fun.parent != -1 && functions_[fun.parent].frame != -1)
+            {
+              ostr_ << "  tc_word link;\n";
+              pointers += 'p';
+            }
+          for (const ast::VarDec* dec : fun.escaping)
+            {
+              const variable& var = variables_.at(dec);
+              ostr_ << "  tc_word " << var.name << ";\n";
+              pointers += var.pointer ? 'p' : '.';
+            }
+          ostr_ << "};\n"
+                << "static const struct tc_map map_frame_" << fun.name
+                << " = {TC_SLOTS, " << pointers.size() << ", \"" << pointers
+                << "\"};\n";
+        }
+    ostr_ << structures_.str() << '\n' << strings_.str();
+
+    // The functions.
+    for (const function& fun : functions_)
+      ostr_ << '\n' << signature(fun) << ";\n";
+    for (const std::string& definition : definitions)
+      ostr_ << '\n' << definition;
+
+    int main = -1;
+    for (unsigned i = 0; i < functions_.size(); ++i)
+      if (functions_[i].parent == -1
+          && functions_[i].dec->name_get() == "_main")
+        main = i;
+    // A file of declarations does nothing.
+    ostr_ << "\ntc_word tc_main(void)\n{\n  return "
+          << (main == -1 ? "0" : functions_[main].name + "()") << ";\n}\n";
+  }
+
+  /*---------------.
+  | The functions. |
+  `---------------*/
+
+  std::string Emitter::signature(const function& fun) const
+  {
+    std::string res = "static tc_word " + fun.name + '(';
+    const char* sep = "";
+    if (fun.parent != -1 && functions_[fun.parent].frame != -1)
+      {
+        res += "tc_word link";
+        sep = ", ";
+      }
+    for (const ast::VarDec* formal : fun.dec->formals_get())
+      {
+        res += sep + std::string("tc_word ") + variables_.at(formal).name;
+        sep = ", ";
+      }
+    if (!*sep)
+      res += "void";
+    return res + ')';
+  }
+
+  std::string Emitter::emit(int index)
+  {
+    const function& fun = functions_[index];
+    current_ = index;
+    body_.str("");
+    body_ << misc::resetindent << misc::incindent;
+
+    // The arguments holding pointers are roots.
+    roots_.clear();
+    bool linked = fun.parent != -1 && functions_[fun.parent].frame != -1;
+    if (linked)
+      roots_.emplace_back("link");
+    for (const ast::VarDec* formal : fun.dec->formals_get())
+      if (variables_.at(formal).pointer)
+        roots_.emplace_back(variables_.at(formal).name);
+    unsigned arguments = roots_.size();
+
+    if (!fun.escaping.empty())
+      {
+        roots_.emplace_back("fp");
+        statement() << "fp = (tc_word) tc_object(&map_frame_" << fun.name
+                    << ", sizeof (struct frame_" << fun.name << "));";
+        if (linked)
+          store(frame_get(index) + "->link", "link", true);
+        for (const ast::VarDec* formal : fun.dec->formals_get())
+          if (const variable& var = variables_.at(formal); var.escapes)
+            store(frame_get(index) + "->" + var.name, var.name, var.pointer);
+      }
+
+    std::string res = value(*fun.dec->body_get());
+    if (!roots_.empty())
+      statement() << "tc_roots_pop(&roots);";
+    statement() << "return " << res << ';';
+
+    // The roots are known once the body is translated.
+    std::ostringstream o;
+    o << signature(fun) << "\n{";
+    if (!roots_.empty())
+      {
+        for (unsigned i = arguments; i < roots_.size(); ++i)
+          o << "\n  tc_word " << roots_[i] << " = 0;";
+        o << "\n  tc_word* slots[] = {";
+        for (unsigned i = 0; i < roots_.size(); ++i)
+          o << (i ? ", &" : "&") << roots_[i];
+        o << "};\n  struct tc_roots roots = {0, " << roots_.size()
+          << ", slots};\n  tc_roots_push(&roots);";
+      }
+    o << body_.str() << "\n}\n";
+    current_ = -1;
+    return o.str();
+  }
+
+  /*-------------.
+  | Statements.  |
+  `-------------*/
+
+  std::ostream& Emitter::statement() { return body_ << misc::iendl; }
+
+  void Emitter::block_open()
+  {
+    statement() << '{';
+    body_ << misc::incindent;
+  }
+
+  void Emitter::block_close()
+  {
+    body_ << misc::decindent;
+    statement() << '}';
+  }
+
+  std::string Emitter::temp(const std::string& value, bool pointer)
+  {
+    std::string res = "tmp_" + std::to_string(names_++);
+    if (pointer)
+      {
+        roots_.emplace_back(res);
+        statement() << res << " = " << value << ';';
+      }
+    else
+      statement() << "tc_word " << res << " = " << value << ';';
+    return res;
+  }
+
+  void Emitter::store(const std::string& place, const std::string& value,
+                      bool barrier)
+  {
+    if (barrier)
+      statement() << "tc_store(&" << place << ", " << value << ");";
+    else
+      statement() << place << " = " << value << ';';
+  }
+
+  std::string Emitter::value(const ast::Exp& e)
+  {
+    e.accept(*this);
+    return std::move(result_);
+  }
+
+  std::string Emitter::value(const ast::Exp& e, bool later)
+  {
+    std::string res = value(e);
+    // Temporaries are never assigned again.
+    if (later && !literal_p(e) && res.compare(0, 4, "tmp_"))
+      res = temp(res, pointer_p(e));
+    return res;
+  }
+
+  void Emitter::discard(const ast::Exp& e)
+  {
+    // Keep the runtime checks.
+    std::string res = value(e);
+    if (res.find('(') != std::string::npos)
+      statement() << "(void) " << res << ';';
+  }
+
+  std::string Emitter::lvalue(const ast::Var& e, bool later)
+  {
+    // Keep the record or the array, not its address, which a
+    // collection may change.
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e))
+      return value(*var);
+    if (auto field = dynamic_cast<const ast::FieldVar*>(&e))
+      return field_get(*field, value(field->var_get(), later));
+    auto& subscript = dynamic_cast<const ast::SubscriptVar&>(e);
+    std::string array =
+      value(subscript.var_get(), later || !leaf_p(subscript.index_get()));
+    std::string index = value(subscript.index_get(), later);
+    return "*tc_element(" + array + ", " + index + ')';
+  }
+
+  /*--------.
+  | Types.  |
+  `--------*/
+
+  const type::Type& Emitter::type_of(const ast::Exp& e) const
+  {
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e))
+      return type_of(*var->def_get());
+    if (auto field = dynamic_cast<const ast::FieldVar*>(&e))
+      {
+        auto& record =
+          dynamic_cast<const type::Record&>(type_of(field->var_get()).actual());
+        return *record.field_type(field->name_get());
+      }
+    if (auto subscript = dynamic_cast<const ast::SubscriptVar*>(&e))
+      return dynamic_cast<const type::Array&>(
+               type_of(subscript->var_get()).actual())
+        .type_get();
+    if (auto call = dynamic_cast<const ast::CallExp*>(&e))
+      if (auto fun =
+            dynamic_cast<const type::Function*>(call->def_get()->type_get()))
+        return fun->result_get();
+    if (auto let = dynamic_cast<const ast::LetExp*>(&e))
+      return type_of(let->exp_get());
+    if (auto seq = dynamic_cast<const ast::SeqExp*>(&e))
+      if (!seq->exps_get().empty())
+        return type_of(*seq->exps_get().back());
+    if (auto test = dynamic_cast<const ast::IfExp*>(&e))
+      if (!dynamic_cast<const ast::NilExp*>(&test->get_thenclause()))
+        return type_of(test->get_thenclause());
+    precondition(e.type_get());
+    return *e.type_get();
+  }
+
+  const type::Type& Emitter::type_of(const ast::VarDec& e) const
+  {
+    if (e.type_name_get())
+      return *e.type_name_get()->type_get();
+    if (e.init_get())
+      return type_of(*e.init_get());
+    return *e.type_get();
+  }
+
+  bool Emitter::pointer_p(const type::Type& t)
+  {
+    const type::Type& actual = t.actual();
+    return dynamic_cast<const type::Record*>(&actual)
+      || dynamic_cast<const type::Array*>(&actual)
+      || dynamic_cast<const type::String*>(&actual);
+  }
+
+  bool Emitter::pointer_p(const ast::Exp& e) const
+  {
+    // The string literals are not in the heap.
+    return !literal_p(e) && pointer_p(type_of(e));
+  }
+
+  const std::string& Emitter::record_get(const type::Type& t)
+  {
+    auto& record = dynamic_cast<const type::Record&>(t.actual());
+    auto [i, inserted] = records_.try_emplace(&record);
+    if (inserted)
+      {
+        i->second = "record_" + std::to_string(records_.size() - 1);
+        std::string pointers;
+        for (const type::Field& field : record)
+          pointers += pointer_p(field.type_get()) ? 'p' : '.';
+        structures_ << "static const struct tc_map map_" << i->second
+                    << " = {TC_SLOTS, " << pointers.size() << ", \""
+                    << pointers << "\"};\n";
+      }
+    return i->second;
+  }
+
+  std::string Emitter::field_get(const ast::FieldVar& e,
+                                 const std::string& base) const
+  {
+    auto& record =
+      dynamic_cast<const type::Record&>(type_of(e.var_get()).actual());
+    return "tc_record(" + base + ")["
+      + std::to_string(record.field_index(e.name_get())) + "]";
+  }
+
+  /*--------.
+  | Names.  |
+  `--------*/
+
+  std::string Emitter::link_get(int owner) const
+  {
+    int frame = functions_[current_].frame;
+    std::string res = frame == current_ ? "fp" : "link";
+    for (; frame != owner; frame = functions_[functions_[frame].parent].frame)
+      res = "((struct frame_" + functions_[frame].name + "*) " + res
+        + ")->link";
+    return res;
+  }
+
+  std::string Emitter::frame_get(int owner) const
+  {
+    return "((struct frame_" + functions_[owner].name + "*) "
+      + link_get(owner) + ')';
+  }
+
+  std::string Emitter::name_make(const std::string& prefix, misc::symbol name)
+  {
+    return prefix + '_' + name.get() + '_' + std::to_string(names_++);
+  }
+
+  /*-------------------.
+  | Visiting methods.  |
+  `-------------------*/
+
+  void Emitter::operator()(const ast::ArrayExp& e)
+  {
+    std::string size = value(e.size_get(), !leaf_p(e.init_get()));
+    std::string init = value(e.init_get());
+    auto& array = dynamic_cast<const type::Array&>(type_of(e).actual());
+    result_ = temp("tc_array_make(" + size + ", " + init + ", "
+                     + (pointer_p(array.type_get()) ? '1' : '0') + ')',
+                   true);
+  }
+
+  void Emitter::operator()(const ast::AssignExp& e)
+  {
+    std::string place = lvalue(e.var_get(), !leaf_p(e.exp_get()));
+    std::string val = value(e.exp_get());
+    // The non escaping variables are not in the heap.
+    auto var = dynamic_cast<const ast::SimpleVar*>(&e.var_get());
+    bool heap = !var || variables_.at(var->def_get()).escapes;
+    store(place, val, heap && pointer_p(e.exp_get()));
+    result_ = "0";
+  }
+
+  void Emitter::operator()(const ast::BreakExp&)
+  {
+    statement() << "break;";
+    result_ = "0";
+  }
+
+  void Emitter::operator()(const ast::CallExp& e)
+  {
+    const ast::FunctionDec& def = *e.def_get();
+    std::string call;
+    const char* sep = "";
+    if (auto i = indices_.find(&def); i != indices_.end())
+      {
+        const function& callee = functions_[i->second];
+        call = callee.name + '(';
+        if (callee.parent != -1 && functions_[callee.parent].frame != -1)
+          {
+            call += link_get(functions_[callee.parent].frame);
+            sep = ", ";
+          }
+      }
+    else
+      call = "tc_" + def.name_get().get() + '(';
+
+    const ast::exps_type& args = e.args_get();
+    for (auto arg = args.begin(); arg != args.end(); ++arg)
+      {
+        call += sep + value(**arg, later_p(std::next(arg), args.end()));
+        sep = ", ";
+      }
+    call += ')';
+
+    if (def.result_get())
+      result_ = temp(call, pointer_p(e));
+    else
+      {
+        statement() << call << ';';
+        result_ = "0";
+      }
+  }
+
+  void Emitter::operator()(const ast::CastExp& e)
+  {
+    result_ = value(e.exp_get());
+  }
+
+  void Emitter::operator()(const ast::FieldVar& e)
+  {
+    result_ = field_get(e, value(e.var_get()));
+  }
+
+  void Emitter::operator()(const ast::ForExp& e)
+  {
+    /* Translate
+
+         for i := lo to hi do body
+
+       as
+
+         i = lo;
+         hi_ = hi;
+         if (i <= hi_)
+           for (;;)
+             {
+               body
+               if (i == hi_)
+                 break;
+               ++i;
+             }
+
+       so that i does not overflow when hi is the largest integer.  */
+    const ast::VarDec& var = e.vardec_get();
+    const variable& index = variables_.at(&var);
+    std::string lo = value(*var.init_get());
+    std::string i = index.name;
+    if (index.escapes)
+      i = "tmp_" + std::to_string(names_++);
+    statement() << "tc_word " << i << " = " << lo << ';';
+    std::string hi = temp(value(e.hi_get()), false);
+    statement() << "if (" << i << " <= " << hi << ')';
+    block_open();
+    statement() << "for (;;)";
+    block_open();
+    if (index.escapes)
+      store(frame_get(current_) + "->" + index.name, i, false);
+    discard(e.body_get());
+    statement() << "if (" << i << " == " << hi << ')';
+    body_ << misc::incindent;
+    statement() << "break;";
+    body_ << misc::decindent;
+    statement() << "++" << i << ';';
+    block_close();
+    block_close();
+    result_ = "0";
+  }
+
+  void Emitter::operator()(const ast::FunctionChunk&)
+  {
+    // The functions are translated on their own.
+  }
+
+  void Emitter::operator()(const ast::IfExp& e)
+  {
+    std::string test = value(e.get_test());
+    bool valued = &e.get_elseclause()
+      && !dynamic_cast<const type::Void*>(&type_of(e).actual());
+    std::string res = valued ? temp("0", pointer_p(type_of(e))) : "0";
+    statement() << "if (" << test << ')';
+    block_open();
+    if (valued)
+      {
+        std::string then = value(e.get_thenclause());
+        statement() << res << " = " << then << ';';
+      }
+    else
+      discard(e.get_thenclause());
+    block_close();
+    if (&e.get_elseclause())
+      {
+        statement() << "else";
+        block_open();
+        if (valued)
+          {
+            std::string otherwise = value(e.get_elseclause());
+            statement() << res << " = " << otherwise << ';';
+          }
+        else
+          discard(e.get_elseclause());
+        block_close();
+      }
+    result_ = res;
+  }
+
+  void Emitter::operator()(const ast::IntExp& e)
+  {
+    int i = e.value_get();
+    if (i == INT_MIN)
+      result_ = "(-2147483647 - 1)";
+    else if (i < 0)
+      result_ = '(' + std::to_string(i) + ')';
+    else
+      result_ = std::to_string(i);
+  }
+
+  void Emitter::operator()(const ast::LetExp& e)
+  {
+    // The variables are C locals of the function: their names are
+    // unique.  Not operator()(const ast::ChunkList&), which translates a
+    // program.
+    super_type::operator()(e.chunklist_get());
+    result_ = value(e.exp_get());
+  }
+
+  void Emitter::operator()(const ast::NilExp&) { result_ = "0"; }
+
+  void Emitter::operator()(const ast::OpExp& e)
+  {
+    using Oper = ast::OpExp::Oper;
+    std::string left = value(e.left_get(), !leaf_p(e.right_get()));
+    std::string right = value(e.right_get());
+    switch (e.oper_get())
+      {
+      case Oper::add:
+        result_ = "TC_ADD(" + left + ", " + right + ')';
+        break;
+      case Oper::sub:
+        result_ = "TC_SUB(" + left + ", " + right + ')';
+        break;
+      case Oper::mul:
+        result_ = "TC_MUL(" + left + ", " + right + ')';
+        break;
+      case Oper::div:
+        result_ = "tc_div(" + left + ", " + right + ')';
+        break;
+      default:
+        {
+          std::string oper = comparison_get(e.oper_get());
+          auto string_p = [this](const ast::Exp& exp) {
+            return !dynamic_cast<const ast::NilExp*>(&exp)
+              && dynamic_cast<const type::String*>(&type_of(exp).actual());
+          };
+          if (string_p(e.left_get()) || string_p(e.right_get()))
+            result_ =
+              "(tc_string_order(" + left + ", " + right + ") " + oper + " 0)";
+          else
+            result_ = '(' + left + ' ' + oper + ' ' + right + ')';
+        }
+      }
+  }
+
+  void Emitter::operator()(const ast::RecordExp& e)
+  {
+    const std::string& record = record_get(*e.def_get()->type_get());
+    const ast::fieldinits_type& fields = e.get_fields();
+    std::vector<std::string> values;
+    for (unsigned i = 0; i < fields.size(); ++i)
+      {
+        bool later = false;
+        for (unsigned j = i + 1; j < fields.size(); ++j)
+          later = later || !leaf_p(fields[j]->init_get());
+        values.emplace_back(value(fields[i]->init_get(), later));
+      }
+    auto& record_type = dynamic_cast<const type::Record&>(
+      e.def_get()->type_get()->actual());
+    std::string res =
+      temp("(tc_word) tc_object(&map_" + record + ", "
+             + std::to_string(record_type.fields_get().size())
+             + " * sizeof (tc_word))",
+           true);
+    for (unsigned i = 0; i < fields.size(); ++i)
+      {
+        int index = record_type.field_index(fields[i]->name_get());
+        store("((tc_word*) " + res + ")[" + std::to_string(index) + "]",
+              values[i], pointer_p(fields[i]->init_get()));
+      }
+    result_ = res;
+  }
+
+  void Emitter::operator()(const ast::SeqExp& e)
+  {
+    const ast::exps_type& exps = e.exps_get();
+    result_ = "0";
+    for (unsigned i = 0; i < exps.size(); ++i)
+      if (i + 1 < exps.size())
+        discard(*exps[i]);
+      else
+        result_ = value(*exps[i]);
+  }
+
+  void Emitter::operator()(const ast::SimpleVar& e)
+  {
+    const variable& var = variables_.at(e.def_get());
+    if (var.escapes)
+      result_ = frame_get(var.function) + "->" + var.name;
+    else
+      result_ = var.name;
+  }
+
+  void Emitter::operator()(const ast::StringExp& e)
+  {
+    std::string str = misc::unescape(e.string_get());
+    auto [i, inserted] = literals_.try_emplace(str);
+    if (inserted)
+      {
+        i->second = "string_" + std::to_string(names_++);
+        strings_ << "static struct tc_string " << i->second << " = {"
+                 << str.size() << ", \"" << c_escape(str) << "\"};\n";
+      }
+    result_ = "(tc_word) &" + i->second;
+  }
+
+  void Emitter::operator()(const ast::SubscriptVar& e)
+  {
+    std::string array = value(e.var_get(), !leaf_p(e.index_get()));
+    std::string index = value(e.index_get());
+    result_ = "*tc_element(" + array + ", " + index + ')';
+  }
+
+  void Emitter::operator()(const ast::TypeChunk&)
+  {
+    // The record types are defined when used.
+  }
+
+  void Emitter::operator()(const ast::VarChunk& e)
+  {
+    for (const ast::VarDec* dec : e)
+      {
+        const variable& var = variables_.at(dec);
+        std::string init = value(*dec->init_get());
+        if (var.escapes)
+          store(frame_get(current_) + "->" + var.name, init,
+                pointer_p(*dec->init_get()));
+        else if (var.pointer)
+          {
+            roots_.emplace_back(var.name);
+            statement() << var.name << " = " << init << ';';
+          }
+        else
+          statement() << "tc_word " << var.name << " = " << init << ';';
+      }
+  }
+
+  void Emitter::operator()(const ast::WhileExp& e)
+  {
+    statement() << "for (;;)";
+    block_open();
+    std::string test = value(e.test_get());
+    statement() << "if (!" << test << ')';
+    body_ << misc::incindent;
+    statement() << "break;";
+    body_ << misc::decindent;
+    discard(e.body_get());
+    block_close();
+    result_ = "0";
+  }
+
+} // namespace cemit
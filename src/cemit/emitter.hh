@@ -0,0 +1,181 @@
+/**
+ ** \file cemit/emitter.hh
+ ** \brief Translate an AST into C.
+ */
+
+#pragma once
+
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <interpret/layout.hh>
+#include <misc/symbol.hh>
+#include <type/fwd.hh>
+
+namespace cemit
+{
+  /** \brief Translate a program into C99.
+
+      Every Tiger value is a `tc_word' of the runtime (see runtime.c).
+      Each function with a body becomes a C function.  Its non escaping
+      variables are C locals; its escaping variables live in a frame
+      allocated on the heap (see interpret::layout), which the nested
+      functions receive.  The records are vectors of `tc_word', whose
+      fields are accessed by index, and the arrays are runtime arrays.
+      No heap object is accessed through a C structure, so the compact
+      objects (see object::DesugarVisitor), whose record is read
+      through the record of a super class, respect strict aliasing.
+
+      The heap is garbage collected: the types give the map of the
+      pointers in the records and in the frames, and the locals holding
+      pointers are registered as roots of the function.  The pointers
+      are stored into the heap through the write barrier.
+
+      Each Tiger expression is translated into C statements, followed by
+      a C expression without side effects for its value.  The `for'
+      loops and the string comparisons are translated too, hence the
+      desugaring is not needed.  */
+  class Emitter
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    /// Super class type.
+    using super_type = ast::DefaultConstVisitor;
+    /// Import all the overloaded visit methods.
+    using super_type::operator();
+
+    /// Emit on \a ostr.
+    explicit Emitter(std::ostream& ostr);
+
+    /// Translate the program \a e, whose bindings, types and escapes
+    /// are computed.
+    void operator()(const ast::ChunkList& e) override;
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::BreakExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::CastExp& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::ForExp& e) override;
+    void operator()(const ast::FunctionChunk& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::IntExp& e) override;
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::NilExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::RecordExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::StringExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::TypeChunk& e) override;
+    void operator()(const ast::VarChunk& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+    /// What is known of a function with a body.
+    struct function : interpret::layout::function
+    {
+      /// Its C name.
+      std::string name;
+    };
+
+    /// What is known of a variable.
+    struct variable : interpret::layout::slot
+    {
+      /// Whether it holds pointers.
+      bool pointer = false;
+      /// Its C name.
+      std::string name;
+    };
+
+  private:
+    /// The C definition of the function \a index.
+    std::string emit(int index);
+    /// The C prototype of \a fun.
+    std::string signature(const function& fun) const;
+
+    /// Start a new statement.
+    std::ostream& statement();
+    /// Open a block.
+    void block_open();
+    /// Close a block.
+    void block_close();
+    /// A fresh temporary holding \a value, a root if a \a pointer.
+    std::string temp(const std::string& value, bool pointer);
+    /// Store \a value into \a place, through the write barrier if
+    /// \a barrier.
+    void store(const std::string& place, const std::string& value,
+               bool barrier);
+
+    /// Translate \a e, and return its value.
+    std::string value(const ast::Exp& e);
+    /// Translate \a e, whose value is not used.
+    void discard(const ast::Exp& e);
+    /// Translate \a e, and return its value, saved in a temporary if
+    /// the translation of \a later expressions may change it.
+    std::string value(const ast::Exp& e, bool later);
+    /// The C lvalue for \a e, whose components are saved if \a later
+    /// expressions may change them.
+    std::string lvalue(const ast::Var& e, bool later);
+
+    /// The type of \a e, in spite of the types the checker leaves on
+    /// the variables.
+    const type::Type& type_of(const ast::Exp& e) const;
+    /// The type of the variable \a e.
+    const type::Type& type_of(const ast::VarDec& e) const;
+    /// Whether the values of type \a t are pointers.
+    static bool pointer_p(const type::Type& t);
+    /// Whether the value of \a e may be a pointer to the heap.
+    bool pointer_p(const ast::Exp& e) const;
+    /// The name of the map of the record type \a t.
+    const std::string& record_get(const type::Type& t);
+    /// The C lvalue of the field \a e, whose record is \a base.
+    std::string field_get(const ast::FieldVar& e,
+                          const std::string& base) const;
+
+    /// The C expression of the frame of the function \a owner, as a
+    /// `tc_word'.
+    std::string link_get(int owner) const;
+    /// The C expression of the frame of the function \a owner.
+    std::string frame_get(int owner) const;
+    /// A C identifier for \a name, unique to this translation.
+    std::string name_make(const std::string& prefix, misc::symbol name);
+
+    /// The output.
+    std::ostream& ostr_;
+
+    /// The functions with a body.
+    std::vector<function> functions_;
+    std::unordered_map<const ast::FunctionDec*, int> indices_;
+    /// The variables.
+    std::unordered_map<const ast::VarDec*, variable> variables_;
+    /// The record types, and the name of their map.
+    std::map<const type::Record*, std::string> records_;
+    /// The definitions of the maps and structures, and of the string
+    /// literals.
+    std::ostringstream structures_;
+    std::ostringstream strings_;
+    std::unordered_map<std::string, std::string> literals_;
+    /// The number of C identifiers made.
+    unsigned names_ = 0;
+
+    /// The body of the function being translated, and its index.
+    std::ostringstream body_;
+    int current_ = -1;
+    /// Its roots.
+    std::vector<std::string> roots_;
+    /// The value of the last visited expression.
+    std::string result_;
+  };
+
+} // namespace cemit
@@ -0,0 +1,17 @@
+/**
+ ** \file cemit/libcemit.cc
+ ** \brief Define exported cemit functions.
+ */
+
+#include <cemit/emitter.hh>
+#include <cemit/libcemit.hh>
+
+namespace cemit
+{
+  void c_emit(const ast::ChunkList& tree, std::ostream& ostr)
+  {
+    Emitter emit(ostr);
+    emit(tree);
+  }
+
+} // namespace cemit
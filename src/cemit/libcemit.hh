@@ -0,0 +1,23 @@
+/**
+ ** \file cemit/libcemit.hh
+ ** \brief Declare functions and variables exported by cemit module.
+ */
+
+#pragma once
+
+#include <iosfwd>
+
+#include <ast/fwd.hh>
+
+/// Translating a program into C.
+namespace cemit
+{
+  /** \brief Translate the program \a tree into C99 on \a ostr.
+
+      \param tree  the program, whose bindings, types and escapes have
+                   been computed.
+      \param ostr  where to write a self-contained C translation unit,
+                   runtime included.  */
+  void c_emit(const ast::ChunkList& tree, std::ostream& ostr);
+
+} // namespace cemit
@@ -0,0 +1,861 @@
+/*
+** The runtime of the Tiger programs compiled into C.
+**
+** Every Tiger value is a tc_word: an integer, or the address of a
+** string, a record or an array (nil is 0).  The integers are on 32
+** bits, and wrap around on overflow.
+**
+** The heap has two generations.  The objects are allocated by bumping
+** a pointer in the nursery; when it is full, its live objects are
+** copied into the old generation, which is compacted when it fills up
+** in turn.  The collection is precise: the compiler generates the map
+** of the slots holding pointers of each type of objects, and each
+** function registers its variables holding pointers on a shadow
+** stack.  The stores of pointers into the objects go through
+** tc_store, which remembers the old objects pointing to young ones.
+**
+** The strings built by concatenation are ropes: tc_concat allocates a
+** node pointing to its two operands, and the characters are copied
+** once, when they are needed contiguously (print, ord, substring,
+** comparisons).  Repeated concatenation thus costs linear time.
+**
+** With TC_GC_STATS set in the environment, the allocations and the
+** pause times are reported on exit.  TC_GC_NURSERY is the size of the
+** nursery, in bytes.
+**
+** The program defines tc_main, which runs `_main'.
+*/
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef intptr_t tc_word;
+typedef int32_t tc_int;
+
+/* A string: its characters are not NUL terminated.  */
+struct tc_string
+{
+  tc_int size;
+  /* Null for a rope.  */
+  const char* data;
+};
+
+/* A concatenation.  Once flattened, LEFT is the flat string and RIGHT
+   is nil.  */
+struct tc_rope
+{
+  struct tc_string string;
+  tc_word left;
+  tc_word right;
+};
+
+/* An array.  */
+struct tc_array
+{
+  tc_int size;
+  tc_word elements[];
+};
+
+tc_word tc_main(void);
+
+/*-----------------.
+| Runtime errors.  |
+`-----------------*/
+
+void tc_error(const char* message)
+{
+  fflush(stdout);
+  fprintf(stderr, "%s\n", message);
+  exit(120);
+}
+
+/*-------------------.
+| The heap objects.  |
+`-------------------*/
+
+/* The kinds of objects.  */
+enum tc_kind
+{
+  /* tc_word slots: the records and the frames.  */
+  TC_SLOTS,
+  /* A struct tc_array.  */
+  TC_ARRAY,
+  /* A struct tc_string, followed by its characters.  */
+  TC_STRING,
+  /* A struct tc_rope.  */
+  TC_ROPE
+};
+
+/* The layout of the objects of a type, generated by the compiler.  */
+struct tc_map
+{
+  enum tc_kind kind;
+  /* The number of slots of the TC_SLOTS objects.  */
+  tc_int size;
+  /* 'p' for each slot holding a pointer, '.' for the others.  For the
+     arrays, whether their elements are pointers.  */
+  const char* pointers;
+};
+
+/* The header preceding each object.  */
+struct tc_header
+{
+  const struct tc_map* map;
+  /* The size of the object, header included.  */
+  size_t size;
+  /* Where the object is moved to during a collection.  */
+  struct tc_header* forward;
+  size_t marked;
+};
+
+static const struct tc_map tc_string_map = {TC_STRING, 0, ""};
+static const struct tc_map tc_rope_map = {TC_ROPE, 0, ""};
+static const struct tc_map tc_array_maps[2] = {
+  {TC_ARRAY, 0, "."},
+  {TC_ARRAY, 0, "p"},
+};
+
+static struct tc_header* tc_header(tc_word p)
+{
+  return (struct tc_header*) p - 1;
+}
+
+/*---------------.
+| Shadow stack.  |
+`---------------*/
+
+/* The variables of a running function that hold pointers.  */
+struct tc_roots
+{
+  struct tc_roots* prev;
+  size_t size;
+  tc_word** slots;
+};
+
+/* The roots of the innermost running function.  */
+static struct tc_roots* tc_roots_top;
+
+void tc_roots_push(struct tc_roots* roots)
+{
+  roots->prev = tc_roots_top;
+  tc_roots_top = roots;
+}
+
+void tc_roots_pop(struct tc_roots* roots)
+{
+  tc_roots_top = roots->prev;
+}
+
+/*------------------.
+| The generations.  |
+`------------------*/
+
+/* A contiguous region, allocated from START to NEXT.  */
+struct tc_space
+{
+  char* start;
+  char* next;
+  char* end;
+};
+
+/* The young objects, and those which survived a collection.  */
+static struct tc_space tc_nursery;
+static struct tc_space tc_old;
+
+/* A growable array of pointers.  */
+struct tc_stack
+{
+  void** data;
+  size_t size;
+  size_t capacity;
+};
+
+/* The slots of the old objects into which young pointers were stored,
+   and the objects to scan while marking.  */
+static struct tc_stack tc_remembered;
+static struct tc_stack tc_marks;
+
+/* What the collector reports.  */
+static struct
+{
+  unsigned long allocated;
+  unsigned long objects;
+  unsigned long promoted;
+  unsigned long minors;
+  unsigned long majors;
+  clock_t start;
+  clock_t pause;
+  clock_t pause_max;
+} tc_stats;
+
+static void* tc_malloc(size_t size)
+{
+  void* res = malloc(size);
+  if (!res)
+    tc_error("out of memory");
+  return res;
+}
+
+static void tc_stack_push(struct tc_stack* stack, void* p)
+{
+  if (stack->size == stack->capacity)
+    {
+      void** data;
+      stack->capacity = stack->capacity ? 2 * stack->capacity : 256;
+      data = realloc(stack->data, stack->capacity * sizeof *data);
+      if (!data)
+        tc_error("out of memory");
+      stack->data = data;
+    }
+  stack->data[stack->size++] = p;
+}
+
+static void tc_space_init(struct tc_space* space, size_t size)
+{
+  space->start = tc_malloc(size);
+  space->next = space->start;
+  space->end = space->start + size;
+}
+
+static size_t tc_space_free(const struct tc_space* space)
+{
+  return space->end - space->next;
+}
+
+static int tc_space_has(const struct tc_space* space, tc_word p)
+{
+  return (uintptr_t) space->start <= (uintptr_t) p
+    && (uintptr_t) p < (uintptr_t) space->next;
+}
+
+static size_t tc_nursery_size(void)
+{
+  return tc_nursery.end - tc_nursery.start;
+}
+
+/* Whether P points to a young object.  */
+static int tc_young(tc_word p)
+{
+  return tc_space_has(&tc_nursery, p);
+}
+
+/* Whether an object of SIZE bytes is allocated in the old generation
+   directly, not to be copied.  */
+static int tc_large(size_t size)
+{
+  return tc_nursery_size() / 4 < size;
+}
+
+/* Call VISIT on the slots of H holding pointers.  */
+static void tc_scan(struct tc_header* h, void (*visit)(tc_word*))
+{
+  const struct tc_map* map = h->map;
+  tc_int i;
+  if (map->kind == TC_SLOTS)
+    {
+      tc_word* slots = (tc_word*) (h + 1);
+      for (i = 0; i < map->size; ++i)
+        if (map->pointers[i] == 'p')
+          visit(&slots[i]);
+    }
+  else if (map->kind == TC_ARRAY && map->pointers[0] == 'p')
+    {
+      struct tc_array* array = (struct tc_array*) (h + 1);
+      for (i = 0; i < array->size; ++i)
+        visit(&array->elements[i]);
+    }
+  else if (map->kind == TC_ROPE)
+    {
+      struct tc_rope* rope = (struct tc_rope*) (h + 1);
+      visit(&rope->left);
+      visit(&rope->right);
+    }
+}
+
+/* Call VISIT on the roots.  */
+static void tc_roots_scan(void (*visit)(tc_word*))
+{
+  struct tc_roots* roots;
+  size_t i;
+  for (roots = tc_roots_top; roots; roots = roots->prev)
+    for (i = 0; i < roots->size; ++i)
+      visit(roots->slots[i]);
+}
+
+/* FROM was moved to TO: the characters of a string move with it.  */
+static void tc_moved(struct tc_header* from, struct tc_header* to)
+{
+  if (to->map->kind == TC_STRING)
+    {
+      struct tc_string* s = (struct tc_string*) (to + 1);
+      if (s->data == (const char*) ((struct tc_string*) (from + 1) + 1))
+        s->data = (const char*) (s + 1);
+    }
+}
+
+/*----------------------------------------.
+| Minor collection: copy the live young.  |
+`----------------------------------------*/
+
+/* Promote the young object *SLOT points to, if not already done.  */
+static void tc_promote(tc_word* slot)
+{
+  struct tc_header* h;
+  if (!tc_young(*slot))
+    return;
+  h = tc_header(*slot);
+  if (!h->forward)
+    {
+      struct tc_header* to = (struct tc_header*) tc_old.next;
+      memcpy(to, h, h->size);
+      tc_old.next += h->size;
+      tc_moved(h, to);
+      h->forward = to;
+    }
+  *slot = (tc_word) (h->forward + 1);
+}
+
+static void tc_minor(void)
+{
+  char* promoted = tc_old.next;
+  char* scan = promoted;
+  size_t i;
+  tc_roots_scan(tc_promote);
+  for (i = 0; i < tc_remembered.size; ++i)
+    tc_promote(tc_remembered.data[i]);
+  tc_remembered.size = 0;
+  /* The promoted objects are scanned in turn (Cheney).  */
+  while (scan < tc_old.next)
+    {
+      struct tc_header* h = (struct tc_header*) scan;
+      tc_scan(h, tc_promote);
+      scan += h->size;
+    }
+  tc_stats.promoted += tc_old.next - promoted;
+  tc_nursery.next = tc_nursery.start;
+  ++tc_stats.minors;
+}
+
+/*----------------------------------------------.
+| Major collection: mark-compact the old ones.  |
+`----------------------------------------------*/
+
+/* The size of the marked objects.  */
+static size_t tc_live;
+
+static void tc_mark(tc_word* slot)
+{
+  struct tc_header* h;
+  if (!tc_space_has(&tc_old, *slot))
+    return;
+  h = tc_header(*slot);
+  if (!h->marked)
+    {
+      h->marked = 1;
+      tc_live += h->size;
+      tc_stack_push(&tc_marks, h);
+    }
+}
+
+static void tc_update(tc_word* slot)
+{
+  if (tc_space_has(&tc_old, *slot))
+    *slot = (tc_word) (tc_header(*slot)->forward + 1);
+}
+
+/* Compact the old generation, with the nursery empty, so that it has
+   NEEDED bytes free on top of room for the next minor collection.  */
+static void tc_major(size_t needed)
+{
+  size_t capacity = tc_old.end - tc_old.start;
+  char* to = tc_old.start;
+  char* next;
+  char* p;
+
+  tc_live = 0;
+  tc_roots_scan(tc_mark);
+  while (tc_marks.size)
+    tc_scan(tc_marks.data[--tc_marks.size], tc_mark);
+
+  /* Keep the live objects below half of the generation.  */
+  if (capacity < 2 * (tc_live + needed + tc_nursery_size()))
+    {
+      while (capacity < 2 * (tc_live + needed + tc_nursery_size()))
+        capacity *= 2;
+      to = tc_malloc(capacity);
+    }
+
+  /* Compute the new addresses, in order.  */
+  next = to;
+  for (p = tc_old.start; p < tc_old.next; p += ((struct tc_header*) p)->size)
+    {
+      struct tc_header* h = (struct tc_header*) p;
+      if (h->marked)
+        {
+          h->forward = (struct tc_header*) next;
+          next += h->size;
+        }
+    }
+
+  /* Update the pointers to the live objects.  */
+  tc_roots_scan(tc_update);
+  for (p = tc_old.start; p < tc_old.next; p += ((struct tc_header*) p)->size)
+    if (((struct tc_header*) p)->marked)
+      tc_scan((struct tc_header*) p, tc_update);
+
+  /* Slide them.  */
+  p = tc_old.start;
+  while (p < tc_old.next)
+    {
+      struct tc_header* h = (struct tc_header*) p;
+      size_t size = h->size;
+      if (h->marked)
+        {
+          struct tc_header* dest = h->forward;
+          memmove(dest, h, size);
+          dest->forward = 0;
+          dest->marked = 0;
+          tc_moved(h, dest);
+        }
+      p += size;
+    }
+
+  if (to != tc_old.start)
+    {
+      free(tc_old.start);
+      tc_old.start = to;
+      tc_old.end = to + capacity;
+    }
+  tc_old.next = next;
+  ++tc_stats.majors;
+}
+
+/* Collect the nursery, and the old generation if it has less than
+   NEEDED bytes free on top of room for the next minor collection.  */
+static void tc_collect(size_t needed)
+{
+  clock_t start = clock();
+  clock_t pause;
+  tc_minor();
+  if (tc_space_free(&tc_old) < needed + tc_nursery_size())
+    tc_major(needed);
+  pause = clock() - start;
+  tc_stats.pause += pause;
+  if (tc_stats.pause_max < pause)
+    tc_stats.pause_max = pause;
+}
+
+/*-------------.
+| Allocation.  |
+`-------------*/
+
+/* A zeroed object of BYTES bytes, laid out as MAP says.  */
+void* tc_object(const struct tc_map* map, size_t bytes)
+{
+  size_t size = sizeof (struct tc_header)
+    + (bytes + sizeof (tc_word) - 1) / sizeof (tc_word) * sizeof (tc_word);
+  struct tc_header* res;
+  if (tc_large(size))
+    {
+      if (tc_space_free(&tc_old) < size + tc_nursery_size())
+        tc_collect(size);
+      res = (struct tc_header*) tc_old.next;
+      tc_old.next += size;
+    }
+  else
+    {
+      if (tc_space_free(&tc_nursery) < size)
+        tc_collect(0);
+      res = (struct tc_header*) tc_nursery.next;
+      tc_nursery.next += size;
+    }
+  memset(res, 0, size);
+  res->map = map;
+  res->size = size;
+  tc_stats.allocated += size;
+  ++tc_stats.objects;
+  return res + 1;
+}
+
+/* Store VALUE into SLOT, which is in an object: remember the old
+   objects pointing to young ones.  */
+void tc_store(tc_word* slot, tc_word value)
+{
+  *slot = value;
+  if (tc_young(value) && !tc_young((tc_word) slot))
+    tc_stack_push(&tc_remembered, slot);
+}
+
+static void tc_gc_report(void)
+{
+  double pause = (double) tc_stats.pause / CLOCKS_PER_SEC;
+  double mutator = (double) (clock() - tc_stats.start) / CLOCKS_PER_SEC
+    - pause;
+  fprintf(stderr,
+          "/* GC statistics.  */\n"
+          "allocated:          %lu bytes, %lu objects\n"
+          "allocation rate:    %.1f MB/s\n"
+          "minor collections:  %lu, %lu bytes promoted\n"
+          "major collections:  %lu\n"
+          "pause time:         %.3f ms, %.3f ms at most\n"
+          "old generation:     %lu bytes, %lu used\n",
+          tc_stats.allocated, tc_stats.objects,
+          0 < mutator ? tc_stats.allocated / mutator / 1e6 : 0.0,
+          tc_stats.minors, tc_stats.promoted, tc_stats.majors,
+          pause * 1e3,
+          (double) tc_stats.pause_max / CLOCKS_PER_SEC * 1e3,
+          (unsigned long) (tc_old.end - tc_old.start),
+          (unsigned long) (tc_old.next - tc_old.start));
+}
+
+static void tc_gc_init(void)
+{
+  const char* nursery = getenv("TC_GC_NURSERY");
+  size_t size = 1 << 20;
+  if (nursery && 0 < atol(nursery))
+    size = atol(nursery);
+  if (size < 1024)
+    size = 1024;
+  tc_space_init(&tc_nursery, size);
+  tc_space_init(&tc_old, 4 * size);
+  tc_stats.start = clock();
+  if (getenv("TC_GC_STATS"))
+    atexit(tc_gc_report);
+}
+
+/*------------------.
+| Records, arrays.  |
+`------------------*/
+
+/* The slots of the record P, which must not be nil.  The fields are
+   accessed as tc_word, never through a structure: the record of a
+   class is read through the type of its super classes.  */
+tc_word* tc_record(tc_word p)
+{
+  if (!p)
+    tc_error("nil record dereference");
+  return (tc_word*) p;
+}
+
+/* An array of SIZE times INIT, which is a pointer if POINTERS.  */
+tc_word tc_array_make(tc_word size, tc_word init, int pointers)
+{
+  tc_word* slots[1];
+  struct tc_roots roots;
+  struct tc_array* res;
+  size_t bytes;
+  tc_int i;
+  if (size < 0)
+    tc_error("negative array size");
+  bytes = sizeof *res + size * sizeof (tc_word);
+  slots[0] = &init;
+  roots.size = 1;
+  roots.slots = slots;
+  tc_roots_push(&roots);
+  /* A large array is old: so must be its elements.  */
+  if (pointers && tc_young(init) && tc_large(bytes))
+    tc_collect(0);
+  res = tc_object(&tc_array_maps[pointers != 0], bytes);
+  tc_roots_pop(&roots);
+  res->size = size;
+  for (i = 0; i < size; ++i)
+    res->elements[i] = init;
+  return (tc_word) res;
+}
+
+/* The element INDEX of the array A.  */
+tc_word* tc_element(tc_word a, tc_word index)
+{
+  struct tc_array* array = (struct tc_array*) a;
+  if (!array)
+    tc_error("nil array dereference");
+  if (index < 0 || array->size <= index)
+    tc_error("index out of bounds");
+  return &array->elements[index];
+}
+
+/*-----------.
+| Integers.  |
+`-----------*/
+
+#define TC_ADD(A, B) ((tc_word) (tc_int) ((uint32_t) (A) + (uint32_t) (B)))
+#define TC_SUB(A, B) ((tc_word) (tc_int) ((uint32_t) (A) - (uint32_t) (B)))
+#define TC_MUL(A, B) ((tc_word) (tc_int) ((uint32_t) (A) * (uint32_t) (B)))
+
+tc_word tc_div(tc_word a, tc_word b)
+{
+  if (!b)
+    tc_error("division by zero");
+  if (a == INT32_MIN && b == -1)
+    return INT32_MIN;
+  return a / b;
+}
+
+/*----------.
+| Strings.  |
+`----------*/
+
+/* The strings of one character.  */
+static struct tc_string tc_chars[256];
+static char tc_chars_data[256];
+static struct tc_string tc_empty = {0, ""};
+
+static void tc_strings_init(void)
+{
+  int c;
+  for (c = 0; c < 256; ++c)
+    {
+      tc_chars_data[c] = (char) c;
+      tc_chars[c].size = 1;
+      tc_chars[c].data = &tc_chars_data[c];
+    }
+}
+
+static struct tc_string* tc_string(tc_word s)
+{
+  return (struct tc_string*) s;
+}
+
+/* A string of SIZE characters, to be filled in.  The collection it
+   may trigger updates *A, and *B unless null.  */
+static struct tc_string* tc_string_alloc(tc_int size, tc_word* a, tc_word* b)
+{
+  tc_word* slots[2];
+  struct tc_roots roots;
+  struct tc_string* res;
+  slots[0] = a;
+  slots[1] = b;
+  roots.size = b ? 2 : 1;
+  roots.slots = slots;
+  tc_roots_push(&roots);
+  res = tc_object(&tc_string_map, sizeof *res + size);
+  tc_roots_pop(&roots);
+  res->size = size;
+  res->data = (const char*) (res + 1);
+  return res;
+}
+
+/* The concatenations shorter than this are copied: a rope node is not
+   worth it.  */
+#define TC_ROPE_MIN ((tc_int) (2 * sizeof (struct tc_rope)))
+
+/* Copy the characters of *S, if it is a rope not flattened yet.  The
+   collection it may trigger updates *S, and *KEEP unless null.  */
+static void tc_flatten(tc_word* s, tc_word* keep)
+{
+  struct tc_rope* rope = (struct tc_rope*) *s;
+  struct tc_stack todo = {0, 0, 0};
+  struct tc_string* res;
+  char* chars;
+  if (rope->string.data || !rope->right)
+    return;
+  res = tc_string_alloc(rope->string.size, s, keep);
+  rope = (struct tc_rope*) *s;
+  /* Copy the leaves from left to right.  The ropes built in a loop are
+     as deep as long: no recursion.  */
+  chars = (char*) (res + 1);
+  tc_stack_push(&todo, (void*) rope->right);
+  tc_stack_push(&todo, (void*) rope->left);
+  while (todo.size)
+    {
+      struct tc_rope* node = todo.data[--todo.size];
+      if (!node->string.data && node->right)
+        {
+          tc_stack_push(&todo, (void*) node->right);
+          tc_stack_push(&todo, (void*) node->left);
+        }
+      else
+        {
+          struct tc_string* leaf = node->string.data
+            ? &node->string : tc_string(node->left);
+          memcpy(chars, leaf->data, leaf->size);
+          chars += leaf->size;
+        }
+    }
+  free(todo.data);
+  /* Let go of the operands.  */
+  tc_store(&rope->left, (tc_word) res);
+  rope->right = 0;
+}
+
+/* The characters of S, which is flat or flattened.  */
+static struct tc_string* tc_flat(tc_word s)
+{
+  struct tc_string* res = tc_string(s);
+  if (res->data)
+    return res;
+  return tc_string(((struct tc_rope*) s)->left);
+}
+
+/* -1, 0 or 1 as A is before, equal to, or after B.  */
+tc_word tc_string_order(tc_word a, tc_word b)
+{
+  struct tc_string* l;
+  struct tc_string* r;
+  tc_int size;
+  int cmp;
+  /* The literals are shared.  */
+  if (a == b)
+    return 0;
+  tc_flatten(&a, &b);
+  tc_flatten(&b, &a);
+  l = tc_flat(a);
+  r = tc_flat(b);
+  size = l->size < r->size ? l->size : r->size;
+  cmp = memcmp(l->data, r->data, size);
+  if (!cmp)
+    cmp = (l->size > r->size) - (l->size < r->size);
+  return (0 < cmp) - (cmp < 0);
+}
+
+/*-------------.
+| Primitives.  |
+`-------------*/
+
+tc_word tc_print(tc_word s)
+{
+  tc_flatten(&s, 0);
+  fwrite(tc_flat(s)->data, 1, tc_flat(s)->size, stdout);
+  return 0;
+}
+
+tc_word tc_print_err(tc_word s)
+{
+  fflush(stdout);
+  tc_flatten(&s, 0);
+  fwrite(tc_flat(s)->data, 1, tc_flat(s)->size, stderr);
+  return 0;
+}
+
+tc_word tc_print_int(tc_word i)
+{
+  printf("%ld", (long) i);
+  return 0;
+}
+
+tc_word tc_flush(void)
+{
+  fflush(stdout);
+  return 0;
+}
+
+tc_word tc_getchar(void)
+{
+  int c = getchar();
+  if (c == EOF)
+    return (tc_word) &tc_empty;
+  return (tc_word) &tc_chars[c];
+}
+
+tc_word tc_ord(tc_word s)
+{
+  if (!tc_string(s)->size)
+    return -1;
+  tc_flatten(&s, 0);
+  return (unsigned char) tc_flat(s)->data[0];
+}
+
+tc_word tc_chr(tc_word i)
+{
+  if (i < 0 || 255 < i)
+    tc_error("chr: character out of range");
+  return (tc_word) &tc_chars[i];
+}
+
+tc_word tc_size(tc_word s)
+{
+  return tc_string(s)->size;
+}
+
+tc_word tc_streq(tc_word a, tc_word b)
+{
+  return !tc_string_order(a, b);
+}
+
+tc_word tc_strcmp(tc_word a, tc_word b)
+{
+  return tc_string_order(a, b);
+}
+
+tc_word tc_substring(tc_word s, tc_word start, tc_word length)
+{
+  struct tc_string* res;
+  if (start < 0 || length < 0 || tc_string(s)->size < start + length)
+    tc_error("substring: arguments out of bounds");
+  if (!length)
+    return (tc_word) &tc_empty;
+  tc_flatten(&s, 0);
+  if (length == 1)
+    return (tc_word) &tc_chars[(unsigned char) tc_flat(s)->data[start]];
+  res = tc_string_alloc(length, &s, 0);
+  memcpy((char*) (res + 1), tc_flat(s)->data + start, length);
+  return (tc_word) res;
+}
+
+tc_word tc_concat(tc_word a, tc_word b)
+{
+  tc_int size;
+  if (!tc_string(a)->size)
+    return b;
+  if (!tc_string(b)->size)
+    return a;
+  if (INT32_MAX - tc_string(a)->size < tc_string(b)->size)
+    tc_error("concat: string too long");
+  size = tc_string(a)->size + tc_string(b)->size;
+  if (size < TC_ROPE_MIN)
+    {
+      /* Shorter than a rope, hence both flat.  */
+      struct tc_string* res = tc_string_alloc(size, &a, &b);
+      char* chars = (char*) (res + 1);
+      memcpy(chars, tc_flat(a)->data, tc_flat(a)->size);
+      memcpy(chars + tc_flat(a)->size, tc_flat(b)->data, tc_flat(b)->size);
+      return (tc_word) res;
+    }
+  else
+    {
+      tc_word* slots[2];
+      struct tc_roots roots;
+      struct tc_rope* res;
+      slots[0] = &a;
+      slots[1] = &b;
+      roots.size = 2;
+      roots.slots = slots;
+      tc_roots_push(&roots);
+      res = tc_object(&tc_rope_map, sizeof *res);
+      tc_roots_pop(&roots);
+      /* RES is young: no need for tc_store.  */
+      res->string.size = size;
+      res->left = a;
+      res->right = b;
+      return (tc_word) res;
+    }
+}
+
+tc_word tc_not(tc_word i)
+{
+  return !i;
+}
+
+tc_word tc_exit(tc_word status)
+{
+  fflush(stdout);
+  exit((int) status);
+}
+
+/*-------.
+| Main.  |
+`-------*/
+
+int main(void)
+{
+  tc_gc_init();
+  tc_strings_init();
+  tc_main();
+  fflush(stdout);
+  return 0;
+}
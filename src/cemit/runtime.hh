@@ -0,0 +1,14 @@
+/**
+ ** \file cemit/runtime.hh
+ ** \brief The C runtime of the compiled programs.
+ */
+
+#pragma once
+
+namespace cemit
+{
+  /// The contents of runtime.c, which the translation of a program
+  /// starts with.
+  extern const char runtime[];
+
+} // namespace cemit
@@ -0,0 +1,22 @@
+/**
+ ** \file cemit/tasks.cc
+ ** \brief Cemit module related tasks' implementation.
+ */
+
+#include <iostream>
+
+#include <ast/tasks.hh>
+#include <cemit/libcemit.hh>
+#define DEFINE_TASKS 1
+#include <cemit/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace cemit::tasks
+{
+  /*---------------.
+    | C Emission.  |
+    `---------------*/
+
+  void c_emit() { ::cemit::c_emit(*ast::tasks::the_program, std::cout); }
+
+} // namespace cemit::tasks
@@ -0,0 +1,21 @@
+/**
+ ** \file cemit/tasks.hh
+ ** \brief Cemit module related tasks.
+ */
+
+#pragma once
+
+#include <task/libtask.hh>
+
+/// The Tasks of the cemit module.
+namespace cemit::tasks
+{
+  TASK_GROUP("C Emission");
+
+  /// Translate the program into C.
+  TASK_DECLARE("c-emit",
+               "translate the program into C99, runtime included",
+               c_emit,
+               "types-compute escapes-compute");
+
+} // namespace cemit::tasks
@@ -0,0 +1,93 @@
+/**
+ ** Checking the translation into C.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <sys/wait.h>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <bind/libbind.hh>
+#include <cemit/libcemit.hh>
+#include <escapes/libescapes.hh>
+#include <misc/contract.hh>
+#include <parse/libparse.hh>
+#include <type/libtype.hh>
+
+using namespace ast;
+
+const char* program_name = "test-cemit";
+
+// Translate \a body into C, compile and run it, and check that it
+// prints \a output and exits with \a status.
+static void test_cemit(const std::string& body, const std::string& output,
+                       int status = 0)
+{
+  std::unique_ptr<ChunkList> tree(
+    parse::parse_unit("let primitive print(s : string)"
+                      "    primitive print_int(i : int)"
+                      "    primitive size(s : string) : int "
+                      "in "
+                      + body + " end"));
+  bind::bind_compute(*tree);
+  type::types_check(*tree);
+  escapes::escapes_compute(*tree);
+
+  {
+    std::ofstream c("test-cemit.c");
+    cemit::c_emit(*tree, c);
+  }
+  // Plain C99: no extension of the C compiler may be relied upon.
+  std::string compile = std::string(CC)
+    + " -std=c99 -pedantic-errors -o test-cemit.out test-cemit.c";
+  assertion(std::system(compile.c_str()) == 0);
+
+  std::string out;
+  FILE* run = popen("./test-cemit.out", "r");
+  assertion(run);
+  for (int c; (c = std::fgetc(run)) != EOF;)
+    out += static_cast<char>(c);
+  int res = WEXITSTATUS(pclose(run));
+  std::cout << body << ": " << res << '\n' << out << '\n';
+  assertion(res == status);
+  assertion(out == output);
+}
+
+int main()
+{
+  // The literals are decoded, then escaped again for C: the size is
+  // the number of decoded characters.
+  test_cemit("print(\"a\\tb\\n\\\\\\\"\\101\\x42\\n\")", "a\tb\n\\\"AB\n");
+  test_cemit("print_int(size(\"\\n\\\\\\x41\"))", "3");
+
+  // With the smallest nursery, the 60000 records go through thousands
+  // of minor and a few major collections, which keep both lists: the
+  // one held by a variable, and the one stored in an old record.
+  setenv("TC_GC_NURSERY", "1024", 1);
+  test_cemit("let type node = {value : int, next : node}"
+             "    var list := node{value = 0, next = nil}"
+             "    var old := node{value = 0, next = nil}"
+             "    var sum := 0 "
+             "in for i := 1 to 20000 do"
+             "    (list := node{value = i, next = list};"
+             "     old.next := node{value = i, next = old.next};"
+             "     node{value = i, next = list};"
+             "     ());"
+             "  for i := 1 to 20000 do"
+             "    (sum := sum + list.value + old.next.value;"
+             "     list := list.next;"
+             "     old.next := old.next.next;"
+             "     ());"
+             "  print_int(sum) "
+             "end",
+             "400020000");
+
+  std::remove("test-cemit.c");
+  std::remove("test-cemit.out");
+}
@@ -7,6 +7,7 @@
 #include <bind/tasks.hh>
 #include <desugar/tasks.hh>
 #include <escapes/tasks.hh>
+#include <inlining/tasks.hh>
 #include <object/tasks.hh>
 
 #include <astclone/libastclone.hh>
@@ -59,10 +60,10 @@ namespace combine::tasks
       ::desugar::tasks::desugar();
 
     if (c_bounds_p)
-      astclone::apply(::desugar::bounds_checks_add, ast::tasks::the_program);
+      ::desugar::tasks::bounds_checks_add();
 
     if (c_inline_p)
-      astclone::apply(::inlining::inline_expand, ast::tasks::the_program);
+      ::inlining::tasks::inline_expand();
 
     if (c_prune_p)
       astclone::apply(::inlining::prune, ast::tasks::the_program);
@@ -0,0 +1,335 @@
+/**
+ ** \file desugar/bounds-analysis.cc
+ ** \brief Implementation of desugar::BoundsAnalysis.
+ */
+
+#include <climits>
+#include <ostream>
+
+#include <ast/all.hh>
+#include <desugar/bounds-analysis.hh>
+
+namespace desugar
+{
+  using namespace ast;
+
+  std::ostream& operator<<(std::ostream& ostr, const BoundsChecksStats& s)
+  {
+    return ostr << "/* Bounds checking statistics.  */\n"
+                << "accesses:  " << s.accesses << '\n'
+                << "  checked: " << s.accesses - s.elided << '\n'
+                << "  elided:  " << s.elided << '\n';
+  }
+
+  namespace
+  {
+    /// Collect the variables that are assigned.
+    class AssignedVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      void operator()(const ast::AssignExp& e) override
+      {
+        super_type::operator()(e);
+        if (auto var = dynamic_cast<const SimpleVar*>(&e.var_get()))
+          assigned.insert(var->def_get());
+      }
+
+      misc::set<const ast::VarDec*> assigned;
+    };
+
+  } // namespace
+
+  BoundsAnalysis::BoundsAnalysis(const ast::Ast& tree)
+  {
+    AssignedVisitor assigned;
+    assigned(tree);
+    assigned_ = std::move(assigned.assigned);
+    tree.accept(*this);
+  }
+
+  bool BoundsAnalysis::safe_p(const ast::SubscriptVar& e) const
+  {
+    return safe_.has(&e);
+  }
+
+  /*---------.
+  | Bounds.  |
+  `---------*/
+
+  bool BoundsAnalysis::immutable_p(const ast::VarDec* var) const
+  {
+    return var && !assigned_.has(var);
+  }
+
+  std::optional<BoundsAnalysis::Bound>
+  BoundsAnalysis::bound_get(const ast::Exp& e) const
+  {
+    if (auto i = dynamic_cast<const IntExp*>(&e))
+      return Bound{nullptr, i->value_get()};
+    if (auto var = dynamic_cast<const SimpleVar*>(&e))
+      {
+        if (immutable_p(var->def_get()))
+          return Bound{var->def_get(), 0};
+        return std::nullopt;
+      }
+    if (auto op = dynamic_cast<const OpExp*>(&e))
+      {
+        std::optional<Bound> lhs = bound_get(op->left_get());
+        std::optional<Bound> rhs = bound_get(op->right_get());
+        if (!lhs || !rhs)
+          return std::nullopt;
+        if (op->oper_get() == OpExp::Oper::add && !(lhs->sym && rhs->sym))
+          return Bound{lhs->sym ? lhs->sym : rhs->sym,
+                       lhs->offset + rhs->offset};
+        if (op->oper_get() == OpExp::Oper::sub && !rhs->sym)
+          return Bound{lhs->sym, lhs->offset - rhs->offset};
+      }
+    return std::nullopt;
+  }
+
+  std::optional<BoundsAnalysis::Bound>
+  BoundsAnalysis::bare_get(const ast::Exp& e) const
+  {
+    if (dynamic_cast<const IntExp*>(&e) || dynamic_cast<const SimpleVar*>(&e))
+      return bound_get(e);
+    return std::nullopt;
+  }
+
+  bool BoundsAnalysis::exact_p(const Bound& b) const
+  {
+    // Additions and subtractions wrap modulo 2^32: the computed value
+    // is the mathematical one as soon as the latter fits in an int.
+    if (!b.sym)
+      return INT_MIN <= b.offset && b.offset <= INT_MAX;
+    if (!b.offset)
+      return true;
+    for (const auto& [var, range] : facts_)
+      if (var == b.sym)
+        {
+          if (b.offset < 0 && range.lo && !range.lo->sym
+              && INT_MIN <= range.lo->offset + b.offset)
+            return true;
+          if (0 < b.offset && range.hi && !range.hi->sym
+              && range.hi->offset + b.offset <= INT_MAX)
+            return true;
+        }
+    return false;
+  }
+
+  std::optional<BoundsAnalysis::Bound>
+  BoundsAnalysis::exact_get(const ast::Exp& e) const
+  {
+    std::optional<Bound> res = bound_get(e);
+    if (res && exact_p(*res))
+      return res;
+    return std::nullopt;
+  }
+
+  std::optional<BoundsAnalysis::Bound>
+  BoundsAnalysis::size_get(const ast::VarDec* var) const
+  {
+    if (!immutable_p(var))
+      return std::nullopt;
+    // Whether the size computed at the creation was exact depends on
+    // the facts known there: only trust the bare ones.
+    if (auto array = dynamic_cast<const ArrayExp*>(var->init_get()))
+      if (std::optional<Bound> size = bare_get(array->size_get()))
+        return size;
+    // The size of an array is fixed: use it as a symbol.
+    return Bound{var, 0};
+  }
+
+  bool BoundsAnalysis::lower_p(const Bound& index) const
+  {
+    if (!index.sym)
+      return 0 <= index.offset;
+    for (const auto& [var, range] : facts_)
+      if (var == index.sym && range.lo && !range.lo->sym
+          && 0 <= range.lo->offset + index.offset)
+        return true;
+    return false;
+  }
+
+  bool BoundsAnalysis::upper_p(const Bound& index, const Bound& size) const
+  {
+    if (index.sym == size.sym)
+      return index.offset < size.offset;
+    if (!index.sym)
+      return false;
+    for (const auto& [var, range] : facts_)
+      if (var == index.sym && range.hi && range.hi->sym == size.sym
+          && range.hi->offset + index.offset < size.offset)
+        return true;
+    return false;
+  }
+
+  /*--------.
+  | Facts.  |
+  `--------*/
+
+  void BoundsAnalysis::fact_add(const ast::VarDec* var, const Range& range)
+  {
+    if (immutable_p(var) && (range.lo || range.hi))
+      facts_.emplace_back(var, range);
+  }
+
+  void BoundsAnalysis::guard(const ast::Exp& test)
+  {
+    // `a & b' is `if a then b <> 0 else 0'.
+    if (auto cond = dynamic_cast<const IfExp*>(&test))
+      {
+        auto elseclause =
+          dynamic_cast<const IntExp*>(&cond->get_elseclause());
+        if (elseclause && elseclause->value_get() == 0)
+          {
+            guard(cond->get_test());
+            guard(cond->get_thenclause());
+          }
+        return;
+      }
+
+    auto op = dynamic_cast<const OpExp*>(&test);
+    if (!op)
+      return;
+
+    // `x <> 0' is `x' as a test.
+    if (auto zero = dynamic_cast<const IntExp*>(&op->right_get());
+        op->oper_get() == OpExp::Oper::ne && zero && !zero->value_get())
+      return guard(op->left_get());
+
+    // The comparison is on the computed values: `i + 1 <= n' does not
+    // imply `i <= n - 1' when `i + 1' wraps.  Only learn from operands
+    // which are not computed.
+    std::optional<Bound> lhs = bare_get(op->left_get());
+    std::optional<Bound> rhs = bare_get(op->right_get());
+    if (!lhs || !rhs)
+      return;
+
+    // Turn `lhs OP rhs' into `lhs <= rhs + delta'.
+    long delta = 0;
+    switch (op->oper_get())
+      {
+      case OpExp::Oper::lt:
+        delta = -1;
+        break;
+      case OpExp::Oper::le:
+        break;
+      case OpExp::Oper::gt:
+        std::swap(lhs, rhs);
+        delta = -1;
+        break;
+      case OpExp::Oper::ge:
+        std::swap(lhs, rhs);
+        break;
+      default:
+        return;
+      }
+    // lhs.sym + lhs.offset <= rhs.sym + rhs.offset + delta.
+    if (lhs->sym)
+      fact_add(lhs->sym,
+               Range{std::nullopt,
+                     Bound{rhs->sym, rhs->offset + delta - lhs->offset}});
+    if (rhs->sym)
+      fact_add(rhs->sym,
+               Range{Bound{lhs->sym, lhs->offset - delta - rhs->offset},
+                     std::nullopt});
+  }
+
+  void BoundsAnalysis::scoped_visit(const ast::Ast& e)
+  {
+    auto size = facts_.size();
+    e.accept(*this);
+    facts_.resize(size);
+  }
+
+  /*----------------.
+  | Visit methods.  |
+  `----------------*/
+
+  void BoundsAnalysis::operator()(const ast::ForExp& e)
+  {
+    // The bounds are evaluated once, before the loop.
+    const VarDec& index = e.vardec_get();
+    e.vardec_get().accept(*this);
+    e.hi_get().accept(*this);
+
+    auto size = facts_.size();
+    fact_add(&index,
+             Range{exact_get(*index.init_get()), exact_get(e.hi_get())});
+    e.body_get().accept(*this);
+    facts_.resize(size);
+  }
+
+  void BoundsAnalysis::operator()(const ast::ArrayExp& e)
+  {
+    super_type::operator()(e);
+
+    // Past the creation, the size is not negative.
+    std::optional<Bound> size = exact_get(e.size_get());
+    if (size && size->sym)
+      fact_add(size->sym, Range{Bound{nullptr, -size->offset}, std::nullopt});
+  }
+
+  void BoundsAnalysis::operator()(const ast::FunctionDec& e)
+  {
+    // A function can only be called where it is visible, i.e., after
+    // the facts known here.
+    auto size = facts_.size();
+    super_type::operator()(e);
+    facts_.resize(size);
+  }
+
+  void BoundsAnalysis::operator()(const ast::IfExp& e)
+  {
+    // The test is always evaluated.
+    e.get_test().accept(*this);
+
+    auto size = facts_.size();
+    guard(e.get_test());
+    e.get_thenclause().accept(*this);
+    facts_.resize(size);
+
+    if (&e.get_elseclause())
+      scoped_visit(e.get_elseclause());
+  }
+
+  void BoundsAnalysis::operator()(const ast::SubscriptVar& e)
+  {
+    super_type::operator()(e);
+
+    auto array = dynamic_cast<const SimpleVar*>(&e.var_get());
+    if (!array)
+      return;
+    std::optional<Bound> size = size_get(array->def_get());
+    std::optional<Bound> index = bound_get(e.index_get());
+    if (!size || !index)
+      return;
+
+    bool safe = lower_p(*index) && upper_p(*index, *size);
+    if (safe)
+      safe_.insert(&e);
+
+    // Past this access (checked or not), the index is within bounds.
+    if (index->sym && (safe || exact_p(*index)))
+      fact_add(index->sym,
+               Range{Bound{nullptr, -index->offset},
+                     Bound{size->sym, size->offset - 1 - index->offset}});
+  }
+
+  void BoundsAnalysis::operator()(const ast::WhileExp& e)
+  {
+    // The test is evaluated at least once.
+    e.test_get().accept(*this);
+
+    auto size = facts_.size();
+    guard(e.test_get());
+    e.body_get().accept(*this);
+    facts_.resize(size);
+  }
+
+} // namespace desugar
@@ -0,0 +1,135 @@
+/**
+ ** \file desugar/bounds-analysis.hh
+ ** \brief Declaration of desugar::BoundsAnalysis.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <misc/set.hh>
+
+namespace desugar
+{
+  /// How many bounds checks were added, and left out.
+  struct BoundsChecksStats
+  {
+    /// Array accesses.
+    unsigned accesses = 0;
+    /// Array accesses proven within bounds, hence left unchecked.
+    unsigned elided = 0;
+  };
+
+  /// Report \a s on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const BoundsChecksStats& s);
+
+  /** \brief Prove array accesses within bounds.
+
+      A range analysis over the structured AST.  The integer variables
+      which are never assigned (including the indexes of `for' loops)
+      are used as symbols: an index or a size is known as an affine
+      bound `symbol + offset', or as a constant.
+
+      An array variable that is never assigned has a fixed size: the
+      size given at its creation when it is known, otherwise its own
+      symbolic size.  The ranges of the variables come from
+
+      - `for' loops: the index is within the bounds of the loop in the
+        body;
+      - guards: `i < n' in the test of an `if' holds in its `then'
+        clause (`&' is handled as well);
+      - dominating accesses: once `a[i]' has been checked, `i' is
+        within the bounds of `a' for the rest of the enclosing scope.
+
+      An access is proven safe when its index is at least 0, and less
+      than the size of the array.  Integers wrap: a fact is only
+      learned from an expression whose value is known to fit in an
+      int, and a guard only from the comparison of variables and
+      constants.  Expressions are evaluated from left
+      to right, so facts flow in the order of the traversal, and are
+      dropped at the end of the loop bodies, branches and functions
+      where they were learned.
+
+      The AST must be bound.  */
+  class BoundsAnalysis
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    using super_type = ast::DefaultConstVisitor;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// Analyze \a tree.
+    explicit BoundsAnalysis(const ast::Ast& tree);
+
+    /// Whether the access \a e is proven within bounds.
+    bool safe_p(const ast::SubscriptVar& e) const;
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::ForExp& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+  private:
+    /// The value `sym + offset', or `offset' if \a sym is null.
+    struct Bound
+    {
+      const ast::VarDec* sym = nullptr;
+      long offset = 0;
+    };
+
+    /// What is known of the value of a variable.
+    struct Range
+    {
+      std::optional<Bound> lo;
+      std::optional<Bound> hi;
+    };
+
+    /// Whether \a var is never assigned.
+    bool immutable_p(const ast::VarDec* var) const;
+    /// The value of \a e, as an affine bound, if known.
+    std::optional<Bound> bound_get(const ast::Exp& e) const;
+    /// The value of \a e, if it is a constant or a variable.
+    std::optional<Bound> bare_get(const ast::Exp& e) const;
+    /// Whether the value \a b is known to fit in an int, i.e., to be
+    /// computed without wrapping.
+    bool exact_p(const Bound& b) const;
+    /// The value of \a e, if known, and computed without wrapping.
+    std::optional<Bound> exact_get(const ast::Exp& e) const;
+    /// The size of the array \a var, if known.
+    std::optional<Bound> size_get(const ast::VarDec* var) const;
+
+    /// Whether \a index is proven at least 0.
+    bool lower_p(const Bound& index) const;
+    /// Whether \a index is proven less than \a size.
+    bool upper_p(const Bound& index, const Bound& size) const;
+
+    /// Learn the facts implied by \a test being true.
+    void guard(const ast::Exp& test);
+    /// Learn that \a var is within \a range.
+    void fact_add(const ast::VarDec* var, const Range& range);
+    /// Visit \a e in a scope of its own: what is learned there is
+    /// forgotten afterwards.
+    void scoped_visit(const ast::Ast& e);
+
+    /// The variables which are assigned somewhere.
+    misc::set<const ast::VarDec*> assigned_;
+    /// The facts known at this point, innermost last.
+    std::vector<std::pair<const ast::VarDec*, Range>> facts_;
+    /// The accesses proven within bounds.
+    misc::set<const ast::SubscriptVar*> safe_;
+  };
+
+} // namespace desugar
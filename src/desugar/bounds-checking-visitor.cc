@@ -3,9 +3,12 @@
  ** \brief Implementation of desugar::BoundsCheckingVisitor.
  */
 
+#include <sstream>
+
 #include <ast/all.hh>
 #include <ast/libast.hh>
 #include <desugar/bounds-checking-visitor.hh>
+#include <misc/escape.hh>
 #include <misc/symbol.hh>
 #include <parse/libparse.hh>
 
@@ -16,16 +19,222 @@ namespace desugar
     /// Return the name of the boxed type for \a s.
     std::string box(misc::symbol s) { return "_box_" + s.get(); }
 
+    /// The declaration of the array type \a def is, or is an alias
+    /// of, if any.
+    const ast::TypeDec* array_dec(const ast::TypeDec* def)
+    {
+      while (def)
+        {
+          if (dynamic_cast<const ast::ArrayTy*>(&def->ty_get()))
+            return def;
+          auto alias = dynamic_cast<const ast::NameTy*>(&def->ty_get());
+          def = alias ? alias->def_get() : nullptr;
+        }
+      return nullptr;
+    }
+
+    /// Whether \a chunk only declares primitives.
+    bool primitives_p(const ast::ChunkInterface* chunk)
+    {
+      auto funs = dynamic_cast<const ast::FunctionChunk*>(chunk);
+      if (!funs)
+        return false;
+      for (const ast::FunctionDec* f : *funs)
+        if (f->body_get())
+          return false;
+      return true;
+    }
+
   } // namespace
 
+  const std::string BoundsCheckingVisitor::prelude =
+    " function _check_bounds(size : int, index : int, location : string)"
+    "   : int ="
+    "   if index < 0 | size <= index then"
+    "     (print_err(location);"
+    "      print_err(\": array index out of bounds\\n\");"
+    "      exit(120);"
+    "      0)"
+    "   else index";
+
   BoundsCheckingVisitor::BoundsCheckingVisitor()
     : super_type()
   {}
 
+  BoundsCheckingVisitor::BoundsCheckingVisitor(const ast::Ast& tree)
+    : super_type()
+    , analysis_(std::make_unique<BoundsAnalysis>(tree))
+  {}
+
+  const BoundsChecksStats& BoundsCheckingVisitor::stats_get() const
+  {
+    return stats_;
+  }
+
   /*-----------------------.
   | Array bounds checking.  |
   `-----------------------*/
 
-  // FIXME: Some code was deleted here.
+  void BoundsCheckingVisitor::operator()(const ast::TypeChunk& e)
+  {
+    super_type::operator()(e);
+    auto chunk = dynamic_cast<ast::TypeChunk*>(result_);
+    // Declare the box of each array type along with it, so that it has
+    // the same scope.
+    for (const ast::TypeDec* dec : e)
+      if (dynamic_cast<const ast::ArrayTy*>(&dec->ty_get()))
+        {
+          const ast::Location& location = dec->location_get();
+          auto fields = new ast::fields_type{
+            new ast::Field(location, "arr",
+                           new ast::NameTy(location, dec->name_get())),
+            new ast::Field(location, "size",
+                           new ast::NameTy(location, "int"))};
+          boxes_[dec] = box(dec->name_get());
+          chunk->emplace_back(*new ast::TypeDec(
+            location, boxes_[dec], new ast::RecordTy(location, fields)));
+        }
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::TypeDec& e)
+  {
+    // An alias of an array type still names the array, not its box:
+    // `u [n] of 0' creates an array.
+    if (auto alias = dynamic_cast<const ast::NameTy*>(&e.ty_get()))
+      {
+        const ast::Location& location = e.location_get();
+        result_ = new ast::TypeDec(
+          location, e.name_get(),
+          new ast::NameTy(alias->location_get(), alias->name_get()));
+        return;
+      }
+    super_type::operator()(e);
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::NameTy& e)
+  {
+    const ast::TypeDec* array = array_dec(e.def_get());
+    if (!array)
+      return super_type::operator()(e);
+    // The type chunks are visited before the uses of their types.
+    result_ = new ast::NameTy(e.location_get(), boxes_[array]);
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::ArrayExp& e)
+  {
+    const ast::NameTy& type_name = e.type_name_get();
+    const ast::TypeDec* array = array_dec(type_name.def_get());
+    assertion(array);
+    // The size is computed once, before the initial value.
+    ast::Exp* boxed = parse::parse(
+      parse::Tweast() << "let var _size := " << recurse(e.size_get())
+                      << " in " << boxes_[array] << " { arr = "
+                      << type_name.name_get() << " [_size] of "
+                      << recurse(e.init_get()) << ", size = _size } end");
+    result_ = boxed;
+  }
+
+  ast::Var* BoundsCheckingVisitor::path(const ast::Var& e,
+                                        ast::VarChunk& decs)
+  {
+    const ast::Location& location = e.location_get();
+    if (auto field = dynamic_cast<const ast::FieldVar*>(&e))
+      return new ast::FieldVar(location, path(field->var_get(), decs),
+                               field->name_get());
+    auto subscript = dynamic_cast<const ast::SubscriptVar*>(&e);
+    if (!subscript)
+      return recurse(e);
+
+    ++stats_.accesses;
+    ast::Var* base = path(subscript->var_get(), decs);
+    if (analysis_ && analysis_->safe_p(*subscript))
+      {
+        // Proven within bounds: just unbox the array.
+        ++stats_.elided;
+        return new ast::SubscriptVar(location,
+                                     new ast::FieldVar(location, base, "arr"),
+                                     recurse(subscript->index_get()));
+      }
+
+    // The box is designated twice, by the check and by the access:
+    // compute it once, unless it is a mere variable.
+    auto var = dynamic_cast<ast::SimpleVar*>(base);
+    misc::symbol box = var ? var->name_get() : misc::symbol::fresh("_box");
+    if (var)
+      delete base;
+    else
+      decs.emplace_back(*new ast::VarDec(location, box, nullptr, base));
+    std::ostringstream where;
+    where << location;
+    ast::Exp* index = parse::parse(
+      parse::Tweast() << "_check_bounds(" << box << ".size, "
+                      << recurse(subscript->index_get()) << ", \""
+                      << misc::escape(where.str()) << "\")");
+    return new ast::SubscriptVar(
+      location,
+      new ast::FieldVar(location, new ast::SimpleVar(location, box), "arr"),
+      index);
+  }
+
+  ast::Exp* BoundsCheckingVisitor::with(ast::VarChunk* decs, ast::Exp* exp)
+  {
+    if (decs->empty())
+      {
+        delete decs;
+        return exp;
+      }
+    const ast::Location& location = exp->location_get();
+    return new ast::LetExp(location, new ast::ChunkList(location, {decs}),
+                           exp);
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::SubscriptVar& e)
+  {
+    auto decs = new ast::VarChunk(e.location_get());
+    ast::Var* var = path(e, *decs);
+    result_ = with(decs, var);
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::FieldVar& e)
+  {
+    auto decs = new ast::VarChunk(e.location_get());
+    ast::Var* var = path(e, *decs);
+    result_ = with(decs, var);
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::AssignExp& e)
+  {
+    auto decs = new ast::VarChunk(e.location_get());
+    ast::Var* var = path(e.var_get(), *decs);
+    ast::Exp* exp = recurse(e.exp_get());
+    result_ = with(decs, new ast::AssignExp(e.location_get(), var, exp));
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::LetExp& e)
+  {
+    ++nesting_;
+    super_type::operator()(e);
+    --nesting_;
+  }
+
+  void BoundsCheckingVisitor::operator()(const ast::ChunkList& e)
+  {
+    ++nesting_;
+    super_type::operator()(e);
+    --nesting_;
+    if (nesting_ || stats_.accesses == stats_.elided)
+      return;
+    // Add the runtime to the outermost declarations, after the
+    // primitives it uses, so that every function can see it.
+    auto res = dynamic_cast<ast::ChunkList*>(result_);
+    auto& chunks = res->chunks_get();
+    auto it = chunks.begin();
+    while (it != chunks.end() && primitives_p(*it))
+      ++it;
+    parse::Tweast input;
+    input << prelude;
+    chunks.insert(it, parse::parse_chunks(input));
+    result_ = res;
+  }
 
 } // namespace desugar
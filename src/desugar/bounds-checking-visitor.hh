@@ -6,13 +6,26 @@
 #pragma once
 
 #include <map>
+#include <memory>
 
 #include <astclone/cloner.hh>
+#include <desugar/bounds-analysis.hh>
 #include <parse/tweast.hh>
 
 namespace desugar
 {
-  /// \brief Add dynamic array bounds checks while duplicating an AST.
+  /** \brief Add dynamic array bounds checks while duplicating an AST.
+
+      Each array is boxed along with its size: `type t = array of int'
+      declares `type _box_t = { arr : t, size : int }' as well, and the
+      uses of `t' are replaced by `_box_t'.  An access `a[i]' becomes
+      `a.arr[_check_bounds(a.size, i, "location")]', or `a.arr[i]' if
+      it is proven within bounds.  When `a' is not a mere variable, as
+      in `m[i][j]', its box is bound once by a `let', so that its
+      effects happen once.  `_check_bounds' is defined among the
+      declarations of the program, right after the primitives.
+
+      The AST must be bound.  */
   class BoundsCheckingVisitor : public astclone::Cloner
   {
   public:
@@ -25,12 +38,36 @@ namespace desugar
     /// Build a BoundsCheckingVisitor.
     BoundsCheckingVisitor();
 
+    /// \brief Build a BoundsCheckingVisitor which leaves out the checks
+    /// of the accesses of \a tree proven within bounds (see
+    /// BoundsAnalysis).
+    explicit BoundsCheckingVisitor(const ast::Ast& tree);
+
     /// \name Visit methods.
     /// \{
-    // FIXME: Some code was deleted here.
+    void operator()(const ast::TypeChunk& e) override;
+    void operator()(const ast::TypeDec& e) override;
+    void operator()(const ast::NameTy& e) override;
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::ChunkList& e) override;
     /// \}
 
+    /// How many checks were added, and left out.
+    const BoundsChecksStats& stats_get() const;
+
   private:
+    /// \brief The clone of \a e, with its accesses checked.
+    ///
+    /// Declare in \a decs the boxes which must be computed once.
+    ast::Var* path(const ast::Var& e, ast::VarChunk& decs);
+
+    /// \a exp within a `let' declaring \a decs, if there are any.
+    ast::Exp* with(ast::VarChunk* decs, ast::Exp* exp);
+
     /// The bounds checking runtime.
     ///
     /// Additional definitions to insert in the prelude.
@@ -38,9 +75,18 @@ namespace desugar
 
     // Symbols would be nicer, but maps of symbols are
     // inconvenient since there is no default ctor.
-    using boxes_type = std::map<const type::Array*, std::string>;
-    /// Map from an array type to the corresponding `box' type name.
+    using boxes_type = std::map<const ast::TypeDec*, std::string>;
+    /// Map from an array type declaration to the corresponding `box'
+    /// type name.
     boxes_type boxes_;
+
+    /// The accesses proven within bounds, if the checks are elided.
+    std::unique_ptr<BoundsAnalysis> analysis_;
+    /// How many checks were added, and left out.
+    BoundsChecksStats stats_;
+    /// The number of ChunkLists and LetExps being visited: the runtime
+    /// goes in the outermost ChunkList, the one of the program.
+    unsigned nesting_ = 0;
   };
 
 } // namespace desugar
@@ -24,7 +24,7 @@ namespace desugar
   template <typename A> void bind_and_types_check(A& tree)
   {
     misc::error e;
-    // FIXME: Some code was deleted here.
+    e << bind::bind_compute(tree);
     e.ice_on_error_here();
     e << type::types_check(tree);
     e.ice_on_error_here();
@@ -66,18 +66,24 @@ namespace desugar
   | Array bounds checking.  |
   `-----------------------*/
 
-  template <typename A> A* raw_bounds_checks_add(const A& tree)
+  template <typename A>
+  A* raw_bounds_checks_add(const A& tree, bool elide, BoundsChecksStats* stats)
   {
     // Add array bounds checking code.
-    BoundsCheckingVisitor add_bounds_checks;
-    add_bounds_checks(tree);
-    return dynamic_cast<A*>(add_bounds_checks.result_get());
+    std::unique_ptr<BoundsCheckingVisitor> add_bounds_checks =
+      elide ? std::make_unique<BoundsCheckingVisitor>(tree)
+            : std::make_unique<BoundsCheckingVisitor>();
+    (*add_bounds_checks)(tree);
+    if (stats)
+      *stats = add_bounds_checks->stats_get();
+    return dynamic_cast<A*>(add_bounds_checks->result_get());
   }
 
-  template <typename A> A* bounds_checks_add(const A& tree)
+  template <typename A>
+  A* bounds_checks_add(const A& tree, bool elide, BoundsChecksStats* stats)
   {
     // Add bounds checks.
-    A* transformed = raw_bounds_checks_add(tree);
+    A* transformed = raw_bounds_checks_add(tree, elide, stats);
     assertion(transformed);
     std::unique_ptr<A> transformed_ptr(transformed);
     // Recompute the bindings and the types.
@@ -86,7 +92,11 @@ namespace desugar
   }
 
   /// Explicit instantiations.
-  template ast::ChunkList* raw_bounds_checks_add(const ast::ChunkList&);
-  template ast::ChunkList* bounds_checks_add(const ast::ChunkList&);
+  template ast::ChunkList* raw_bounds_checks_add(const ast::ChunkList&,
+                                                 bool,
+                                                 BoundsChecksStats*);
+  template ast::ChunkList* bounds_checks_add(const ast::ChunkList&,
+                                             bool,
+                                             BoundsChecksStats*);
 
 } // namespace desugar
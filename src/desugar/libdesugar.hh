@@ -5,6 +5,7 @@
 
 #pragma once
 
+#include <desugar/bounds-analysis.hh>
 #include <misc/error.hh>
 
 /// Desugaring an ast::Ast.
@@ -58,12 +59,18 @@ namespace desugar
 
   /** \brief Add runtime checks of array bounds.
 
-      \param tree abstract syntax tree's root, whose bindings and types
-                  have been computed, and whose identifiers are all unique.
+      \param tree  abstract syntax tree's root, whose bindings and types
+                   have been computed, and whose identifiers are all unique.
+      \param elide leave out the checks proven useless by BoundsAnalysis.
+      \param stats if not null, where to store how many checks were
+                   added and left out.
 
       \return the AST with bounds checks, with bindings and type-checked. */
 
-  template <typename A> A* bounds_checks_add(const A& tree);
+  template <typename A>
+  A* bounds_checks_add(const A& tree,
+                       bool elide = false,
+                       BoundsChecksStats* stats = nullptr);
 
   /** \brief Remove the syntactic sugar from an AST without
       recomputing its bindings nor its types.
@@ -75,9 +82,15 @@ namespace desugar
       if the tree with bounds checks is badly bound or typed, it can
       still be pretty-printed).
 
-      \param tree AST on which bounds checks are to be added
+      \param tree  AST on which bounds checks are to be added
+      \param elide leave out the checks proven useless by BoundsAnalysis.
+      \param stats if not null, where to store how many checks were
+                   added and left out.
 
       \return the AST with bounds checks.  */
-  template <typename A> A* raw_bounds_checks_add(const A& tree);
+  template <typename A>
+  A* raw_bounds_checks_add(const A& tree,
+                           bool elide = false,
+                           BoundsChecksStats* stats = nullptr);
 
 } // namespace desugar
@@ -3,6 +3,8 @@
  ** \brief Desugar module related tasks' implementation.
  **/
 
+#include <iostream>
+
 #include <ast/tasks.hh>
 #include <astclone/libastclone.hh>
 #include <common.hh>
@@ -33,14 +35,21 @@ namespace desugar::tasks
     | Array bounds checking.  |
     `-----------------------*/
 
+  /// The statistics of the last bounds checking.
+  static BoundsChecksStats stats;
+
   void bounds_checks_add()
   {
-    astclone::apply(::desugar::bounds_checks_add, ast::tasks::the_program);
+    ast::tasks::the_program.reset(::desugar::bounds_checks_add(
+      *ast::tasks::the_program, bounds_checks_elide_p, &stats));
   }
 
   void raw_bounds_checks_add()
   {
-    astclone::apply(::desugar::raw_bounds_checks_add, ast::tasks::the_program);
+    ast::tasks::the_program.reset(::desugar::raw_bounds_checks_add(
+      *ast::tasks::the_program, bounds_checks_elide_p, &stats));
   }
 
+  void bounds_checks_stats() { std::cout << stats; }
+
 } // namespace desugar::tasks
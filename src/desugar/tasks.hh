@@ -57,6 +57,13 @@ namespace desugar::tasks
     | Array bounds checking.  |
     `-----------------------*/
 
+  /// Leave out the bounds checks proven useless.
+  BOOLEAN_TASK_DECLARE("bounds-checks-elide",
+                       "leave out the bounds checks proven useless "
+                       "by a range analysis",
+                       bounds_checks_elide_p,
+                       "");
+
   /// Enable emission of dynamic array bounds checking code.
   TASK_DECLARE("bounds-checks-add",
                "add dynamic bounds checks",
@@ -71,4 +78,10 @@ namespace desugar::tasks
                raw_bounds_checks_add,
                "typed rename");
 
+  /// Report how many bounds checks were left out.
+  TASK_DECLARE("bounds-checks-stats",
+               "report bounds checking statistics",
+               bounds_checks_stats,
+               "bounds-checks-add");
+
 } // namespace desugar::tasks
@@ -0,0 +1,91 @@
+/**
+ ** Checking the range analysis of array accesses.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/libast.hh>
+#include <ast/non-object-visitor.hh>
+#include <bind/libbind.hh>
+#include <desugar/bounds-analysis.hh>
+#include <misc/contract.hh>
+#include <testing.hh>
+
+using namespace ast;
+using namespace desugar;
+
+const char* program_name = "test-bounds-analysis";
+
+// Count the array accesses proven within bounds.
+class SafeCounter
+  : public DefaultConstVisitor
+  , public NonObjectConstVisitor
+{
+public:
+  using super_type = DefaultConstVisitor;
+  using super_type::operator();
+
+  explicit SafeCounter(const BoundsAnalysis& analysis)
+    : analysis_(analysis)
+  {}
+
+  void operator()(const SubscriptVar& e) override
+  {
+    super_type::operator()(e);
+    ++accesses;
+    if (analysis_.safe_p(e))
+      ++safe;
+  }
+
+  unsigned accesses = 0;
+  unsigned safe = 0;
+
+private:
+  const BoundsAnalysis& analysis_;
+};
+
+// Check that \a safe of the accesses of \a body are proven safe.
+static void test_bounds(const std::string& body, unsigned safe)
+{
+  ChunkList* tree = testing::program_parse("type ints = array of int"
+                                           " var n := 10"
+                                           " var a := ints [n] of 0"
+                                           " var b := ints [42] of 0"
+                                           " var m := 51",
+                                           body);
+  bind::bind_compute(*tree);
+  BoundsAnalysis analysis(*tree);
+  SafeCounter count(analysis);
+  count(*tree);
+  std::cout << body << ": " << count.safe << '/' << count.accesses << '\n';
+  assertion(count.safe == safe);
+  delete tree;
+}
+
+int main()
+{
+  // Canonical loops.
+  test_bounds("for i := 0 to n - 1 do a[i] := i", 1);
+  test_bounds("for i := 1 to 40 do b[i - 1] := b[i] + b[i + 1]", 3);
+  test_bounds("for i := 0 to n do a[i] := i", 0);
+  test_bounds("for i := 0 to m - 1 do a[i] := i", 0);
+
+  // Guards.
+  test_bounds("for i := 0 to m do if i < n then a[i] := i", 1);
+  test_bounds("for i := 0 to m do if i < n & i > 0 then a[i - 1] := i", 1);
+
+  // Integers wrap: `i + 1 <= n' holds for the largest int.
+  test_bounds("let function f(i : int) ="
+              "  if i + 1 <= n & i >= 0 then a[i] := i "
+              "in f(n) end",
+              0);
+
+  // Dominating checks.
+  test_bounds("(a[m] := 1; a[m] := a[m] + 1)", 2);
+
+  // Mutable variables are not trusted.
+  test_bounds("let var i := 0 in (i := 12; a[i]) end", 0);
+}
@@ -1,37 +1,43 @@
 // Checking bounds checking.
 
+#include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
 
 #include <ast/all.hh>
 #include <ast/libast.hh>
 #include <bind/libbind.hh>
 #include <desugar/bounds-checking-visitor.hh>
+#include <misc/contract.hh>
 #include <parse/libparse.hh>
-#include <type/libtype.hh>
 
 using namespace ast;
 using namespace desugar;
 
 const char* program_name = "test-bounds-checking";
 
-static void test_bounds_checking(ast::Ast& tree)
+static BoundsChecksStats test_bounds_checking(ast::Ast& tree,
+                                              bool elide = false)
 {
+  // The boxes are found through the bindings, not the types.
   bind::bind_compute(tree);
-  type::types_check(tree);
   std::cout << "/* === Original tree...  */\n" << tree << '\n';
 
-  BoundsCheckingVisitor bounds_checks_add;
-  bounds_checks_add(tree);
+  auto bounds_checks_add = elide
+    ? std::make_unique<BoundsCheckingVisitor>(tree)
+    : std::make_unique<BoundsCheckingVisitor>();
+  (*bounds_checks_add)(tree);
 
   std::cout << "/* === AST with bounds checks...  */\n"
-            << *bounds_checks_add.result_get() << '\n';
-  delete bounds_checks_add.result_get();
+            << *bounds_checks_add->result_get() << '\n';
+  delete bounds_checks_add->result_get();
   std::cout << std::endl;
+  return bounds_checks_add->stats_get();
 }
 
 int main()
-{/*
+{
   // Minimal built-in function requirements.
   std::string builtins = " primitive print_err(string: string)"
                          " primitive exit(status: int)"
@@ -64,5 +70,69 @@ int main()
     delete tree;
     tree = nullptr;
   }
-  */
+
+  // Leaving out the checks proven useless.
+  {
+    std::cout << "Third test...\n";
+    ChunkList* tree = parse::parse(parse::Tweast()
+                                   << builtins
+                                   << " function _main() ="
+                                      "   for i := 0 to 42 do"
+                                      "     print_err(forty_twos[i])");
+    BoundsChecksStats stats = test_bounds_checking(*tree, true);
+    assertion(stats.accesses == 1);
+    assertion(stats.elided == 0);
+    delete tree;
+    tree = nullptr;
+  }
+  {
+    std::cout << "Fourth test...\n";
+    ChunkList* tree = parse::parse(parse::Tweast()
+                                   << builtins
+                                   << " function _main() ="
+                                      "   for i := 0 to 41 do"
+                                      "     print_err(forty_twos[i])");
+    BoundsChecksStats stats = test_bounds_checking(*tree, true);
+    assertion(stats.accesses == 1);
+    assertion(stats.elided == 1);
+    delete tree;
+    tree = nullptr;
+  }
+
+  // An inner index is computed once, and the runtime is visible to
+  // every function.
+  {
+    std::cout << "Fifth test...\n";
+    ChunkList* tree = parse::parse(parse::Tweast()
+                                   << builtins
+                                   << " type matrix = array of strings"
+                                      " var m := matrix [2] of forty_twos"
+                                      " function g() : int = 1"
+                                      " function f(j : int) : string ="
+                                      "   m[g()][j]"
+                                      " function _main() ="
+                                      "   (m[g()][0] := f(1); ())");
+    bind::bind_compute(*tree);
+    BoundsCheckingVisitor bounds_checks_add;
+    bounds_checks_add(*tree);
+    std::unique_ptr<Ast> checked(bounds_checks_add.result_get());
+    std::ostringstream o;
+    o << *checked;
+    std::cout << o.str() << '\n';
+    const std::string text = o.str();
+    assertion(bounds_checks_add.stats_get().accesses == 4);
+    // Each of the two accesses to m calls g once.
+    size_t calls = 0;
+    for (size_t i = text.find("g()"); i != std::string::npos;
+         i = text.find("g()", i + 1))
+      ++calls;
+    assertion(calls == 3);
+    // The runtime is declared before f.
+    assertion(text.find("function _check_bounds")
+              < text.find("function f"));
+    // Its own bindings are correct.
+    assertion(!bind::bind_compute(*checked));
+    delete tree;
+    tree = nullptr;
+  }
 }
@@ -0,0 +1,123 @@
+/**
+ ** \file effects/effects-visitor.cc
+ ** \brief Implementation of effects::EffectsVisitor.
+ */
+
+#include <ast/all.hh>
+#include <effects/effects-visitor.hh>
+#include <effects/libeffects.hh>
+
+namespace effects
+{
+  using ast::Effectful;
+
+  EffectsVisitor::EffectsVisitor(bool calls)
+    : calls_(calls)
+    , effects_(Effectful::pure)
+  {}
+
+  EffectsVisitor::EffectsVisitor(const ast::FunctionDec& fun)
+    : EffectsVisitor(false)
+  {
+    for (const ast::VarDec* formal : fun.formals_get())
+      declared_.insert(formal);
+    if (fun.body_get())
+      fun.body_get()->accept(*this);
+    else
+      effects_ = primitive_effects(fun.name_get());
+  }
+
+  unsigned EffectsVisitor::effects_get() const { return effects_; }
+
+  void EffectsVisitor::operator()(const ast::ArrayExp& e)
+  {
+    super_type::operator()(e);
+    // The size may be negative.
+    effects_ |= Effectful::allocates | Effectful::diverges;
+  }
+
+  void EffectsVisitor::operator()(const ast::AssignExp& e)
+  {
+    // The variable is written, not read.  Its subexpressions are read.
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e.var_get()))
+      {
+        if (!declared_.has(var->def_get()))
+          effects_ |= Effectful::writes;
+      }
+    else if (auto field = dynamic_cast<const ast::FieldVar*>(&e.var_get()))
+      {
+        // The record may be nil.
+        field->var_get().accept(*this);
+        effects_ |= Effectful::writes | Effectful::diverges;
+      }
+    else if (auto sub = dynamic_cast<const ast::SubscriptVar*>(&e.var_get()))
+      {
+        // The index may be out of bounds.
+        sub->var_get().accept(*this);
+        sub->index_get().accept(*this);
+        effects_ |= Effectful::writes | Effectful::diverges;
+      }
+    e.exp_get().accept(*this);
+  }
+
+  void EffectsVisitor::operator()(const ast::CallExp& e)
+  {
+    super_type::operator()(e);
+    const ast::FunctionDec* def = e.def_get();
+    if (calls_ || !def || !def->body_get())
+      effects_ |= call_effects(def);
+  }
+
+  void EffectsVisitor::operator()(const ast::FieldVar& e)
+  {
+    super_type::operator()(e);
+    effects_ |= Effectful::reads | Effectful::diverges;
+  }
+
+  void EffectsVisitor::operator()(const ast::FunctionDec&)
+  {
+    // Declaring a function has no effect.
+  }
+
+  void EffectsVisitor::operator()(const ast::OpExp& e)
+  {
+    super_type::operator()(e);
+    if (e.oper_get() == ast::OpExp::Oper::div)
+      {
+        auto divisor = dynamic_cast<const ast::IntExp*>(&e.right_get());
+        if (!divisor || !divisor->value_get())
+          effects_ |= Effectful::diverges;
+      }
+  }
+
+  void EffectsVisitor::operator()(const ast::RecordExp& e)
+  {
+    super_type::operator()(e);
+    effects_ |= Effectful::allocates;
+  }
+
+  void EffectsVisitor::operator()(const ast::SimpleVar& e)
+  {
+    if (!declared_.has(e.def_get()))
+      effects_ |= Effectful::reads;
+  }
+
+  void EffectsVisitor::operator()(const ast::SubscriptVar& e)
+  {
+    super_type::operator()(e);
+    effects_ |= Effectful::reads | Effectful::diverges;
+  }
+
+  void EffectsVisitor::operator()(const ast::VarDec& e)
+  {
+    declared_.insert(&e);
+    super_type::operator()(e);
+  }
+
+  void EffectsVisitor::operator()(const ast::WhileExp& e)
+  {
+    super_type::operator()(e);
+    effects_ |= Effectful::diverges;
+  }
+
+} // namespace effects
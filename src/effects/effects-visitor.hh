@@ -0,0 +1,73 @@
+/**
+ ** \file effects/effects-visitor.hh
+ ** \brief Compute the effects of an expression.
+ */
+
+#pragma once
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <misc/set.hh>
+
+namespace effects
+{
+  /** \brief Compute the effects of an expression, or of the body of a
+   ** function.
+   **
+   ** A variable is "non local" if it is not declared in the visited
+   ** expression (or among the formals of the visited function).  Reading
+   ** or writing a field or an array element always counts, since records
+   ** and arrays may be shared.  Creating a record or an array allocates,
+   ** and creating an array of negative size fails.
+   **
+   ** The nested function declarations are not visited: declaring a
+   ** function has no effect.  The effects of a call are those stored in
+   ** the declaration of the callee; the calls to the functions with a
+   ** body may be skipped, to compute the effects of a function on its
+   ** own, before those of its callees are known.
+   **/
+  class EffectsVisitor
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    /// Super class type.
+    using super_type = ast::DefaultConstVisitor;
+    /// Import all the overloaded visit methods.
+    using super_type::operator();
+
+    /// Build a visitor, following the calls if \a calls.
+    explicit EffectsVisitor(bool calls = true);
+
+    /// Compute the effects of the body of \a fun, not counting its
+    /// calls to the functions with a body.
+    explicit EffectsVisitor(const ast::FunctionDec& fun);
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::RecordExp& e) override;
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::VarDec& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+    /// The effects found so far, as a set of ast::Effectful::effect.
+    unsigned effects_get() const;
+
+  private:
+    /// Whether to count the effects of the calls to functions with a body.
+    bool calls_;
+    /// The variables declared in the visited code.
+    misc::set<const ast::VarDec*> declared_;
+    /// The effects found so far.
+    unsigned effects_;
+  };
+
+} // namespace effects
@@ -0,0 +1,94 @@
+/**
+ ** \file effects/libeffects.cc
+ ** \brief Define exported effects functions.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <ast/all.hh>
+#include <callgraph/libcallgraph.hh>
+#include <effects/effects-visitor.hh>
+#include <effects/libeffects.hh>
+
+namespace effects
+{
+  using ast::Effectful;
+
+  unsigned primitive_effects(misc::symbol name)
+  {
+    static const std::map<std::string, unsigned> primitives = {
+      {"chr", Effectful::diverges},
+      {"concat", Effectful::pure},
+      {"exit", Effectful::io | Effectful::diverges},
+      {"flush", Effectful::io},
+      {"getchar", Effectful::io},
+      {"not", Effectful::pure},
+      {"ord", Effectful::pure},
+      {"print", Effectful::io},
+      {"print_err", Effectful::io},
+      {"print_int", Effectful::io},
+      {"size", Effectful::pure},
+      {"streq", Effectful::pure},
+      {"strcmp", Effectful::pure},
+      {"substring", Effectful::diverges},
+    };
+    auto i = primitives.find(name.get());
+    return i == primitives.end() ? Effectful::any : i->second;
+  }
+
+  unsigned call_effects(const ast::FunctionDec* fun)
+  {
+    if (!fun)
+      return Effectful::any;
+    if (!fun->body_get())
+      return primitive_effects(fun->name_get());
+    return fun->effects_get();
+  }
+
+  void effects_compute(ast::Ast& tree)
+  {
+    std::unique_ptr<callgraph::CallGraph> graph(
+      callgraph::callgraph_compute(tree));
+    const callgraph::FrozenCallGraph frozen = graph->freeze();
+    using vertex_type = callgraph::FrozenCallGraph::vertex_type;
+
+    // The vertices of each component.  The callees are in components
+    // with smaller numbers.
+    std::vector<vertex_type> component = frozen.components_get();
+    std::vector<std::vector<vertex_type>> members;
+    for (vertex_type v = 0; v < frozen.vertex_count(); ++v)
+      {
+        if (members.size() <= component[v])
+          members.resize(component[v] + 1);
+        members[component[v]].push_back(v);
+      }
+
+    for (const std::vector<vertex_type>& vertices : members)
+      {
+        unsigned effects = Effectful::pure;
+        for (vertex_type v : vertices)
+          {
+            effects |= EffectsVisitor(*frozen[v]).effects_get();
+            for (vertex_type w : frozen.successors_get(v))
+              if (component[w] != component[v])
+                effects |= frozen[w]->effects_get();
+              else
+                // Recursion.
+                effects |= Effectful::diverges;
+          }
+        for (vertex_type v : vertices)
+          frozen[v]->effects_set(effects);
+      }
+  }
+
+  unsigned effects_get(const ast::Exp& e)
+  {
+    EffectsVisitor effects;
+    e.accept(effects);
+    return effects.effects_get();
+  }
+
+} // namespace effects
@@ -0,0 +1,36 @@
+/**
+ ** \file effects/libeffects.hh
+ ** \brief Declare functions and variables exported by effects module.
+ */
+
+#pragma once
+
+#include <ast/fwd.hh>
+#include <misc/symbol.hh>
+
+/// Computing the side effects of functions and expressions.
+namespace effects
+{
+  /// The effects of the primitive \a name of the prelude, as a set of
+  /// ast::Effectful::effect.  Unknown primitives may do anything.
+  unsigned primitive_effects(misc::symbol name);
+
+  /// The effects of a call to \a fun: those of the primitive, or those
+  /// computed for the function.  A call to an unknown function (nullptr)
+  /// may do anything.
+  unsigned call_effects(const ast::FunctionDec* fun);
+
+  /// \brief Compute the effects of the functions of \a tree.
+  ///
+  /// The call graph is processed bottom-up, one strongly connected
+  /// component at a time: the effects of a function are its own, plus
+  /// those of its callees.  The functions of a recursive component
+  /// share their effects, and may not terminate.  The result is stored
+  /// in the declarations (see ast::Effectful).
+  void effects_compute(ast::Ast& tree);
+
+  /// The effects of evaluating \a e, as a set of ast::Effectful::effect,
+  /// once the effects of the functions are computed.
+  unsigned effects_get(const ast::Exp& e);
+
+} // namespace effects
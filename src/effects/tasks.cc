@@ -0,0 +1,27 @@
+/**
+ ** \file effects/tasks.cc
+ ** \brief Effects module related tasks' implementation.
+ */
+
+#include <ostream>
+
+#include <ast/libast.hh>
+#include <ast/tasks.hh>
+#include <effects/libeffects.hh>
+#define DEFINE_TASKS 1
+#include <effects/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace effects::tasks
+{
+  /*----------.
+    | Effects.  |
+    `----------*/
+
+  void effects_compute() { effects::effects_compute(*ast::tasks::the_program); }
+
+  // See escapes::tasks::escapes_display for why this is not a
+  // BOOLEAN_TASK_DECLARE.
+  void effects_display() { ast::effects_display(std::cout) = true; }
+
+} // namespace effects::tasks
@@ -0,0 +1,27 @@
+/**
+ ** \file effects/tasks.hh
+ ** \brief Effects module related tasks.
+ */
+
+#pragma once
+
+#include <task/libtask.hh>
+
+/// The Tasks of the effects module.
+namespace effects::tasks
+{
+  TASK_GROUP("3. Effects");
+
+  /// Compute the effects of the functions.
+  TASK_DECLARE("effects-compute",
+               "compute the side effects of the functions",
+               effects_compute,
+               "bindings-compute");
+
+  /// Display the effects of the functions.
+  TASK_DECLARE("effects-display",
+               "enable effects display in the AST",
+               effects_display,
+               "effects-compute");
+
+} // namespace effects::tasks
@@ -6,9 +6,14 @@
 #include <ast/all.hh>
 #include <escapes/escapes-visitor.hh>
 #include <misc/contract.hh>
+#include <misc/thread-pool.hh>
 
 namespace escapes
 {
+  EscapesVisitor::EscapesVisitor(unsigned jobs)
+    : jobs(jobs)
+  {}
+
   void EscapesVisitor::operator()(ast::LetExp& e)
   {
     scope++;
@@ -48,6 +53,14 @@ namespace escapes
     escape.scope_end();
     scope--;
   }
+  void EscapesVisitor::operator()(ast::FunctionChunk& e)
+  {
+    if (1 < jobs && !shard && 2 <= e.decs_get().size())
+      chunk_parallel(e);
+    else
+      super_type::operator()(e);
+  }
+
   void EscapesVisitor::operator()(ast::FunctionDec& e)
   {
     scope++;
@@ -78,8 +91,46 @@ namespace escapes
     auto it = escape.get(e.name_get());
     if (it.second != scope)
       {
-        it.first->escapable_set(true);
+        if (shard && it.second <= shard_scope)
+          outer_escapes.emplace_back(it.first);
+        else
+          it.first->escapable_set(true);
       }
   }
 
+  void EscapesVisitor::shard_visit(ast::FunctionDec& e)
+  {
+    shard = true;
+    shard_scope = scope;
+    e.accept(*this);
+    shard = false;
+  }
+
+  void EscapesVisitor::chunk_parallel(ast::FunctionChunk& e)
+  {
+    if (!pool)
+      pool = std::make_shared<misc::thread_pool>(jobs);
+
+    // Each shard starts from a copy of this visitor, which knows the
+    // variables visible from the chunk, and only sets the flags of its
+    // own variables.
+    auto& fundecs = e.decs_get();
+    std::vector<std::vector<ast::VarDec*>> outer(fundecs.size());
+    pool->parallel_for(fundecs.size(), [this, &fundecs, &outer](std::size_t i) {
+      EscapesVisitor shard(*this);
+      shard.shard_visit(*fundecs[i]);
+      outer[i] = shard.outer_escapes_get();
+    });
+
+    // Merge the escapes of the variables declared outside the chunk.
+    for (const std::vector<ast::VarDec*>& vs : outer)
+      for (ast::VarDec* v : vs)
+        v->escapable_set(true);
+  }
+
+  const std::vector<ast::VarDec*>& EscapesVisitor::outer_escapes_get() const
+  {
+    return outer_escapes;
+  }
+
 } // namespace escapes
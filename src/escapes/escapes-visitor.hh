@@ -22,10 +22,13 @@
 #pragma once
 
 #include <map>
+#include <memory>
+#include <vector>
 
 #include <ast/default-visitor.hh>
 #include <ast/non-object-visitor.hh>
 
+#include <misc/fwd.hh>
 #include <misc/scoped-map.hh>
 
 namespace escapes
@@ -55,17 +58,51 @@ namespace escapes
     /// Import all the overloaded visit methods.
     using super_type::operator();
 
+    /// \brief Build an EscapesVisitor.
+    ///
+    /// If \a jobs is greater than 1, the functions of a chunk declaring
+    /// several of them are visited in parallel: the outermost such
+    /// chunks, i.e., the top-level ones, and the ones nested in the
+    /// body of a lone `_main'.
+    explicit EscapesVisitor(unsigned jobs = 1);
+
     void operator()(ast::LetExp& e) override;
     void operator()(ast::WhileExp& e) override;
     void operator()(ast::ForExp& e) override;
     void operator()(ast::IfExp& e) override;
+    void operator()(ast::FunctionChunk& e) override;
     void operator()(ast::FunctionDec& e) override;
     void operator()(ast::VarDec& e) override;
     void operator()(ast::SimpleVar& e) override;
 
+    /// \brief Compute the escapes of the function \a e only.
+    ///
+    /// The visitor must already know the variables declared outside
+    /// \a e, i.e., be a copy of the one visiting its chunk.  Their
+    /// escapes are not set, since other shards may run concurrently:
+    /// they are recorded in outer_escapes_get() instead, to be merged
+    /// by the caller.
+    void shard_visit(ast::FunctionDec& e);
+    /// The variables declared outside the shard that escape.
+    const std::vector<ast::VarDec*>& outer_escapes_get() const;
+
   protected:
+    /// Visit the functions of \a e in parallel.
+    void chunk_parallel(ast::FunctionChunk& e);
+
     misc::scoped_map<misc::symbol, std::pair<ast::VarDec*, int>> escape;
     int scope = 0;
+    /// Number of threads allowed to visit functions.
+    unsigned jobs;
+    /// The threads, created on demand.
+    std::shared_ptr<misc::thread_pool> pool;
+    /// Whether we are computing a shard.
+    bool shard = false;
+    /// The scope of the chunk of the shard: the variables declared up
+    /// to this scope are outside of it.
+    int shard_scope = 0;
+    /// The escaping variables declared outside the shard.
+    std::vector<ast::VarDec*> outer_escapes;
   };
 
 } // namespace escapes
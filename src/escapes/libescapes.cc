@@ -3,15 +3,17 @@
  ** \brief Define exported escapes functions.
  */
 
+#include <ast/all.hh>
 #include <escapes/escapes-visitor.hh>
 #include <escapes/libescapes.hh>
+
 namespace escapes
 {
   /** Walk the tree, and set the escape flag of variables and arguments
       if they do escape. */
-  void escapes_compute(ast::Ast& tree)
+  void escapes_compute(ast::Ast& tree, unsigned jobs)
   {
-    EscapesVisitor escapes_compute;
+    EscapesVisitor escapes_compute(jobs);
     escapes_compute(tree);
   }
 
@@ -11,7 +11,12 @@
 /// Computing escape and static link related information.
 namespace escapes
 {
-  /// Compute the escaping variables.
-  void escapes_compute(ast::Ast& tree);
+  /// \brief Compute the escaping variables.
+  ///
+  /// If \a jobs is greater than 1, the functions of the outermost
+  /// chunks declaring several of them (the top-level ones, and those
+  /// nested in a lone `_main') are processed in parallel on \a jobs
+  /// threads.
+  void escapes_compute(ast::Ast& tree, unsigned jobs = 1);
 
 } // namespace escapes
@@ -12,6 +12,7 @@
 #include <escapes/tasks.hh>
 #undef DEFINE_TASKS
 #include <misc/xalloc.hh>
+#include <task/tasks.hh>
 
 namespace escapes::tasks
 {
@@ -20,7 +21,10 @@ namespace escapes::tasks
     | Static Link tasks.  |
     `--------------------*/
 
-  void escapes_compute() { escapes::escapes_compute(*ast::tasks::the_program); }
+  void escapes_compute()
+  {
+    escapes::escapes_compute(*ast::tasks::the_program, ::task::tasks::jobs);
+  }
 
   /* WARNING.  It is very tempting to use BOOLEAN_TASK_DECLARE with
      these stream flags, since it factors out the need for the
@@ -0,0 +1,219 @@
+/**
+ ** \file inlining/cost-model.cc
+ ** \brief Implementation of inlining::CostModel.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <callgraph/libcallgraph.hh>
+#include <inlining/cost-model.hh>
+
+namespace inlining
+{
+  namespace
+  {
+    /// Estimate the size of the functions, and collect their calls.
+    class SizeVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+      using infos_type =
+        std::unordered_map<const ast::FunctionDec*, CostModel::FunctionInfo>;
+
+      SizeVisitor(infos_type& infos, unsigned loop_weight)
+        : infos_(infos)
+        , loop_weight_(loop_weight)
+      {}
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        CostModel::FunctionInfo* save = current_;
+        unsigned save_depth = loop_depth_;
+        current_ = &infos_[&e];
+        loop_depth_ = 0;
+        super_type::operator()(e);
+        current_ = save;
+        loop_depth_ = save_depth;
+      }
+
+      void operator()(const ast::CallExp& e) override
+      {
+        count();
+        if (current_)
+          {
+            unsigned weight = 1;
+            for (unsigned i = 0; i < std::min(loop_depth_, 3u); ++i)
+              weight *= loop_weight_;
+            current_->sites.push_back({&e, e.def_get(), weight});
+          }
+        super_type::operator()(e);
+      }
+
+      void operator()(const ast::WhileExp& e) override
+      {
+        count();
+        ++loop_depth_;
+        super_type::operator()(e);
+        --loop_depth_;
+      }
+
+      void operator()(const ast::ForExp& e) override
+      {
+        count();
+        ++loop_depth_;
+        super_type::operator()(e);
+        --loop_depth_;
+      }
+
+      // The other nodes that produce code.
+      void operator()(const ast::SimpleVar& e) override { visit(e); }
+      void operator()(const ast::FieldVar& e) override { visit(e); }
+      void operator()(const ast::SubscriptVar& e) override { visit(e); }
+      void operator()(const ast::NilExp& e) override { visit(e); }
+      void operator()(const ast::IntExp& e) override { visit(e); }
+      void operator()(const ast::StringExp& e) override { visit(e); }
+      void operator()(const ast::OpExp& e) override { visit(e); }
+      void operator()(const ast::RecordExp& e) override { visit(e); }
+      void operator()(const ast::AssignExp& e) override { visit(e); }
+      void operator()(const ast::IfExp& e) override { visit(e); }
+      void operator()(const ast::BreakExp& e) override { visit(e); }
+      void operator()(const ast::ArrayExp& e) override { visit(e); }
+      void operator()(const ast::CastExp& e) override { visit(e); }
+      void operator()(const ast::VarDec& e) override { visit(e); }
+
+    private:
+      void count()
+      {
+        if (current_)
+          ++current_->size;
+      }
+
+      template <typename E> void visit(const E& e)
+      {
+        count();
+        super_type::operator()(e);
+      }
+
+      infos_type& infos_;
+      unsigned loop_weight_;
+      CostModel::FunctionInfo* current_ = nullptr;
+      unsigned loop_depth_ = 0;
+    };
+
+  } // namespace
+
+  CostModel::CostModel(const ast::Ast& tree, const InlineParams& params)
+  {
+    using vertex_type = callgraph::FrozenCallGraph::vertex_type;
+
+    SizeVisitor sizes(infos_, params.loop_weight);
+    tree.accept(sizes);
+
+    std::unique_ptr<const callgraph::CallGraph> graph(
+      callgraph::callgraph_compute(tree));
+    const callgraph::FrozenCallGraph frozen = graph->freeze();
+    const std::vector<vertex_type> components = frozen.components_get();
+
+    // A function is recursive iff it belongs to a cycle of the call
+    // graph, i.e., it calls itself, or its strongly connected component
+    // has several members.
+    std::vector<unsigned> component_sizes(frozen.vertex_count(), 0);
+    for (vertex_type c : components)
+      ++component_sizes[c];
+    for (vertex_type v = 0; v < frozen.vertex_count(); ++v)
+      if (1 < component_sizes[components[v]] || frozen.has_edge(v, v))
+        rec_funs_.insert(frozen[v]);
+
+    for (const auto& [f, info] : infos_)
+      stats_.size_before += info.size;
+    // In 64 bits: the product overflows for large programs or budgets.
+    const std::uint64_t budget =
+      std::uint64_t{stats_.size_before} * params.budget / 100;
+    std::uint64_t growth = 0;
+
+    // Bottom-up: the components are numbered callees first.
+    std::vector<vertex_type> order(frozen.vertex_count());
+    for (vertex_type v = 0; v < order.size(); ++v)
+      order[v] = v;
+    std::ranges::stable_sort(order, {}, [&components](vertex_type v) {
+      return components[v];
+    });
+
+    for (vertex_type v : order)
+      {
+        FunctionInfo& info = infos_[frozen[v]];
+        // Hot sites first, within this function only.
+        std::vector<CallSite> sites = info.sites;
+        std::ranges::stable_sort(sites, std::ranges::greater{},
+                                 &CallSite::weight);
+        for (const CallSite& site : sites)
+          {
+            ++stats_.sites;
+            if (!site.callee || !site.callee->body_get())
+              {
+                ++stats_.primitive;
+                continue;
+              }
+            if (rec_funs_.has(site.callee))
+              {
+                ++stats_.recursive;
+                continue;
+              }
+            unsigned size = infos_[site.callee].size;
+            if (std::uint64_t{params.threshold} * site.weight < size)
+              {
+                ++stats_.too_big;
+                continue;
+              }
+            if (budget < growth + size)
+              {
+                ++stats_.over_budget;
+                continue;
+              }
+            inlined_.insert(site.call);
+            ++stats_.inlined;
+            growth += size;
+            info.size += size;
+          }
+      }
+    stats_.size_after = stats_.size_before + growth;
+
+    if (params.stats)
+      *params.stats = stats_;
+  }
+
+  bool CostModel::inline_p(const ast::CallExp& e) const
+  {
+    return inlined_.has(&e);
+  }
+
+  const misc::set<const ast::FunctionDec*>& CostModel::rec_funs_get() const
+  {
+    return rec_funs_;
+  }
+
+  const InlineStats& CostModel::stats_get() const { return stats_; }
+
+  std::ostream& operator<<(std::ostream& ostr, const InlineStats& s)
+  {
+    return ostr << "/* Inlining statistics.  */\n"
+                << "call sites:    " << s.sites << '\n'
+                << "  inlined:     " << s.inlined << '\n'
+                << "  primitive:   " << s.primitive << '\n'
+                << "  recursive:   " << s.recursive << '\n'
+                << "  too big:     " << s.too_big << '\n'
+                << "  over budget: " << s.over_budget << '\n'
+                << "size:          " << s.size_before << " -> "
+                << s.size_after << '\n';
+  }
+
+} // namespace inlining
@@ -0,0 +1,115 @@
+/**
+ ** \file inlining/cost-model.hh
+ ** \brief Declaration of inlining::CostModel.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/fwd.hh>
+#include <misc/set.hh>
+
+namespace inlining
+{
+  /// What happened to the call sites during inline expansion.
+  struct InlineStats
+  {
+    /// Call sites within functions.
+    unsigned sites = 0;
+    /// Call sites that were expanded.
+    unsigned inlined = 0;
+    /// Call sites to primitives.
+    unsigned primitive = 0;
+    /// Call sites to recursive functions.
+    unsigned recursive = 0;
+    /// Call sites whose callee is above the threshold.
+    unsigned too_big = 0;
+    /// Call sites rejected because the budget was exhausted.
+    unsigned over_budget = 0;
+    /// Estimated size of the functions, in AST nodes, before and after.
+    unsigned size_before = 0;
+    unsigned size_after = 0;
+  };
+
+  /// Report \a s on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const InlineStats& s);
+
+  /// Parameters of the inlining policy.
+  struct InlineParams
+  {
+    /// Largest callee (in AST nodes) to expand at a cold call site.
+    unsigned threshold = 40;
+    /// How much the program may grow, in percents of its size.
+    unsigned budget = 100;
+    /// The threshold is multiplied by this factor for each enclosing
+    /// loop of the call site (up to three of them).
+    unsigned loop_weight = 4;
+    /// If not null, where to store the statistics.
+    InlineStats* stats = nullptr;
+  };
+
+  /** \brief Decide which call sites to expand.
+
+      The size of each function is estimated in one walk over the AST,
+      which also collects its call sites, weighted by their loop
+      nesting.  The call graph is then processed bottom-up (callees
+      first, by strongly connected components), so that the size of a
+      callee already accounts for the calls expanded in its body.
+
+      A call site is expanded if its callee is neither a primitive nor
+      recursive, if the callee is not larger than the threshold times
+      the weight of the site, and if the growth of the program stays
+      within the budget.  The budget is spent in the bottom-up order of
+      the functions, which the sizes of the callees require: the hot
+      sites are considered first within each function only, and a hot
+      site of a caller may find the budget exhausted by the colder sites
+      of its callees.  */
+  class CostModel
+  {
+  public:
+    /// Compute the decisions for \a tree.
+    CostModel(const ast::Ast& tree, const InlineParams& params);
+
+    /// Whether \a e should be expanded.
+    bool inline_p(const ast::CallExp& e) const;
+
+    /// \name Getters.
+    /// \{
+    const misc::set<const ast::FunctionDec*>& rec_funs_get() const;
+    const InlineStats& stats_get() const;
+    /// \}
+
+    /// A call, within a function.
+    struct CallSite
+    {
+      const ast::CallExp* call;
+      const ast::FunctionDec* callee;
+      /// How hot the site is: a power of the loop weight.
+      unsigned weight;
+    };
+
+    /// What we know about a function.
+    struct FunctionInfo
+    {
+      /// Estimated size of the body, in AST nodes, nested functions
+      /// excluded, expanded calls included.
+      unsigned size = 0;
+      /// The calls in the body, nested functions excluded.
+      std::vector<CallSite> sites;
+    };
+
+  private:
+    /// The per-function data.
+    std::unordered_map<const ast::FunctionDec*, FunctionInfo> infos_;
+    /// Recursive functions of the program.
+    misc::set<const ast::FunctionDec*> rec_funs_;
+    /// Call sites to expand.
+    misc::set<const ast::CallExp*> inlined_;
+    /// Statistics.
+    InlineStats stats_;
+  };
+
+} // namespace inlining
@@ -3,47 +3,171 @@
  ** \brief Implementation of inlining::Inliner.
  */
 
-#include <boost/graph/transitive_closure.hpp>
+#include <utility>
+#include <vector>
 
-#include <callgraph/libcallgraph.hh>
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
 #include <inlining/inliner.hh>
-#include <parse/libparse.hh>
-#include <parse/tweast.hh>
-#include <range/v3/view/iota.hpp>
 
 namespace inlining
 {
   using namespace ast;
 
-  Inliner::Inliner(const ast::Ast& tree)
+  Inliner::Inliner(const ast::Ast& tree, const InlineParams& params)
     : super_type()
-    , rec_funs_()
-  {
-    // Compute the transitive closure of the call graph to compute the
-    // set of recursive functions.
-    const callgraph::CallGraph* graph = callgraph::callgraph_compute(tree);
-    callgraph::CallGraph closure;
-    boost::transitive_closure(*graph, closure);
-
-    // Re-attach properties to the vertices.
-    for (auto [i, i_end] = boost::vertices(closure); i != i_end; ++i)
-      closure[*i] = (*graph)[*i];
-    // Detect recursive functions.
-    for (auto [i, i_end] = boost::vertices(closure); i != i_end; ++i)
+    , cost_(tree, params)
+  {}
+
+  const misc::set<const ast::FunctionDec*>& Inliner::rec_funs_get() const
+  {
+    return cost_.rec_funs_get();
+  }
+
+  const InlineStats& Inliner::stats_get() const { return cost_.stats_get(); }
+
+  /*---------------.
+  | Fresh names.  |
+  `---------------*/
+
+  namespace
+  {
+    /// Collect the declarations of an expression.
+    class DecsCollector
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        decs.emplace_back(&e);
+        super_type::operator()(e);
+      }
+
+      void operator()(const ast::TypeDec& e) override
       {
-        for (auto [j, j_end] = boost::adjacent_vertices(*i, closure);
-             j != j_end; ++j)
-          if (*i == *j)
-            rec_funs_.insert(closure[*i]);
+        decs.emplace_back(&e);
+        super_type::operator()(e);
       }
-    delete graph;
+
+      void operator()(const ast::VarDec& e) override
+      {
+        decs.emplace_back(&e);
+        super_type::operator()(e);
+      }
+
+      std::vector<const ast::Dec*> decs;
+    };
+
+  } // namespace
+
+  void Inliner::fresh_names(const ast::FunctionDec& callee)
+  {
+    DecsCollector collect;
+    for (const VarDec* formal : callee.formals_get())
+      collect.decs.emplace_back(formal);
+    callee.body_get()->accept(collect);
+    for (const Dec* dec : collect.decs)
+      fresh_[dec] = misc::symbol::fresh(dec->name_get());
   }
 
-  const misc::set<const ast::FunctionDec*>& Inliner::rec_funs_get() const
+  template <typename E> void Inliner::rename(const ast::Dec* def)
+  {
+    if (!expanding_)
+      return;
+    auto i = fresh_.find(def);
+    if (i != fresh_.end())
+      static_cast<E*>(result_)->name_set(i->second);
+  }
+
+  /*-------------.
+  | Expansion.  |
+  `-------------*/
+
+  /* Replace `f(arg_1, ..., arg_n)' with
+
+         let
+           var formal_1' : type_1 := arg_1
+           ...
+           var formal_n' : type_n := arg_n
+         in
+           body'
+         end
+
+     where the formals and the declarations of the body are given
+     fresh names, so that the identifiers remain unique when F is
+     expanded several times.  Since they are unique, the arguments
+     cannot be captured by the formals, nor the free variables of the
+     body by the declarations of the call site.  */
+  void Inliner::operator()(const ast::CallExp& e)
+  {
+    if (!cost_.inline_p(e))
+      {
+        super_type::operator()(e);
+        rename<CallExp>(e.def_get());
+        return;
+      }
+
+    const Location& location = e.location_get();
+    const FunctionDec& callee = *e.def_get();
+
+    // The arguments belong to the caller.
+    exps_type args;
+    for (const Exp* arg : e.args_get())
+      args.emplace_back(recurse(*arg));
+
+    // A nested function of the body may be expanded within it: its
+    // declaration keeps the names of the enclosing expansion.
+    auto names = fresh_;
+    fresh_names(callee);
+    ++expanding_;
+    auto formals = new VarChunk(location);
+    auto arg = args.begin();
+    for (const VarDec* formal : callee.formals_get())
+      formals->emplace_back(*new VarDec(location, fresh_.at(formal),
+                                        recurse(formal->type_name_get()),
+                                        *arg++));
+
+    auto chunks = new ChunkList(location);
+    chunks->emplace_back(formals);
+    Exp* body = recurse(*callee.body_get());
+    --expanding_;
+    fresh_ = std::move(names);
+    result_ = new LetExp(location, chunks, body);
+  }
+
+  void Inliner::operator()(const ast::FunctionDec& e)
   {
-    return rec_funs_;
+    super_type::operator()(e);
+    rename<FunctionDec>(&e);
   }
 
-  // FIXME: Some code was deleted here.
+  void Inliner::operator()(const ast::NameTy& e)
+  {
+    super_type::operator()(e);
+    rename<NameTy>(e.def_get());
+  }
+
+  void Inliner::operator()(const ast::SimpleVar& e)
+  {
+    super_type::operator()(e);
+    rename<SimpleVar>(e.def_get());
+  }
+
+  void Inliner::operator()(const ast::TypeDec& e)
+  {
+    super_type::operator()(e);
+    rename<TypeDec>(&e);
+  }
+
+  void Inliner::operator()(const ast::VarDec& e)
+  {
+    super_type::operator()(e);
+    rename<VarDec>(&e);
+  }
 
 } // namespace inlining
@@ -8,8 +8,10 @@
 #include <map>
 
 #include <astclone/cloner.hh>
+#include <inlining/cost-model.hh>
 #include <misc/scoped-map.hh>
 #include <misc/set.hh>
+#include <misc/symbol.hh>
 
 namespace inlining
 {
@@ -22,22 +24,41 @@ namespace inlining
     // Import overloaded virtual functions.
     using super_type::operator();
 
-    /// Build an Inliner.
-    Inliner(const ast::Ast& tree);
+    /// Build an Inliner, and decide which calls of \a tree to expand.
+    Inliner(const ast::Ast& tree, const InlineParams& params = {});
 
     /// \name Visit methods.
     /// \{
-    // FIXME: Some code was deleted here.
+    /// Expand \a e if the cost model says so.
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    void operator()(const ast::NameTy& e) override;
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::TypeDec& e) override;
+    void operator()(const ast::VarDec& e) override;
     /// \}
 
     /// \name Getters.
     /// \{
     const misc::set<const ast::FunctionDec*>& rec_funs_get() const;
+    const InlineStats& stats_get() const;
     /// \}
 
   private:
-    /// Recursive functions of the program.
-    misc::set<const ast::FunctionDec*> rec_funs_;
+    /// Give fresh names to the formals of \a callee, and to the
+    /// declarations of its body.
+    void fresh_names(const ast::FunctionDec& callee);
+    /// Within an expanded body, give the result the fresh name of
+    /// \a def, if it has one.
+    template <typename E> void rename(const ast::Dec* def);
+
+    /// The inlining decisions.
+    CostModel cost_;
+    /// The fresh names of the declarations of the bodies being
+    /// expanded.
+    std::map<const ast::Dec*, misc::symbol> fresh_;
+    /// The number of bodies being expanded.
+    unsigned expanding_ = 0;
   };
 
 } // namespace inlining
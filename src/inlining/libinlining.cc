@@ -17,10 +17,11 @@ namespace inlining
   | Inlining.  |
   `-----------*/
 
-  template <typename A> A* inline_expand(const A& tree)
+  template <typename A>
+  A* inline_expand(const A& tree, const InlineParams& params)
   {
     // Inline.
-    Inliner inline_expand(tree);
+    Inliner inline_expand(tree, params);
     inline_expand(tree);
     A* inlined = dynamic_cast<A*>(inline_expand.result_get());
     assertion(inlined);
@@ -30,7 +31,8 @@ namespace inlining
     return inlined_ptr.release();
   }
 
-  template ast::ChunkList* inline_expand(const ast::ChunkList&);
+  template ast::ChunkList* inline_expand(const ast::ChunkList&,
+                                         const InlineParams&);
 
   /*-------------------.
   | Function pruning.  |
@@ -39,7 +41,7 @@ namespace inlining
   template <typename A> A* prune(const A& tree)
   {
     // Prune unused functions.
-    Pruner prune;
+    Pruner prune(tree);
     prune(tree);
     A* pruned = dynamic_cast<A*>(prune.result_get());
     assertion(pruned);
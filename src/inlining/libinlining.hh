@@ -6,6 +6,7 @@
 #pragma once
 
 #include <ast/fwd.hh>
+#include <inlining/cost-model.hh>
 #include <misc/error.hh>
 
 /// Inlining functions of an ast::Ast.
@@ -17,14 +18,17 @@ namespace inlining
 
   /** Perform inline expansion of function bodies.
 
-      \param tree  abstract syntax tree's root, whose bindings and types
-                   have been computed.  Each identifier must also be unique
-                   within the AST to avoid name capture.
+      \param tree    abstract syntax tree's root, whose bindings and types
+                     have been computed.  Each identifier must also be
+                     unique within the AST to avoid name capture.
+      \param params  the inlining policy (see CostModel).
 
-      \return      the AST where the bodies of non recursive functions have
-                   been expanded (inlined), with bindings and type-checked.
+      \return        the AST where the calls to non recursive functions
+                     selected by the cost model have been expanded
+                     (inlined), with bindings and type-checked.
   */
-  template <typename A> A* inline_expand(const A& tree);
+  template <typename A>
+  A* inline_expand(const A& tree, const InlineParams& params);
 
   /*-------------------.
   | Function pruning.  |
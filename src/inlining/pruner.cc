@@ -3,32 +3,127 @@
  ** \brief Implementation of inlining::Pruner.
  */
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <callgraph/libcallgraph.hh>
 #include <inlining/pruner.hh>
-#include <range/v3/algorithm/remove_if.hpp>
 
 namespace inlining
 {
   using namespace ast;
 
-  ast::FunctionChunk* Pruner::prune(ast::FunctionChunk& e)
+  namespace
   {
-    while (true)
+    /// Collect the functions called outside of any function, e.g., in
+    /// the initialization of a top-level variable.  They do not appear
+    /// in the call graph, yet they are alive.
+    class OrphanCallsVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      void operator()(const ast::FunctionDec&) override {}
+
+      void operator()(const ast::CallExp& e) override
+      {
+        super_type::operator()(e);
+        if (e.def_get())
+          callees.emplace_back(e.def_get());
+      }
+
+      std::vector<const ast::FunctionDec*> callees;
+    };
+
+  } // namespace
+
+  Pruner::Pruner(const ast::Ast& tree)
+    : super_type()
+    , dead_funs_()
+  {
+    using vertex_type = callgraph::FrozenCallGraph::vertex_type;
+
+    std::unique_ptr<const callgraph::CallGraph> graph(
+      callgraph::callgraph_compute(tree));
+    const callgraph::FrozenCallGraph frozen = graph->freeze();
+
+    // Work on the strongly connected components, so that mutually
+    // recursive functions are freed together: the graph of the
+    // components is acyclic, hence reference counting is exact there.
+    const std::vector<vertex_type> components = frozen.components_get();
+    vertex_type ncomponents = 0;
+    for (vertex_type c : components)
+      ncomponents = std::max(ncomponents, c + 1);
+
+    std::vector<std::vector<vertex_type>> members(ncomponents);
+    for (vertex_type v = 0; v < frozen.vertex_count(); ++v)
+      members[components[v]].emplace_back(v);
+
+    // The number of calls into each component, from outside it.
+    std::vector<unsigned> count(ncomponents, 0);
+    for (vertex_type v = 0; v < frozen.vertex_count(); ++v)
+      for (vertex_type w : frozen.successors_get(v))
+        if (components[v] != components[w])
+          ++count[components[w]];
+
+    // The components that are alive no matter what.
+    std::vector<bool> pinned(ncomponents, false);
+    for (vertex_type v = 0; v < frozen.vertex_count(); ++v)
+      if (is_root(*frozen[v]))
+        pinned[components[v]] = true;
+    OrphanCallsVisitor orphans;
+    tree.accept(orphans);
+    for (const ast::FunctionDec* f : orphans.callees)
+      if (frozen.has_fundec(f))
+        pinned[components[frozen.hfundec_get(f)]] = true;
+
+    // Propagate the deaths.
+    std::vector<vertex_type> worklist;
+    for (vertex_type c = 0; c < ncomponents; ++c)
+      if (!count[c] && !pinned[c])
+        worklist.emplace_back(c);
+    while (!worklist.empty())
       {
-        auto it = ranges::remove_if(e, [&](ast::FunctionDec* func_dec) {
-          if (!func_dec->body_get() || func_dec->name_get() == "_main")
-            return false;
-          else
-            return called_functions_[func_dec->name_get()] == 0;
-        });
-
-        if (it == e.end())
-          break;
-        e.erase(it, e.end());
+        vertex_type c = worklist.back();
+        worklist.pop_back();
+        for (vertex_type v : members[c])
+          {
+            dead_funs_.insert(frozen[v]);
+            for (vertex_type w : frozen.successors_get(v))
+              {
+                vertex_type d = components[w];
+                if (d != c && !--count[d] && !pinned[d])
+                  worklist.emplace_back(d);
+              }
+          }
       }
+  }
 
-    return new FunctionChunk(e.location_get(), &e.decs_get());
+  bool Pruner::is_root(const ast::FunctionDec& f)
+  {
+    // Primitives have no body: they are never removed.
+    return !f.body_get() || f.name_get() == "_main";
   }
 
-  // FIXME: Some code was deleted here.
+  const misc::set<const ast::FunctionDec*>& Pruner::dead_funs_get() const
+  {
+    return dead_funs_;
+  }
+
+  void Pruner::operator()(const ast::FunctionChunk& e)
+  {
+    auto decs = new FunctionChunk::Ds;
+    for (const FunctionDec* f : e)
+      if (!dead_funs_.has(f))
+        decs->emplace_back(recurse(*f));
+    result_ = new FunctionChunk(e.location_get(), decs);
+  }
 
 } // namespace inlining
@@ -5,8 +5,6 @@
 
 #pragma once
 
-#include <map>
-
 #include <astclone/cloner.hh>
 #include <misc/set.hh>
 
@@ -21,22 +19,27 @@ namespace inlining
     // Import overloaded virtual functions.
     using super_type::operator();
 
-    using func_vect = std::vector<ast::FunctionDec*>;
-    using func_count = std::map<misc::symbol, int>;
+    /// Build a Pruner, and compute the functions of \a tree to remove.
+    Pruner(const ast::Ast& tree);
 
     /// \name Visit methods.
     /// \{
-    // FIXME: Some code was deleted here.
+    /// Clone the live functions of \a e only.
+    void operator()(const ast::FunctionChunk& e) override;
     /// \}
 
-    ast::FunctionChunk* prune(ast::FunctionChunk& e);
+    /// \name Getters.
+    /// \{
+    /// Functions unreachable from the roots of the program.
+    const misc::set<const ast::FunctionDec*>& dead_funs_get() const;
+    /// \}
 
   private:
-    // Need to keep the current function
-    const ast::FunctionDec* current_function_ = nullptr;
+    /// Whether \a f must be kept even if it is not called.
+    static bool is_root(const ast::FunctionDec& f);
 
-    // Associate function dec with the number of CallExp calling it
-    func_count called_functions_;
+    /// Functions to remove.
+    misc::set<const ast::FunctionDec*> dead_funs_;
   };
 
 } // namespace inlining
@@ -3,6 +3,8 @@
  ** \brief Inlining module related tasks' implementation.
  **/
 
+#include <iostream>
+
 #include <ast/tasks.hh>
 #include <astclone/libastclone.hh>
 #include <common.hh>
@@ -17,11 +19,24 @@ namespace inlining::tasks
   | Inlining.  |
   `-----------*/
 
+  int inline_threshold = InlineParams().threshold;
+  int inline_budget = InlineParams().budget;
+
+  /// The statistics of the last expansion.
+  static InlineStats stats;
+
   void inline_expand()
   {
-    astclone::apply(::inlining::inline_expand, ast::tasks::the_program);
+    InlineParams params;
+    params.threshold = inline_threshold;
+    params.budget = inline_budget;
+    params.stats = &stats;
+    astclone::apply(::inlining::inline_expand, ast::tasks::the_program,
+                    params);
   }
 
+  void inline_stats() { std::cout << stats; }
+
   /*-------------------.
   | Function pruning.  |
   `-------------------*/
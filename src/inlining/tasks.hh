@@ -17,12 +17,36 @@ namespace inlining::tasks
     | Inlining.  |
     `-----------*/
 
+  /// Largest callee to expand at a cold call site.
+  extern int inline_threshold;
+  INT_TASK_DECLARE("inline-threshold",
+                   0,
+                   1000000,
+                   "expand callees of up to NUM nodes (scaled up in loops)",
+                   inline_threshold,
+                   "");
+
+  /// Allowed growth of the program, in percents.
+  extern int inline_budget;
+  INT_TASK_DECLARE("inline-budget",
+                   0,
+                   1000000,
+                   "let inlining grow the program by NUM percents",
+                   inline_budget,
+                   "");
+
   /// Expand the body of functions at the call sites.
   TASK_DECLARE("inline",
                "inline functions",
                inline_expand,
                "types-compute rename");
 
+  /// Report what inlining did.
+  TASK_DECLARE("inline-stats",
+               "report inlining statistics",
+               inline_stats,
+               "inline");
+
   /*-------------------.
     | Function pruning.  |
     `-------------------*/
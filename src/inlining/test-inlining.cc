@@ -0,0 +1,68 @@
+/**
+ ** Checking the inlining cost model and the inline expansion.
+ */
+
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <bind/libbind.hh>
+#include <inlining/inliner.hh>
+#include <misc/contract.hh>
+#include <testing.hh>
+
+using namespace ast;
+using namespace inlining;
+
+const char* program_name = "test-inlining";
+
+// Expand the calls of \a body with \a params, and check the statistics
+// against \a expected.  The result must not declare a name twice.
+static void
+test_inline(const std::string& body, InlineParams params, InlineStats expected)
+{
+  ChunkList* tree =
+    testing::program_parse("function add(a : int, b : int) : int ="
+                           "   let var s := a + b in s end"
+                           " function fact(n : int) : int ="
+                           "   if n = 0 then 1 else n * fact(n - 1)",
+                           body);
+  testing::program_check(*tree);
+
+  InlineStats stats;
+  params.stats = &stats;
+  Inliner inline_expand(*tree, params);
+  inline_expand(*tree);
+  Ast* inlined = inline_expand.result_get();
+  std::cout << body << ":\n" << *inlined << '\n' << stats;
+  assertion(stats.inlined == expected.inlined);
+  assertion(stats.recursive == expected.recursive);
+  assertion(stats.too_big == expected.too_big);
+  assertion(stats.over_budget == expected.over_budget);
+  assertion(testing::unique_names_p(*inlined));
+  assertion(!bind::bind_compute(*inlined));
+  delete inlined;
+  delete tree;
+}
+
+int main()
+{
+  const std::string adds = "print_int(add(1, 2) + add(add(3, 4), 5))";
+  InlineParams params;
+
+  // The budget is computed without overflowing.  The recursive call
+  // of `fact' is never expanded.
+  params.budget = std::numeric_limits<unsigned>::max();
+  test_inline(adds, params, {.inlined = 3, .recursive = 1});
+  test_inline("print_int(fact(add(1, 2)))", params,
+              {.inlined = 1, .recursive = 2});
+
+  // Callees too big, or no budget.
+  params.threshold = 0;
+  test_inline(adds, params, {.recursive = 1, .too_big = 3});
+  params.threshold = 40;
+  params.budget = 0;
+  test_inline(adds, params, {.recursive = 1, .over_budget = 3});
+}
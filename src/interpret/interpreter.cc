@@ -0,0 +1,429 @@
+/**
+ ** \file interpret/interpreter.cc
+ ** \brief Implementation of interpret::Interpreter.
+ */
+
+#include <climits>
+#include <string>
+
+#include <ast/all.hh>
+#include <interpret/interpreter.hh>
+#include <misc/contract.hh>
+#include <misc/escape.hh>
+
+namespace interpret
+{
+  namespace
+  {
+    /// Whether \a cmp, the result of a three-way comparison, satisfies
+    /// \a oper.
+    bool compare(ast::OpExp::Oper oper, int cmp)
+    {
+      switch (oper)
+        {
+        case ast::OpExp::Oper::eq:
+          return cmp == 0;
+        case ast::OpExp::Oper::ne:
+          return cmp != 0;
+        case ast::OpExp::Oper::lt:
+          return cmp < 0;
+        case ast::OpExp::Oper::le:
+          return cmp <= 0;
+        case ast::OpExp::Oper::gt:
+          return cmp > 0;
+        case ast::OpExp::Oper::ge:
+          return cmp >= 0;
+        default:
+          unreachable();
+        }
+    }
+
+  } // namespace
+
+  Interpreter::Interpreter(const ast::ChunkList& tree,
+                           std::istream& in,
+                           std::ostream& out,
+                           std::ostream& err)
+    : tree_(tree)
+    , layout_(layout_compute(tree))
+    , runtime_(in, out, err)
+  {}
+
+  int Interpreter::run()
+  {
+    const ast::FunctionDec* main = nullptr;
+    for (const ast::ChunkInterface* chunk : tree_.chunks_get())
+      if (auto funs = dynamic_cast<const ast::FunctionChunk*>(chunk))
+        for (const ast::FunctionDec* fun : *funs)
+          if (fun->name_get() == "_main")
+            main = fun;
+    // A file of declarations does nothing.
+    if (!main)
+      return 0;
+
+    return runtime_.run([this, main] {
+      std::vector<value> args;
+      call(*main, args);
+    });
+  }
+
+  /*--------------.
+  | Evaluation.   |
+  `--------------*/
+
+  value Interpreter::eval(const ast::Exp& e)
+  {
+    e.accept(*this);
+    return std::move(result_);
+  }
+
+  int Interpreter::eval_int(const ast::Exp& e)
+  {
+    value res = eval(e);
+    // After a break, the value is whatever was left.
+    return breaking_ ? 0 : std::get<int>(res);
+  }
+
+  value& Interpreter::var_get(const ast::VarDec& e)
+  {
+    auto i = layout_.slots.find(&e);
+    assertion(i != layout_.slots.end());
+    const layout::slot& s = i->second;
+    if (!s.escapes)
+      return current_->locals[s.index];
+    interpret::frame* f = current_->frame;
+    unsigned depth = layout_.functions[s.function].depth;
+    for (unsigned hops = current_->depth - depth; hops; --hops)
+      f = f->link;
+    return f->slots[s.index];
+  }
+
+  value& Interpreter::lvalue_get(const ast::Var& e)
+  {
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e))
+      return var_get(*var->def_get());
+    if (auto field = dynamic_cast<const ast::FieldVar*>(&e))
+      return field_get(*field);
+    return element_get(dynamic_cast<const ast::SubscriptVar&>(e));
+  }
+
+  value& Interpreter::field_get(const ast::FieldVar& e)
+  {
+    value var = eval(e.var_get());
+    if (breaking_)
+      return discarded_;
+    object* record = std::get<object*>(var);
+    if (!record)
+      throw failure{"nil record dereference"};
+    return record->slots[layout_.fields.at(&e)];
+  }
+
+  value& Interpreter::element_get(const ast::SubscriptVar& e)
+  {
+    value var = eval(e.var_get());
+    if (breaking_)
+      return discarded_;
+    int index = eval_int(e.index_get());
+    if (breaking_)
+      return discarded_;
+    object* array = std::get<object*>(var);
+    if (!array)
+      throw failure{"nil array dereference"};
+    if (index < 0 || static_cast<unsigned>(index) >= array->slots.size())
+      throw failure{"index out of bounds"};
+    return array->slots[index];
+  }
+
+  /*--------.
+  | Calls.  |
+  `--------*/
+
+  value Interpreter::call(const ast::FunctionDec& fun, std::vector<value>& args)
+  {
+    if (!fun.body_get())
+      {
+        auto prim = layout_.primitives.find(&fun);
+        if (prim == layout_.primitives.end())
+          throw failure{"unknown primitive: " + fun.name_get().get()};
+        return runtime_.call(prim->second, args.data());
+      }
+
+    const layout::function& info = layout_.functions[layout_.indices.at(&fun)];
+    activation callee;
+    callee.locals.resize(info.locals);
+    interpret::frame* link = nullptr;
+    if (info.parent != -1)
+      {
+        // Follow the static links of the caller up to the frame of the
+        // enclosing function of the callee.
+        link = current_->frame;
+        unsigned depth = layout_.functions[info.parent].depth;
+        for (unsigned hops = current_->depth - depth; hops; --hops)
+          link = link->link;
+      }
+    if (!info.escaping.empty())
+      {
+        callee.own.link = link;
+        callee.own.slots.resize(info.escaping.size());
+        callee.frame = &callee.own;
+      }
+    else
+      callee.frame = link;
+    callee.depth = info.depth;
+
+    unsigned i = 0;
+    for (const ast::VarDec* formal : fun.formals_get())
+      {
+        const layout::slot& s = layout_.slots.at(formal);
+        (s.escapes ? callee.own.slots : callee.locals)[s.index] =
+          std::move(args[i++]);
+      }
+
+    activation* caller = current_;
+    current_ = &callee;
+    value res;
+    try
+      {
+        res = eval(*fun.body_get());
+      }
+    catch (...)
+      {
+        current_ = caller;
+        throw;
+      }
+    current_ = caller;
+    return res;
+  }
+
+  /*-------------------.
+  | Visiting methods.  |
+  `-------------------*/
+
+  void Interpreter::operator()(const ast::ArrayExp& e)
+  {
+    int size = eval_int(e.size_get());
+    if (breaking_)
+      return;
+    value init = eval(e.init_get());
+    if (breaking_)
+      return;
+    if (size < 0)
+      throw failure{"negative array size"};
+    object* array = runtime_.allocate(size);
+    for (value& element : array->slots)
+      element = init;
+    result_ = array;
+  }
+
+  void Interpreter::operator()(const ast::AssignExp& e)
+  {
+    value& place = lvalue_get(e.var_get());
+    if (breaking_)
+      return;
+    value val = eval(e.exp_get());
+    if (breaking_)
+      return;
+    place = std::move(val);
+    result_ = 0;
+  }
+
+  void Interpreter::operator()(const ast::BreakExp&)
+  {
+    breaking_ = true;
+    result_ = 0;
+  }
+
+  void Interpreter::operator()(const ast::CallExp& e)
+  {
+    std::vector<value> args;
+    args.reserve(e.args_get().size());
+    for (const ast::Exp* arg : e.args_get())
+      {
+        args.emplace_back(eval(*arg));
+        if (breaking_)
+          return;
+      }
+    result_ = call(*e.def_get(), args);
+  }
+
+  void Interpreter::operator()(const ast::CastExp& e)
+  {
+    result_ = eval(e.exp_get());
+  }
+
+  void Interpreter::operator()(const ast::FieldVar& e)
+  {
+    result_ = field_get(e);
+  }
+
+  void Interpreter::operator()(const ast::ForExp& e)
+  {
+    const ast::VarDec& index = e.vardec_get();
+    // A break in the bounds leaves the enclosing loop.
+    int lo = eval_int(*index.init_get());
+    if (breaking_)
+      return;
+    int hi = eval_int(e.hi_get());
+    if (breaking_)
+      return;
+    value& i = var_get(index);
+    // Stop on hi rather than after it, which may overflow.
+    if (lo <= hi)
+      for (int n = lo;; ++n)
+        {
+          i = n;
+          eval(e.body_get());
+          if (breaking_ || n == hi)
+            break;
+        }
+    breaking_ = false;
+    result_ = 0;
+  }
+
+  void Interpreter::operator()(const ast::FunctionChunk&)
+  {
+    // Declaring functions does nothing.
+  }
+
+  void Interpreter::operator()(const ast::IfExp& e)
+  {
+    int test = eval_int(e.get_test());
+    if (breaking_)
+      return;
+    if (test)
+      result_ = eval(e.get_thenclause());
+    else if (&e.get_elseclause())
+      result_ = eval(e.get_elseclause());
+    else
+      result_ = 0;
+  }
+
+  void Interpreter::operator()(const ast::IntExp& e) { result_ = e.value_get(); }
+
+  void Interpreter::operator()(const ast::LetExp& e)
+  {
+    e.chunklist_get().accept(*this);
+    if (breaking_)
+      return;
+    result_ = eval(e.exp_get());
+  }
+
+  void Interpreter::operator()(const ast::NilExp&)
+  {
+    result_ = static_cast<object*>(nullptr);
+  }
+
+  void Interpreter::operator()(const ast::OpExp& e)
+  {
+    using Oper = ast::OpExp::Oper;
+    value left = eval(e.left_get());
+    if (breaking_)
+      return;
+    value right = eval(e.right_get());
+    if (breaking_)
+      return;
+    Oper oper = e.oper_get();
+
+    if (oper != Oper::add && oper != Oper::sub && oper != Oper::mul
+        && oper != Oper::div)
+      {
+        result_ = compare(oper, order(left, right));
+        return;
+      }
+
+    // Wrap around on overflow, as the compiled code does.
+    int l = std::get<int>(left);
+    int r = std::get<int>(right);
+    auto lhs = static_cast<unsigned>(l);
+    auto rhs = static_cast<unsigned>(r);
+    switch (oper)
+      {
+      case Oper::add:
+        result_ = static_cast<int>(lhs + rhs);
+        break;
+      case Oper::sub:
+        result_ = static_cast<int>(lhs - rhs);
+        break;
+      case Oper::mul:
+        result_ = static_cast<int>(lhs * rhs);
+        break;
+      default:
+        if (!r)
+          throw failure{"division by zero"};
+        result_ = l == INT_MIN && r == -1 ? INT_MIN : l / r;
+      }
+  }
+
+  void Interpreter::operator()(const ast::RecordExp& e)
+  {
+    const ast::fieldinits_type& fields = e.get_fields();
+    object* record = runtime_.allocate(fields.size());
+    for (unsigned i = 0; i < fields.size(); ++i)
+      {
+        record->slots[i] = eval(fields[i]->init_get());
+        if (breaking_)
+          return;
+      }
+    result_ = record;
+  }
+
+  void Interpreter::operator()(const ast::SeqExp& e)
+  {
+    value res = 0;
+    for (const ast::Exp* exp : e.exps_get())
+      {
+        res = eval(*exp);
+        // The rest of the sequence is skipped.
+        if (breaking_)
+          break;
+      }
+    result_ = std::move(res);
+  }
+
+  void Interpreter::operator()(const ast::SimpleVar& e)
+  {
+    result_ = var_get(*e.def_get());
+  }
+
+  void Interpreter::operator()(const ast::StringExp& e)
+  {
+    auto [i, inserted] = strings_.try_emplace(&e);
+    if (inserted)
+      i->second = string_type::intern(misc::unescape(e.string_get()));
+    result_ = i->second;
+  }
+
+  void Interpreter::operator()(const ast::SubscriptVar& e)
+  {
+    result_ = element_get(e);
+  }
+
+  void Interpreter::operator()(const ast::TypeChunk&)
+  {
+    // Declaring types does nothing.
+  }
+
+  void Interpreter::operator()(const ast::VarChunk& e)
+  {
+    for (const ast::VarDec* var : e)
+      {
+        value init = eval(*var->init_get());
+        if (breaking_)
+          return;
+        var_get(*var) = std::move(init);
+      }
+  }
+
+  void Interpreter::operator()(const ast::WhileExp& e)
+  {
+    while (eval_int(e.test_get()) && !breaking_)
+      {
+        eval(e.body_get());
+        if (breaking_)
+          break;
+      }
+    breaking_ = false;
+    result_ = 0;
+  }
+
+} // namespace interpret
@@ -0,0 +1,131 @@
+/**
+ ** \file interpret/interpreter.hh
+ ** \brief Evaluate a bound and typed AST.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <interpret/layout.hh>
+#include <interpret/runtime.hh>
+#include <interpret/value.hh>
+
+namespace interpret
+{
+  /** \brief Evaluate a program by walking its AST.
+
+      Before running, the variables are given a slot in the activations
+      of their function (see layout): the non escaping variables live in
+      an array of locals, the escaping ones in a frame.  At run time, a
+      variable is found from its declaration (see
+      ast::SimpleVar::def_get), without looking its name up.
+
+      The primitives of the prelude and the heap are those of the
+      runtime (see Runtime).  */
+  class Interpreter
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    /// Super class type.
+    using super_type = ast::DefaultConstVisitor;
+    /// Import all the overloaded visit methods.
+    using super_type::operator();
+
+    /// Prepare the evaluation of \a tree, whose bindings, types and
+    /// escapes are computed.
+    Interpreter(const ast::ChunkList& tree, std::istream& in,
+                std::ostream& out, std::ostream& err);
+
+    /// Run the program, i.e., its `_main' function if any, and return
+    /// its exit status.  A runtime error is reported, and exits with
+    /// status 120.
+    int run();
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::BreakExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::CastExp& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::ForExp& e) override;
+    void operator()(const ast::FunctionChunk& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::IntExp& e) override;
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::NilExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::RecordExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::StringExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::TypeChunk& e) override;
+    void operator()(const ast::VarChunk& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+  private:
+    /// An activation of a function.
+    struct activation
+    {
+      /// The non escaping variables.
+      std::vector<value> locals;
+      /// The frame of the function, if it has escaping variables.
+      interpret::frame own;
+      /// The frame to reach the escaping variables from: own, or the
+      /// frame of an enclosing function.
+      interpret::frame* frame = nullptr;
+      /// The depth of the function.
+      unsigned depth = 0;
+    };
+
+    /// Evaluate \a e.
+    value eval(const ast::Exp& e);
+    /// Evaluate \a e, which is an integer.
+    int eval_int(const ast::Exp& e);
+
+    /// Where the variable \a e lives.
+    value& var_get(const ast::VarDec& e);
+    /// Where the store into \a e goes.
+    value& lvalue_get(const ast::Var& e);
+    /// The field of a record designated by \a e.
+    value& field_get(const ast::FieldVar& e);
+    /// The element of an array designated by \a e.
+    value& element_get(const ast::SubscriptVar& e);
+
+    /// Call \a fun with \a args.
+    value call(const ast::FunctionDec& fun, std::vector<value>& args);
+
+    /// The program.
+    const ast::ChunkList& tree_;
+    /// Its functions, variables and fields.
+    const layout layout_;
+    /// The primitives and the heap.
+    Runtime runtime_;
+
+    /// The string literals.
+    std::unordered_map<const ast::StringExp*, string_type> strings_;
+
+    /// The current activation.
+    activation* current_ = nullptr;
+    /// The value of the last evaluated expression.
+    value result_;
+    /// \brief Whether a `break' is leaving the innermost loop.
+    ///
+    /// Once set, each expression returns as soon as the evaluation of
+    /// one of its parts does, and the loop clears it.  Unlike an
+    /// exception, it costs nothing to the loops which do not break.
+    bool breaking_ = false;
+    /// What a store goes to when a `break' left its lvalue.
+    value discarded_;
+  };
+
+} // namespace interpret
@@ -0,0 +1,114 @@
+/**
+ ** \file interpret/layout.cc
+ ** \brief Implementation of interpret::layout_compute.
+ */
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <interpret/layout.hh>
+#include <misc/contract.hh>
+#include <type/record.hh>
+
+namespace interpret
+{
+  namespace
+  {
+    /// Give the functions their index, the variables their slot, and
+    /// the fields their index.
+    class Layout
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      explicit Layout(layout& res)
+        : res_(res)
+      {}
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        if (!e.body_get())
+          {
+            if (auto prim = primitive_get(e.name_get()))
+              res_.primitives[&e] = *prim;
+            return;
+          }
+        int index = res_.functions.size();
+        res_.indices[&e] = index;
+        layout::function& fun = res_.functions.emplace_back();
+        fun.dec = &e;
+        fun.parent = current_;
+
+        int outer = current_;
+        current_ = index;
+        e.formals_get().accept(*this);
+        e.body_get()->accept(*this);
+        current_ = outer;
+      }
+
+      void operator()(const ast::VarDec& e) override
+      {
+        precondition(current_ != -1);
+        layout::function& fun = res_.functions[current_];
+        layout::slot& s = res_.slots[&e];
+        s.function = current_;
+        s.escapes = e.escapable_get();
+        if (s.escapes)
+          {
+            s.index = fun.escaping.size();
+            fun.escaping.emplace_back(&e);
+          }
+        else
+          s.index = fun.locals++;
+        fun.variables.emplace_back(&e);
+        super_type::operator()(e);
+      }
+
+      void operator()(const ast::FieldVar& e) override
+      {
+        // The fields of a record are in the order of its type.
+        auto& record =
+          dynamic_cast<const type::Record&>(e.var_get().type_get()->actual());
+        int index = record.field_index(e.name_get());
+        assertion(0 <= index);
+        res_.fields[&e] = index;
+        super_type::operator()(e);
+      }
+
+      /// Compute the frames of the functions, once their escaping
+      /// variables are known.
+      void frames_compute()
+      {
+        // The enclosing functions come first.
+        for (unsigned i = 0; i < res_.functions.size(); ++i)
+          {
+            layout::function& fun = res_.functions[i];
+            const layout::function* parent =
+              fun.parent == -1 ? nullptr : &res_.functions[fun.parent];
+            bool own = !fun.escaping.empty();
+            fun.depth = (parent ? parent->depth : 0) + own;
+            fun.frame = own ? static_cast<int>(i) : parent ? parent->frame : -1;
+          }
+      }
+
+    private:
+      layout& res_;
+      /// The index of the function being laid out.
+      int current_ = -1;
+    };
+
+  } // namespace
+
+  layout layout_compute(const ast::Ast& tree)
+  {
+    layout res;
+    Layout lay(res);
+    tree.accept(lay);
+    lay.frames_compute();
+    return res;
+  }
+
+} // namespace interpret
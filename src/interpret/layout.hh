@@ -0,0 +1,77 @@
+/**
+ ** \file interpret/layout.hh
+ ** \brief Lay the functions of a program and their variables out.
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <ast/fwd.hh>
+#include <interpret/runtime.hh>
+
+namespace interpret
+{
+  /** \brief Where the functions of a program keep their variables.
+
+      The functions with a body are numbered in the order of the
+      program, hence the enclosing functions first.  The non escaping
+      variables of a function are its locals; the escaping ones live in
+      its frame, linked to the frame of its enclosing function, so that
+      the nested functions reach them.  A function without escaping
+      variables has no frame of its own, and lends the one of its
+      enclosing function.
+
+      The interpreter, the VM and the translation into C share it.  */
+  struct layout
+  {
+    /// A function with a body.
+    struct function
+    {
+      /// Its declaration.
+      const ast::FunctionDec* dec = nullptr;
+      /// The index of its enclosing function, or -1.
+      int parent = -1;
+      /// Its variables, the formals first, in the order of the program.
+      std::vector<const ast::VarDec*> variables;
+      /// The number of its non escaping variables.
+      unsigned locals = 0;
+      /// Its escaping variables, in the order of its frame.
+      std::vector<const ast::VarDec*> escaping;
+      /// The number of frames on the chain of static links, its own
+      /// included.
+      unsigned depth = 0;
+      /// The index of the function owning the frame it uses: itself if
+      /// it has escaping variables, otherwise that of its enclosing
+      /// function; -1 if none.
+      int frame = -1;
+    };
+
+    /// Where a variable lives.
+    struct slot
+    {
+      /// The index of the function which declares it.
+      int function = -1;
+      /// Whether it lives in the frame of its function.
+      bool escapes = false;
+      /// Its index in the locals or in the frame.
+      unsigned index = 0;
+    };
+
+    /// The functions with a body, and their index.
+    std::vector<function> functions;
+    std::unordered_map<const ast::FunctionDec*, int> indices;
+    /// The known primitives.
+    std::unordered_map<const ast::FunctionDec*, primitive> primitives;
+    /// The variables.
+    std::unordered_map<const ast::VarDec*, slot> slots;
+    /// The index of the accessed fields in the type of their record,
+    /// which is also their slot in the record.
+    std::unordered_map<const ast::FieldVar*, unsigned> fields;
+  };
+
+  /// Lay \a tree out, whose bindings, types and escapes are computed.
+  layout layout_compute(const ast::Ast& tree);
+
+} // namespace interpret
@@ -0,0 +1,18 @@
+/**
+ ** \file interpret/libinterpret.cc
+ ** \brief Define exported interpret functions.
+ */
+
+#include <interpret/interpreter.hh>
+#include <interpret/libinterpret.hh>
+
+namespace interpret
+{
+  int interpret(const ast::ChunkList& tree, std::istream& in,
+                std::ostream& out, std::ostream& err)
+  {
+    Interpreter interpreter(tree, in, out, err);
+    return interpreter.run();
+  }
+
+} // namespace interpret
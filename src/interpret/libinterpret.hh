@@ -0,0 +1,28 @@
+/**
+ ** \file interpret/libinterpret.hh
+ ** \brief Declare functions and variables exported by interpret module.
+ */
+
+#pragma once
+
+#include <iosfwd>
+
+#include <ast/fwd.hh>
+
+/// Running a program by evaluating its AST.
+namespace interpret
+{
+  /** \brief Run the program \a tree.
+
+      \param tree  the program, whose bindings, types and escapes have
+                   been computed.
+      \param in    the standard input of the program.
+      \param out   the standard output of the program.
+      \param err   the standard error output of the program.
+
+      \return the exit status of the program: the argument of `exit',
+              120 on a runtime error, and 0 otherwise.  */
+  int interpret(const ast::ChunkList& tree, std::istream& in,
+                std::ostream& out, std::ostream& err);
+
+} // namespace interpret
@@ -0,0 +1,162 @@
+/**
+ ** \file interpret/runtime.cc
+ ** \brief Implementation of interpret::Runtime.
+ */
+
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+
+#include <interpret/runtime.hh>
+#include <misc/contract.hh>
+
+namespace interpret
+{
+  const char* name_get(primitive prim)
+  {
+    static const char* const names[] = {
+#define INTERPRET_PRIMITIVE(Id, Name, Arity) Name,
+      INTERPRET_PRIMITIVES(INTERPRET_PRIMITIVE)
+#undef INTERPRET_PRIMITIVE
+    };
+    return names[static_cast<unsigned>(prim)];
+  }
+
+  unsigned arity_get(primitive prim)
+  {
+    static const unsigned arities[] = {
+#define INTERPRET_PRIMITIVE(Id, Name, Arity) Arity,
+      INTERPRET_PRIMITIVES(INTERPRET_PRIMITIVE)
+#undef INTERPRET_PRIMITIVE
+    };
+    return arities[static_cast<unsigned>(prim)];
+  }
+
+  std::optional<primitive> primitive_get(misc::symbol name)
+  {
+    static const std::unordered_map<std::string, primitive> primitives = {
+#define INTERPRET_PRIMITIVE(Id, Name, Arity) {Name, primitive::Id},
+      INTERPRET_PRIMITIVES(INTERPRET_PRIMITIVE)
+#undef INTERPRET_PRIMITIVE
+    };
+    auto i = primitives.find(name.get());
+    if (i == primitives.end())
+      return std::nullopt;
+    return i->second;
+  }
+
+  int order(const value& lhs, const value& rhs)
+  {
+    if (auto l = std::get_if<int>(&lhs))
+      {
+        int r = std::get<int>(rhs);
+        return (*l > r) - (*l < r);
+      }
+    if (auto l = std::get_if<string_type>(&lhs))
+      {
+        int cmp = l->compare(std::get<string_type>(rhs));
+        return (0 < cmp) - (cmp < 0);
+      }
+    return std::get<object*>(lhs) != std::get<object*>(rhs);
+  }
+
+  Runtime::Runtime(std::istream& in, std::ostream& out, std::ostream& err)
+    : in_(in)
+    , out_(out)
+    , err_(err)
+  {}
+
+  int Runtime::run(const std::function<void()>& main)
+  {
+    int status = 0;
+    try
+      {
+        main();
+      }
+    catch (const exit_signal& e)
+      {
+        status = e.status;
+      }
+    catch (const failure& e)
+      {
+        out_.flush();
+        err_ << e.message << '\n';
+        status = 120;
+      }
+    out_.flush();
+    return status;
+  }
+
+  object* Runtime::allocate(std::size_t size)
+  {
+    heap_size_ += sizeof (object) + size * sizeof (value);
+    if (heap_max < heap_size_)
+      throw failure{"out of memory"};
+    object& res = heap_.emplace_back();
+    res.slots.resize(size);
+    return &res;
+  }
+
+  value Runtime::call(primitive prim, const value* args)
+  {
+    auto str = [args](unsigned i) -> const string_type& {
+      return std::get<string_type>(args[i]);
+    };
+    auto num = [args](unsigned i) { return std::get<int>(args[i]); };
+
+    switch (prim)
+      {
+      case primitive::print:
+        out_ << str(0);
+        return 0;
+      case primitive::print_err:
+        out_.flush();
+        err_ << str(0);
+        return 0;
+      case primitive::print_int:
+        out_ << num(0);
+        return 0;
+      case primitive::flush:
+        out_.flush();
+        return 0;
+      case primitive::getchar:
+        {
+          int c = in_.get();
+          if (c == std::char_traits<char>::eof())
+            return string_type();
+          return string_type(std::string(1, static_cast<char>(c)));
+        }
+      case primitive::ord:
+        return str(0).empty() ? -1 : static_cast<unsigned char>(str(0)[0]);
+      case primitive::chr:
+        if (num(0) < 0 || 255 < num(0))
+          throw failure{"chr: character out of range"};
+        return string_type(std::string(1, static_cast<char>(num(0))));
+      case primitive::size:
+        return static_cast<int>(str(0).size());
+      case primitive::streq:
+        return str(0) == str(1);
+      case primitive::strcmp:
+        return order(args[0], args[1]);
+      case primitive::substring:
+        {
+          const string_type& s = str(0);
+          long long start = num(1);
+          long long length = num(2);
+          if (start < 0 || length < 0
+              || start + length > static_cast<long long>(s.size()))
+            throw failure{"substring: arguments out of bounds"};
+          return s.substr(start, length);
+        }
+      case primitive::concat:
+        return str(0) + str(1);
+      case primitive::not_:
+        return !num(0);
+      case primitive::exit:
+        throw exit_signal{num(0)};
+      default:
+        unreachable();
+      }
+  }
+
+} // namespace interpret
@@ -0,0 +1,101 @@
+/**
+ ** \file interpret/runtime.hh
+ ** \brief The runtime shared by the interpreter and the VM.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+#include <interpret/value.hh>
+#include <misc/symbol.hh>
+
+namespace interpret
+{
+  /// The primitives of the prelude: their identifier, name and arity.
+#define INTERPRET_PRIMITIVES(X)                                         \
+  X(print, "print", 1)                                                  \
+  X(print_err, "print_err", 1)                                          \
+  X(print_int, "print_int", 1)                                          \
+  X(flush, "flush", 0)                                                  \
+  X(getchar, "getchar", 0)                                              \
+  X(ord, "ord", 1)                                                      \
+  X(chr, "chr", 1)                                                      \
+  X(size, "size", 1)                                                    \
+  X(streq, "streq", 2)                                                  \
+  X(strcmp, "strcmp", 2)                                                \
+  X(substring, "substring", 3)                                          \
+  X(concat, "concat", 2)                                                \
+  X(not_, "not", 1)                                                     \
+  X(exit, "exit", 1)
+
+  /// A primitive.
+  enum class primitive : unsigned char
+  {
+#define INTERPRET_PRIMITIVE(Id, Name, Arity) Id,
+    INTERPRET_PRIMITIVES(INTERPRET_PRIMITIVE)
+#undef INTERPRET_PRIMITIVE
+  };
+
+  /// The name of \a prim.
+  const char* name_get(primitive prim);
+  /// The number of arguments of \a prim.
+  unsigned arity_get(primitive prim);
+  /// The primitive named \a name, if any.
+  std::optional<primitive> primitive_get(misc::symbol name);
+
+  /// Leave the program.
+  struct exit_signal
+  {
+    int status;
+  };
+
+  /// A runtime error.
+  struct failure
+  {
+    std::string message;
+  };
+
+  /// Compare \a lhs and \a rhs: -1, 0 or 1 for integers and strings,
+  /// 0 or 1 for records and arrays, compared by address.
+  int order(const value& lhs, const value& rhs);
+
+  /** \brief The heap and the primitives of a running program.
+
+      The records and the arrays are never freed before the runtime,
+      and their memory is bounded by heap_max.  */
+  class Runtime
+  {
+  public:
+    /// Run on the given standard streams.
+    Runtime(std::istream& in, std::ostream& out, std::ostream& err);
+
+    /// Run \a main, and return the exit status of the program: the
+    /// argument of `exit', 120 on a runtime error, which is reported,
+    /// and 0 otherwise.
+    int run(const std::function<void()>& main);
+
+    /// Call the primitive \a prim on \a args.
+    value call(primitive prim, const value* args);
+
+    /// Allocate an object of \a size slots.
+    object* allocate(std::size_t size);
+
+  private:
+    /// The standard streams of the program.
+    std::istream& in_;
+    std::ostream& out_;
+    std::ostream& err_;
+
+    /// The records and the arrays, never collected.
+    std::deque<object> heap_;
+    /// The memory they hold, bounded by heap_max.
+    std::size_t heap_size_ = 0;
+  };
+
+} // namespace interpret
@@ -0,0 +1,30 @@
+/**
+ ** \file interpret/tasks.cc
+ ** \brief Interpret module related tasks' implementation.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <ast/tasks.hh>
+#include <interpret/libinterpret.hh>
+#define DEFINE_TASKS 1
+#include <interpret/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace interpret::tasks
+{
+  /*-----------------.
+    | Interpretation.  |
+    `-----------------*/
+
+  void interpret()
+  {
+    int status = ::interpret::interpret(*ast::tasks::the_program, std::cin,
+                                        std::cout, std::cerr);
+    // Exit as the program did.
+    if (status)
+      std::exit(status);
+  }
+
+} // namespace interpret::tasks
@@ -0,0 +1,22 @@
+/**
+ ** \file interpret/tasks.hh
+ ** \brief Interpret module related tasks.
+ */
+
+#pragma once
+
+#include <task/libtask.hh>
+
+/// The Tasks of the interpret module.
+namespace interpret::tasks
+{
+  TASK_GROUP("Interpretation");
+
+  /// Run the program.
+  TASK_DECLARE("interpret",
+               "run the program by evaluating its AST (the heap is "
+               "not collected, and is bounded to 1 GB)",
+               interpret,
+               "types-compute escapes-compute");
+
+} // namespace interpret::tasks
@@ -0,0 +1,124 @@
+/**
+ ** Checking the interpreter.
+ */
+
+#include <memory>
+#include <string>
+
+#include <ast/all.hh>
+#include <misc/contract.hh>
+#include <testing.hh>
+
+using namespace ast;
+
+const char* program_name = "test-interpret";
+
+// Run \a body, and check that it prints \a output and exits with
+// \a status.
+static void test_interpret(const std::string& body,
+                           const std::string& output, int status = 0)
+{
+  std::unique_ptr<ChunkList> tree(testing::program_compute(body));
+  testing::run_check(body, testing::program_interpret(*tree),
+                     {status, output});
+}
+
+int main()
+{
+  // The escapes are decoded once, when the literal is interned.
+  test_interpret("print(\"a\\tb\\n\\\\\\\"\\101\\x42\\n\")",
+                 "a\tb\n\\\"AB\n");
+  test_interpret("print_int(size(\"\\n\\\\\\x41\"))", "3");
+
+  // The fields are found by their index in the type of the record.
+  test_interpret("let type p = {x : int, y : int}"
+                 "    type q = {n : string, p : p}"
+                 "    var v := q{n = \"n\", p = p{x = 1, y = 2}} "
+                 "in v.p.y := v.p.y + 3; print_int(v.p.y); print_int(v.p.x);"
+                 "   print(v.n) end",
+                 "51n");
+  test_interpret("let type l = {x : int, n : l} var v := l{x = 1, n = nil} "
+                 "in print_int(v.x); print_int(v.n.x) end",
+                 "1", 120);
+
+  // Calls and recursion.
+  test_interpret("let function fact(n : int) : int ="
+                 "      if n = 0 then 1 else n * fact(n - 1) "
+                 "in print_int(fact(10)) end",
+                 "3628800");
+  test_interpret("let function fib(n : int) : int ="
+                 "      if n < 2 then n else fib(n - 1) + fib(n - 2) "
+                 "in print_int(fib(20)) end",
+                 "6765");
+  test_interpret("let function f(a : int, b : int, c : int) : int ="
+                 "      a * 100 + b * 10 + c "
+                 "in print_int(f(f(0, 0, 1), 2, 3)) end",
+                 "123");
+
+  // The static links reach the escaping variables of the enclosing
+  // functions, several levels up, and the frames outlive nothing.
+  test_interpret("let var n := 0"
+                 "    function inc() = n := n + 1 "
+                 "in inc(); inc(); print_int(n) end",
+                 "2");
+  test_interpret("let function f(x : int) : int ="
+                 "      let function g(y : int) : int ="
+                 "            let function h() : int = x * 10 + y"
+                 "            in h() end"
+                 "      in g(x + 1) end "
+                 "in print_int(f(1)); print_int(f(4)) end",
+                 "1245");
+  test_interpret("let function count(n : int) : int ="
+                 "      let var calls := 0"
+                 "          function down(i : int) ="
+                 "            (calls := calls + 1;"
+                 "             if i > 0 then down(i - 1))"
+                 "      in down(n); calls end "
+                 "in print_int(count(3)); print_int(count(5)) end",
+                 "46");
+
+  // Loops, and the loop a break leaves.
+  test_interpret("for i := 1 to 10 do (if i = 4 then break; print_int(i))",
+                 "123");
+  test_interpret("let var i := 0 "
+                 "in while 1 do (i := i + 1; if i > 3 then break;"
+                 "                print_int(i)) end",
+                 "123");
+  test_interpret("for i := 1 to 3 do"
+                 "  (for j := 1 to 3 do"
+                 "     (if j > i then break; print_int(j));"
+                 "   print(\"/\"))",
+                 "1/12/123/");
+  test_interpret("while 1 do let var x := 1 in print_int(x); break end",
+                 "1");
+  test_interpret("for i := 1 to 3 do"
+                 "  (print_int(i); if i = 2 then (break; print(\"x\")))",
+                 "12");
+  test_interpret("for i := 1 to 0 do print_int(i)", "");
+
+  // Arrays, and their bounds.
+  test_interpret("let type a = array of int"
+                 "    var v := a [5] of 1 "
+                 "in v[2] := 7; for i := 0 to 4 do print_int(v[i]) end",
+                 "11711");
+  test_interpret("let type a = array of int"
+                 "    type m = array of a"
+                 "    var v := m [2] of a [2] of 0 "
+                 "in v[1][1] := 3; print_int(v[0][1]); print_int(v[1][1]) end",
+                 "33");
+  test_interpret("let type a = array of int"
+                 "    var v := a [3] of 0 "
+                 "in print_int(v[2]); print_int(v[3]) end",
+                 "0", 120);
+  test_interpret("let type a = array of int"
+                 "    var v := a [3] of 0 "
+                 "in print_int(v[-1]) end",
+                 "", 120);
+  test_interpret("let type a = array of int"
+                 "    var v := a [-1] of 0 "
+                 "in end",
+                 "", 120);
+
+  // The status is the one given to exit.
+  test_interpret("(print_int(1); exit(3); print_int(2))", "1", 3);
+}
@@ -0,0 +1,48 @@
+/**
+ ** \file interpret/value.hh
+ ** \brief The values handled by the interpreter.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <variant>
+#include <vector>
+
+#include <misc/rope.hh>
+
+namespace interpret
+{
+  struct object;
+
+  /// A string.  Strings are immutable ropes: concatenating them shares
+  /// their characters instead of copying them.
+  using string_type = misc::rope;
+
+  /// A Tiger value: an integer, a string, or a record or an array
+  /// (nil is the null object).  Procedures return 0.
+  using value = std::variant<int, string_type, object*>;
+
+  /// A record or an array.
+  struct object
+  {
+    /// The fields, in the order of their declaration, or the elements.
+    std::vector<value> slots;
+  };
+
+  /// The bound on the memory held by the records and the arrays, in
+  /// bytes.  The interpreter and the VM never collect their heap: a
+  /// program allocating more fails with "out of memory", instead of
+  /// exhausting the memory of tc.
+  inline constexpr std::size_t heap_max = std::size_t{1} << 30;
+
+  /// The escaping variables of an activation of a function.
+  struct frame
+  {
+    /// The frame of the enclosing function.
+    frame* link = nullptr;
+    /// The variables.
+    std::vector<value> slots;
+  };
+
+} // namespace interpret
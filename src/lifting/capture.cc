@@ -0,0 +1,196 @@
+/**
+ ** \file lifting/capture.cc
+ ** \brief Implementation of lifting::Capture.
+ */
+
+#include <algorithm>
+#include <ostream>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <lifting/capture.hh>
+#include <type/builtin-types.hh>
+#include <type/type.hh>
+
+namespace lifting
+{
+  namespace
+  {
+    /// Append \a t to \a ts unless it is already there.
+    template <typename T> bool add(std::vector<T>& ts, T t)
+    {
+      if (std::find(ts.begin(), ts.end(), t) != ts.end())
+        return false;
+      ts.emplace_back(t);
+      return true;
+    }
+
+    /// Collect the variables used and the functions called by each
+    /// function, and the assigned variables.
+    class CaptureVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+      using infos_type =
+        std::unordered_map<const ast::FunctionDec*, Capture::FunctionInfo>;
+
+      explicit CaptureVisitor(infos_type& infos)
+        : infos_(infos)
+      {}
+
+      void operator()(const ast::LetExp& e) override
+      {
+        ++let_depth_;
+        super_type::operator()(e);
+        --let_depth_;
+      }
+
+      void operator()(const ast::FunctionDec& e) override
+      {
+        const ast::FunctionDec* save = current_;
+        current_ = &e;
+        infos_[&e].nested = let_depth_ > 0;
+        functions.emplace_back(&e);
+        super_type::operator()(e);
+        current_ = save;
+      }
+
+      void operator()(const ast::VarDec& e) override
+      {
+        owners[&e] = current_;
+        super_type::operator()(e);
+      }
+
+      void operator()(const ast::SimpleVar& e) override
+      {
+        const ast::VarDec* def = e.def_get();
+        auto owner = owners.find(def);
+        if (current_ && owner != owners.end() && owner->second
+            && owner->second != current_ && !Capture::unit_p(*def))
+          {
+            captured.insert(def);
+            add(infos_[current_].captured, def);
+          }
+      }
+
+      void operator()(const ast::AssignExp& e) override
+      {
+        if (auto var = dynamic_cast<const ast::SimpleVar*>(&e.var_get()))
+          assigned.insert(var->def_get());
+        super_type::operator()(e);
+      }
+
+      void operator()(const ast::CallExp& e) override
+      {
+        if (current_ && e.def_get() && e.def_get()->body_get())
+          add(infos_[current_].callees,
+              static_cast<const ast::FunctionDec*>(e.def_get()));
+        super_type::operator()(e);
+      }
+
+      /// The functions, in the order of the program.
+      std::vector<const ast::FunctionDec*> functions;
+      /// The function declaring each variable, null for the globals.
+      std::unordered_map<const ast::VarDec*, const ast::FunctionDec*> owners;
+      /// The variables used by a nested function.
+      misc::set<const ast::VarDec*> captured;
+      /// The variables assigned somewhere.
+      misc::set<const ast::VarDec*> assigned;
+
+    private:
+      infos_type& infos_;
+      const ast::FunctionDec* current_ = nullptr;
+      unsigned let_depth_ = 0;
+    };
+
+  } // namespace
+
+  Capture::Capture(const ast::Ast& tree)
+  {
+    CaptureVisitor walk(infos_);
+    tree.accept(walk);
+
+    // A function passes on the variables captured by the nested
+    // functions it calls, save its own.
+    for (bool changed = true; changed;)
+      {
+        changed = false;
+        for (const ast::FunctionDec* f : walk.functions)
+          for (const ast::FunctionDec* g : infos_[f].callees)
+            {
+              const FunctionInfo& callee = infos_[g];
+              if (!callee.nested)
+                continue;
+              // Index based: F may call itself.
+              for (size_t i = 0; i < callee.captured.size(); ++i)
+                {
+                  const ast::VarDec* v = callee.captured[i];
+                  if (walk.owners.at(v) != f && add(infos_[f].captured, v))
+                    changed = true;
+                }
+            }
+      }
+
+    for (const ast::VarDec* v : walk.captured)
+      if (walk.assigned.has(v))
+        boxed_.insert(v);
+
+    for (const ast::FunctionDec* f : walk.functions)
+      {
+        const FunctionInfo& info = infos_[f];
+        if (!info.nested)
+          continue;
+        ++stats_.functions;
+        stats_.parameters += info.captured.size();
+        if (std::any_of(info.captured.begin(), info.captured.end(),
+                        [this](const ast::VarDec* v) {
+                          return boxed_.has(v);
+                        }))
+          ++stats_.converted;
+        else
+          ++stats_.lifted;
+      }
+    stats_.boxed = boxed_.size();
+  }
+
+  bool Capture::nested_p(const ast::FunctionDec& f) const
+  {
+    auto i = infos_.find(&f);
+    return i != infos_.end() && i->second.nested;
+  }
+
+  const std::vector<const ast::VarDec*>&
+  Capture::captured_get(const ast::FunctionDec& f) const
+  {
+    return infos_.at(&f).captured;
+  }
+
+  bool Capture::boxed_p(const ast::VarDec& v) const
+  {
+    return boxed_.has(&v);
+  }
+
+  bool Capture::unit_p(const ast::VarDec& v)
+  {
+    if (v.type_name_get() || !v.type_get())
+      return false;
+    return dynamic_cast<const type::Void*>(&v.type_get()->actual());
+  }
+
+  const LiftStats& Capture::stats_get() const { return stats_; }
+
+  std::ostream& operator<<(std::ostream& ostr, const LiftStats& s)
+  {
+    return ostr << "/* Lambda lifting statistics.  */\n"
+                << "nested functions:    " << s.functions << '\n'
+                << "  lifted:            " << s.lifted << '\n'
+                << "  closure-converted: " << s.converted << '\n'
+                << "parameters added:    " << s.parameters << '\n'
+                << "boxed variables:     " << s.boxed << '\n';
+  }
+
+} // namespace lifting
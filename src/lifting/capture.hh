@@ -0,0 +1,93 @@
+/**
+ ** \file lifting/capture.hh
+ ** \brief Declaration of lifting::Capture.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/fwd.hh>
+#include <misc/set.hh>
+
+namespace lifting
+{
+  /// What happened to the nested functions during lambda lifting.
+  struct LiftStats
+  {
+    /// Functions declared within a `let'.
+    unsigned functions = 0;
+    /// Nested functions lifted with their free variables as parameters.
+    unsigned lifted = 0;
+    /// Nested functions that also receive environment records.
+    unsigned converted = 0;
+    /// Parameters added to the lifted functions.
+    unsigned parameters = 0;
+    /// Variables moved into an environment record.
+    unsigned boxed = 0;
+  };
+
+  /// Report \a s on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const LiftStats& s);
+
+  /** \brief Compute what the nested functions capture.
+
+      A variable escapes when a function nested in the one declaring it
+      uses it: these are the variables escapes-compute marks, but
+      lifting also needs to know which functions capture them.  The
+      variables a function captures are the ones it uses directly, and
+      the ones captured by the nested functions it calls, which it must
+      pass on once they are lifted: they are computed up to a fixed
+      point over the calls.
+
+      A captured variable that is never assigned can be passed by value
+      to the lifted functions.  One that is assigned must be shared by
+      its function and the nested ones: it is truly escaping, and goes
+      into an environment record, passed by reference.  The variables
+      of type void are not captured, since they have a single value.  */
+  class Capture
+  {
+  public:
+    /// Compute the captures of \a tree, whose bindings and types are
+    /// computed.
+    explicit Capture(const ast::Ast& tree);
+
+    /// Whether \a f is declared within a `let', and is to be lifted.
+    bool nested_p(const ast::FunctionDec& f) const;
+    /// The variables of the enclosing functions used by \a f, directly
+    /// or through calls, in a stable order.
+    const std::vector<const ast::VarDec*>&
+    captured_get(const ast::FunctionDec& f) const;
+    /// Whether \a v must be stored in an environment record.
+    bool boxed_p(const ast::VarDec& v) const;
+    /// Whether \a v has type void.
+    static bool unit_p(const ast::VarDec& v);
+
+    /// \name Getters.
+    /// \{
+    const LiftStats& stats_get() const;
+    /// \}
+
+    /// What we know about a function.
+    struct FunctionInfo
+    {
+      /// Whether it is declared within a `let'.
+      bool nested = false;
+      /// The variables of the enclosing functions it captures.
+      std::vector<const ast::VarDec*> captured;
+      /// The functions it calls, nested functions excluded.
+      std::vector<const ast::FunctionDec*> callees;
+    };
+
+  private:
+    /// The per-function data.
+    std::unordered_map<const ast::FunctionDec*, FunctionInfo> infos_;
+    /// The variables to store in an environment record.
+    misc::set<const ast::VarDec*> boxed_;
+    /// Statistics.
+    LiftStats stats_;
+  };
+
+} // namespace lifting
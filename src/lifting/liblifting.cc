@@ -0,0 +1,32 @@
+/**
+ ** \file lifting/liblifting.cc
+ ** \brief Functions exported by the lifting module.
+ */
+
+#include <memory>
+
+#include <ast/exp.hh>
+#include <desugar/libdesugar.hh>
+#include <lifting/liblifting.hh>
+#include <lifting/lifter.hh>
+
+namespace lifting
+{
+  template <typename A> A* lambda_lift(const A& tree, LiftStats* stats)
+  {
+    // Lift.
+    Lifter lift(tree);
+    lift(tree);
+    A* lifted = dynamic_cast<A*>(lift.result_get());
+    assertion(lifted);
+    std::unique_ptr<A> lifted_ptr(lifted);
+    if (stats)
+      *stats = lift.stats_get();
+    // Recompute the bindings and the types.
+    desugar::bind_and_types_check(*lifted_ptr);
+    return lifted_ptr.release();
+  }
+
+  template ast::ChunkList* lambda_lift(const ast::ChunkList&, LiftStats*);
+
+} // namespace lifting
@@ -0,0 +1,28 @@
+/**
+ ** \file lifting/liblifting.hh
+ ** \brief Declare functions exported by the lifting module.
+ */
+
+#pragma once
+
+#include <ast/fwd.hh>
+#include <lifting/capture.hh>
+
+/// Lambda lifting of an ast::Ast.
+namespace lifting
+{
+  /** Lift the nested functions to the top level.
+
+      \param tree   abstract syntax tree's root, whose bindings and types
+                    have been computed, and whose identifiers are all
+                    unique.
+      \param stats  if not null, where to store what was done.
+
+      \return       the AST where each nested function is a top-level
+                    function taking the variables it captures as extra
+                    arguments, the assigned ones in environment records,
+                    with bindings and type-checked.  */
+  template <typename A>
+  A* lambda_lift(const A& tree, LiftStats* stats = nullptr);
+
+} // namespace lifting
@@ -0,0 +1,232 @@
+/**
+ ** \file lifting/lifter.cc
+ ** \brief Implementation of lifting::Lifter.
+ */
+
+#include <ast/all.hh>
+#include <lifting/lifter.hh>
+#include <type/builtin-types.hh>
+#include <type/named.hh>
+
+namespace lifting
+{
+  using namespace ast;
+
+  Lifter::Lifter(const ast::Ast& tree)
+    : super_type()
+    , capture_(tree)
+  {}
+
+  const LiftStats& Lifter::stats_get() const { return capture_.stats_get(); }
+
+  /*----------------------.
+  | Environment records.  |
+  `----------------------*/
+
+  misc::symbol Lifter::type_name(const ast::VarDec& v)
+  {
+    if (v.type_name_get())
+      return v.type_name_get()->name_get();
+    const type::Type* type = v.type_get();
+    if (auto named = dynamic_cast<const type::Named*>(type))
+      return named->name_get();
+    if (dynamic_cast<const type::String*>(type))
+      return "string";
+    assertion(dynamic_cast<const type::Int*>(type));
+    return "int";
+  }
+
+  misc::symbol Lifter::box_get(const ast::VarDec& v)
+  {
+    misc::symbol type = type_name(v);
+    auto i = boxes_.find(type);
+    if (i != boxes_.end())
+      return i->second;
+
+    // The types are visible where their variables are, hence already
+    // hoisted: the record comes after them.
+    const Location& location = v.location_get();
+    misc::symbol box = misc::symbol::fresh("box");
+    auto fields = new fields_type{
+      new Field(location, "contents", new NameTy(location, type))};
+    auto chunk = new TypeChunk(location);
+    chunk->emplace_back(
+      *new TypeDec(location, box, new RecordTy(location, fields)));
+    hoisted_.emplace_back(chunk);
+    boxes_.emplace(type, box);
+    return box;
+  }
+
+  ast::VarDec* Lifter::box(const ast::VarDec& v, ast::Exp* init)
+  {
+    const Location& location = v.location_get();
+    misc::symbol type = box_get(v);
+    auto fields =
+      new fieldinits_type{new FieldInit(location, "contents", init)};
+    auto res = new VarDec(location, v.name_get(), new NameTy(location, type),
+                          new RecordExp(location, new NameTy(location, type),
+                                        fields));
+    res->escapable_set(false);
+    return res;
+  }
+
+  /*----------------.
+  | Visit methods.  |
+  `----------------*/
+
+  void Lifter::operator()(const ast::ChunkList& e)
+  {
+    auto chunks = new ChunkList(e.location_get());
+    for (const ChunkInterface* c : e.chunks_get())
+      {
+        ChunkInterface* chunk = recurse(*c);
+        for (TypeChunk* types : hoisted_)
+          chunks->emplace_back(types);
+        hoisted_.clear();
+        if (!lifted_.empty())
+          {
+            // Within the same chunk as the top-level functions, so that
+            // they all see each other.  A function is lifted after the
+            // ones nested in it, and is declared after them, before the
+            // function it was lifted from: each function is declared
+            // before its uses.
+            auto functions = dynamic_cast<FunctionChunk*>(chunk);
+            if (!functions)
+              {
+                functions = new FunctionChunk(c->location_get());
+                chunks->emplace_back(functions);
+              }
+            for (auto f = lifted_.rbegin(); f != lifted_.rend(); ++f)
+              functions->push_front(**f);
+            lifted_.clear();
+          }
+        chunks->emplace_back(chunk);
+      }
+    result_ = chunks;
+  }
+
+  void Lifter::operator()(const ast::LetExp& e)
+  {
+    const Location& location = e.location_get();
+    auto chunks = new ChunkList(location);
+    for (const ChunkInterface* c : e.chunklist_get().chunks_get())
+      if (auto types = dynamic_cast<const TypeChunk*>(c))
+        hoisted_.emplace_back(recurse(*types));
+      else if (auto functions = dynamic_cast<const FunctionChunk*>(c))
+        for (const FunctionDec* f : *functions)
+          lifted_.emplace_back(recurse(*f));
+      else
+        chunks->emplace_back(recurse(*c));
+    Exp* exp = recurse(e.exp_get());
+    if (chunks->chunks_get().empty())
+      {
+        delete chunks;
+        result_ = exp;
+      }
+    else
+      result_ = new LetExp(location, chunks, exp);
+  }
+
+  /* Turn
+
+         function f(a : t, b : u) = body
+
+     where `b' is boxed, and `f' captures `x' and `y', the latter
+     boxed, into
+
+         function f(a : t, b' : u, x : v, y : box_w) =
+           let var b : box_u := box_u {contents = b'}
+           in body end  */
+  void Lifter::operator()(const ast::FunctionDec& e)
+  {
+    const Location& location = e.location_get();
+    auto formals = new VarChunk(location);
+    auto boxes = new VarChunk(location);
+    for (const VarDec* formal : e.formals_get())
+      if (!capture_.boxed_p(*formal))
+        formals->emplace_back(*recurse(*formal));
+      else
+        {
+          misc::symbol name = misc::symbol::fresh(formal->name_get());
+          auto arg = new VarDec(location, name,
+                                new NameTy(location, type_name(*formal)),
+                                nullptr);
+          arg->escapable_set(false);
+          formals->emplace_back(*arg);
+          boxes->emplace_back(*box(*formal, new SimpleVar(location, name)));
+        }
+
+    if (capture_.nested_p(e))
+      for (const VarDec* v : capture_.captured_get(e))
+        {
+          misc::symbol type =
+            capture_.boxed_p(*v) ? box_get(*v) : type_name(*v);
+          auto formal = new VarDec(location, v->name_get(),
+                                   new NameTy(location, type), nullptr);
+          formal->escapable_set(false);
+          formals->emplace_back(*formal);
+        }
+
+    NameTy* result = recurse(e.result_get());
+    Exp* body = recurse(e.body_get());
+    if (!boxes->decs_get().empty())
+      {
+        auto chunks = new ChunkList(location);
+        chunks->emplace_back(boxes);
+        body = new LetExp(location, chunks, body);
+      }
+    else
+      delete boxes;
+    result_ = new FunctionDec(location, e.name_get(), formals, result, body);
+  }
+
+  void Lifter::operator()(const ast::VarDec& e)
+  {
+    if (capture_.boxed_p(e))
+      {
+        result_ = box(e, recurse(e.init_get()));
+        return;
+      }
+    super_type::operator()(e);
+    // No function is nested any longer.
+    static_cast<VarDec*>(result_)->escapable_set(false);
+  }
+
+  void Lifter::operator()(const ast::SimpleVar& e)
+  {
+    const Location& location = e.location_get();
+    const VarDec* def = e.def_get();
+    if (def && Capture::unit_p(*def))
+      result_ = new SeqExp(location, new exps_type);
+    else if (def && capture_.boxed_p(*def))
+      result_ = new FieldVar(location, new SimpleVar(location, e.name_get()),
+                             "contents");
+    else
+      super_type::operator()(e);
+  }
+
+  void Lifter::operator()(const ast::AssignExp& e)
+  {
+    // The variables of type void are not passed to the lifted functions.
+    auto var = dynamic_cast<const SimpleVar*>(&e.var_get());
+    if (var && var->def_get() && Capture::unit_p(*var->def_get()))
+      result_ = recurse(e.exp_get());
+    else
+      super_type::operator()(e);
+  }
+
+  void Lifter::operator()(const ast::CallExp& e)
+  {
+    super_type::operator()(e);
+    const FunctionDec* callee = e.def_get();
+    if (!callee || !capture_.nested_p(*callee))
+      return;
+    // Pass the captured variables themselves, not the contents of the
+    // environment records.
+    auto call = static_cast<CallExp*>(result_);
+    for (const VarDec* v : capture_.captured_get(*callee))
+      call->args_get().emplace_back(
+        new SimpleVar(e.location_get(), v->name_get()));
+  }
+
+} // namespace lifting
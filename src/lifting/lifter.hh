@@ -0,0 +1,81 @@
+/**
+ ** \file lifting/lifter.hh
+ ** \brief Declaration of lifting::Lifter.
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <astclone/cloner.hh>
+#include <lifting/capture.hh>
+#include <misc/symbol.hh>
+
+namespace lifting
+{
+  /** \brief Lift the nested functions to the top level.
+
+      Each nested function becomes a function of the top-level chunk
+      enclosing it, taking the variables it captures as extra formals,
+      named after them: since the identifiers are unique, the call
+      sites pass them on as is, and the enclosing functions no longer
+      need a frame, nor the nested ones a static link.
+
+      A variable assigned and captured is the content of an environment
+      record, `box {contents : type}', which its function allocates, and
+      the lifted functions receive.  The type declarations are hoisted
+      before the top-level chunk too, to remain visible.
+
+      The result has no nested function, hence no escaping variable.  */
+  class Lifter : public astclone::Cloner
+  {
+  public:
+    using super_type = astclone::Cloner;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// Build a Lifter, and compute the captures of \a tree.
+    explicit Lifter(const ast::Ast& tree);
+
+    /// \name Visit methods.
+    /// \{
+    /// Insert the lifted functions and the hoisted types in the
+    /// top-level chunks.
+    void operator()(const ast::ChunkList& e) override;
+    /// Move the functions and the types of \a e out of it, and drop it
+    /// if nothing remains.
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    void operator()(const ast::VarDec& e) override;
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    /// \}
+
+    /// \name Getters.
+    /// \{
+    const LiftStats& stats_get() const;
+    /// \}
+
+  private:
+    /// The name of the type of \a v.
+    static misc::symbol type_name(const ast::VarDec& v);
+    /// The environment record type of \a v.
+    misc::symbol box_get(const ast::VarDec& v);
+    /// The declaration of \a v as an environment record holding \a init.
+    ast::VarDec* box(const ast::VarDec& v, ast::Exp* init);
+
+    /// The captures.
+    Capture capture_;
+    /// The environment record type of each type.
+    std::map<misc::symbol, misc::symbol> boxes_;
+    /// The functions lifted from the current top-level chunk.
+    std::vector<ast::FunctionDec*> lifted_;
+    /// The types hoisted from the current top-level chunk, including
+    /// the new environment records.
+    std::vector<ast::TypeChunk*> hoisted_;
+  };
+
+} // namespace lifting
@@ -0,0 +1,28 @@
+/**
+ ** \file lifting/tasks.cc
+ ** \brief Lifting module related tasks' implementation.
+ **/
+
+#include <iostream>
+
+#include <ast/tasks.hh>
+#include <common.hh>
+#include <lifting/liblifting.hh>
+#define DEFINE_TASKS 1
+#include <lifting/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace lifting::tasks
+{
+  /// The statistics of the last lifting.
+  static LiftStats stats;
+
+  void lambda_lift()
+  {
+    ast::tasks::the_program.reset(
+      ::lifting::lambda_lift(*ast::tasks::the_program, &stats));
+  }
+
+  void lambda_lift_stats() { std::cout << stats; }
+
+} // namespace lifting::tasks
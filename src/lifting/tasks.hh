@@ -0,0 +1,28 @@
+/**
+ ** \file lifting/tasks.hh
+ ** \brief Lifting module tasks.
+ */
+
+#pragma once
+
+#include <config.h>
+#include <misc/fwd.hh>
+#include <task/libtask.hh>
+
+namespace lifting::tasks
+{
+  TASK_GROUP("Lambda Lifting");
+
+  /// Lift the nested functions to the top level.
+  TASK_DECLARE("lambda-lift",
+               "lift nested functions, closure-converting the escapes",
+               lambda_lift,
+               "types-compute rename");
+
+  /// Report what lambda lifting did.
+  TASK_DECLARE("lambda-lift-stats",
+               "report lambda lifting statistics",
+               lambda_lift_stats,
+               "lambda-lift");
+
+} // namespace lifting::tasks
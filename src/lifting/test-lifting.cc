@@ -0,0 +1,103 @@
+/**
+ ** Checking the lambda lifting.
+ */
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/libast.hh>
+#include <ast/non-object-visitor.hh>
+#include <bind/libbind.hh>
+#include <escapes/libescapes.hh>
+#include <interpret/libinterpret.hh>
+#include <lifting/liblifting.hh>
+#include <misc/contract.hh>
+#include <parse/libparse.hh>
+#include <type/libtype.hh>
+
+using namespace ast;
+
+const char* program_name = "test-lifting";
+
+// Count the functions declared within a `let', and the escaping
+// variables.
+class NestingCounter
+  : public DefaultConstVisitor
+  , public NonObjectConstVisitor
+{
+public:
+  using super_type = DefaultConstVisitor;
+  using super_type::operator();
+
+  void operator()(const FunctionDec& e) override
+  {
+    nested += depth;
+    ++depth;
+    super_type::operator()(e);
+    --depth;
+  }
+
+  void operator()(const VarDec& e) override
+  {
+    super_type::operator()(e);
+    escaping += e.escapable_get();
+  }
+
+  unsigned depth = 0;
+  unsigned nested = 0;
+  unsigned escaping = 0;
+};
+
+// The output of \a tree, run by the interpreter.
+static std::string run(ChunkList& tree)
+{
+  escapes::escapes_compute(tree);
+  std::istringstream in;
+  std::ostringstream out;
+  std::ostringstream err;
+  assertion(interpret::interpret(tree, in, out, err) == 0);
+  return out.str();
+}
+
+int main()
+{
+  // show reads n only: its captures are passed by value.  bump assigns
+  // count, which goes to an environment record, and twice captures it
+  // through its calls.  The procedures end with () to be of type void.
+  std::unique_ptr<ChunkList> tree(parse::parse_unit(
+    "let primitive print_int(i : int)"
+    "    function outer(n : int) ="
+    "      let var count := 0"
+    "          function show(k : int) = (print_int(n + k); ())"
+    "          function bump() = (count := count + n; ())"
+    "          function twice() = (bump(); bump())"
+    "      in show(1); twice(); print_int(count) end "
+    "in outer(10) end"));
+  bind::bind_compute(*tree);
+  bind::name_compute(*tree);
+  type::types_check(*tree);
+  std::string expected = run(*tree);
+  assertion(expected == "1120");
+
+  lifting::LiftStats stats;
+  std::unique_ptr<ChunkList> lifted(lifting::lambda_lift(*tree, &stats));
+  std::cout << *lifted << '\n' << stats;
+  // print_int and outer are within the `let' of _main too.
+  assertion(stats.functions == 5);
+  assertion(stats.lifted == 3);
+  assertion(stats.converted == 2);
+  assertion(stats.parameters == 5);
+  assertion(stats.boxed == 1);
+
+  // No function is nested any longer, hence no variable escapes, and
+  // the program still does the same.
+  NestingCounter count;
+  lifted->accept(count);
+  assertion(count.nested == 0);
+  assertion(count.escaping == 0);
+  assertion(run(*lifted) == expected);
+}
@@ -25,13 +25,20 @@ namespace object
 
   void Binder::operator()(ast::SimpleVar& e)
   {
-    // FIXME: Some code was deleted here.
+    if (e.name_get() == "self" && within_method_dec_ && !overrided_self_)
+      e.def_set(nullptr);
+    else
+      super_type::operator()(e);
   }
 
   // Handle the case of `Object'.
   void Binder::operator()(ast::NameTy& e)
   {
-    // FIXME: Some code was deleted here.
+    // The builtin Object has no definition site.
+    if (e.name_get() == "Object")
+      e.def_set(nullptr);
+    else
+      super_type::operator()(e);
   }
 
   /*---------------.
@@ -86,16 +93,14 @@ namespace object
       }
   }
 
-  void Binder::operator()(ast::FunctionChunk& e)
-  {
-    chunk_visit<ast::FunctionDec>(e);
-  }
-
   template <class D> void Binder::chunk_visit(ast::Chunk<D>& e)
   {
     // Shorthand.
     using chunk_type = ast::Chunk<D>;
-    // FIXME: Some code was deleted here (Two passes: once on headers, then on bodies).
+    for (typename chunk_type::value_type dec : e)
+      visit_dec_header<D>(*dec);
+    for (typename chunk_type::value_type dec : e)
+      visit_dec_body<D>(*dec);
   }
 
   // This trampoline is needed, since `virtual' and `template' cannot
@@ -118,6 +123,11 @@ namespace object
     within_class_ty_ = saved_within_class_ty;
   }
 
+  void Binder::operator()(ast::FunctionChunk& e)
+  {
+    chunk_visit<ast::FunctionDec>(e);
+  }
+
   /* We can't bind methods definitions without types, so we don't
      store them.  Nonetheless, object::Binder must still recurse
      through the children of ast::MethodChunk to bind other names.
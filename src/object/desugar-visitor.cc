@@ -3,6 +3,7 @@
  ** \brief Implementation of object::DesugarVisitor.
  */
 
+#include <algorithm>
 #include <sstream>
 
 #include <ast/all.hh>
@@ -13,15 +14,21 @@
 #include <parse/tweast.hh>
 #include <range/v3/algorithm/any_of.hpp>
 #include <range/v3/algorithm/find_if.hpp>
+#include <type/builtin-types.hh>
 #include <type/class.hh>
 #include <type/function.hh>
+#include <type/named.hh>
 #include <type/record.hh>
 
 namespace object
 {
-  DesugarVisitor::DesugarVisitor(const class_names_type& names)
+  DesugarVisitor::DesugarVisitor(const class_names_type& names, bool compact)
     : class_names_(names)
-  {}
+    , compact_(compact)
+  {
+    // Class ids are preorder ids, so that dispatch can test intervals.
+    type::Class::object_instance().preorder_compute();
+  }
 
   /*---------------------------.
   | Handling names and types.  |
@@ -40,6 +47,8 @@ namespace object
     const char* class_variant_prefix = "_variant_";
     // Prefix of the fields in the variant.
     const char* variant_field_prefix = "field_";
+    // Prefix of every record of the compact layout.
+    const char* class_layout_prefix = "_layout_";
     // Prefix of constructors.
     const char* class_ctor_prefix = "_new_";
     // Prefix of methods.
@@ -51,7 +60,10 @@ namespace object
     // type, return a null pointer.
     const type::Class* class_type_query(const ast::Typable& t)
     {
-      // FIXME: Some code was deleted here.
+      const type::Type* type = t.type_get();
+      if (!type)
+        return nullptr;
+      return dynamic_cast<const type::Class*>(&type->actual());
     }
 
     // Like class_type_query, but ensure the type is actually a class.
@@ -62,6 +74,16 @@ namespace object
       return class_type;
     }
 
+    // The classes from Object down to \a cls.
+    std::vector<const type::Class*> lineage(const type::Class* cls)
+    {
+      std::vector<const type::Class*> res;
+      for (const type::Class* c = cls; c; c = c->super_get())
+        res.emplace_back(c);
+      std::ranges::reverse(res);
+      return res;
+    }
+
   } // namespace
 
   /*------------------.
@@ -70,23 +92,37 @@ namespace object
 
   std::string DesugarVisitor::type_symbol(const type::Type* type)
   {
-    // FIXME: Some code was deleted here (Check int, then string, then class name).
+    const type::Type& actual = type->actual();
+    if (dynamic_cast<const type::Int*>(&actual))
+      return "int";
+    if (dynamic_cast<const type::String*>(&actual))
+      return "string";
+    if (auto class_type = dynamic_cast<const type::Class*>(&actual))
+      return object_type_name(class_type);
+    // Records and arrays are referred to by the name they are declared with.
+    auto named = dynamic_cast<const type::Named*>(type);
+    assertion(named);
+    return named->name_get().get();
   }
 
-  std::string DesugarVisitor::upcast_fun_name(const type::Class* from,
-                                              const type::Class* to)
+  std::string DesugarVisitor::object_type_name(const type::Class* cls)
   {
-    std::stringstream s;
-    s << "_upcast_" << class_names_(from) << "_to_" << class_names_(to);
-    return s.str();
+    return (compact_ ? class_layout_prefix : class_variant_prefix)
+      + class_names_(cls).get();
   }
 
-  std::string DesugarVisitor::downcast_fun_name(const type::Class* from,
-                                                const type::Class* to)
+  misc::symbol DesugarVisitor::cast_fun_name(const type::Class* from,
+                                             const type::Class* to)
   {
-    std::stringstream s;
-    s << "_downcast_" << class_names_(from) << "_to_" << class_names_(to);
-    return s.str();
+    precondition(from != to);
+    auto [it, inserted] = cast_names_.try_emplace(cast_type(from, to));
+    if (inserted)
+      {
+        it->second = (from->is_a(*to) ? "_upcast_" : "_downcast_")
+          + class_names_(from).get() + "_to_" + class_names_(to).get();
+        casts_.emplace_back(from, to);
+      }
+    return it->second;
   }
 
   std::string DesugarVisitor::dispatch_fun_name(const type::Class* owner,
@@ -103,6 +139,20 @@ namespace object
     return s.str();
   }
 
+  ast::Exp* DesugarVisitor::cast_exp(ast::Exp* exp,
+                                     const type::Class* source,
+                                     const type::Class* target)
+  {
+    const ast::Location location = exp->location_get();
+    // With the compact layout, the record of a super class is a prefix
+    // of the record of the object: an upcast reinterprets it in place.
+    if (compact_ && source->is_a(*target))
+      return new ast::CastExp(
+        location, exp, new ast::NameTy(location, object_type_name(target)));
+    return new ast::CallExp(location, cast_fun_name(source, target),
+                            new ast::exps_type{exp});
+  }
+
   void DesugarVisitor::adapt_type(ast::Exp*& source_exp,
                                   const type::Class* source_type,
                                   const type::Class* target_type)
@@ -110,9 +160,7 @@ namespace object
     // If the source type is different from the target type, (up)cast
     // the source expression to the latter.
     if (source_type && target_type && source_type != target_type)
-      source_exp = parse::parse(parse::Tweast()
-                                << upcast_fun_name(source_type, target_type)
-                                << " (" << source_exp << ")");
+      source_exp = cast_exp(source_exp, source_type, target_type);
   }
 
   ast::Exp* DesugarVisitor::variant_exp(const type::Class* static_type,
@@ -200,55 +248,154 @@ namespace object
     return input;
   }
 
-  void DesugarVisitor::fill_init_list(const type::Class* class_type,
-                                      field_inits_type& inits)
+  std::string DesugarVisitor::attr_field_name(const type::Class* owner,
+                                              misc::symbol attr)
   {
-    // Populate the initialization list with classes
-    // owning actual data only.
-    if (class_type->has_data())
-      {
-        std::string field_name = class_names_(class_type);
-        misc::put(inits, class_type,
-                  std::string("source.") + variant_field_prefix + field_name);
-      }
+    // A subclass may declare an attribute of the same name as one of
+    // its super classes: qualify the fields of the compact layout.
+    if (compact_)
+      return class_names_(owner).get() + "_" + attr.get();
+    return attr.get();
   }
 
-  parse::Tweast* DesugarVisitor::cast_function(const std::string& name,
-                                               const type::Class* source,
-                                               const type::Class* target,
-                                               const type::Class* exact_type)
+  parse::Tweast* DesugarVisitor::layout_ty(const type::Class* class_type)
   {
     auto input = new parse::Tweast;
-    *input << " function " << name << "   (source : " << class_variant_prefix
-           << class_names_(source)
-           << ") :"
-              "   "
-           << class_variant_prefix << class_names_(target) << " = ";
-
-    // Copy all fields from the source.
-    field_inits_type inits;
-    // First, fields from the class and its super classes...
-    for (const type::Class* c = source; c; c = c->super_get())
-      fill_init_list(c, inits);
-    // ...then, fields from the subclasses.
-    for (const type::Class* c : source->subclasses_get())
-      fill_init_list(c, inits);
-    *input << variant_exp(target, exact_type, inits) << "\n";
+    *input << " { exact_type : int";
+    // The attributes of the super classes first, in the same order as
+    // in their own records, so that the record of a super class is a
+    // prefix of this one.
+    for (const type::Class* c : lineage(class_type))
+      for (const type::Attribute& attr : c->attrs_get())
+        *input << ", " << attr_field_name(c, attr.name_get()) << " : "
+               << type_symbol(&attr.type_get());
+    *input << " }\n";
     return input;
   }
 
-  parse::Tweast* DesugarVisitor::upcast_function(const type::Class* source,
-                                                 const type::Class* target)
+  void DesugarVisitor::layout_constructor(parse::Tweast& functions,
+                                          const type::Class* cls,
+                                          misc::symbol class_name)
   {
-    return cast_function(upcast_fun_name(source, target), source, target,
-                         source);
+    functions << " function " << class_ctor_prefix << class_name
+              << "() : " << object_type_name(cls) << " = "
+              << object_type_name(cls) << " { exact_type = "
+              << class_id_prefix << class_name;
+    for (const type::Class* c : lineage(cls))
+      if (c->has_data())
+        {
+          functions << ", ";
+          attrs_init(functions, c);
+        }
+    functions << " }\n";
   }
 
-  parse::Tweast* DesugarVisitor::downcast_function(const type::Class* source,
-                                                   const type::Class* target)
+  ast::FunctionDec* DesugarVisitor::cast_function(const type::Class* source,
+                                                  const type::Class* target,
+                                                  misc::symbol name)
   {
-    return cast_function(downcast_fun_name(source, target), source, target,
-                         target);
+    const ast::Location location;
+    auto source_var = [&location]() {
+      return new ast::SimpleVar(location, "source");
+    };
+
+    ast::Exp* body = nullptr;
+    if (compact_)
+      {
+        // With the compact layout, the record of the target is a prefix
+        // of the record of the object: reinterpret it, no need to
+        // allocate anything.
+        body = new ast::CastExp(
+          location, source_var(),
+          new ast::NameTy(location, object_type_name(target)));
+        if (!source->is_a(*target))
+          {
+            // A downcast: the exact type of the object must be in the
+            // subtree of the target, i.e., within its preorder interval.
+            //   (if source <> nil then
+            //      if source.exact_type < first then fail
+            //      else if source.exact_type > last then fail;
+            //    _cast(source, target))
+            auto exact_type = [&]() {
+              return new ast::FieldVar(location, source_var(), "exact_type");
+            };
+            auto fail = [&]() {
+              auto print_args = new ast::exps_type{
+                new ast::StringExp(location, "invalid downcast\\n")};
+              auto exit_args =
+                new ast::exps_type{new ast::IntExp(location, 120)};
+              return new ast::SeqExp(
+                location,
+                new ast::exps_type{
+                  new ast::CallExp(location, "print_err", print_args),
+                  new ast::CallExp(location, "exit", exit_args)});
+            };
+            auto check = new ast::IfExp(
+              location,
+              new ast::OpExp(location, source_var(), ast::OpExp::Oper::ne,
+                             new ast::NilExp(location)),
+              new ast::IfExp(
+                location,
+                new ast::OpExp(location, exact_type(), ast::OpExp::Oper::lt,
+                               new ast::IntExp(location,
+                                               target->preorder_id_get())),
+                fail(),
+                new ast::IfExp(
+                  location,
+                  new ast::OpExp(
+                    location, exact_type(), ast::OpExp::Oper::gt,
+                    new ast::IntExp(location, target->preorder_last_get())),
+                  fail())));
+            body = new ast::SeqExp(location, new ast::exps_type{check, body});
+          }
+      }
+    else
+      {
+        // Copy the exact type and all the fields of the source which
+        // exist in the variant of the target, set the others to nil.
+        auto fields = new ast::fieldinits_type;
+        fields->emplace_back(new ast::FieldInit(
+          location, "exact_type",
+          new ast::FieldVar(location, source_var(), "exact_type")));
+        auto field = [&](const type::Class* c) {
+          misc::symbol field_name =
+            variant_field_prefix + class_names_(c).get();
+          ast::Exp* init = nullptr;
+          if (source->is_a(*c) || c->is_a(*source))
+            init = new ast::FieldVar(location, source_var(), field_name);
+          else
+            init = new ast::NilExp(location);
+          fields->emplace_back(new ast::FieldInit(location, field_name, init));
+        };
+        // Don't generate slots for classes with no data.
+        for (const type::Class* c = target; c; c = c->super_get())
+          if (c->has_data())
+            field(c);
+        for (const type::Class* c : target->subclasses_get())
+          if (c->has_data())
+            field(c);
+        body = new ast::RecordExp(
+          location, new ast::NameTy(location, object_type_name(target)),
+          fields);
+      }
+
+    auto formals = new ast::VarChunk(location);
+    formals->emplace_back(
+      *new ast::VarDec(location, "source",
+                       new ast::NameTy(location, object_type_name(source)),
+                       nullptr));
+    return new ast::FunctionDec(
+      location, name, formals,
+      new ast::NameTy(location, object_type_name(target)), body);
+  }
+
+  ast::FunctionChunk* DesugarVisitor::cast_functions()
+  {
+    auto res = new ast::FunctionChunk(ast::Location());
+    for (const cast_type& cast : casts_)
+      res->emplace_back(
+        *cast_function(cast.first, cast.second, cast_names_[cast]));
+    return res;
   }
 
   ast::Exp* DesugarVisitor::dispatch_switch(const type::Class* class_type,
@@ -263,51 +410,75 @@ namespace object
     // declaration, formals of the mother method have been used
     // (because of the use of dispatch_map_, we cannot use child's
     // formals.
-    const ast::MethodDec* def;
-    // FIXME: Some code was deleted here (Initialize def).
+    const ast::MethodDec* def =
+      (dispatch_method ? dispatch_method : method)->def_get();
+    precondition(def);
     const ast::VarChunk& formals = def->formals_get();
 
-    // Create a case for each method redefinition.
-    classes_type overridings;
-    for (const type::Class* c : class_type->subclasses_get())
-      if (ranges::any_of(*typechunk, [c](const ast::TypeDec* tmp) {
-            return class_type_query(*tmp) == c;
-          }))
-        overridings.emplace_back(c);
-
-    if (overridings.empty())
-      // No dispatch is needed; simply call the method.
-      input << method_call(class_names_(class_type), method_name, "self",
-                           formals);
-    else
+    // The classes of the chunk: the others are handled by the
+    // fallback (see below).
+    misc::set<const type::Class*> in_chunk;
+    for (const ast::TypeDec* t : *typechunk)
+      if (const type::Class* c = class_type_query(*t))
+        in_chunk.insert(c);
+
+    // The subclasses are numbered in preorder, hence the dynamic type
+    // of self is in [class_type, last].  Cut this interval in runs
+    // of classes sharing the same implementation of the method, a null
+    // implementation standing for the fallback.
+    classes_type subtree(class_type->subclasses_get());
+    subtree.emplace_back(class_type);
+    std::ranges::sort(subtree, {}, &type::Class::preorder_id_get);
+    dispatch_intervals_type intervals;
+    for (const type::Class* c : subtree)
       {
-        // Emit code for self.
-        bool first = true;
-        // Emit code for other types.
-        for (auto c : overridings)
+        const type::Class* impl = nullptr;
+        if (c != class_type && in_chunk.has(c))
           {
-            if (!first)
-              input << " else ";
-            input << " if self.exact_type = " << class_id_prefix
-                  << class_names_(c) << " then ";
             // We search for the nearest implementation of our method.
-            const type::Class* nearest_c = c;
-            while (nearest_c && !(nearest_c->owned_meth_find(method_name)))
-              nearest_c = nearest_c->super_get();
-            input << method_call(
-              class_names_(nearest_c), method_name,
-              ((*class_type != *nearest_c)
-                 ? downcast_fun_name(class_type, nearest_c) + " (self)"
-                 : "self"),
-              formals);
-            first = false;
+            impl = c;
+            while (impl && !impl->owned_meth_find(method_name))
+              impl = impl->super_get();
+          }
+        else if (!dispatch_method)
+          impl = class_type;
+        if (intervals.empty() || intervals.back().second != impl)
+          intervals.emplace_back(c->preorder_id_get(), impl);
+      }
+
+    dispatch_tree(input, intervals, 0, intervals.size(), class_type, method,
+                  formals, dispatch_method);
+    input << '\n';
+    return parse::parse(input);
+  }
+
+  void DesugarVisitor::dispatch_tree(parse::Tweast& input,
+                                     const dispatch_intervals_type& intervals,
+                                     std::size_t first,
+                                     std::size_t last,
+                                     const type::Class* class_type,
+                                     const type::Method* method,
+                                     const ast::VarChunk& formals,
+                                     const type::Method* dispatch_method)
+  {
+    precondition(first < last);
+    if (last - first == 1)
+      {
+        const type::Class* impl = intervals[first].second;
+        if (impl)
+          {
+            ast::Exp* self = new ast::SimpleVar(ast::Location(), "self");
+            if (*class_type != *impl)
+              self = cast_exp(self, class_type, impl);
+            input << method_call(class_names_(impl), method->name_get(),
+                                 self, formals);
           }
-        input << " else ";
-        // If this is a sub dispatch function, call the last dispatch
-        // method built so we don't need to write every single test
-        // for exact_type.
-        if (dispatch_method)
+        else
           {
+            // This is a sub dispatch function: call the last dispatch
+            // method built so we don't need to write every single test
+            // for exact_type.
+            precondition(dispatch_method);
             input << "_dispatch_";
             if ((dispatch_map_[method] - 1) != 1)
               input << (dispatch_map_[method] - 1) << "_";
@@ -318,25 +489,32 @@ namespace object
               input << ", " << arg->name_get();
             input << ")";
           }
-        else
-          input << method_call(class_names_(class_type), method_name, "self",
-                               formals);
+        return;
       }
-    input << '\n';
-    return parse::parse(input);
+
+    // Split the intervals in two halves.
+    std::size_t middle = first + (last - first) / 2;
+    input << " if self.exact_type < " << intervals[middle].first << " then (";
+    dispatch_tree(input, intervals, first, middle, class_type, method, formals,
+                  dispatch_method);
+    input << ") else (";
+    dispatch_tree(input, intervals, middle, last, class_type, method, formals,
+                  dispatch_method);
+    input << ")";
   }
 
   parse::Tweast* DesugarVisitor::method_call(misc::symbol class_name,
                                              misc::symbol method_name,
-                                             const std::string& target,
+                                             ast::Exp* target,
                                              const ast::VarChunk& formals)
   {
     auto input = new parse::Tweast;
     *input << method_prefix << class_name << "_" << method_name << " (";
     // Pass the target.
-    // FIXME: Some code was deleted here.
+    *input << target;
     // Pass other arguments.
-    // FIXME: Some code was deleted here.
+    for (const ast::VarDec* arg : formals)
+      *input << ", " << arg->name_get();
     *input << ")";
     return input;
   }
@@ -353,6 +531,7 @@ namespace object
     // it, but it's not easy to see whether we could benefit from
     // this.  (Maybe a variant would be appropriate.)
     ast::ChunkList::list_type contents;
+    ++chunk_lists_;
     for (const ast::ChunkInterface* d : e)
       {
         d->accept(*this);
@@ -372,6 +551,15 @@ namespace object
               abort();
           }
       }
+    --chunk_lists_;
+    // Without `_main', the declarations introduced by the classes go
+    // to the top of the tree.
+    if (!chunk_lists_ && !prologue_injected_)
+      {
+        ast::ChunkList* decs = prologue();
+        contents.splice(contents.begin(), decs->chunks_get());
+        delete decs;
+      }
     result_ = new ast::ChunkList(location, contents);
   }
 
@@ -379,14 +567,38 @@ namespace object
   | Desugar class declarations.  |
   `-----------------------------*/
 
+  void DesugarVisitor::attrs_init(parse::Tweast& functions,
+                                  const type::Class* c)
+  {
+    for (auto a = c->attrs_get().begin(); a != c->attrs_get().end(); a++)
+      {
+        if (a != c->attrs_get().begin())
+          functions << ", ";
+        const ast::VarDec* attr = a->def_get();
+        misc::symbol attr_name = attr->name_get();
+        // Partially clone the contents of the VarDec
+        // (cloning the whole VarDec would leak memory).
+
+        ast::Exp* attr_init = recurse(attr->init_get());
+        // Cast the initialization value if needed.
+        if (attr->init_get() && attr->type_name_get())
+          adapt_type(attr_init, class_type_query(*attr->init_get()),
+                     class_type_query(*attr->type_name_get()));
+        functions << attr_field_name(c, attr_name) << " = " << attr_init;
+      }
+  }
+
   void DesugarVisitor::desugar_constructor(parse::Tweast& functions,
                                            const type::Class* cls,
                                            misc::symbol class_name)
   {
+    if (compact_)
+      return layout_constructor(functions, cls, class_name);
+
     functions << " function " << class_ctor_prefix << class_name
               << "() : "
                  " "
-              << class_variant_prefix << class_name
+              << object_type_name(cls)
               << " = "
                  " let";
     // Initialize each mandatory field of the variant (i.e.,
@@ -397,24 +609,7 @@ namespace object
         {
           functions << " var contents_" << class_names_(c) << " := "
                     << " " << class_contents_prefix << class_names_(c) << " { ";
-
-          for (auto a = c->attrs_get().begin(); a != c->attrs_get().end(); a++)
-            {
-              if (a != c->attrs_get().begin())
-                functions << ", ";
-              const ast::VarDec* attr;
-              // FIXME: Some code was deleted here (Initialize attr).
-              misc::symbol attr_name = attr->name_get();
-              // Partially clone the contents of the VarDec
-              // (cloning the whole VarDec would leak memory).
-
-              ast::Exp* attr_init = recurse(attr->init_get());
-              // Cast the initialization value if needed.
-              if (attr->init_get() && attr->type_name_get())
-                adapt_type(attr_init, class_type_query(*attr->init_get()),
-                           class_type_query(*attr->type_name_get()));
-              functions << attr_name << " = " << attr_init;
-            }
+          attrs_init(functions, c);
           functions << " } ";
         }
     functions << " in ";
@@ -423,9 +618,7 @@ namespace object
     field_inits_type inits;
     for (const type::Class* c = cls; c; c = c->super_get())
       if (c->has_data())
-        {
-          // FIXME: Some code was deleted here.
-        }
+        misc::put(inits, c, "contents_" + class_names_(c).get());
     // Create the contents of the variant.
     functions << variant_exp(cls, cls, inits) << " end\n";
   }
@@ -435,11 +628,11 @@ namespace object
                                       misc::symbol class_name)
   {
     functions << " function " << method_prefix << class_name << "_"
-              << method->name_get() << " (self : " << class_variant_prefix
-              << class_name;
+              << method->name_get()
+              << " (self : " << object_type_name(method->owner_get());
     // Get the other arguments.
-    const ast::MethodDec* def;
-    // FIXME: Some code was deleted here (Initiliaze def).
+    const ast::MethodDec* def = method->def_get();
+    precondition(def);
     for (const ast::VarDec* arg : def->formals_get())
       functions << ", " << arg->name_get() << " : "
                 << recurse(*arg->type_name_get());
@@ -458,7 +651,6 @@ namespace object
                                          const ast::TypeChunk& e,
                                          const type::Class* cls,
                                          const type::Method* method,
-                                         misc::symbol class_name,
                                          dispatch_list_type& sub_dispatches)
   {
     for (const type::Class* c = cls->super_get(); c; c = c->super_get())
@@ -499,10 +691,11 @@ namespace object
 
         // We build the subdispatch method.
         functions << " function " << dispatch_fun_name(c, *meth_it)
-                  << " (self : " << class_variant_prefix << class_names_(c);
-        // Get the other arguments.
-        const ast::MethodDec* def;
-        // FIXME: Some code was deleted here (Initialize def).
+                  << " (self : " << object_type_name(c);
+        // Get the other arguments, those of the dispatched method (see
+        // dispatch_switch).
+        const ast::MethodDec* def = method->def_get();
+        precondition(def);
         for (const ast::VarDec* arg : def->formals_get())
           functions << ", " << arg->name_get() << " : "
                     << recurse(*arg->type_name_get());
@@ -513,10 +706,10 @@ namespace object
       }
 
     functions << " function " << dispatch_fun_name(cls, method)
-              << " (self : " << class_variant_prefix << class_name;
+              << " (self : " << object_type_name(cls);
     // Get the other arguments.
-    const ast::MethodDec* def;
-    // FIXME: Some code was deleted here (Initialize def).
+    const ast::MethodDec* def = method->def_get();
+    precondition(def);
     for (const ast::VarDec* arg : def->formals_get())
       functions << ", " << arg->name_get() << " : "
                 << recurse(*arg->type_name_get());
@@ -538,17 +731,34 @@ namespace object
     `---------------------------*/
 
     class_ids_ << " var " << class_id_prefix << class_name
-               << " := " << cls->id_get() << "\n";
+               << " := " << cls->preorder_id_get() << "\n";
 
     /*----------------------------------------------------.
     | Create a record holding the actual class contents.  |
     `----------------------------------------------------*/
 
-    if (cls->has_data())
+    if (compact_)
+      {
+        /*-------------------------------------------------------------.
+        | Create the single record of the objects of this class: the   |
+        | exact type, then the attributes of the super classes and its |
+        | own, so that the record of the super class is a prefix.      |
+        `-------------------------------------------------------------*/
+
+        types_ << " type " << object_type_name(cls) << " =" << layout_ty(cls);
+      }
+    else if (cls->has_data())
       {
         types_ << " type " << class_contents_prefix << class_name << " ="
                << " { ";
-        // FIXME: Some code was deleted here (Populate the record with attributes (names and types)).
+        for (auto a = cls->attrs_get().begin(); a != cls->attrs_get().end();
+             a++)
+          {
+            if (a != cls->attrs_get().begin())
+              types_ << ", ";
+            types_ << attr_field_name(cls, a->name_get()) << " : "
+                   << type_symbol(&a->type_get());
+          }
         types_ << " }\n";
       }
 
@@ -557,8 +767,9 @@ namespace object
     | to this (static) class type.                                  |
     `--------------------------------------------------------------*/
 
-    types_ << " type " << class_variant_prefix << class_name << " ="
-           << variant_ty(cls);
+    if (!compact_)
+      types_ << " type " << class_variant_prefix << class_name << " ="
+             << variant_ty(cls);
 
     /*-----------------------.
     | Create a constructor.  |
@@ -566,27 +777,13 @@ namespace object
 
     desugar_constructor(functions, cls, class_name);
 
-    /*-------------------------------------------------------------.
-    | Create conversion routines from the class type to any of its |
-    | super types.                                                 |
-    `-------------------------------------------------------------*/
-
-    for (const type::Class* super_type = cls->super_get(); super_type;
-         super_type = super_type->super_get())
-      funs_tweast << upcast_function(cls, super_type);
-
-    /*-------------------------------------------------------------.
-    | Create conversion routines from the class type to any of its |
-    | subtypes.                                                    |
-    `-------------------------------------------------------------*/
-
-    for (const type::Class* subclass : cls->subclasses_get())
-      functions << downcast_function(cls, subclass);
+    // The conversion routines from and to this class are generated on
+    // demand, see cast_fun_name.
 
     for (const type::Method* m : cls->meths_get())
       {
         desugar_method(functions, m, class_name);
-        dispatch_function(functions, e, cls, m, class_name, sub_dispatches);
+        dispatch_function(functions, e, cls, m, sub_dispatches);
       }
   }
 
@@ -603,7 +800,9 @@ namespace object
     for (const ast::TypeDec* t : e)
       {
         const type::Class* cls = nullptr;
-        // FIXME: Some code was deleted here (Get the ty's class type).
+        // An alias of a class is not a class declaration.
+        if (dynamic_cast<const ast::ClassTy*>(&t->ty_get()))
+          cls = class_type_get(*t);
 
         if (cls)
           handle_class(e, cls, functions, sub_dispatches);
@@ -654,7 +853,7 @@ namespace object
             init = recurse(e.init_get());
             // If the dynamic type is non-nil and different from the
             // static type, cast INIT to the latter.
-            // FIXME: Some code was deleted here.
+            adapt_type(init, class_type_query(*e.init_get()), class_type);
           }
         else
           // No manifest type: simply clone the declaration as-is.
@@ -673,33 +872,45 @@ namespace object
   // Desugar a class instantiation as a call to the desugared ctor routine.
   void DesugarVisitor::operator()(const ast::ObjectExp& e)
   {
-    // FIXME: Some code was deleted here.
+    const type::Class* cls = class_type_get(e);
+    result_ = new ast::CallExp(e.location_get(),
+                               class_ctor_prefix + class_names_(cls).get(),
+                               new ast::exps_type);
   }
 
   void DesugarVisitor::operator()(const ast::IfExp& e)
   {
-    // FIXME: Some code was deleted here.
+    // If this is not a choice between objects, delegate to the cloner.
+    const type::Class* if_type = class_type_query(e);
+    if (!if_type)
+      return super_type::operator()(e);
+
+    // Cast the branches to the common super class of their types.
+    ast::Exp* test = recurse(e.get_test());
+    ast::Exp* then_clause = recurse(e.get_thenclause());
+    adapt_type(then_clause, class_type_query(e.get_thenclause()), if_type);
+    ast::Exp* else_clause = recurse(e.get_elseclause());
+    adapt_type(else_clause, class_type_query(e.get_elseclause()), if_type);
+    result_ =
+      new ast::IfExp(e.location_get(), test, then_clause, else_clause);
   }
 
   void DesugarVisitor::operator()(const ast::AssignExp& e)
   {
     // If this is not an object assignment, delegate to the cloner.
-    const type::Class* lhs_class_type;
-    // FIXME: Some code was deleted here.
+    const type::Class* lhs_class_type = class_type_query(e.var_get());
 
     if (!lhs_class_type)
       return super_type::operator()(e);
 
     // Duplicate the subtrees of E.
-    ast::Var* var = nullptr;
-    // FIXME: Some code was deleted here (Recurse).
+    ast::Var* var = recurse(e.var_get());
 
-    ast::Exp* exp = nullptr;
-    // FIXME: Some code was deleted here (Recurse).
+    ast::Exp* exp = recurse(e.exp_get());
 
     // If the RHS type is non-nil and different from the LHS type,
     // cast EXP to the latter.
-    // FIXME: Some code was deleted here.
+    adapt_type(exp, class_type_query(e.exp_get()), lhs_class_type);
     ast::Exp* assignment =
       parse::parse(parse::Tweast() << var << " := " << exp);
     result_ = assignment;
@@ -725,7 +936,7 @@ namespace object
         // formal.
         const type::Type* formal_type = &j->type_get().actual();
         auto formal_class_type = dynamic_cast<const type::Class*>(formal_type);
-        // FIXME: Some code was deleted here.
+        adapt_type(arg, class_type_query(**i), formal_class_type);
         args->emplace_back(arg);
       }
     return args;
@@ -743,7 +954,19 @@ namespace object
     //   arr[0] := new B;
     //   arr[1] := new A
     // end
-    // FIXME: Some code was deleted here.
+    auto array_type =
+      dynamic_cast<const type::Array*>(&e.type_name_get().type_get()->actual());
+    assertion(array_type);
+    auto elt_class_type =
+      dynamic_cast<const type::Class*>(&array_type->type_get().actual());
+    if (!elt_class_type)
+      return super_type::operator()(e);
+
+    ast::NameTy* type_name = recurse(e.type_name_get());
+    ast::Exp* size = recurse(e.size_get());
+    ast::Exp* init = recurse(e.init_get());
+    adapt_type(init, class_type_query(e.init_get()), elt_class_type);
+    result_ = new ast::ArrayExp(e.location_get(), type_name, size, init);
   }
 
   void DesugarVisitor::operator()(const ast::RecordExp& e)
@@ -756,25 +979,41 @@ namespace object
     //   var rec := rectype { a = new B }
     // in
     // end
-    // FIXME: Some code was deleted here.
+    auto record_type =
+      dynamic_cast<const type::Record*>(&e.type_get()->actual());
+    assertion(record_type);
+
+    auto fields = new ast::fieldinits_type;
+    for (const ast::FieldInit* f : e.get_fields())
+      {
+        ast::Exp* init = recurse(f->init_get());
+        auto field_class_type = dynamic_cast<const type::Class*>(
+          &record_type->field_type(f->name_get())->actual());
+        adapt_type(init, class_type_query(f->init_get()), field_class_type);
+        fields->emplace_back(
+          new ast::FieldInit(f->location_get(), f->name_get(), init));
+      }
+    result_ = new ast::RecordExp(e.location_get(),
+                                 recurse(e.get_type_name()), fields);
   }
 
   void DesugarVisitor::operator()(const ast::CallExp& e)
   {
-    const type::Function* function_type;
-    // FIXME: Some code was deleted here.
+    const type::Function* function_type =
+      dynamic_cast<const type::Function*>(e.def_get()->type_get());
+    assertion(function_type);
 
     const ast::Location& location = e.location_get();
-    // FIXME: Some code was deleted here (Grab name).
+    misc::symbol name = e.name_get();
 
-    // FIXME: Some code was deleted here (Actual arguments).
+    const ast::exps_type& actuals = e.args_get();
 
     // (Types of) formal arguments.
     const type::Record& formals = function_type->formals_get();
     // Desugar the arguments and handle possible polymorphic assignments.
-    // FIXME: Some code was deleted here.
+    ast::exps_type* args = recurse_args(actuals, formals);
 
-    // FIXME: Some code was deleted here (Instantiate into result).
+    result_ = new ast::CallExp(location, name, args);
   }
 
   /*------------------------------------.
@@ -785,36 +1024,43 @@ namespace object
   {
     // Check the type of the variable to see whether it is a class or
     // a record.
-    const type::Class* class_type;
-    // FIXME: Some code was deleted here.
+    const type::Class* class_type = class_type_query(e.var_get());
 
     // If this is not a class, delegate to the cloner.
     if (!class_type)
       return super_type::operator()(e);
 
-    // FIXME: Some code was deleted here (Grab name).
+    misc::symbol name = e.name_get();
 
     // Otherwise, desugar this FieldVar as an access to an attribute.
 
     // Look for the attribute within the class and its base classes.
     const type::Class* owner = nullptr;
     for (const type::Class* c = class_type; c; c = c->super_get())
-      {
-        // FIXME: Some code was deleted here.
-      }
+      if (c->owned_attr_find(name))
+        {
+          owner = c;
+          break;
+        }
     assertion(owner);
 
-    ast::Var* var;
-    // FIXME: Some code was deleted here (Recurse).
+    ast::Var* var = recurse(e.var_get());
 
-    ast::Exp* attr_var =
-      parse::parse(parse::Tweast() << var << "." << variant_field_prefix
-                                   << class_names_(owner) << "."
-                   // FIXME: Some code was deleted here.
-      );
+    ast::Exp* attr_var = parse::parse(
+      parse::Tweast() << var << attr_path(owner) << "."
+                      << attr_field_name(owner, name));
     result_ = attr_var;
   }
 
+  std::string DesugarVisitor::attr_path(const type::Class* owner)
+  {
+    // With the compact layout, the record of the object holds the
+    // attributes of all its super classes.
+    if (compact_)
+      return "";
+    return std::string(".") + variant_field_prefix + class_names_(owner).get();
+  }
+
   void DesugarVisitor::operator()(const ast::LetExp& e)
   {
     // Save the current scope situation for dispatched methods
@@ -838,61 +1084,60 @@ namespace object
 
   void DesugarVisitor::operator()(const ast::MethodCallExp& e)
   {
-    const type::Method* method_type;
-    // FIXME: Some code was deleted here (Initialize method_type).
+    // The object type checker bound the call to the method.
+    const type::Method* method_type =
+      dynamic_cast<const type::Method*>(e.def_get()->type_get());
+    precondition(method_type);
     const type::Class* owner_type = method_type->owner_get();
 
     const ast::Location& location = e.location_get();
     std::string name = dispatch_fun_name(owner_type, method_type);
 
-    // FIXME: Some code was deleted here (Fetch actual arguments).
+    const ast::exps_type& actuals = e.args_get();
 
     // (Types of) formal arguments.
     const type::Record& formals = method_type->formals_get();
     // Desugar the arguments and handle possible polymorphic assignements.
-    ast::exps_type* args;
-    // FIXME: Some code was deleted here (Initialize args).
+    ast::exps_type* args = recurse_args(actuals, formals);
 
     // Process the target of the method call, and convert it to the
     // expected type if needed.
-    ast::Exp* object;
-    // FIXME: Some code was deleted here (Recurse).
+    ast::Exp* object = recurse(e.get_object());
 
-    // FIXME: Some code was deleted here (Adapt type).
+    adapt_type(object, class_type_query(e.get_object()), owner_type);
     // Prepend the target to the actual arguments, as the desugared
     // method expects to find it as its first arguments.
     args->insert(args->begin(), object);
 
     // Turn the method call into a function call to the desugared method.
-    // FIXME: Some code was deleted here (Instanciate into result).
+    result_ = new ast::CallExp(location, name, args);
   }
 
   /*--------------------------.
   | New types and functions.  |
   `--------------------------*/
 
-  // Introduce a desugared builtin Object in the top-level function.
-  void DesugarVisitor::operator()(const ast::FunctionDec& e)
+  ast::ChunkList* DesugarVisitor::prologue()
   {
-    bool is_main;
-    // FIXME: Some code was deleted here (Setup is_main).
-    if (is_main)
-      {
-        // Desugared data structures of the builtin Object.
-        types_ << "   type " << class_variant_prefix
-               << "Object =" << variant_ty(&type::Class::object_instance());
-        // Object's class id.
-        class_ids_ << "   var  " << class_id_prefix
-                   << "Object := "
-                      "        "
-                   << type::Class::object_instance().id_get();
-      }
-
-    // Process E.
-    super_type::operator()(e);
-    if (is_main)
+    // Desugared data structures of the builtin Object.
+    if (compact_)
+      types_ << "   type " << class_layout_prefix
+             << "Object =" << layout_ty(&type::Class::object_instance());
+    else
+      types_ << "   type " << class_variant_prefix
+             << "Object =" << variant_ty(&type::Class::object_instance());
+    // Object's class id.
+    class_ids_ << "   var  " << class_id_prefix
+               << "Object := "
+                  "        "
+               << type::Class::object_instance().preorder_id_get();
+
+    // Object's ctor.
+    if (compact_)
+      layout_constructor(funs_tweast, &type::Class::object_instance(),
+                         "Object");
+    else
       {
-        // Object's ctor.
         funs_tweast << "   function " << class_ctor_prefix
                     << "Object() :"
                        "     "
@@ -906,19 +1151,35 @@ namespace object
         funs_tweast << variant_exp(&type::Class::object_instance(),
                                    &type::Class::object_instance(),
                                    object_init);
+      }
+
+    // Parse the built TWEASTs.
+    ast::ChunkList* types = parse::parse(types_);
+    ast::ChunkList* class_ids = parse::parse(class_ids_);
+    ast::ChunkList* funs = parse::parse(funs_tweast);
+    // Gather these declarations.  The conversion routines requested
+    // during the traversal only depend on the types and the class
+    // ids: put them in a single chunk before the other functions.
+    types->splice_back(*class_ids);
+    if (!casts_.empty())
+      types->emplace_back(cast_functions());
+    types->splice_back(*funs);
+    return types;
+  }
 
-        // Parse the built TWEASTs.
-        ast::ChunkList* types = parse::parse(types_);
-        ast::ChunkList* class_ids = parse::parse(class_ids_);
-        ast::ChunkList* funs = parse::parse(funs_tweast);
-        // Gather these declarations.
-        types->splice_back(*class_ids);
-        types->splice_back(*funs);
-        // Add them to the top of the program.
+  // Introduce a desugared builtin Object in the top-level function.
+  void DesugarVisitor::operator()(const ast::FunctionDec& e)
+  {
+    // Process E.
+    super_type::operator()(e);
+    if (e.name_get() == "_main")
+      {
+        // Add the declarations to the top of the program.
         auto res = dynamic_cast<ast::FunctionDec*>(result_);
         parse::Tweast input;
-        input << "let " << types << " in " << res->body_get() << " end";
+        input << "let " << prologue() << " in " << res->body_get() << " end";
         res->body_set(parse::parse(input));
+        prologue_injected_ = true;
       }
 
     // Cast the return value of the function if needed.
@@ -929,10 +1190,9 @@ namespace object
         if (body_type && result_type && body_type != result_type)
           {
             auto res = dynamic_cast<ast::FunctionDec*>(result_);
-            parse::Tweast input;
-            input << upcast_fun_name(body_type, result_type) << " ("
-                  << res->body_get() << ")";
-            res->body_set(parse::parse(input));
+            ast::Exp* body = res->body_get();
+            adapt_type(body, body_type, result_type);
+            res->body_set(body);
           }
       }
   }
@@ -946,8 +1206,7 @@ namespace object
 
     // Otherwise, desugar the name of E.
     const ast::Location& location = e.location_get();
-    result_ = new ast::NameTy(
-      location, class_variant_prefix + class_names_(class_type).get());
+    result_ = new ast::NameTy(location, object_type_name(class_type));
   }
 
 } // namespace object
@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include <map>
+#include <utility>
+#include <vector>
+
 #include <astclone/cloner.hh>
 #include <object/libobject.hh>
 #include <parse/tweast.hh>
@@ -21,8 +25,16 @@ namespace object
     // Import overloaded virtual functions.
     using super_type::operator();
 
-    /// Build a DesugarVisitor.
-    DesugarVisitor(const class_names_type& class_names);
+    /// \brief Build a DesugarVisitor.
+    ///
+    /// \param class_names  the names of the classes of the program
+    /// \param compact      whether to use the compact layout of objects:
+    ///                     instead of a variant holding every attribute
+    ///                     of the hierarchy, an object is a single
+    ///                     record whose fields are those of its super
+    ///                     class followed by its own, so that casts
+    ///                     reinterpret the object instead of allocating.
+    DesugarVisitor(const class_names_type& class_names, bool compact = false);
 
     /// Special version of the visit of a ChunkList allowing the
     /// transformation of an ast::ChunkInterface to either a single ast::ChunkInterface or
@@ -85,7 +97,7 @@ namespace object
     /// A list of classes (e.g., useful to represent a set of subclasses).
     using classes_type = std::vector<const type::Class*>;
 
-  private:
+  protected:
     /// \name Code generation.
     /// \{
 
@@ -102,6 +114,16 @@ namespace object
                              const type::Class* cls,
                              misc::symbol class_name);
 
+    /// \brief Initialize the attributes of \a c, on a record expression.
+    void attrs_init(parse::Tweast& functions, const type::Class* c);
+
+    /// \brief Desugar the constructor of the current class, with the
+    /// compact layout: allocate a single record, holding the attributes
+    /// of every class from Object down to \a cls.
+    void layout_constructor(parse::Tweast& functions,
+                            const type::Class* cls,
+                            misc::symbol class_name);
+
     /// \brief Desugar the current method.
     ///
     /// \param functions the tweast containing the method being desugared
@@ -117,13 +139,11 @@ namespace object
     /// \param e              the block of type being processed
     /// \param cls            the cls being desugared
     /// \param method         the method being dispatched
-    /// \param class_name     the desugared version of the class name
     /// \param sub_dispatches the processed classes/methods for dispatch
     void dispatch_function(parse::Tweast& functions,
                            const ast::TypeChunk& e,
                            const type::Class* cls,
                            const type::Method* method,
-                           misc::symbol class_name,
                            dispatch_list_type& sub_dispatches);
 
     /// \brief Handle a class declaration.
@@ -137,8 +157,6 @@ namespace object
     ///       class;
     /// (3) new functions:
     ///     - a constructor,
-    ///     - conversion routines used in polymorphic assignments (upcasts),
-    ///     - conversion routines used in dynamic dispatch (downcasts),
     ///     - (desugared) methods,
     ///     - dispatch functions.
     ///
@@ -150,7 +168,9 @@ namespace object
     /// visited.  Thus we collect all class definitions from E,
     /// replace them by new data structures ((2)) and inject the
     /// rest of the new material *after* the TypeChunk ((1) and
-    /// (3)).
+    /// (3)).  The conversion routines used in polymorphic assignments
+    /// (upcasts) and in dynamic dispatch (downcasts) are generated on
+    /// demand, once for the whole program (see cast_exp).
     void handle_class(const ast::TypeChunk& e,
                       const type::Class* cls,
                       parse::Tweast& functions,
@@ -162,19 +182,24 @@ namespace object
     /// \result             the name of the type
     std::string type_symbol(const type::Type* type);
 
-    /// Return the name of the upcast function between types \a from
-    /// and \a to.
-    std::string upcast_fun_name(const type::Class* from, const type::Class* to);
-    /// Return the name of the downcast function between types \a from
-    /// and \a to.
-    std::string downcast_fun_name(const type::Class* from,
-                                  const type::Class* to);
+    /// \brief Return the name of the conversion function from \a from
+    /// to \a to (an upcast or a downcast), and register it so that it
+    /// is generated once, by cast_functions.
+    misc::symbol cast_fun_name(const type::Class* from, const type::Class* to);
 
     /// Return the name of the dispatch function for \a method,
     /// defined in class \a owner.
     std::string dispatch_fun_name(const type::Class* owner,
                                   const type::Method* method);
 
+    /// \brief Convert \a exp from the class \a source to \a target.
+    ///
+    /// An upcast of the compact layout is an inline `_cast', the other
+    /// conversions call a routine registered by cast_fun_name.
+    ast::Exp* cast_exp(ast::Exp* exp,
+                       const type::Class* source,
+                       const type::Class* target);
+
     /// Check if the type \a source_type of \a source_exp matches
     /// \a target_type, and generate a type conversion wrapper if
     /// needed.
@@ -218,36 +243,50 @@ namespace object
     /// \return             the TWEAST on which the code is generated
     parse::Tweast* variant_ty(const type::Class* class_type);
 
-    /// \brief Populate an initialization list.
-    ///
-    /// \param class_type   the type of the class used to populate the list
-    /// \param inits        the initialization list
-    void fill_init_list(const type::Class* class_type, field_inits_type& inits);
+    /// \brief Generate code for the record of \a class_type in the
+    /// compact layout: the exact type, then the attributes of each
+    /// class from Object down to \a class_type.  The record of a class
+    /// is thus a prefix of the records of its subclasses.
+    parse::Tweast* layout_ty(const type::Class* class_type);
+
+    /// The name of the field holding the attribute \a attr of \a owner.
+    std::string attr_field_name(const type::Class* owner, misc::symbol attr);
 
-    /// \brief Generate a conversion routine.
+    /// \brief The field path from an object to the record holding the
+    /// attributes of \a owner (empty with the compact layout).
+    std::string attr_path(const type::Class* owner);
+
+    /// The name of the desugared type of the objects of \a cls.
+    std::string object_type_name(const type::Class* cls);
+
+    /// \brief Generate a conversion routine, directly as an AST.
     ///
-    /// \param name         the type of the generated function
     /// \param source       the type of the converted value
     /// \param target       the target type of the conversion
-    /// \param exact_type   the exact type of the returned variant
-    /// \return             the TWEAST on which the code is generated
-    parse::Tweast* cast_function(const std::string& name,
-                                 const type::Class* source,
-                                 const type::Class* target,
-                                 const type::Class* exact_type);
-
-    /// Syntactic sugar for object::DesugarVisitor::cast_function,
-    /// used to generate an upcast function.
-    parse::Tweast* upcast_function(const type::Class* source,
-                                   const type::Class* target);
+    /// \param name         the name of the generated function
+    /// \return             the conversion routine
+    ast::FunctionDec* cast_function(const type::Class* source,
+                                    const type::Class* target,
+                                    misc::symbol name);
+
+    /// \brief Generate the conversion routines registered by
+    /// cast_fun_name.
+    ///
+    /// They are injected once, after the class ids (see prologue).
+    ast::FunctionChunk* cast_functions();
 
-    /// Syntactic sugar for object::DesugarVisitor::cast_function,
-    /// used to generate a downcast function.
-    parse::Tweast* downcast_function(const type::Class* source,
-                                     const type::Class* target);
+    /// \brief Gather the declarations introduced by the classes: the
+    /// types, the class ids, the conversion routines and the functions,
+    /// including those of the builtin Object.
+    ///
+    /// They are injected once, at the top of `_main', or at the top of
+    /// a tree without `_main' (e.g., an imported module alone).
+    ast::ChunkList* prologue();
 
     /// \brief Generate an expression looking like a switch
-    /// expression, to dispatch a method call. Do not generate code
+    /// expression, to dispatch a method call.  The class ids being
+    /// preorder ids, this is a binary search on intervals of ids, in
+    /// O(log n) tests for n overridings.  Do not generate code
     /// for classes outside typechunk. If this function is used to create a sub
     /// dispatch function, recursive call should be true, in order to call
     /// the previous dispatch function if nothing matches.
@@ -262,6 +301,26 @@ namespace object
                               const ast::TypeChunk* typechunk,
                               const type::Method* dispatch_method = nullptr);
 
+    /// Ranges of consecutive class preorder ids sharing the same
+    /// implementation of a method: the first id of the range, and the
+    /// class owning the implementation (null for the fallback of a sub
+    /// dispatch function).
+    using dispatch_intervals_type =
+      std::vector<std::pair<unsigned, const type::Class*>>;
+
+    /// \brief Generate a balanced binary decision tree on the exact
+    /// type of self, selecting among \a intervals [\a first, \a last).
+    ///
+    /// The other arguments are those of dispatch_switch.
+    void dispatch_tree(parse::Tweast& input,
+                       const dispatch_intervals_type& intervals,
+                       std::size_t first,
+                       std::size_t last,
+                       const type::Class* class_type,
+                       const type::Method* method,
+                       const ast::VarChunk& formals,
+                       const type::Method* dispatch_method);
+
     /// \brief Generate a (static) call to a desugared method.
     ///
     /// \note The dynamic dispatch must have been performed before
@@ -269,12 +328,13 @@ namespace object
     ///
     /// \param class_name   the class where the method resides
     /// \param method_name  the name of the method
-    /// \param target       the name of the target (object)
+    /// \param target       the target (object), already cast to the
+    ///                     class of the method
     /// \param formals      the actual arguments (other than the target)
     /// \return             the TWEAST on which the code is generated
     parse::Tweast* method_call(misc::symbol class_name,
                                misc::symbol method_name,
-                               const std::string& target,
+                               ast::Exp* target,
                                const ast::VarChunk& formals);
 
     /// \}
@@ -282,14 +342,27 @@ namespace object
   private:
     /// The names of the classes defined in the program.
     class_names_type class_names_;
+    /// Whether objects use the compact layout.
+    bool compact_;
 
     /// TWEAST of desugared types.
     parse::Tweast types_;
     /// TWEAST of class ids.
     parse::Tweast class_ids_;
 
-    /// TWEAST of upcast functions.
+    /// TWEAST of the top-level functions.
     parse::Tweast funs_tweast;
+    /// The depth of the visited ChunkList, to find the top-level one.
+    unsigned chunk_lists_ = 0;
+    /// Whether the prologue was injected in `_main'.
+    bool prologue_injected_ = false;
+
+    /// A conversion, from a class to another.
+    using cast_type = std::pair<const type::Class*, const type::Class*>;
+    /// The names of the conversion routines requested so far.
+    std::map<cast_type, misc::symbol> cast_names_;
+    /// The conversion routines requested so far, in order.
+    std::vector<cast_type> casts_;
 
     /// Vector keeping track of added dispatch functions within a scope.
     misc::vector<const type::Method*> dispatch_added_;
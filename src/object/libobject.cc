@@ -5,8 +5,8 @@
 
 #include <memory>
 
-// FIXME: Some code was deleted here.
 #include <desugar/libdesugar.hh>
+#include <object/binder.hh>
 #include <object/desugar-visitor.hh>
 #include <object/libobject.hh>
 #include <object/renamer.hh>
@@ -18,7 +18,12 @@ namespace object
   | Bind.  |
   `-------*/
 
-  // FIXME: Some code was deleted here.
+  misc::error bind(ast::Ast& tree)
+  {
+    Binder bind;
+    bind(tree);
+    return bind.error_get();
+  }
 
   /*----------------.
   | Compute types.  |
@@ -48,19 +53,21 @@ namespace object
   `------------------*/
 
   template <typename A>
-  A* raw_desugar(const A& tree, const class_names_type& class_names)
+  A* raw_desugar(const A& tree,
+                 const class_names_type& class_names,
+                 bool compact)
   {
     // Desugar.
-    DesugarVisitor desugar(class_names);
+    DesugarVisitor desugar(class_names, compact);
     desugar(tree);
     return dynamic_cast<A*>(desugar.result_get());
   }
 
   template <typename A>
-  A* desugar(const A& tree, const class_names_type& class_names)
+  A* desugar(const A& tree, const class_names_type& class_names, bool compact)
   {
     // Desugar.
-    A* desugared = raw_desugar(tree, class_names);
+    A* desugared = raw_desugar(tree, class_names, compact);
     assertion(desugared);
     std::unique_ptr<A> desugared_ptr(desugared);
     // Recompute the bindings and the types.
@@ -70,8 +77,10 @@ namespace object
 
   /// Explicit instantiations.
   template ast::ChunkList* raw_desugar(const ast::ChunkList&,
-                                       const class_names_type&);
+                                       const class_names_type&,
+                                       bool);
   template ast::ChunkList* desugar(const ast::ChunkList&,
-                                   const class_names_type&);
+                                   const class_names_type&,
+                                   bool);
 
 } // namespace object
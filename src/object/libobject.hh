@@ -17,7 +17,12 @@ namespace object
   | Bind.  |
   `-------*/
 
-  // FIXME: Some code was deleted here.
+  /** \brief Bind the identifiers, allowing objects.
+
+      \param tree abstract syntax tree's root.
+
+      \return success of the binding.  */
+  misc::error bind(ast::Ast& tree);
 
   /*----------------.
   | Compute types.  |
@@ -51,10 +56,13 @@ namespace object
                          and types have been computed, and whose
                          identifiers are all unique.
       \param class_names the names of the class types of the AST
+      \param compact     whether to use the compact layout of objects
 
       \return     the desugared, bound and type-checked AST.  */
   template <typename A>
-  A* desugar(const A& tree, const class_names_type& class_names);
+  A* desugar(const A& tree,
+             const class_names_type& class_names,
+             bool compact = false);
 
   /** \brief Remove objects constructs from an AST without recomputing
       its bindings nor its types.
@@ -67,9 +75,12 @@ namespace object
 
       \param tree        AST to desugar.
       \param class_names the names of the class types of the AST
+      \param compact     whether to use the compact layout of objects
 
       \return            the desugared AST.  */
   template <typename A>
-  A* raw_desugar(const A& tree, const class_names_type& class_names);
+  A* raw_desugar(const A& tree,
+                 const class_names_type& class_names,
+                 bool compact = false);
 
 } // namespace object
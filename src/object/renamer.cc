@@ -3,6 +3,7 @@
  ** \brief Implementation of object::Renamer.
  */
 
+#include <ast/all.hh>
 #include <object/renamer.hh>
 
 namespace object
@@ -34,7 +35,8 @@ namespace object
 
   void Renamer::operator()(ast::MethodChunk& e)
   {
-    // FIXME: Some code was deleted here (Just recurse on children nodes).
+    for (ast::MethodDec* m : e)
+      m->accept(*this);
   }
 
   void Renamer::operator()(ast::MethodDec& e)
@@ -54,19 +56,25 @@ namespace object
   void Renamer::operator()(ast::TypeDec& e)
   {
     // Rename.
-    // FIXME: Some code was deleted here.
+    super_type::operator()(e);
 
     // Collect the name of the classes.
-    // FIXME: Some code was deleted here.
+    if (auto class_type =
+          dynamic_cast<const type::Class*>(&e.type_get()->actual());
+        class_type && dynamic_cast<const ast::ClassTy*>(&e.ty_get()))
+      misc::put(*class_names_, class_type, e.name_get());
   }
 
   /*-----------------------.
   | Visiting usage sites.  |
   `-----------------------*/
 
+  // The methods are found by the type of the object, not renamed.
   void Renamer::operator()(ast::MethodCallExp& e)
   {
-    // FIXME: Some code was deleted here.
+    e.get_object().accept(*this);
+    for (ast::Exp* arg : e.args_get())
+      arg->accept(*this);
   }
 
   /*--------------------------------------.
@@ -75,12 +83,16 @@ namespace object
 
   void Renamer::operator()(ast::ClassTy& e)
   {
-    // FIXME: Some code was deleted here.
+    e.super_get().accept(*this);
+    bool saved_within_class_ty = within_class_ty_;
+    within_class_ty_ = true;
+    e.chunks_get().accept(*this);
+    within_class_ty_ = saved_within_class_ty;
   }
 
   void Renamer::operator()(ast::ObjectExp& e)
   {
-    // FIXME: Some code was deleted here.
+    e.type_name_get().accept(*this);
   }
 
   /*--------------.
@@ -17,7 +17,11 @@ namespace object::tasks
 {
   void object_parse() {}
 
-  // FIXME: Some code was deleted here.
+  void object_bind()
+  {
+    task_error() << ::object::bind(*ast::tasks::the_program)
+                 << &misc::error::exit_on_error;
+  }
 
   void object_types_compute()
   {
@@ -34,14 +38,14 @@ namespace object::tasks
 
   void object_desugar()
   {
-    astclone::apply(::object::desugar, ast::tasks::the_program,
-                    *class_names.get());
+    ast::tasks::the_program.reset(::object::desugar(
+      *ast::tasks::the_program, *class_names.get(), object_compact_p));
   }
 
   void raw_object_desugar()
   {
-    astclone::apply(::object::raw_desugar, ast::tasks::the_program,
-                    *class_names.get());
+    ast::tasks::the_program.reset(::object::raw_desugar(
+      *ast::tasks::the_program, *class_names.get(), object_compact_p));
   }
 
 } // namespace object::tasks
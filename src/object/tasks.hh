@@ -24,7 +24,11 @@ namespace object::tasks
                object_parse,
                "object parse");
 
-  // FIXME: Some code was deleted here.
+  /// Bind the identifiers, allowing objects.
+  TASK_DECLARE("object-bindings-compute",
+               "bind the identifiers, allowing objects",
+               object_bind,
+               "object-parse");
 
   /// Check for type violation, allowing objects.
   TASK_DECLARE("object-types-compute",
@@ -39,6 +43,16 @@ namespace object::tasks
                object_rename,
                "object-types-compute");
 
+  /// Use the compact layout of objects when desugaring.  Experimental:
+  /// the method calls and the polymorphic assignments of the desugarer
+  /// are not implemented yet.
+  BOOLEAN_TASK_DECLARE("object-compact",
+                       "[experimental] desugar objects as single "
+                       "records extending those of their super classes, "
+                       "so that casts do not allocate",
+                       object_compact_p,
+                       "");
+
   /// Remove syntactic sugar from the Ast.
   TASK_DECLARE("object-desugar",
                "remove object constructs from the program",
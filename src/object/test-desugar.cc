@@ -1,116 +1,97 @@
 /// Checking the removal of object constructs.
 
-#include <cstdlib>
-#include <iostream>
+#include <memory>
+#include <string>
 
-#include <ast/chunk-list.hh>
-#include <ast/exp.hh>
-#include <ast/libast.hh>
-#include <bind/libbind.hh>
-#include <object/desugar-visitor.hh>
+#include <ast/all.hh>
+#include <misc/contract.hh>
 #include <object/libobject.hh>
-#include <parse/libparse.hh>
-#include <type/libtype.hh>
-/*
-static void desugar(const std::string& s)
-{
-  // Parse, bind and type-check the input.
-  ast::Ast* tree = nullptr;
-  object::class_names_type* class_names = nullptr;
-  try
-    {
-      tree = parse::parse_unit(s, true);
-      std::cout << "/* === Original tree...  *//*\n" << *tree << '\n';
-      object::bind(*tree).exit_on_error();
-      object::types_check(*tree).exit_on_error();
-      class_names = object::rename(*tree);
-      std::cout << "/* === Renamed tree...  *//*\n" << *tree << '\n';
-    }
-  catch (const misc::error& error)
-    {
-      std::cerr << "error-->" << error << '\n';
-      exit(error.status_get_value());
-    }
+#include <testing.hh>
 
-  // Desugar the tree.
-  object::DesugarVisitor desugar(*class_names);
-  desugar(tree);
-  delete tree;
-  tree = nullptr;
-  ast::Ast* desugared = desugar.result_get();
-  std::cout << "/* === Desugared tree...  *//*\n" << *desugared << '\n';
+using namespace ast;
 
-  // Compute the bindings and the types on the desugared tree.
-  try
-    {
-      bind::bind(*desugared).exit_on_error();
-      type::types_check(*desugared).exit_on_error();
-    }
-  catch (const misc::error& error)
-    {
-      std::cerr << "error-->" << error << '\n';
-      exit(error.status_get_value());
-    }
+const char* program_name = "test-desugar";
 
-  delete desugared;
-  delete class_names;
+// Parse \a body with objects, compute its bindings and types, and
+// desugar it, which binds and type-checks the desugared tree again.
+static ChunkList* desugar(const std::string& body)
+{
+  std::unique_ptr<ChunkList> tree(
+    parse::parse_unit("let primitive print(s : string)"
+                      "    primitive print_int(i : int) "
+                      "in "
+                        + body + " end",
+                      true));
+  assertion(tree);
+  assertion(!object::bind(*tree));
+  assertion(!object::types_check(*tree));
+  std::unique_ptr<object::class_names_type> class_names(
+    object::rename(*tree));
+  ChunkList* res = object::desugar(*tree, *class_names);
+  assertion(res);
+  escapes::escapes_compute(*res);
+  return res;
+}
+
+// Desugar \a body, and check that it prints \a output.
+static void test_desugar(const std::string& body, const std::string& output)
+{
+  std::unique_ptr<ChunkList> tree(desugar(body));
+  testing::run_check(body, testing::program_interpret(*tree), {0, output});
 }
 
-const char* program_name = "test-desugar";
-*/
 int main()
 {
-  /*
-  std::cout << "/* Test 1.  *//*\n";
-  desugar(" let"
-          "   type A = class"
-          "   {"
-          "     var s := \"Hello\""
-          "     method m() = ()"
-          "   }"
-          "   "
-          "   var a : A := new A"
-          " in"
-          "   a.s;"
-          "   a.m()"
-          " end");
-  std::cout << "\n\n"
-            << "/* Test 2.  *//*\n";
-  desugar(" let"
-          "   primitive print(s : string)"
-          "   "
-          "   class A"
-          "   {"
-          "     var s := \"Hello\""
-          "     method m() = (print(self.s); print(\"\\n\"))"
-          "   }"
-          "   class B extends A"
-          "   {"
-          "     var s2 := \" World!\""
-          "     method m() = (print(self.s); print(self.s2);"
-          "                    print(\"\\n\"))"
-          "   }"
-          "   "
-          "   var b : B := new B"
-          "   var a : A := b"
-          "   var a2 : A := new B"
-          " in"
-          "   b.m();"
-          "   a.m();"
-          "   a2.m();"
-          "   a := a2;"
-          "   a := b"
-          " end");
-  std::cout << "\n\n"
-            << "/* Test 3.  *//*\n";
-  desugar(" let"
-          "   class A {}"
-          "   class B extends A {}"
-          "   function id(a : A) : A = a"
-          "   var b := new B"
-          "   var a := id(b)"
-          " in"
-          " end");
-*/
-return 0;
+  // The attributes, and the methods.
+  test_desugar("let class A"
+               "    {"
+               "      var s := \"Hello\""
+               "      method m() = print(self.s)"
+               "    }"
+               "    var a : A := new A "
+               "in a.s; a.m() end",
+               "Hello");
+
+  // The overriding method is called through a variable of the base
+  // class: the dispatch is on the exact type of the object.
+  test_desugar("let class A"
+               "    {"
+               "      var x := 1"
+               "      method m() : int = self.x"
+               "    }"
+               "    class B extends A"
+               "    {"
+               "      method m() : int = 2"
+               "    }"
+               "    var a : A := new B"
+               "    var b : A := new A "
+               "in print_int(a.m()); print_int(b.m()) end",
+               "21");
+  test_desugar("let class A"
+               "    {"
+               "      var s := \"Hello\""
+               "      method m() = print(self.s)"
+               "    }"
+               "    class B extends A"
+               "    {"
+               "      var s2 := \" World!\""
+               "      method m() = (print(self.s); print(self.s2))"
+               "    }"
+               "    var b : B := new B"
+               "    var a : A := b"
+               "    var a2 : A := new A "
+               "in b.m(); a.m(); a2.m(); a := a2; a.m(); a := b; a.m() end",
+               "Hello World!Hello World!HelloHelloHello World!");
+
+  // The upcasts of the arguments and of the results.
+  test_desugar("let class A {}"
+               "    class B extends A"
+               "    {"
+               "      method m() : int = 3"
+               "    }"
+               "    function id(a : A) : A = a"
+               "    var b := new B"
+               "    var a := id(b) "
+               "in print_int(b.m()) end",
+               "3");
 }
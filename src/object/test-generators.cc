@@ -0,0 +1,164 @@
+/// Checking the code generated for the classes, without a program.
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <variant>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <misc/contract.hh>
+#include <object/desugar-visitor.hh>
+#include <object/libobject.hh>
+#include <parse/libparse.hh>
+#include <parse/tweast.hh>
+#include <type/builtin-types.hh>
+#include <type/class.hh>
+#include <type/method.hh>
+#include <type/record.hh>
+
+using namespace ast;
+
+const char* program_name = "test-generators";
+
+namespace
+{
+  /// Expose the generators of the desugarer.
+  struct Generators : object::DesugarVisitor
+  {
+    using object::DesugarVisitor::DesugarVisitor;
+    using object::DesugarVisitor::cast_exp;
+    using object::DesugarVisitor::cast_functions;
+    using object::DesugarVisitor::dispatch_intervals_type;
+    using object::DesugarVisitor::dispatch_tree;
+    using object::DesugarVisitor::layout_ty;
+  };
+
+  /// The text of \a input.
+  std::string text(parse::Tweast* input)
+  {
+    std::unique_ptr<parse::Tweast> t(input);
+    t->flatten();
+    return t->input_get();
+  }
+
+  /// The printing of \a ast.
+  std::string text(const Ast& ast)
+  {
+    std::ostringstream o;
+    o << ast;
+    return o.str();
+  }
+
+  /// An attribute \a name of type \a type.
+  VarDec* attribute(misc::symbol name, const type::Type& type)
+  {
+    auto res = new VarDec(Location(), name, nullptr, nullptr);
+    res->type_set(&type);
+    return res;
+  }
+} // namespace
+
+int main()
+{
+  // Object <- A {x : int} <- B {x : string}, and A <- C <- D.  B's x
+  // hides A's: preorder ids Object 0, A 1, B 2, C 3, D 4.
+  const type::Class& object = type::Class::object_instance();
+  type::Class a(&object);
+  type::Class b(&a);
+  type::Class c(&a);
+  type::Class d(&c);
+  std::unique_ptr<VarDec> a_x(attribute("x", type::Int::instance()));
+  std::unique_ptr<VarDec> b_x(attribute("x", type::String::instance()));
+  a.attr_add(a_x.get());
+  b.attr_add(b_x.get());
+  for (const type::Class* cls : {&a, &b, &c, &d})
+    object.subclass_add(cls);
+  for (const type::Class* cls : {&b, &c, &d})
+    a.subclass_add(cls);
+  c.subclass_add(&d);
+  object.preorder_compute();
+
+  object::class_names_type names;
+  names[&object] = "Object";
+  names[&a] = "A";
+  names[&b] = "B";
+  names[&c] = "C";
+  names[&d] = "D";
+
+  // The compact layout: a record of the super class is a prefix of the
+  // record of its subclasses, whose fields are qualified by their owner.
+  {
+    Generators compact(names, true);
+    std::string layout = text(compact.layout_ty(&b));
+    std::cout << layout;
+    assertion(layout == " { exact_type : int, A_x : int, B_x : string }\n");
+    assertion(text(compact.layout_ty(&c))
+              == " { exact_type : int, A_x : int }\n");
+
+    // An upcast reinterprets the object in place.
+    std::unique_ptr<Exp> up(
+      compact.cast_exp(new SimpleVar(Location(), "b"), &b, &a));
+    std::cout << *up << '\n';
+    assertion(text(*up) == "_cast(b, _layout_A)");
+
+    // A downcast checks that the exact type is within the preorder
+    // interval of the target.
+    std::unique_ptr<Exp> down(
+      compact.cast_exp(new SimpleVar(Location(), "a"), &a, &b));
+    std::cout << *down << '\n';
+    assertion(text(*down) == "_downcast_A_to_B(a)");
+    std::unique_ptr<FunctionChunk> casts(compact.cast_functions());
+    std::cout << *casts << '\n';
+    assertion(casts->decs_get().size() == 1);
+    std::string cast = text(*casts);
+    assertion(cast.find("source.exact_type < 2") != std::string::npos);
+    assertion(cast.find("source.exact_type > 2") != std::string::npos);
+    assertion(cast.find("_cast(source, _layout_B)") != std::string::npos);
+  }
+
+  // The variant layout copies the object in a routine, in both ways.
+  {
+    Generators variant(names);
+    std::unique_ptr<Exp> up(
+      variant.cast_exp(new SimpleVar(Location(), "b"), &b, &a));
+    std::cout << *up << '\n';
+    assertion(text(*up) == "_upcast_B_to_A(b)");
+    std::unique_ptr<FunctionChunk> casts(variant.cast_functions());
+    std::cout << *casts << '\n';
+    assertion(casts->decs_get().size() == 1);
+  }
+
+  // A method m of A, overridden by B and D: the dispatch is a balanced
+  // binary search over the runs of ids sharing an implementation.
+  {
+    Generators compact(names, true);
+    // The method owns its formals.
+    type::Method m("m", &a, new type::Record, type::Void::instance(),
+                   nullptr);
+    VarChunk args((Location()));
+    Generators::dispatch_intervals_type intervals = {
+      {1, &a}, {2, &b}, {3, &a}, {4, &d}};
+    parse::Tweast input;
+    compact.dispatch_tree(input, intervals, 0, intervals.size(), &a, &m, args,
+                          nullptr);
+    std::unique_ptr<Exp> dispatch(std::get<Exp*>(parse::parse(input)));
+    std::cout << *dispatch << '\n';
+    std::string tree = text(*dispatch);
+    // The root splits the ids in two halves, each split once more.
+    assertion(tree.starts_with("if (self.exact_type < 3)"));
+    assertion(tree.find("if (self.exact_type < 2)") != std::string::npos);
+    assertion(tree.find("if (self.exact_type < 4)") != std::string::npos);
+    // The subclasses get self cast down to them, C inherits A's.
+    assertion(tree.find("_method_A_m(self)") != std::string::npos);
+    assertion(tree.find("_method_B_m(_downcast_A_to_B(self))")
+              != std::string::npos);
+    assertion(tree.find("_method_D_m(_downcast_A_to_D(self))")
+              != std::string::npos);
+  }
+
+  object.subclasses_clear();
+  a.subclasses_clear();
+  c.subclasses_clear();
+}
@@ -8,6 +8,7 @@
 
 #include <ast/all.hh>
 #include <object/type-checker.hh>
+#include <type/type-arena.hh>
 #include <type/types.hh>
 
 namespace object
@@ -21,7 +22,7 @@ namespace object
 
     // `self' variables are the only valid variables having a null
     // declaration site.  Use this property to tag them as read-only.
-    // FIXME: Some code was deleted here.
+    var_read_only_.insert(nullptr);
   }
 
   /*--------------------------.
@@ -34,18 +35,28 @@ namespace object
 
   void TypeChecker::operator()(ast::SimpleVar& e)
   {
-    // FIXME: Some code was deleted here.
+    // `self' is the object of the current method.
+    if (!e.def_get())
+      {
+        assertion(current_);
+        type_default(e, current_);
+      }
+    else
+      super_type::operator()(e);
   }
 
   void TypeChecker::operator()(ast::FieldVar& e)
   {
-    const type::Type* def_type = nullptr;
-    // FIXME: Some code was deleted here (Grab type).
+    const type::Type* def_type = type(e.var_get());
     auto class_type = dynamic_cast<const type::Class*>(&def_type->actual());
 
     if (class_type)
       {
-        // FIXME: Some code was deleted here.
+        // The attributes of the super classes are those of the class.
+        const type::Attribute* attr = class_type->attr_find(e.name_get());
+        if (!attr)
+          return error_and_recover(e, "unknown attribute", e.name_get());
+        type_default(e, &attr->type_get());
       }
     else
       super_type::operator()(e);
@@ -58,7 +69,10 @@ namespace object
   // Handle the case of `Object'.
   void TypeChecker::operator()(ast::NameTy& e)
   {
-    // FIXME: Some code was deleted here.
+    if (e.name_get() == "Object" && !e.def_get())
+      type_default(e, &type::Class::object_instance());
+    else
+      super_type::operator()(e);
   }
 
   /*-----------------.
@@ -79,7 +93,20 @@ namespace object
     // in
     //    a.print() /* error */
     // end
-    // FIXME: Some code was deleted here.
+    const type::Type* then_type = type(e.get_thenclause());
+    const type::Type* else_type =
+      &e.get_elseclause() ? type(e.get_elseclause()) : nullptr;
+    auto then_class = dynamic_cast<const type::Class*>(&then_type->actual());
+    auto else_class = else_type
+      ? dynamic_cast<const type::Class*>(&else_type->actual())
+      : nullptr;
+    if (!then_class || !else_class)
+      return super_type::operator()(e);
+
+    // The type of E is the nearest common super class of the branches.
+    check_types(e, "condition type", *type(e.get_test()), "expected type",
+                type::Int::instance());
+    type_default(e, then_class->common_root(*else_class));
   }
 
   void TypeChecker::operator()(ast::OpExp& e)
@@ -95,17 +122,38 @@ namespace object
     // in
     //   a = b
     // end
-    // FIXME: Some code was deleted here.
+    const type::Type* left = type(e.left_get());
+    const type::Type* right = type(e.right_get());
+    auto left_class = dynamic_cast<const type::Class*>(&left->actual());
+    auto right_class = dynamic_cast<const type::Class*>(&right->actual());
+    if (left_class && right_class && left_class != right_class)
+      type_mismatch(e, "left operand", *left, "right operand", *right);
+    super_type::operator()(e);
   }
 
   void TypeChecker::operator()(ast::ObjectExp& e)
   {
-    // FIXME: Some code was deleted here.
+    const type::Type* type_name = type(e.type_name_get());
+    if (!dynamic_cast<const type::Class*>(&type_name->actual()))
+      return error_and_recover(e, "class expected", *type_name);
+    type_default(e, type_name);
   }
 
   void TypeChecker::operator()(ast::MethodCallExp& e)
   {
-    // FIXME: Some code was deleted here.
+    const type::Type* object = type(e.get_object());
+    auto class_type = dynamic_cast<const type::Class*>(&object->actual());
+    if (!class_type)
+      return error_and_recover(e, "class expected", *object);
+
+    // Bind the call to the nearest definition of the method.
+    const type::Method* method = class_type->meth_find(e.name_get());
+    if (!method)
+      return error_and_recover(e, "unknown method", e.name_get());
+    e.def_set(const_cast<ast::MethodDec*>(method->def_get()));
+
+    check_actuals(e, e.args_get(), method->formals_get());
+    type_default(e, &method->result_get());
   }
 
   /*-----------------.
@@ -156,7 +204,13 @@ namespace object
   {
     assertion(current_);
 
-    // FIXME: Some code was deleted here.
+    const type::Record* formals = type(e.formals_get());
+    const type::Type* result = e.result_get()
+      ? type(*e.result_get())
+      : &type::Void::instance();
+    auto method =
+      arena_.make<type::Method>(e.name_get(), current_, formals, *result, &e);
+    type_default(e, method);
 
     // Check for multiple definitions in the current class.
     for (const type::Method* m : current_->meths_get())
@@ -164,9 +218,23 @@ namespace object
         return error(e, "method multiply defined", e.name_get());
 
     // Check for signature conformance w.r.t. super class, if applicable.
-    const auto* super_meth_type =
-      dynamic_cast<const type::Method*>(current_->meth_type(e.name_get()));
-    // FIXME: Some code was deleted here.
+    const type::Method* super_meth_type = current_->super_get()
+      ? current_->super_get()->meth_find(e.name_get())
+      : nullptr;
+    if (super_meth_type)
+      {
+        bool conform = super_meth_type->result_get() == *result
+          && super_meth_type->formals_get().fields_get().size()
+            == formals->fields_get().size();
+        auto super_formal = super_meth_type->formals_get().begin();
+        for (const type::Field& formal : *formals)
+          conform =
+            conform && (super_formal++)->type_get() == formal.type_get();
+        if (!conform)
+          return error(e, "method signature mismatch with the super class",
+                       e.name_get());
+      }
+    current_->meth_add(method);
   }
 
   // Type check this method's body.
@@ -220,19 +288,34 @@ namespace object
   // Don't handle members, as visit_dec_members is in charge of this task.
   void TypeChecker::operator()(ast::ClassTy& e)
   {
-    // FIXME: Some code was deleted here (Create class).
-
-    // FIXME: Some code was deleted here (Set the type of the super class).
-
-    // FIXME: Some code was deleted here (Recursively update the list of subclasses of the super classes).
+    auto class_type = arena_.make<type::Class>();
+    type_default(e, class_type);
+    created_type_default(e, class_type);
+
+    // The super class may be declared later in the same chunk, in
+    // which case its name is not bound to a type yet.
+    const type::Type* super = type(e.super_get());
+    if (auto named = dynamic_cast<const type::Named*>(super);
+        named && !named->type_get())
+      return error(e.super_get(), "super class not yet defined",
+                   e.super_get().name_get());
+    auto super_class = dynamic_cast<const type::Class*>(&super->actual());
+    if (!super_class)
+      return error(e.super_get(), "super class expected", *super);
+    class_type->super_set(super_class);
+
+    // Register the class in the (transitive) subclasses of its
+    // ancestors: the desugarer numbers the classes in preorder from
+    // those of Object.
+    for (const type::Class* c = super_class; c; c = c->super_get())
+      c->subclass_add(class_type);
   }
 
   // Handle the members of a class.
   void TypeChecker::visit_dec_members(ast::ClassTy& e)
   {
     assertion(!within_class_body_p_); // Should be false by the time we get here
-    const type::Type* type = nullptr;
-    // FIXME: Some code was deleted here.
+    const type::Type* type = e.type_get();
 
     assertion(type);
     auto class_type = dynamic_cast<const type::Class*>(type);
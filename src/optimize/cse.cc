@@ -0,0 +1,471 @@
+/**
+ ** \file optimize/cse.cc
+ ** \brief Implementation of optimize::Cse.
+ */
+
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+#include <ast/all.hh>
+#include <effects/libeffects.hh>
+#include <misc/set.hh>
+#include <optimize/cse.hh>
+#include <parse/libparse.hh>
+#include <parse/tweast.hh>
+#include <type/builtin-types.hh>
+
+namespace optimize
+{
+  using namespace ast;
+
+  std::ostream& operator<<(std::ostream& ostr, const CseStats& s)
+  {
+    ostr << "/* Common subexpression elimination statistics.  */\n"
+         << "eliminated: " << s.eliminated << '\n';
+    for (const auto& [name, count] : s.functions)
+      ostr << "  " << name << ": " << count << '\n';
+    return ostr;
+  }
+
+  namespace
+  {
+    /// Whether \a e is a leaf: a literal or a variable.
+    bool leaf_p(const Exp& e)
+    {
+      return dynamic_cast<const IntExp*>(&e)
+        || dynamic_cast<const StringExp*>(&e)
+        || dynamic_cast<const NilExp*>(&e)
+        || dynamic_cast<const SimpleVar*>(&e);
+    }
+
+    /// Whether the value of \a e may be shared: \a e is made of loads,
+    /// operations and calls without writes, input/output nor
+    /// allocations.
+    bool candidate_p(const Exp& e);
+
+    /// Whether \a e is a candidate or a leaf.
+    bool operand_p(const Exp& e) { return leaf_p(e) || candidate_p(e); }
+
+    bool candidate_p(const Exp& e)
+    {
+      if (auto field = dynamic_cast<const FieldVar*>(&e))
+        return operand_p(field->var_get());
+      if (auto sub = dynamic_cast<const SubscriptVar*>(&e))
+        return operand_p(sub->var_get()) && operand_p(sub->index_get());
+      if (auto op = dynamic_cast<const OpExp*>(&e))
+        return operand_p(op->left_get()) && operand_p(op->right_get());
+      if (auto call = dynamic_cast<const CallExp*>(&e))
+        {
+          // A temporary cannot hold the value of a procedure.  Each
+          // call to a function which allocates returns a new record.
+          if ((effects::call_effects(call->def_get())
+               & (Effectful::writes | Effectful::io | Effectful::allocates))
+              || dynamic_cast<const type::Void*>(&call->type_get()->actual()))
+            return false;
+          for (const Exp* arg : call->args_get())
+            if (!operand_p(*arg))
+              return false;
+          return true;
+        }
+      return false;
+    }
+
+    /// Whether evaluating \a e itself (not its operands) may fail.
+    bool partial_p(const Exp& e)
+    {
+      if (dynamic_cast<const FieldVar*>(&e)
+          || dynamic_cast<const SubscriptVar*>(&e))
+        return true;
+      if (auto op = dynamic_cast<const OpExp*>(&e))
+        {
+          auto divisor = dynamic_cast<const IntExp*>(&op->right_get());
+          return op->oper_get() == OpExp::Oper::div
+            && !(divisor && divisor->value_get());
+        }
+      if (auto call = dynamic_cast<const CallExp*>(&e))
+        return effects::call_effects(call->def_get()) != Effectful::pure;
+      return false;
+    }
+
+    /// Number the values of a sequence.
+    class ValueNumbering
+    {
+    public:
+      /// A value.
+      struct value
+      {
+        /// Its first occurrence.
+        const Exp* first;
+        /// The index of the expression of the sequence where it first
+        /// appears.
+        unsigned element;
+        /// Its occurrences, the first one included.
+        std::vector<const Exp*> occurrences;
+      };
+
+      explicit ValueNumbering(const exps_type& exps)
+      {
+        for (const Exp* exp : exps)
+          {
+            effects_ = false;
+            walk(*exp);
+            ++element_;
+          }
+      }
+
+      /// The values, in the order of their first occurrence.
+      std::vector<value> values;
+
+    private:
+      /// What may change a value.
+      struct deps
+      {
+        /// The variables it reads.
+        misc::set<const VarDec*> vars;
+        /// The fields it loads.
+        misc::set<misc::symbol> fields;
+        /// Whether it loads an array element.
+        bool arrays = false;
+        /// Whether it calls a function reading non local data.
+        bool calls = false;
+      };
+
+      /// A value currently available.
+      struct available
+      {
+        /// Its number, i.e., its index in values.
+        unsigned number = 0;
+        /// What may change it.
+        deps depends;
+      };
+
+      /// The key of \a e, made of the definitions and the names.
+      static void key_get(const Exp& e, std::ostream& o)
+      {
+        if (auto i = dynamic_cast<const IntExp*>(&e))
+          o << i->value_get();
+        else if (auto s = dynamic_cast<const StringExp*>(&e))
+          o << s->string_get().size() << '"' << s->string_get();
+        else if (dynamic_cast<const NilExp*>(&e))
+          o << "nil";
+        else if (auto var = dynamic_cast<const SimpleVar*>(&e))
+          o << "v" << var->def_get();
+        else if (auto field = dynamic_cast<const FieldVar*>(&e))
+          {
+            key_get(field->var_get(), o);
+            o << '.' << field->name_get();
+          }
+        else if (auto sub = dynamic_cast<const SubscriptVar*>(&e))
+          {
+            key_get(sub->var_get(), o);
+            o << '[';
+            key_get(sub->index_get(), o);
+            o << ']';
+          }
+        else if (auto op = dynamic_cast<const OpExp*>(&e))
+          {
+            o << '(';
+            key_get(op->left_get(), o);
+            o << ' ' << static_cast<int>(op->oper_get()) << ' ';
+            key_get(op->right_get(), o);
+            o << ')';
+          }
+        else if (auto call = dynamic_cast<const CallExp*>(&e))
+          {
+            o << "f" << call->def_get() << '(';
+            for (const Exp* arg : call->args_get())
+              {
+                key_get(*arg, o);
+                o << ',';
+              }
+            o << ')';
+          }
+      }
+
+      /// Collect what may change the value of \a e into \a d.
+      static void deps_get(const Exp& e, deps& d)
+      {
+        if (auto var = dynamic_cast<const SimpleVar*>(&e))
+          d.vars.insert(var->def_get());
+        else if (auto field = dynamic_cast<const FieldVar*>(&e))
+          {
+            d.fields.insert(field->name_get());
+            deps_get(field->var_get(), d);
+          }
+        else if (auto sub = dynamic_cast<const SubscriptVar*>(&e))
+          {
+            d.arrays = true;
+            deps_get(sub->var_get(), d);
+            deps_get(sub->index_get(), d);
+          }
+        else if (auto op = dynamic_cast<const OpExp*>(&e))
+          {
+            deps_get(op->left_get(), d);
+            deps_get(op->right_get(), d);
+          }
+        else if (auto call = dynamic_cast<const CallExp*>(&e))
+          {
+            if (effects::call_effects(call->def_get()) & Effectful::reads)
+              d.calls = true;
+            for (const Exp* arg : call->args_get())
+              deps_get(*arg, d);
+          }
+      }
+
+      /// Forget the values for which \a changed holds.
+      template <typename Pred> void forget(Pred changed)
+      {
+        std::erase_if(available_, [&changed](const auto& i) {
+          return changed(i.second.depends);
+        });
+      }
+
+      /// Forget the values a function which may write may change.
+      void forget_heap()
+      {
+        forget([](const deps& d) {
+          if (d.calls || d.arrays || !d.fields.empty())
+            return true;
+          for (const VarDec* var : d.vars)
+            if (var->escapable_get())
+              return true;
+          return false;
+        });
+      }
+
+      /// Number the candidates of \a e, in the order of evaluation.
+      void walk(const Exp& e)
+      {
+        if (leaf_p(e))
+          return;
+
+        if (candidate_p(e))
+          {
+            std::ostringstream o;
+            key_get(e, o);
+            std::string key = o.str();
+            auto i = available_.find(key);
+            if (i != available_.end())
+              {
+                // Computed already: the operands are not evaluated.
+                values[i->second.number].occurrences.emplace_back(&e);
+                return;
+              }
+            // The value may be computed earlier if nothing happened
+            // before, in this expression of the sequence.
+            bool clean = !effects_;
+            operands_walk(e);
+            if (clean)
+              {
+                available a;
+                a.number = values.size();
+                deps_get(e, a.depends);
+                available_.emplace(key, std::move(a));
+                values.emplace_back(value{&e, element_, {&e}});
+              }
+            if (partial_p(e))
+              effects_ = true;
+            return;
+          }
+
+        if (auto assign = dynamic_cast<const AssignExp*>(&e))
+          {
+            const Var& var = assign->var_get();
+            if (auto field = dynamic_cast<const FieldVar*>(&var))
+              walk(field->var_get());
+            else if (auto sub = dynamic_cast<const SubscriptVar*>(&var))
+              {
+                walk(sub->var_get());
+                walk(sub->index_get());
+              }
+            walk(assign->exp_get());
+
+            if (auto simple = dynamic_cast<const SimpleVar*>(&var))
+              {
+                const VarDec* def = simple->def_get();
+                forget([def](const deps& d) {
+                  return d.vars.has(def) || (d.calls && def->escapable_get());
+                });
+              }
+            else if (auto field = dynamic_cast<const FieldVar*>(&var))
+              {
+                misc::symbol name = field->name_get();
+                forget([name](const deps& d) {
+                  return d.fields.has(name) || d.calls;
+                });
+              }
+            else
+              forget([](const deps& d) { return d.arrays || d.calls; });
+            effects_ = true;
+          }
+        else if (auto call = dynamic_cast<const CallExp*>(&e))
+          {
+            for (const Exp* arg : call->args_get())
+              walk(*arg);
+            unsigned effects = effects::call_effects(call->def_get());
+            if (effects & Effectful::writes)
+              forget_heap();
+            if (effects != Effectful::pure)
+              effects_ = true;
+          }
+        else if (dynamic_cast<const FieldVar*>(&e)
+                 || dynamic_cast<const SubscriptVar*>(&e)
+                 || dynamic_cast<const OpExp*>(&e))
+          {
+            operands_walk(e);
+            if (partial_p(e))
+              effects_ = true;
+          }
+        else if (auto record = dynamic_cast<const RecordExp*>(&e))
+          for (const FieldInit* init : record->get_fields())
+            walk(init->init_get());
+        else if (auto array = dynamic_cast<const ArrayExp*>(&e))
+          {
+            walk(array->size_get());
+            walk(array->init_get());
+            // A negative size fails.
+            effects_ = true;
+          }
+        else
+          {
+            // Not straight-line code, or a new scope.
+            unsigned effects = effects::effects_get(e);
+            if (effects & Effectful::writes)
+              available_.clear();
+            if (effects != Effectful::pure
+                || dynamic_cast<const BreakExp*>(&e))
+              effects_ = true;
+          }
+      }
+
+      /// Walk the operands of \a e.
+      void operands_walk(const Exp& e)
+      {
+        if (auto field = dynamic_cast<const FieldVar*>(&e))
+          walk(field->var_get());
+        else if (auto sub = dynamic_cast<const SubscriptVar*>(&e))
+          {
+            walk(sub->var_get());
+            walk(sub->index_get());
+          }
+        else if (auto op = dynamic_cast<const OpExp*>(&e))
+          {
+            walk(op->left_get());
+            walk(op->right_get());
+          }
+        else if (auto call = dynamic_cast<const CallExp*>(&e))
+          for (const Exp* arg : call->args_get())
+            walk(*arg);
+      }
+
+      /// The values currently available, by key.
+      std::unordered_map<std::string, available> available_;
+      /// The index of the current expression of the sequence.
+      unsigned element_ = 0;
+      /// Whether something may have had an effect (or failed) since the
+      /// beginning of the current expression of the sequence.
+      bool effects_ = false;
+    };
+
+  } // namespace
+
+  const CseStats& Cse::stats_get() const { return stats_; }
+
+  bool Cse::replace(const ast::Exp& e)
+  {
+    if (&e == init_)
+      return false;
+    auto i = replaced_.find(&e);
+    if (i == replaced_.end())
+      return false;
+    result_ = new SimpleVar(e.location_get(), i->second);
+    return true;
+  }
+
+  void Cse::operator()(const ast::CallExp& e)
+  {
+    if (!replace(e))
+      super_type::operator()(e);
+  }
+
+  void Cse::operator()(const ast::FieldVar& e)
+  {
+    if (!replace(e))
+      super_type::operator()(e);
+  }
+
+  void Cse::operator()(const ast::FunctionDec& e)
+  {
+    unsigned count = 0;
+    unsigned* outer = count_;
+    count_ = &count;
+    super_type::operator()(e);
+    count_ = outer;
+    if (count)
+      stats_.functions.emplace_back(e.name_get(), count);
+  }
+
+  void Cse::operator()(const ast::OpExp& e)
+  {
+    if (!replace(e))
+      super_type::operator()(e);
+  }
+
+  void Cse::operator()(const ast::SubscriptVar& e)
+  {
+    if (!replace(e))
+      super_type::operator()(e);
+  }
+
+  void Cse::operator()(const ast::SeqExp& e)
+  {
+    const Location& location = e.location_get();
+    const exps_type& exps = e.exps_get();
+
+    // The temporaries to declare before each expression of the
+    // sequence, with their value.
+    std::vector<std::vector<std::pair<misc::symbol, const Exp*>>> temps(
+      exps.size());
+    ValueNumbering numbering(exps);
+    for (const ValueNumbering::value& v : numbering.values)
+      if (v.occurrences.size() > 1)
+        {
+          misc::symbol name = misc::symbol::fresh("_cse");
+          temps[v.element].emplace_back(name, v.first);
+          for (const Exp* occurrence : v.occurrences)
+            replaced_.emplace(occurrence, name);
+          stats_.eliminated += v.occurrences.size() - 1;
+          if (count_)
+            *count_ += v.occurrences.size() - 1;
+        }
+
+    std::vector<Exp*> clones;
+    for (const Exp* exp : exps)
+      clones.emplace_back(recurse(*exp));
+
+    // Nest the rest of the sequence in the scope of the temporaries.
+    auto res = new exps_type;
+    for (unsigned i = exps.size(); i-- > 0;)
+      {
+        res->insert(res->begin(), clones[i]);
+        if (temps[i].empty())
+          continue;
+        parse::Tweast input;
+        input << "let";
+        for (const auto& [name, first] : temps[i])
+          {
+            init_ = first;
+            input << " var " << name << " := " << recurse(*first);
+            init_ = nullptr;
+          }
+        Exp* seq = new SeqExp(location, res);
+        input << " in " << seq << " end";
+        ast::Exp* let = parse::parse(input);
+        res = new exps_type{let};
+      }
+    result_ = new SeqExp(location, res);
+  }
+
+} // namespace optimize
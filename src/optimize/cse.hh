@@ -0,0 +1,94 @@
+/**
+ ** \file optimize/cse.hh
+ ** \brief Declaration of optimize::Cse.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include <astclone/cloner.hh>
+#include <misc/symbol.hh>
+
+namespace optimize
+{
+  /// Statistics of the common subexpression elimination.
+  struct CseStats
+  {
+    /// The number of eliminated expressions.
+    unsigned eliminated = 0;
+    /// The number of eliminated expressions of each function, in the
+    /// order of the program.  The functions without any are omitted.
+    std::vector<std::pair<misc::symbol, unsigned>> functions;
+  };
+
+  /// Report \a s on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const CseStats& s);
+
+  /** \brief Eliminate the common subexpressions while duplicating an Ast.
+
+      The expressions of a sequence are evaluated one after the other:
+      the same value, computed twice in a sequence, is computed once
+      in a temporary.  For instance, in
+
+          (print_int(a.b.c); a.b.c := a.b.c + 1)
+
+      the loads of `a.b' and of `a.b.c' are shared:
+
+          let var _cse_0 := a.b
+              var _cse_1 := _cse_0.c
+          in (print_int(_cse_1); _cse_0.c := _cse_1 + 1) end
+
+      The values are numbered on the structure of the expressions,
+      whose keys are the definitions of the variables and functions,
+      and the names of the fields.  The candidates are the loads of
+      fields and of array elements, the operations, and the calls to
+      functions which neither write, perform input/output, nor allocate
+      (see the effects module).  A store, or a call to a function which
+      may write, forgets the values it may change.
+
+      The temporary is computed at the beginning of the expression of
+      the sequence where the value first appears, so the value must not
+      be preceded by anything with an effect in that expression.  The
+      conditionals, the loops, and the nested sequences and `let's are
+      not looked into: they are processed on their own.  */
+  class Cse : public astclone::Cloner
+  {
+  public:
+    using super_type = astclone::Cloner;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    /// \}
+
+    /// The statistics.
+    const CseStats& stats_get() const;
+
+  private:
+    /// If \a e is the occurrence of a shared value, replace it with
+    /// its temporary, and return true.
+    bool replace(const ast::Exp& e);
+
+    /// The occurrences of shared values, and their temporaries.
+    std::map<const ast::Exp*, misc::symbol> replaced_;
+    /// The expression being cloned to initialize its temporary.
+    const ast::Exp* init_ = nullptr;
+    /// The number of eliminated expressions of the current function.
+    unsigned* count_ = nullptr;
+    /// The statistics.
+    CseStats stats_;
+  };
+
+} // namespace optimize
@@ -0,0 +1,411 @@
+/**
+ ** \file optimize/dce.cc
+ ** \brief Implementation of optimize::Dce.
+ */
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <effects/libeffects.hh>
+#include <optimize/dce.hh>
+
+namespace optimize
+{
+  using namespace ast;
+
+  namespace
+  {
+    /// Whether \a e may be left out when its value is unused.
+    bool removable_p(const Exp& e)
+    {
+      return !(effects::effects_get(e)
+               & (Effectful::writes | Effectful::io | Effectful::diverges));
+    }
+
+    /// The literal value of \a e, if it is an integer literal.
+    std::optional<int> literal_get(const Exp& e)
+    {
+      if (auto i = dynamic_cast<const IntExp*>(&e))
+        return i->value_get();
+      return std::nullopt;
+    }
+
+    /// An empty sequence, i.e., `()'.
+    Exp* nop(const Location& location)
+    {
+      return new SeqExp(location, new exps_type);
+    }
+
+    /// Whether \a e is `()'.
+    bool nop_p(const Exp* e)
+    {
+      auto seq = dynamic_cast<const SeqExp*>(e);
+      return seq && seq->exps_get().empty();
+    }
+
+    /// Collect the variables read by an expression, and whether it
+    /// contains a `break'.
+    class ReadsVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      void operator()(const ast::AssignExp& e) override
+      {
+        if (!dynamic_cast<const SimpleVar*>(&e.var_get()))
+          e.var_get().accept(*this);
+        e.exp_get().accept(*this);
+      }
+
+      void operator()(const ast::BreakExp&) override { breaks = true; }
+
+      void operator()(const ast::SimpleVar& e) override
+      {
+        reads.insert(e.def_get());
+      }
+
+      misc::set<const ast::VarDec*> reads;
+      bool breaks = false;
+    };
+
+    /// Find the dead code.
+    ///
+    /// The right-hand sides of the stores and the initializations of
+    /// the variables are "owners" of the reads they contain.  When a
+    /// variable is dead, its stores and its initialization are
+    /// removed, and so are the reads of their owners.
+    class DeadCodeVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      DeadCodeVisitor(misc::set<const VarDec*>& dead_vars,
+                      std::map<const AssignExp*, bool>& dead_stores,
+                      misc::set<const Exp*>& dead_exps,
+                      unsigned& removed)
+        : dead_vars_(dead_vars)
+        , dead_stores_(dead_stores)
+        , dead_exps_(dead_exps)
+        , removed_(removed)
+      {}
+
+      void operator()(const ast::AssignExp& e) override
+      {
+        auto var = dynamic_cast<const SimpleVar*>(&e.var_get());
+        if (!var)
+          return super_type::operator()(e);
+        unsigned o = owner_open(var->def_get(), e.exp_get());
+        owners_[o].store = &e;
+        vars_[var->def_get()].stores.emplace_back(o);
+        e.exp_get().accept(*this);
+        current_.pop_back();
+      }
+
+      void operator()(const ast::ForExp& e) override
+      {
+        // The index is never removed, and never stored into.
+        e.vardec_get().init_get()->accept(*this);
+        e.hi_get().accept(*this);
+        e.body_get().accept(*this);
+      }
+
+      void operator()(const ast::IfExp& e) override
+      {
+        std::optional<int> test = literal_get(e.get_test());
+        if (!test)
+          return super_type::operator()(e);
+        ++removed_;
+        if (*test)
+          e.get_thenclause().accept(*this);
+        else if (&e.get_elseclause())
+          e.get_elseclause().accept(*this);
+      }
+
+      void operator()(const ast::SeqExp& e) override
+      {
+        const exps_type& exps = e.exps_get();
+        misc::set<const AssignExp*> overwritten = overwritten_get(exps);
+        for (const Exp* exp : exps)
+          if (auto store = dynamic_cast<const AssignExp*>(exp);
+              store && overwritten.has(store))
+            dead_stores_.emplace(store, true);
+          else if (exp != exps.back() && removable_p(*exp))
+            {
+              dead_exps_.insert(exp);
+              ++removed_;
+            }
+          else
+            exp->accept(*this);
+      }
+
+      void operator()(const ast::SimpleVar& e) override
+      {
+        const VarDec* def = e.def_get();
+        // A read in the code removed with the variable does not count.
+        for (unsigned o = current_.empty() ? none : current_.back();
+             o != none; o = owners_[o].parent)
+          if (owners_[o].target == def && owners_[o].removable)
+            return;
+        ++vars_[def].reads;
+        if (!current_.empty())
+          owners_[current_.back()].reads.emplace_back(def);
+      }
+
+      void operator()(const ast::VarDec& e) override
+      {
+        if (!e.init_get())
+          return super_type::operator()(e);
+        if (e.type_name_get())
+          e.type_name_get()->accept(*this);
+        unsigned o = owner_open(&e, *e.init_get());
+        vars_[&e].init = o;
+        e.init_get()->accept(*this);
+        current_.pop_back();
+      }
+
+      void operator()(const ast::WhileExp& e) override
+      {
+        std::optional<int> test = literal_get(e.test_get());
+        if (test && !*test)
+          ++removed_;
+        else
+          super_type::operator()(e);
+      }
+
+      /// Propagate the deaths of the variables.
+      void dead_vars_compute()
+      {
+        std::vector<const VarDec*> worklist;
+        for (auto& [var, info] : vars_)
+          if (!info.reads)
+            worklist.emplace_back(var);
+
+        while (!worklist.empty())
+          {
+            const VarDec* var = worklist.back();
+            worklist.pop_back();
+            var_info& info = vars_[var];
+            if (info.dead)
+              continue;
+            info.dead = true;
+            for (unsigned o : info.stores)
+              {
+                dead_stores_.emplace(owners_[o].store, owners_[o].removable);
+                if (owners_[o].removable)
+                  owner_remove(o, worklist);
+              }
+            if (info.init != none && owners_[info.init].removable)
+              {
+                dead_vars_.insert(var);
+                owner_remove(info.init, worklist);
+              }
+          }
+        removed_ += dead_vars_.size() + dead_stores_.size();
+      }
+
+    private:
+      /// No owner.
+      static constexpr unsigned none = -1;
+
+      /// An owner of reads.
+      struct owner
+      {
+        /// The variable stored into, or initialized.
+        const VarDec* target = nullptr;
+        /// Whether the code may be removed with the variable.
+        bool removable = false;
+        /// The enclosing owner.
+        unsigned parent = none;
+        /// The store, if any.
+        const AssignExp* store = nullptr;
+        /// The reads of the code, but those of the nested owners.
+        std::vector<const VarDec*> reads;
+        /// The nested owners.
+        std::vector<unsigned> children;
+        /// Whether the code is removed.
+        bool removed = false;
+      };
+
+      /// What is known of a variable.
+      struct var_info
+      {
+        /// The number of reads.
+        unsigned reads = 0;
+        /// The stores into it.
+        std::vector<unsigned> stores;
+        /// Its initialization, if it is declared by a `let'.
+        unsigned init = none;
+        /// Whether it is dead.
+        bool dead = false;
+      };
+
+      /// Open the owner of the code \a e, storing into \a target.
+      unsigned owner_open(const VarDec* target, const Exp& e)
+      {
+        unsigned parent = current_.empty() ? none : current_.back();
+        unsigned o = owners_.size();
+        owner& res = owners_.emplace_back();
+        res.target = target;
+        res.removable = removable_p(e);
+        res.parent = parent;
+        if (parent != none)
+          owners_[parent].children.emplace_back(o);
+        current_.emplace_back(o);
+        return o;
+      }
+
+      /// Remove the code of \a o, and its reads.
+      void owner_remove(unsigned o, std::vector<const VarDec*>& worklist)
+      {
+        if (owners_[o].removed)
+          return;
+        owners_[o].removed = true;
+        for (const VarDec* var : owners_[o].reads)
+          if (!--vars_[var].reads)
+            worklist.emplace_back(var);
+        for (unsigned child : owners_[o].children)
+          owner_remove(child, worklist);
+      }
+
+      /// The stores of \a exps into a non escaping variable which is
+      /// stored into again, before being read, later in \a exps.
+      static misc::set<const AssignExp*>
+      overwritten_get(const exps_type& exps)
+      {
+        misc::set<const AssignExp*> res;
+        // The variables stored into later, and not read before.
+        misc::set<const VarDec*> killed;
+        for (auto i = exps.rbegin(); i != exps.rend(); ++i)
+          {
+            ReadsVisitor reads;
+            (*i)->accept(reads);
+            auto store = dynamic_cast<const AssignExp*>(*i);
+            const SimpleVar* var = nullptr;
+            if (store)
+              var = dynamic_cast<const SimpleVar*>(&store->var_get());
+            if (var && killed.has(var->def_get())
+                && removable_p(store->exp_get()))
+              res.insert(store);
+
+            if (reads.breaks)
+              killed.clear();
+            for (const VarDec* read : reads.reads)
+              killed.erase(read);
+            if (var && !reads.breaks && !var->def_get()->escapable_get()
+                && !reads.reads.has(var->def_get()))
+              killed.insert(var->def_get());
+          }
+        return res;
+      }
+
+      misc::set<const VarDec*>& dead_vars_;
+      std::map<const AssignExp*, bool>& dead_stores_;
+      misc::set<const Exp*>& dead_exps_;
+      unsigned& removed_;
+
+      /// The owners.
+      std::vector<owner> owners_;
+      /// The enclosing owners.
+      std::vector<unsigned> current_;
+      /// The variables.
+      std::unordered_map<const VarDec*, var_info> vars_;
+    };
+
+  } // namespace
+
+  Dce::Dce(const ast::Ast& tree)
+    : super_type()
+  {
+    DeadCodeVisitor dead(dead_vars_, dead_stores_, dead_exps_, removed_);
+    tree.accept(dead);
+    dead.dead_vars_compute();
+  }
+
+  unsigned Dce::removed_get() const { return removed_; }
+
+  void Dce::operator()(const ast::AssignExp& e)
+  {
+    auto i = dead_stores_.find(&e);
+    if (i == dead_stores_.end())
+      return super_type::operator()(e);
+
+    const Location& location = e.location_get();
+    if (i->second)
+      result_ = nop(location);
+    else
+      // Keep the effects of the right-hand side.
+      result_ = new SeqExp(location,
+                           new exps_type{recurse(e.exp_get()), nop(location)});
+  }
+
+  void Dce::operator()(const ast::IfExp& e)
+  {
+    const Location& location = e.location_get();
+    std::optional<int> test = literal_get(e.get_test());
+    if (test && *test)
+      result_ = recurse(e.get_thenclause());
+    else if (test)
+      result_ = &e.get_elseclause() ? recurse(e.get_elseclause())
+                                    : nop(location);
+    else
+      {
+        super_type::operator()(e);
+        // Both arms may have been emptied.
+        auto cond = dynamic_cast<IfExp*>(result_);
+        if (nop_p(&cond->get_thenclause())
+            && (!&cond->get_elseclause() || nop_p(&cond->get_elseclause()))
+            && removable_p(e.get_test()))
+          {
+            delete result_;
+            result_ = nop(location);
+          }
+      }
+  }
+
+  void Dce::operator()(const ast::SeqExp& e)
+  {
+    const exps_type& exps = e.exps_get();
+    auto res = new exps_type;
+    for (const Exp* exp : exps)
+      {
+        if (dead_exps_.has(exp))
+          continue;
+        Exp* clone = recurse(*exp);
+        // Drop the stores which were removed.
+        if (exp != exps.back() && nop_p(clone))
+          delete clone;
+        else
+          res->emplace_back(clone);
+      }
+    result_ = new SeqExp(e.location_get(), res);
+  }
+
+  void Dce::operator()(const ast::VarChunk& e)
+  {
+    auto decs = new VarChunk::Ds;
+    for (const VarDec* var : e)
+      if (!dead_vars_.has(var))
+        decs->emplace_back(recurse(*var));
+    result_ = new VarChunk(e.location_get(), decs);
+  }
+
+  void Dce::operator()(const ast::WhileExp& e)
+  {
+    std::optional<int> test = literal_get(e.test_get());
+    if (test && !*test)
+      result_ = nop(e.location_get());
+    else
+      super_type::operator()(e);
+  }
+
+} // namespace optimize
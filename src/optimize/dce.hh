@@ -0,0 +1,68 @@
+/**
+ ** \file optimize/dce.hh
+ ** \brief Declaration of optimize::Dce.
+ */
+
+#pragma once
+
+#include <map>
+
+#include <astclone/cloner.hh>
+#include <misc/set.hh>
+
+namespace optimize
+{
+  /** \brief Remove dead code and dead stores while duplicating an Ast.
+
+      The following is removed:
+      - the variables which are never read, if their initialization
+        can be left out, and the stores into them (their right-hand
+        side is kept if it has an effect);
+      - in a sequence, the stores into a non escaping variable which
+        is stored into again before being read;
+      - in a sequence, the expressions but the last which have no
+        effect, and cannot fail nor loop;
+      - the arm of a conditional which cannot be taken, and the loops
+        which cannot be entered, when their test is a literal.
+
+      The effects of an expression are given by the effects module.
+      Removing a store or an initialization may leave other variables
+      unread: they are found with a worklist, on the reference counts
+      of the variables.  Variables which only read one another in a
+      cycle are not found.  */
+  class Dce : public astclone::Cloner
+  {
+  public:
+    using super_type = astclone::Cloner;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// Build a Dce, and find the dead code of \a tree.
+    explicit Dce(const ast::Ast& tree);
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::VarChunk& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+    /// The number of removed declarations, stores and expressions.
+    unsigned removed_get() const;
+
+  private:
+    /// The variable declarations to remove.
+    misc::set<const ast::VarDec*> dead_vars_;
+    /// The stores to remove, and whether their right-hand side may be
+    /// removed too.
+    std::map<const ast::AssignExp*, bool> dead_stores_;
+    /// The expressions of sequences to remove.
+    misc::set<const ast::Exp*> dead_exps_;
+    /// The number of removed declarations, stores and expressions.
+    unsigned removed_ = 0;
+  };
+
+} // namespace optimize
@@ -0,0 +1,323 @@
+/**
+ ** \file optimize/folder.cc
+ ** \brief Implementation of optimize::Folder.
+ */
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+
+#include <ast/all.hh>
+#include <effects/libeffects.hh>
+#include <misc/contract.hh>
+#include <misc/escape.hh>
+#include <optimize/folder.hh>
+
+namespace optimize
+{
+  using namespace ast;
+
+  namespace
+  {
+    /// The value of \a e if it is an integer literal.
+    std::optional<int> int_get(const Exp* e)
+    {
+      if (auto i = dynamic_cast<const IntExp*>(e))
+        return i->value_get();
+      return std::nullopt;
+    }
+
+    /// \brief The value of \a e if it is a string literal.
+    ///
+    /// The scanner keeps the escapes as is in the literals: decode them.
+    std::optional<std::string> string_get(const Exp* e)
+    {
+      if (auto s = dynamic_cast<const StringExp*>(e))
+        return misc::unescape(s->string_get());
+      return std::nullopt;
+    }
+
+    /// Compute the comparison \a oper of \a lhs and \a rhs.
+    template <typename T>
+    int compare(OpExp::Oper oper, const T& lhs, const T& rhs)
+    {
+      switch (oper)
+        {
+        case OpExp::Oper::eq:
+          return lhs == rhs;
+        case OpExp::Oper::ne:
+          return lhs != rhs;
+        case OpExp::Oper::lt:
+          return lhs < rhs;
+        case OpExp::Oper::le:
+          return lhs <= rhs;
+        case OpExp::Oper::gt:
+          return lhs > rhs;
+        case OpExp::Oper::ge:
+          return lhs >= rhs;
+        default:
+          unreachable();
+        }
+    }
+
+    /// \brief Compute \a lhs \a oper \a rhs.
+    ///
+    /// Return nothing if the computation must be left to the runtime:
+    /// division by zero, or a result out of the range of `int'.
+    std::optional<int> compute(OpExp::Oper oper, int lhs, int rhs)
+    {
+      std::int64_t l = lhs;
+      std::int64_t r = rhs;
+      std::int64_t res = 0;
+      switch (oper)
+        {
+        case OpExp::Oper::add:
+          res = l + r;
+          break;
+        case OpExp::Oper::sub:
+          res = l - r;
+          break;
+        case OpExp::Oper::mul:
+          res = l * r;
+          break;
+        case OpExp::Oper::div:
+          if (r == 0)
+            return std::nullopt;
+          res = l / r;
+          break;
+        default:
+          return compare(oper, lhs, rhs);
+        }
+      if (res < std::numeric_limits<int>::min()
+          || std::numeric_limits<int>::max() < res)
+        return std::nullopt;
+      return static_cast<int>(res);
+    }
+  } // namespace
+
+  unsigned Folder::folds_get() const { return folds_; }
+
+  bool Folder::pure_p(const Exp& e)
+  {
+    if (dynamic_cast<const IntExp*>(&e) || dynamic_cast<const StringExp*>(&e)
+        || dynamic_cast<const NilExp*>(&e)
+        || dynamic_cast<const SimpleVar*>(&e))
+      return true;
+    if (auto op = dynamic_cast<const OpExp*>(&e))
+      {
+        // A division may fail.
+        if (op->oper_get() == OpExp::Oper::div)
+          {
+            std::optional<int> divisor = int_get(&op->right_get());
+            if (!divisor || *divisor == 0)
+              return false;
+          }
+        return pure_p(op->left_get()) && pure_p(op->right_get());
+      }
+    if (auto seq = dynamic_cast<const SeqExp*>(&e))
+      {
+        for (const Exp* exp : seq->exps_get())
+          if (!pure_p(*exp))
+            return false;
+        return true;
+      }
+    if (auto call = dynamic_cast<const CallExp*>(&e))
+      {
+        // Reading and allocating are harmless if the value is unused.
+        // The functions may do anything until their effects are
+        // computed.
+        if (effects::call_effects(call->def_get())
+            & (Effectful::writes | Effectful::io | Effectful::diverges))
+          return false;
+        for (const Exp* arg : call->args_get())
+          if (!pure_p(*arg))
+            return false;
+        return true;
+      }
+    return false;
+  }
+
+  void Folder::operator()(const CallExp& e)
+  {
+    super_type::operator()(e);
+
+    // Only the primitives of the prelude are known.
+    const FunctionDec* def = e.def_get();
+    if (!def || def->body_get())
+      return;
+
+    const Location& location = e.location_get();
+    const exps_type& args = dynamic_cast<CallExp*>(result_)->args_get();
+    std::string name = e.name_get().get();
+    Exp* res = nullptr;
+    if (name == "size" && args.size() == 1)
+      {
+        if (auto s = string_get(args[0]))
+          res = new IntExp(location, s->size());
+      }
+    else if (name == "streq" && args.size() == 2)
+      {
+        auto s1 = string_get(args[0]);
+        auto s2 = string_get(args[1]);
+        if (s1 && s2)
+          res = new IntExp(location, *s1 == *s2);
+      }
+    else if (name == "concat" && args.size() == 2)
+      {
+        // Escapes are kept verbatim, hence can be concatenated.
+        auto s1 = dynamic_cast<const StringExp*>(args[0]);
+        auto s2 = dynamic_cast<const StringExp*>(args[1]);
+        if (s1 && s2)
+          res = new StringExp(location, s1->string_get() + s2->string_get());
+      }
+
+    if (res)
+      {
+        delete result_;
+        result_ = res;
+        ++folds_;
+      }
+  }
+
+  void Folder::operator()(const IfExp& e)
+  {
+    Exp* test = recurse(e.get_test());
+    std::optional<int> value = int_get(test);
+    if (!value)
+      {
+        const Location& location = e.location_get();
+        Exp* thenclause = recurse(e.get_thenclause());
+        Exp* elseclause = recurse(&e.get_elseclause());
+        result_ = new IfExp(location, test, thenclause, elseclause);
+        return;
+      }
+
+    // Keep only the selected branch.
+    delete test;
+    ++folds_;
+    if (*value)
+      result_ = recurse(e.get_thenclause());
+    else if (&e.get_elseclause())
+      result_ = recurse(e.get_elseclause());
+    else
+      result_ = new SeqExp(e.location_get(), new exps_type);
+  }
+
+  void Folder::operator()(const OpExp& e)
+  {
+    const Location& location = e.location_get();
+    Exp* left = recurse(e.left_get());
+    OpExp::Oper oper = e.oper_get();
+    Exp* right = recurse(e.right_get());
+
+    std::optional<int> lhs = int_get(left);
+    std::optional<int> rhs = int_get(right);
+
+    // Literal operands.
+    if (lhs && rhs)
+      if (std::optional<int> value = compute(oper, *lhs, *rhs))
+        {
+          delete left;
+          delete right;
+          result_ = new IntExp(location, *value);
+          ++folds_;
+          return;
+        }
+    if (auto l = string_get(left))
+      if (auto r = string_get(right))
+        {
+          delete left;
+          delete right;
+          result_ = new IntExp(location, compare(oper, *l, *r));
+          ++folds_;
+          return;
+        }
+
+    // Neutral elements: `x + 0', `0 + x', `x - 0', `x * 1', `1 * x',
+    // and `x / 1', and absorbing elements: `x * 0' and `0 * x', if x
+    // can be dropped.
+    Exp* keep = nullptr;
+    Exp* drop = nullptr;
+    bool additive = oper == OpExp::Oper::add || oper == OpExp::Oper::sub;
+    bool multiplicative =
+      oper == OpExp::Oper::mul || oper == OpExp::Oper::div;
+    if ((additive && rhs == 0) || (multiplicative && rhs == 1))
+      {
+        keep = left;
+        drop = right;
+      }
+    else if ((oper == OpExp::Oper::add && lhs == 0)
+             || (oper == OpExp::Oper::mul && lhs == 1))
+      {
+        keep = right;
+        drop = left;
+      }
+    else if (oper == OpExp::Oper::mul && rhs == 0 && pure_p(*left))
+      {
+        keep = right;
+        drop = left;
+      }
+    else if (oper == OpExp::Oper::mul && lhs == 0 && pure_p(*right))
+      {
+        keep = left;
+        drop = right;
+      }
+    if (keep)
+      {
+        delete drop;
+        result_ = keep;
+        ++folds_;
+        return;
+      }
+
+    result_ = new OpExp(location, left, oper, right);
+  }
+
+  void Folder::operator()(const SeqExp& e)
+  {
+    const Location& location = e.location_get();
+    auto exps = new exps_type;
+    for (auto i = e.exps_get().begin(); i != e.exps_get().end(); ++i)
+      {
+        Exp* exp = recurse(**i);
+        // The value of all but the last expression is discarded.  The
+        // calls of the clone are not bound yet: those of the original
+        // tell their effects.
+        if (std::next(i) != e.exps_get().end()
+            && (pure_p(**i) || pure_p(*exp)))
+          {
+            delete exp;
+            ++folds_;
+          }
+        else
+          exps->emplace_back(exp);
+      }
+
+    // `(exp)' is `exp'.
+    if (exps->size() == 1)
+      {
+        result_ = exps->front();
+        delete exps;
+      }
+    else
+      result_ = new SeqExp(location, exps);
+  }
+
+  void Folder::operator()(const WhileExp& e)
+  {
+    Exp* test = recurse(e.test_get());
+    if (int_get(test) == 0)
+      {
+        // The body is never run.
+        delete test;
+        result_ = new SeqExp(e.location_get(), new exps_type);
+        ++folds_;
+        return;
+      }
+    Exp* body = recurse(e.body_get());
+    result_ = new WhileExp(e.location_get(), test, body);
+  }
+
+} // namespace optimize
@@ -0,0 +1,56 @@
+/**
+ ** \file optimize/folder.hh
+ ** \brief Declaration of optimize::Folder.
+ */
+
+#pragma once
+
+#include <astclone/cloner.hh>
+
+namespace optimize
+{
+  /** \brief Fold constant expressions while duplicating an Ast.
+
+      Fold integer arithmetics and comparisons of literals, apply
+      simple algebraic identities (`x + 0', `x * 1'...), select the
+      branch of conditionals with a constant test, drop the pure
+      expressions of sequences whose value is unused, and compute the
+      calls to the `size', `streq' and `concat' primitives on string
+      literals.
+
+      Tiger semantics are preserved: divisions by zero and overflowing
+      computations are left to the runtime, and no expression with a
+      side effect is removed.  A call is removed only if its callee
+      neither writes, nor performs input/output, nor may diverge (see
+      effects::effects_compute).  */
+  class Folder : public astclone::Cloner
+  {
+  public:
+    using super_type = astclone::Cloner;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+    /// \brief Whether evaluating \a e has no effect (no side effect,
+    /// no runtime error), so that it can be dropped if its value is
+    /// not used.
+    static bool pure_p(const ast::Exp& e);
+
+    /// Number of folded nodes.
+    unsigned folds_get() const;
+
+  private:
+    /// Number of folded nodes.
+    unsigned folds_ = 0;
+  };
+
+} // namespace optimize
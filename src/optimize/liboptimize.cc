@@ -0,0 +1,122 @@
+/**
+ ** \file optimize/liboptimize.cc
+ ** \brief Functions exported by the optimize module.
+ */
+
+#include <memory>
+
+#include <ast/chunk-list.hh>
+#include <desugar/libdesugar.hh>
+#include <optimize/cse.hh>
+#include <optimize/dce.hh>
+#include <optimize/folder.hh>
+#include <optimize/liboptimize.hh>
+#include <optimize/licm.hh>
+#include <optimize/tail-rec.hh>
+
+namespace optimize
+{
+  /*-------------------.
+  | Constant folding.  |
+  `-------------------*/
+
+  template <typename A> A* fold(const A& tree)
+  {
+    // Fold.
+    Folder fold;
+    fold(tree);
+    A* folded = dynamic_cast<A*>(fold.result_get());
+    assertion(folded);
+    std::unique_ptr<A> folded_ptr(folded);
+    // Recompute the bindings and the types.
+    desugar::bind_and_types_check(*folded_ptr);
+    return folded_ptr.release();
+  }
+
+  /// Explicit instantiations.
+  template ast::ChunkList* fold(const ast::ChunkList&);
+
+  /*-----------------.
+  | Tail recursion.  |
+  `-----------------*/
+
+  template <typename A> A* tail_rec(const A& tree)
+  {
+    TailRec tail_rec(tree);
+    if (!tail_rec.loops_get())
+      return nullptr;
+    tail_rec(tree);
+    A* looped = dynamic_cast<A*>(tail_rec.result_get());
+    assertion(looped);
+    std::unique_ptr<A> looped_ptr(looped);
+    // Recompute the bindings and the types.
+    desugar::bind_and_types_check(*looped_ptr);
+    return looped_ptr.release();
+  }
+
+  /// Explicit instantiations.
+  template ast::ChunkList* tail_rec(const ast::ChunkList&);
+
+  /*-----------------------------.
+  | Loop invariant code motion.  |
+  `-----------------------------*/
+
+  template <typename A> A* licm(const A& tree)
+  {
+    Licm licm;
+    licm(tree);
+    A* hoisted = dynamic_cast<A*>(licm.result_get());
+    assertion(hoisted);
+    std::unique_ptr<A> hoisted_ptr(hoisted);
+    // Recompute the bindings and the types.
+    desugar::bind_and_types_check(*hoisted_ptr);
+    return hoisted_ptr.release();
+  }
+
+  /// Explicit instantiations.
+  template ast::ChunkList* licm(const ast::ChunkList&);
+
+  /*------------------------.
+  | Dead code elimination.  |
+  `------------------------*/
+
+  template <typename A> A* dce(const A& tree)
+  {
+    Dce dce(tree);
+    if (!dce.removed_get())
+      return nullptr;
+    dce(tree);
+    A* alive = dynamic_cast<A*>(dce.result_get());
+    assertion(alive);
+    std::unique_ptr<A> alive_ptr(alive);
+    // Recompute the bindings and the types.
+    desugar::bind_and_types_check(*alive_ptr);
+    return alive_ptr.release();
+  }
+
+  /// Explicit instantiations.
+  template ast::ChunkList* dce(const ast::ChunkList&);
+
+  /*-----------------------------------.
+  | Common subexpression elimination.  |
+  `-----------------------------------*/
+
+  template <typename A> A* cse(const A& tree, CseStats* stats)
+  {
+    Cse cse;
+    cse(tree);
+    std::unique_ptr<A> shared_ptr(dynamic_cast<A*>(cse.result_get()));
+    assertion(shared_ptr);
+    if (stats)
+      *stats = cse.stats_get();
+    if (!cse.stats_get().eliminated)
+      return nullptr;
+    // Recompute the bindings and the types.
+    desugar::bind_and_types_check(*shared_ptr);
+    return shared_ptr.release();
+  }
+
+  /// Explicit instantiations.
+  template ast::ChunkList* cse(const ast::ChunkList&, CseStats*);
+
+} // namespace optimize
@@ -0,0 +1,85 @@
+/**
+ ** \file optimize/liboptimize.hh
+ ** \brief Declare functions exported by the optimize module.
+ */
+
+#pragma once
+
+#include <optimize/cse.hh>
+
+/// Optimizing an ast::Ast.
+namespace optimize
+{
+  /*-------------------.
+  | Constant folding.  |
+  `-------------------*/
+
+  /** \brief Fold the constant expressions of an AST.
+
+      \param tree abstract syntax tree's root, whose bindings and types
+                  have been computed.
+
+      \return the folded AST, bound and type-checked.  */
+  template <typename A> A* fold(const A& tree);
+
+  /*-----------------.
+  | Tail recursion.  |
+  `-----------------*/
+
+  /** \brief Turn the self tail calls of an AST into loops.
+
+      \param tree abstract syntax tree's root, whose bindings and types
+                  have been computed, and whose identifiers are all unique.
+
+      \return the AST with loops, bound and type-checked, or nullptr if
+              there is no self tail call in \a tree, in which case it is
+              left as is (and not checked again).  */
+  template <typename A> A* tail_rec(const A& tree);
+
+  /*-----------------------------.
+  | Loop invariant code motion.  |
+  `-----------------------------*/
+
+  /** \brief Hoist the loop invariant expressions of an AST.
+
+      \param tree abstract syntax tree's root, whose bindings, types,
+                  escapes and effects have been computed, and whose
+                  identifiers are all unique.
+
+      \return the AST with the invariants computed ahead of their
+              loops, bound and type-checked.  */
+  template <typename A> A* licm(const A& tree);
+
+  /*------------------------.
+  | Dead code elimination.  |
+  `------------------------*/
+
+  /** \brief Remove the dead code and the dead stores of an AST.
+
+      \param tree abstract syntax tree's root, whose bindings, types,
+                  escapes and effects have been computed.
+
+      \return the AST without dead code, bound and type-checked, or
+              nullptr if there is no dead code in \a tree, in which case
+              it is left as is (and not checked again).  */
+  template <typename A> A* dce(const A& tree);
+
+  /*-----------------------------------.
+  | Common subexpression elimination.  |
+  `-----------------------------------*/
+
+  /** \brief Compute once the values computed twice in the sequences of
+      an AST.
+
+      \param tree   abstract syntax tree's root, whose bindings, types,
+                    escapes and effects have been computed.
+      \param stats  where to report the eliminated expressions, if not
+                    null.
+
+      \return the AST with the common subexpressions in temporaries,
+              bound and type-checked, or nullptr if there is none, in
+              which case \a tree is left as is (and not checked
+              again).  */
+  template <typename A> A* cse(const A& tree, CseStats* stats = nullptr);
+
+} // namespace optimize
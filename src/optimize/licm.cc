@@ -0,0 +1,367 @@
+/**
+ ** \file optimize/licm.cc
+ ** \brief Implementation of optimize::Licm.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <astclone/libastclone.hh>
+#include <effects/libeffects.hh>
+#include <optimize/licm.hh>
+#include <parse/libparse.hh>
+#include <parse/tweast.hh>
+
+namespace optimize
+{
+  using namespace ast;
+
+  namespace
+  {
+    /// Collect what may change in a loop.
+    class LoopFactsVisitor
+      : public ast::DefaultConstVisitor
+      , public ast::NonObjectConstVisitor
+    {
+    public:
+      using super_type = ast::DefaultConstVisitor;
+      using super_type::operator();
+
+      explicit LoopFactsVisitor(Licm::loop& loop)
+        : loop_(loop)
+      {}
+
+      void operator()(const ast::AssignExp& e) override
+      {
+        super_type::operator()(e);
+        if (auto var = dynamic_cast<const SimpleVar*>(&e.var_get()))
+          loop_.assigned.insert(var->def_get());
+        else if (auto field = dynamic_cast<const FieldVar*>(&e.var_get()))
+          loop_.fields.insert(field->name_get());
+      }
+
+      void operator()(const ast::CallExp& e) override
+      {
+        super_type::operator()(e);
+        if (effects::call_effects(e.def_get()) & Effectful::writes)
+          loop_.writes = true;
+      }
+
+      void operator()(const ast::VarDec& e) override
+      {
+        super_type::operator()(e);
+        loop_.declared.insert(&e);
+      }
+
+    private:
+      Licm::loop& loop_;
+    };
+
+    /// Declare the first \a count hoisted expressions of \a l (all
+    /// of them by default) in \a input.
+    void hoisted_declare(parse::Tweast& input, Licm::loop& l,
+                         std::size_t count = -1)
+    {
+      auto end = l.hoisted.begin() + std::min(count, l.hoisted.size());
+      for (auto i = l.hoisted.begin(); i != end; ++i)
+        input << " var " << i->first << " := " << i->second;
+      l.hoisted.erase(l.hoisted.begin(), end);
+    }
+
+  } // namespace
+
+  unsigned Licm::hoisted_get() const { return hoisted_; }
+
+  /*-------------.
+  | Invariance.  |
+  `-------------*/
+
+  void Licm::loop_facts(const ast::Exp& e, loop& l) const
+  {
+    LoopFactsVisitor facts(l);
+    facts(e);
+  }
+
+  Licm::invariance Licm::invariance_get(const ast::Exp& e,
+                                        const loop& l) const
+  {
+    if (dynamic_cast<const IntExp*>(&e) || dynamic_cast<const StringExp*>(&e)
+        || dynamic_cast<const NilExp*>(&e))
+      return invariance::total;
+
+    if (auto var = dynamic_cast<const SimpleVar*>(&e))
+      {
+        const VarDec* def = var->def_get();
+        if (!def || l.declared.has(def) || l.assigned.has(def)
+            || (def->escapable_get() && l.writes))
+          return invariance::variant;
+        return invariance::total;
+      }
+
+    if (auto field = dynamic_cast<const FieldVar*>(&e))
+      {
+        if (l.writes || l.fields.has(field->name_get())
+            || invariance_get(field->var_get(), l) == invariance::variant)
+          return invariance::variant;
+        return invariance::partial;
+      }
+
+    if (auto op = dynamic_cast<const OpExp*>(&e))
+      {
+        invariance res = std::min(invariance_get(op->left_get(), l),
+                                  invariance_get(op->right_get(), l));
+        auto divisor = dynamic_cast<const IntExp*>(&op->right_get());
+        if (op->oper_get() == OpExp::Oper::div
+            && !(divisor && divisor->value_get()))
+          res = std::min(res, invariance::partial);
+        return res;
+      }
+
+    if (auto call = dynamic_cast<const CallExp*>(&e))
+      {
+        unsigned effects = effects::call_effects(call->def_get());
+        invariance res = invariance::total;
+        // Including an allocation: the record would be shared by the
+        // iterations.
+        if (effects & ~Effectful::diverges)
+          res = invariance::variant;
+        else if (effects & Effectful::diverges)
+          res = invariance::partial;
+        for (const Exp* arg : call->args_get())
+          res = std::min(res, invariance_get(*arg, l));
+        return res;
+      }
+
+    return invariance::variant;
+  }
+
+  /*-----------.
+  | Hoisting.  |
+  `-----------*/
+
+  bool Licm::hoist(const ast::Exp& e)
+  {
+    if (loops_.empty())
+      return false;
+
+    // A total expression goes ahead of the outermost loop where it is
+    // invariant, a partial one ahead of the innermost loop, provided
+    // that it is computed first thing in every iteration.
+    loop* target = nullptr;
+    for (loop& l : loops_)
+      if (invariance_get(e, l) == invariance::total)
+        {
+          target = &l;
+          break;
+        }
+    if (!target)
+      {
+        loop& l = loops_.back();
+        if (l.effects || l.conditional
+            || invariance_get(e, l) != invariance::partial)
+          return false;
+        target = &l;
+        target->partial = true;
+      }
+
+    ++hoisted_;
+    misc::symbol name = misc::symbol::fresh("_inv");
+    target->hoisted.emplace_back(name, astclone::clone(e));
+    result_ = new SimpleVar(e.location_get(), name);
+    return true;
+  }
+
+  void Licm::effect()
+  {
+    for (loop& l : loops_)
+      l.effects = true;
+  }
+
+  /*-------------------.
+  | Visiting methods.  |
+  `-------------------*/
+
+  void Licm::operator()(const ast::ArrayExp& e)
+  {
+    // A negative size fails.
+    super_type::operator()(e);
+    effect();
+  }
+
+  void Licm::operator()(const ast::AssignExp& e)
+  {
+    const Location& location = e.location_get();
+    lvalue_ = true;
+    Var* var = recurse(e.var_get());
+    lvalue_ = false;
+    // Storing into a record or an array may fail.
+    if (!dynamic_cast<const SimpleVar*>(&e.var_get()))
+      effect();
+    Exp* exp = recurse(e.exp_get());
+    effect();
+    result_ = new AssignExp(location, var, exp);
+  }
+
+  void Licm::operator()(const ast::BreakExp& e)
+  {
+    super_type::operator()(e);
+    effect();
+  }
+
+  void Licm::operator()(const ast::CallExp& e)
+  {
+    if (hoist(e))
+      return;
+    super_type::operator()(e);
+    if (effects::call_effects(e.def_get()) != Effectful::pure)
+      effect();
+  }
+
+  void Licm::operator()(const ast::FieldVar& e)
+  {
+    if (lvalue_)
+      lvalue_ = false;
+    else if (hoist(e))
+      return;
+    super_type::operator()(e);
+    effect();
+  }
+
+  void Licm::operator()(const ast::ForExp& e)
+  {
+    const Location& location = e.location_get();
+    const VarDec& index = e.vardec_get();
+
+    // The bounds are computed once, before the loop.
+    Exp* lo = recurse(index.init_get());
+    Exp* hi = recurse(e.hi_get());
+
+    loops_.emplace_back();
+    loops_.back().declared.insert(&index);
+    loop_facts(e.body_get(), loops_.back());
+    Exp* body = recurse(e.body_get());
+    loop l = std::move(loops_.back());
+    loops_.pop_back();
+
+    if (l.hoisted.empty())
+      {
+        auto vardec =
+          new VarDec(index.location_get(), index.name_get(), nullptr, lo);
+        result_ = new ForExp(location, vardec, hi, body);
+        return;
+      }
+
+    // The bounds are computed before the invariants, as in the original
+    // loop: they may change what the invariants read.
+    parse::Tweast input;
+    std::string suffix = l.hoisted.front().first.get();
+    std::string lo_name = "_lo" + suffix;
+    std::string hi_name = "_hi" + suffix;
+    input << "let var " << lo_name << " := " << lo << " var " << hi_name
+          << " := " << hi << " in ";
+    if (l.partial)
+      {
+        // Compute the invariants only if the loop is entered.
+        input << "if " << lo_name << " <= " << hi_name << " then let";
+        hoisted_declare(input, l);
+        input << " in for " << index.name_get() << " := " << lo_name
+              << " to " << hi_name << " do " << body << " end end";
+      }
+    else
+      {
+        input << "let";
+        hoisted_declare(input, l);
+        input << " in for " << index.name_get() << " := " << lo_name
+              << " to " << hi_name << " do " << body << " end end";
+      }
+    ast::Exp* res = parse::parse(input);
+    result_ = res;
+  }
+
+  void Licm::operator()(const ast::FunctionDec& e)
+  {
+    // The body of a function is not part of the enclosing loops.
+    std::vector<loop> loops;
+    std::swap(loops, loops_);
+    super_type::operator()(e);
+    std::swap(loops, loops_);
+  }
+
+  void Licm::operator()(const ast::IfExp& e)
+  {
+    const Location& location = e.location_get();
+    Exp* test = recurse(e.get_test());
+    if (!loops_.empty())
+      ++loops_.back().conditional;
+    Exp* thenclause = recurse(e.get_thenclause());
+    Exp* elseclause = recurse(&e.get_elseclause());
+    if (!loops_.empty())
+      --loops_.back().conditional;
+    result_ = new IfExp(location, test, thenclause, elseclause);
+  }
+
+  void Licm::operator()(const ast::OpExp& e)
+  {
+    if (hoist(e))
+      return;
+    super_type::operator()(e);
+    auto divisor = dynamic_cast<const IntExp*>(&e.right_get());
+    if (e.oper_get() == OpExp::Oper::div && !(divisor && divisor->value_get()))
+      effect();
+  }
+
+  void Licm::operator()(const ast::SubscriptVar& e)
+  {
+    lvalue_ = false;
+    super_type::operator()(e);
+    effect();
+  }
+
+  void Licm::operator()(const ast::WhileExp& e)
+  {
+    const Location& location = e.location_get();
+
+    loops_.emplace_back();
+    loop_facts(e.test_get(), loops_.back());
+    loop_facts(e.body_get(), loops_.back());
+    Exp* test = recurse(e.test_get());
+    std::size_t tested = loops_.back().hoisted.size();
+    Exp* body = recurse(e.body_get());
+    loop l = std::move(loops_.back());
+    loops_.pop_back();
+
+    if (l.hoisted.empty())
+      {
+        result_ = new WhileExp(location, test, body);
+        return;
+      }
+
+    parse::Tweast input;
+    if (l.partial)
+      {
+        // Compute the invariants of the body only if the loop is
+        // entered.  Those of the test are computed first thing anyway.
+        input << "let";
+        hoisted_declare(input, l, tested);
+        input << " in if " << astclone::clone(*test) << " then let";
+        hoisted_declare(input, l);
+        input << " in while 1 do (" << body << "; if " << test
+              << " = 0 then break) end end";
+      }
+    else
+      {
+        Exp* loop = new WhileExp(location, test, body);
+        input << "let";
+        hoisted_declare(input, l);
+        input << " in " << loop << " end";
+      }
+    ast::Exp* res = parse::parse(input);
+    result_ = res;
+  }
+
+} // namespace optimize
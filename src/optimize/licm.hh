@@ -0,0 +1,137 @@
+/**
+ ** \file optimize/licm.hh
+ ** \brief Declaration of optimize::Licm.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <astclone/cloner.hh>
+#include <misc/set.hh>
+#include <misc/symbol.hh>
+
+namespace optimize
+{
+  /** \brief Hoist loop invariant expressions while duplicating an Ast.
+
+      An expression of a loop is invariant if it is pure, and if none
+      of the variables and fields it reads may change in the loop.  It
+      is then computed once, in a fresh variable declared ahead of the
+      loop:
+
+          while i < size(s) do (print(substring(s, i, 1)); i := i + 1)
+
+      becomes
+
+          let var _inv_0 := size(s)
+          in while i < _inv_0 do (print(substring(s, i, 1)); i := i + 1) end
+
+      The calls are hoisted if the callee neither reads nor writes
+      anything but its arguments and locals, nor performs input/output,
+      nor allocates: each iteration must get a record of its own (see
+      effects::effects_compute).  A loop calling a function which
+      may write keeps its loads of fields and of escaping variables.
+
+      An invariant expression that cannot fail nor loop (a "total"
+      expression, e.g., `size(s)' or `n * 2') is hoisted ahead of the
+      outermost loop where it is invariant.  The others (record field
+      loads, `chr', `substring', divisions by a variable) could fail
+      where the original program does not, if the loop is not run, or
+      fail earlier than the original program (the same goes for a call
+      to a function which may not return).  They are hoisted out of
+      their innermost loop only, and only if they are computed on every
+      iteration before anything else may have an effect.  The loop is
+      then rotated so that they are computed only if it is entered:
+
+          if c then
+            let var _inv_0 := r.f
+            in while 1 do (body; if c = 0 then break) end
+
+      The invariants of the test `c', computed first thing anyway, are
+      declared ahead of the `if'.  The identifiers must be unique, and the escapes and the effects
+      computed.  */
+  class Licm : public astclone::Cloner
+  {
+  public:
+    using super_type = astclone::Cloner;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::BreakExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::ForExp& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+    /// The number of hoisted expressions.
+    unsigned hoisted_get() const;
+
+    /// How much an expression is invariant in a loop.
+    enum class invariance
+    {
+      /// It may change.
+      variant,
+      /// It does not change, but may fail.
+      partial,
+      /// It does not change, and cannot fail.
+      total
+    };
+
+    /// What may change in a loop, and what was hoisted out of it.
+    struct loop
+    {
+      /// The variables declared in the loop.
+      misc::set<const ast::VarDec*> declared;
+      /// The variables assigned in the loop.
+      misc::set<const ast::VarDec*> assigned;
+      /// The names of the fields written in the loop.
+      misc::set<misc::symbol> fields;
+      /// Whether the loop calls a function which may write.
+      bool writes = false;
+
+      /// Whether something may have had an effect (or failed) since
+      /// the beginning of the current iteration.
+      bool effects = false;
+      /// The number of enclosing conditionals, within the loop.
+      unsigned conditional = 0;
+
+      /// The hoisted expressions, and the variables holding them.
+      std::vector<std::pair<misc::symbol, ast::Exp*>> hoisted;
+      /// Whether some hoisted expression is partial.
+      bool partial = false;
+    };
+
+  private:
+    /// Collect what may change in the loop \a e into \a l.
+    void loop_facts(const ast::Exp& e, loop& l) const;
+
+    /// How much \a e is invariant in \a l.
+    invariance invariance_get(const ast::Exp& e, const loop& l) const;
+
+    /// Hoist \a e if it is invariant, and return whether it was.
+    bool hoist(const ast::Exp& e);
+
+    /// Record that the current iterations may have had an effect.
+    void effect();
+
+    /// The enclosing loops of the current function, outermost first.
+    std::vector<loop> loops_;
+    /// Whether the visited variable is assigned.
+    bool lvalue_ = false;
+    /// The number of hoisted expressions.
+    unsigned hoisted_ = 0;
+  };
+
+} // namespace optimize
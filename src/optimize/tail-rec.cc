@@ -0,0 +1,189 @@
+/**
+ ** \file optimize/tail-rec.cc
+ ** \brief Implementation of optimize::TailRec.
+ */
+
+#include <memory>
+
+#include <ast/all.hh>
+#include <callgraph/libcallgraph.hh>
+#include <misc/symbol.hh>
+#include <optimize/tail-rec.hh>
+#include <parse/libparse.hh>
+#include <parse/tweast.hh>
+#include <type/builtin-types.hh>
+#include <type/record.hh>
+
+namespace optimize
+{
+  using namespace ast;
+
+  namespace
+  {
+    /// The name of the loop flag of \a fun.
+    std::string loop_name(const FunctionDec& fun)
+    {
+      return "_loop_" + fun.name_get().get();
+    }
+
+    /// The name of the result of \a fun.
+    std::string result_name(const FunctionDec& fun)
+    {
+      return "_result_" + fun.name_get().get();
+    }
+
+  } // namespace
+
+  TailRec::TailRec(const ast::Ast& tree)
+    : super_type()
+  {
+    std::unique_ptr<const callgraph::CallGraph> graph(
+      callgraph::callgraph_compute(tree));
+    const callgraph::FrozenCallGraph frozen = graph->freeze();
+
+    for (callgraph::FrozenCallGraph::vertex_type v = 0;
+         v < frozen.vertex_count(); ++v)
+      {
+        const FunctionDec* fun = frozen[v];
+        if (!frozen.has_edge(v, v) || !fun->body_get())
+          continue;
+
+        // The initial value of the result.
+        std::string init;
+        if (const NameTy* result = fun->result_get())
+          {
+            const type::Type& type = result->type_get()->actual();
+            if (dynamic_cast<const type::Int*>(&type))
+              init = "0";
+            else if (dynamic_cast<const type::String*>(&type))
+              init = "\"\"";
+            else if (dynamic_cast<const type::Record*>(&type))
+              init = "nil";
+            else
+              continue;
+          }
+
+        auto size = tail_calls_.size();
+        tail_calls_collect(*fun, *fun->body_get());
+        if (size != tail_calls_.size())
+          loops_.emplace(fun, init);
+      }
+  }
+
+  unsigned TailRec::loops_get() const { return loops_.size(); }
+
+  void TailRec::tail_calls_collect(const ast::FunctionDec& fun,
+                                   const ast::Exp& e)
+  {
+    if (auto call = dynamic_cast<const CallExp*>(&e))
+      {
+        if (call->def_get() == &fun)
+          tail_calls_.insert(call);
+      }
+    else if (auto cond = dynamic_cast<const IfExp*>(&e))
+      {
+        tail_calls_collect(fun, cond->get_thenclause());
+        if (&cond->get_elseclause())
+          tail_calls_collect(fun, cond->get_elseclause());
+      }
+    else if (auto seq = dynamic_cast<const SeqExp*>(&e))
+      {
+        if (!seq->exps_get().empty())
+          tail_calls_collect(fun, *seq->exps_get().back());
+      }
+    else if (auto let = dynamic_cast<const LetExp*>(&e))
+      tail_calls_collect(fun, let->exp_get());
+  }
+
+  /* Replace `f(arg_1, ..., arg_n)' with
+
+         let
+           var _arg_f_1_k : type_1 := arg_1
+           ...
+           var _arg_f_n_l : type_n := arg_n
+         in
+           formal_1 := _arg_f_1_k; ...; formal_n := _arg_f_n_l;
+           _loop_f := 1;
+           _result_f
+         end
+
+     The arguments are all evaluated before the formals are assigned,
+     since they may depend on them.  The temporaries have fresh names
+     (see misc::symbol::fresh), so that the identifiers remain unique.
+     A formal passed as is is not assigned.  The value of the expression
+     is irrelevant, as the loop goes on; `_result_f' just has the right
+     type.  */
+  void TailRec::operator()(const ast::CallExp& e)
+  {
+    if (!tail_calls_.has(&e))
+      return super_type::operator()(e);
+
+    const FunctionDec& fun = *e.def_get();
+    // Heap allocated, since the enclosing Tweast takes them over.
+    auto decs = new parse::Tweast;
+    auto assignments = new parse::Tweast;
+    bool temporaries = false;
+    auto arg = e.args_get().begin();
+    for (const VarDec* formal : fun.formals_get())
+      {
+        const Exp& actual = **arg++;
+        auto var = dynamic_cast<const SimpleVar*>(&actual);
+        if (var && var->def_get() == formal)
+          continue;
+        // Fresh, since each tail call declares its own.
+        misc::symbol tmp = misc::symbol::fresh(
+          "_arg_" + fun.name_get().get() + "_" + formal->name_get().get());
+        *decs << " var " << tmp << " : "
+              << formal->type_name_get()->name_get() << " := "
+              << recurse(actual);
+        *assignments << formal->name_get() << " := " << tmp << "; ";
+        temporaries = true;
+      }
+
+    parse::Tweast input;
+    if (temporaries)
+      input << "let " << decs << " in ";
+    else
+      {
+        delete decs;
+        input << "(";
+      }
+    input << assignments << loop_name(fun) << " := 1";
+    if (!loops_[&fun].empty())
+      input << "; " << result_name(fun);
+    input << (temporaries ? " end" : ")");
+
+    ast::Exp* loop = parse::parse(input);
+    result_ = loop;
+  }
+
+  void TailRec::operator()(const ast::FunctionDec& e)
+  {
+    auto i = loops_.find(&e);
+    if (i == loops_.end())
+      return super_type::operator()(e);
+
+    const Location& location = e.location_get();
+    const std::string& init = i->second;
+    std::string loop = loop_name(e);
+    std::string result = result_name(e);
+
+    parse::Tweast input;
+    input << "let var " << loop << " := 1";
+    if (!init.empty())
+      input << " var " << result << " : " << e.result_get()->name_get()
+            << " := " << init;
+    input << " in while " << loop << " do (" << loop << " := 0; ";
+    if (!init.empty())
+      input << result << " := ";
+    input << recurse(*e.body_get()) << ")";
+    if (!init.empty())
+      input << "; " << result;
+    input << " end";
+
+    ast::Exp* body = parse::parse(input);
+    result_ = new FunctionDec(location, e.name_get(), recurse(e.formals_get()),
+                              recurse(e.result_get()), body);
+  }
+
+} // namespace optimize
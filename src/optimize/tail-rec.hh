@@ -0,0 +1,79 @@
+/**
+ ** \file optimize/tail-rec.hh
+ ** \brief Declaration of optimize::TailRec.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include <astclone/cloner.hh>
+#include <misc/set.hh>
+
+namespace optimize
+{
+  /** \brief Turn self tail calls into loops while duplicating an Ast.
+
+      A function calling itself in tail position, e.g.,
+
+          function f(a : int, b : int) : int =
+            if a = 0 then b else f(a - 1, a + b)
+
+      is rewritten as a loop assigning its formals:
+
+          function f(a : int, b : int) : int =
+            let
+              var _loop_f := 1
+              var _result_f : int := 0
+            in
+              while _loop_f do
+                (_loop_f := 0;
+                 _result_f :=
+                   if a = 0 then b
+                   else
+                     let var _arg_f_a_0 : int := a - 1
+                         var _arg_f_b_1 : int := a + b
+                     in a := _arg_f_a_0; b := _arg_f_b_1;
+                        _loop_f := 1; _result_f end);
+              _result_f
+            end
+
+      The candidates are the functions with a self loop in the call
+      graph.  Functions returning an array or an object are left as
+      is, since there is no value to initialize their result with.
+
+      The identifiers must be unique, and remain so: the temporaries
+      of the arguments get fresh names.  */
+  class TailRec : public astclone::Cloner
+  {
+  public:
+    using super_type = astclone::Cloner;
+
+    // Import overloaded virtual functions.
+    using super_type::operator();
+
+    /// Build a TailRec, and find the self tail calls of \a tree.
+    explicit TailRec(const ast::Ast& tree);
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::FunctionDec& e) override;
+    /// \}
+
+    /// The number of functions turned into loops.
+    unsigned loops_get() const;
+
+  private:
+    /// Collect the calls to \a fun in tail position in \a e.
+    void tail_calls_collect(const ast::FunctionDec& fun, const ast::Exp& e);
+
+    /// The self tail calls.
+    misc::set<const ast::CallExp*> tail_calls_;
+    /// The functions to rewrite, and the initial value of their result
+    /// (empty for procedures).
+    std::map<const ast::FunctionDec*, std::string> loops_;
+  };
+
+} // namespace optimize
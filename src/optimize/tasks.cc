@@ -0,0 +1,70 @@
+/**
+ ** \file optimize/tasks.cc
+ ** \brief Optimize module related tasks' implementation.
+ **/
+
+#include <iostream>
+
+#include <ast/tasks.hh>
+#include <astclone/libastclone.hh>
+#include <optimize/liboptimize.hh>
+#define DEFINE_TASKS 1
+#include <optimize/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace optimize::tasks
+{
+  /*-------------------.
+    | Constant folding.  |
+    `-------------------*/
+
+  void fold() { astclone::apply(::optimize::fold, ast::tasks::the_program); }
+
+  /*-----------------.
+    | Tail recursion.  |
+    `-----------------*/
+
+  void tail_rec()
+  {
+    // Keep the program as is if there is nothing to rewrite.
+    ast::ChunkList* looped = ::optimize::tail_rec(*ast::tasks::the_program);
+    if (looped)
+      ast::tasks::the_program.reset(looped);
+  }
+
+  /*-----------------------------.
+    | Loop invariant code motion.  |
+    `-----------------------------*/
+
+  void licm() { astclone::apply(::optimize::licm, ast::tasks::the_program); }
+
+  /*------------------------.
+    | Dead code elimination.  |
+    `------------------------*/
+
+  void dce()
+  {
+    // Keep the program as is if there is nothing to remove.
+    ast::ChunkList* alive = ::optimize::dce(*ast::tasks::the_program);
+    if (alive)
+      ast::tasks::the_program.reset(alive);
+  }
+
+  /*-----------------------------------.
+    | Common subexpression elimination.  |
+    `-----------------------------------*/
+
+  /// The statistics of the last elimination.
+  static CseStats stats;
+
+  void cse()
+  {
+    // Keep the program as is if there is nothing to share.
+    ast::ChunkList* shared = ::optimize::cse(*ast::tasks::the_program, &stats);
+    if (shared)
+      ast::tasks::the_program.reset(shared);
+  }
+
+  void cse_stats() { std::cout << stats; }
+
+} // namespace optimize::tasks
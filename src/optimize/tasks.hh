@@ -0,0 +1,73 @@
+/**
+ ** \file optimize/tasks.hh
+ ** \brief Optimize module tasks.
+ */
+
+#pragma once
+
+#include <config.h>
+#include <misc/fwd.hh>
+#include <task/libtask.hh>
+
+/// Tasks of the optimize module.
+namespace optimize::tasks
+{
+  TASK_GROUP("Optimization");
+
+  /*-------------------.
+    | Constant folding.  |
+    `-------------------*/
+
+  /// Fold constant expressions.
+  TASK_DECLARE("fold",
+               "fold constant expressions",
+               fold,
+               "types-compute rename effects-compute");
+
+  /*-----------------.
+    | Tail recursion.  |
+    `-----------------*/
+
+  /// Turn self tail calls into loops.
+  TASK_DECLARE("tail-rec",
+               "turn self tail calls into loops",
+               tail_rec,
+               "types-compute rename");
+
+  /*-----------------------------.
+    | Loop invariant code motion.  |
+    `-----------------------------*/
+
+  /// Hoist loop invariant expressions.
+  TASK_DECLARE("licm",
+               "hoist loop invariant expressions",
+               licm,
+               "types-compute rename escapes-compute effects-compute");
+
+  /*------------------------.
+    | Dead code elimination.  |
+    `------------------------*/
+
+  /// Remove dead code and dead stores.
+  TASK_DECLARE("dce",
+               "remove dead code and dead stores",
+               dce,
+               "types-compute escapes-compute effects-compute");
+
+  /*-----------------------------------.
+    | Common subexpression elimination.  |
+    `-----------------------------------*/
+
+  /// Compute common subexpressions once.
+  TASK_DECLARE("cse",
+               "eliminate common subexpressions",
+               cse,
+               "types-compute escapes-compute effects-compute");
+
+  /// Report the eliminated subexpressions.
+  TASK_DECLARE("cse-stats",
+               "report the eliminated common subexpressions",
+               cse_stats,
+               "cse");
+
+} // namespace optimize::tasks
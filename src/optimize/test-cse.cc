@@ -0,0 +1,65 @@
+/**
+ ** Checking common subexpression elimination.
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <effects/libeffects.hh>
+#include <escapes/libescapes.hh>
+#include <misc/contract.hh>
+#include <optimize/liboptimize.hh>
+#include <testing.hh>
+
+using namespace ast;
+using namespace optimize;
+
+const char* program_name = "test-cse";
+
+// Eliminate the common subexpressions of \a body, and check that
+// \a eliminated of them were shared.
+static void test_cse(const std::string& body, unsigned eliminated)
+{
+  std::unique_ptr<ChunkList> tree(
+    testing::program_parse("type rec = {x : int}"
+                           " type arr = array of int"
+                           " function twice(i : int) : int = i * 2"
+                           " function len(t : arr) : int = 0"
+                           " function mk() : rec = rec {x = 0}"
+                           " var n := 21"
+                           " var a := mk()"
+                           " var b := mk()",
+                           body));
+  testing::program_check(*tree);
+  escapes::escapes_compute(*tree);
+  effects::effects_compute(*tree);
+
+  CseStats stats;
+  std::unique_ptr<ChunkList> shared(cse(*tree, &stats));
+  std::cout << body << ": " << stats.eliminated << '\n';
+  if (shared)
+    std::cout << *shared << '\n';
+  assertion(stats.eliminated == eliminated);
+  assertion(!shared == !eliminated);
+}
+
+int main()
+{
+  // Operations and pure calls.
+  test_cse("(print_int(n * 3); print_int(n * 3))", 1);
+  test_cse("(print_int(twice(n)); print_int(twice(n)))", 1);
+
+  // A store forgets the values it changes.
+  test_cse("(print_int(n * 3); n := 1; print_int(n * 3))", 0);
+  test_cse("(a := mk(); print_int(a.x); a.x := 1; print_int(a.x))", 0);
+
+  // A negative size fails: what follows is not computed before.
+  test_cse("(print_int(len(arr [n - 30] of 0) + n * 3); print_int(n * 3))",
+           0);
+
+  // Each call to a function which allocates returns a new record.
+  test_cse("(a := mk(); b := mk(); a.x := 1; print_int(b.x))", 0);
+}
@@ -0,0 +1,56 @@
+/**
+ ** Checking dead code elimination.
+ */
+
+#include <iostream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <effects/libeffects.hh>
+#include <escapes/libescapes.hh>
+#include <misc/contract.hh>
+#include <optimize/dce.hh>
+#include <testing.hh>
+
+using namespace ast;
+using namespace optimize;
+
+const char* program_name = "test-dce";
+
+// Remove the dead code of \a body, and check that \a removed
+// declarations, stores and expressions were.
+static void test_dce(const std::string& body, unsigned removed)
+{
+  ChunkList* tree =
+    testing::program_parse("type rec = {x : int}"
+                           " function mk() : rec = rec {x = 0}"
+                           " var n := 10",
+                           body);
+  testing::program_check(*tree);
+  escapes::escapes_compute(*tree);
+  effects::effects_compute(*tree);
+
+  Dce dce(*tree);
+  dce(*tree);
+  std::cout << body << ": " << dce.removed_get() << '\n'
+            << *dce.result_get() << '\n';
+  assertion(dce.removed_get() == removed);
+  delete dce.result_get();
+  delete tree;
+}
+
+int main()
+{
+  // Unread variables, allocations included.
+  test_dce("let var x := n * 2 in print_int(n) end", 1);
+  test_dce("let var r := mk() in print_int(n) end", 1);
+
+  // Dead stores and useless expressions.
+  test_dce("let var x := 0 in (x := n; x := 2; print_int(x + n)) end", 1);
+  test_dce("(n + 1; print_int(n))", 1);
+  test_dce("(print_int(n); n := n - 1)", 0);
+
+  // Arms which cannot be taken.
+  test_dce("(print_int(n); if 0 then print_int(n))", 1);
+}
@@ -0,0 +1,106 @@
+/**
+ ** Checking constant folding.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <bind/libbind.hh>
+#include <effects/libeffects.hh>
+#include <misc/contract.hh>
+#include <optimize/folder.hh>
+#include <parse/libparse.hh>
+
+using namespace ast;
+using namespace optimize;
+
+const char* program_name = "test-folder";
+
+// Fold \a input, and check that it prints as \a expected.
+static void test_fold(const std::string& input, const std::string& expected)
+{
+  Exp* tree = parse::parse(input);
+  Folder fold;
+  fold(*tree);
+  delete tree;
+
+  std::ostringstream o;
+  o << *fold.result_get();
+  delete fold.result_get();
+  std::cout << input << " => " << o.str() << '\n';
+  assertion(o.str() == expected);
+}
+
+// Fold \a input, where the string primitives, a string variable s and
+// a function of integers twice are bound, and their effects computed,
+// and check that it prints as \a expected.
+static void test_fold_bound(const std::string& input,
+                            const std::string& expected)
+{
+  Exp* tree = parse::parse("let primitive size(s : string) : int"
+                           "    primitive streq(a : string, b : string) : int"
+                           "    primitive concat(a : string, b : string)"
+                           "      : string"
+                           "    primitive print(s : string)"
+                           "    var s := \"s\""
+                           "    function twice(i : int) : int = i * 2 "
+                           "in "
+                           + input + " end");
+  assertion(!bind::bind_compute(*tree));
+  effects::effects_compute(*tree);
+  Folder fold;
+  fold(*tree);
+  delete tree;
+
+  std::ostringstream o;
+  o << dynamic_cast<LetExp&>(*fold.result_get()).exp_get();
+  delete fold.result_get();
+  std::cout << input << " => " << o.str() << '\n';
+  assertion(o.str() == expected);
+}
+
+int main()
+{
+  // Arithmetics and comparisons.
+  test_fold("1 + 2 * 3", "7");
+  test_fold("-(4 - 6)", "2");
+  test_fold("(1 + 2) < 4", "1");
+  test_fold("\"foo\" = \"bar\"", "0");
+  test_fold("\"\\n\" = \"\\012\"", "1");
+
+  // Runtime errors and overflows are left to the runtime.
+  test_fold("1 / 0", "(1 / 0)");
+  test_fold("2147483647 + 1", "(2147483647 + 1)");
+
+  // Conditionals and logical operators.
+  test_fold("if 1 < 2 then 3 else 4", "3");
+  test_fold("0 & 1", "0");
+  test_fold("1 | 0", "1");
+
+  // The string comparisons.
+  test_fold("\"abc\" < \"abd\"", "1");
+  test_fold("\"b\" >= \"ab\"", "1");
+
+  // The string primitives, on literals only.
+  test_fold_bound("size(\"abc\")", "3");
+  test_fold_bound("size(\"\\n\")", "1");
+  test_fold_bound("concat(\"a\", \"b\")", "\"ab\"");
+  test_fold_bound("streq(\"a\", \"a\")", "1");
+  test_fold_bound("streq(\"a\", \"b\")", "0");
+  test_fold_bound("size(s)", "size(s)");
+  test_fold_bound("concat(s, \"b\")", "concat(s, \"b\")");
+  test_fold_bound("streq(s, \"s\")", "streq(s, \"s\")");
+  test_fold_bound("size(concat(\"ab\", \"c\")) + size(s)",
+                  "(3 + size(s))");
+
+  // The calls without effects are dropped when their value is unused.
+  test_fold_bound("(size(s); twice(2); 3)", "3");
+  test_fold_bound("(print(s); 3)", "(\n  print(s);\n  3\n)");
+  test_fold_bound("(twice(1 / 0); 3)", "(\n  twice((1 / 0));\n  3\n)");
+
+  // Pure expressions of sequences.
+  test_fold("(1; 2; 3)", "3");
+}
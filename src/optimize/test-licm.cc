@@ -0,0 +1,79 @@
+/**
+ ** Checking loop invariant code motion.
+ */
+
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <effects/libeffects.hh>
+#include <escapes/libescapes.hh>
+#include <misc/contract.hh>
+#include <optimize/licm.hh>
+#include <testing.hh>
+
+using namespace ast;
+using namespace optimize;
+
+const char* program_name = "test-licm";
+
+// Hoist the loop invariants of \a body, check that \a hoisted
+// expressions were, and return the result.
+static std::string test_licm(const std::string& body, unsigned hoisted)
+{
+  ChunkList* tree =
+    testing::program_parse("primitive size(s : string) : int"
+                           " type rec = {x : int}"
+                           " function twice(i : int) : int = i * 2"
+                           " function mk() : rec = rec {x = 0}"
+                           " var s := \"forty-two\""
+                           " var n := 10"
+                           " var m := 21"
+                           " var a := mk()"
+                           " function next() : int = (n := n + 1; 9)",
+                           body);
+  testing::program_check(*tree);
+  escapes::escapes_compute(*tree);
+  effects::effects_compute(*tree);
+
+  Licm licm;
+  licm(*tree);
+  std::ostringstream o;
+  o << *licm.result_get();
+  std::cout << body << ": " << licm.hoisted_get() << '\n' << o.str() << '\n';
+  assertion(licm.hoisted_get() == hoisted);
+  delete licm.result_get();
+  delete tree;
+  return o.str();
+}
+
+int main()
+{
+  std::string res;
+
+  // Total invariants.
+  test_licm("while n > 0 do (print_int(size(s)); n := n - 1)", 1);
+  test_licm("for i := 0 to 9 do print_int(twice(m) + m)", 1);
+
+  // A partial invariant is computed only if the loop is entered: the
+  // test, with its own invariants, comes first.
+  res = test_licm("while n > size(s) do (print_int(a.x); n := n - 1)", 2);
+  assertion(res.find(":= size(") < res.find("if ("));
+  assertion(res.find("if (") < res.find(":= a_"));
+
+  // The bounds are computed before the invariants: they may change them.
+  res = test_licm("for i := 0 to next() do print_int(n * 2)", 1);
+  std::regex doubled("\\(n_\\d+ \\* 2\\)");
+  std::smatch invariant;
+  assertion(std::regex_search(res, invariant, doubled));
+  assertion(res.find(" := next_") < std::size_t(invariant.position()));
+
+  // Variant expressions.
+  test_licm("while n > 0 do (print_int(n * 2); n := n - 1)", 0);
+
+  // Each iteration allocates a record of its own.
+  test_licm("while n > 0 do (a := mk(); n := n - 1)", 0);
+}
@@ -0,0 +1,90 @@
+/**
+ ** Checking the tail recursion elimination.
+ */
+
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/libast.hh>
+#include <escapes/libescapes.hh>
+#include <misc/contract.hh>
+#include <optimize/tail-rec.hh>
+#include <testing.hh>
+
+using namespace ast;
+using namespace optimize;
+
+const char* program_name = "test-tail-rec";
+
+// Turn the self tail calls of \a decs into loops, and check that
+// \a loops functions were, without reusing a name.
+static void test_tail_rec(const std::string& decs, unsigned loops)
+{
+  ChunkList* tree = testing::program_parse(decs, "()");
+  testing::program_check(*tree);
+
+  TailRec tail_rec(*tree);
+  tail_rec(*tree);
+  std::cout << *tail_rec.result_get() << '\n';
+  assertion(tail_rec.loops_get() == loops);
+  assertion(testing::unique_names_p(*tail_rec.result_get()));
+  delete tail_rec.result_get();
+  delete tree;
+}
+
+// Turn the self tail calls of \a decs into loops, and check that the
+// result, bound and type-checked again, prints \a output when its body
+// is \a body.
+static void test_run(const std::string& decs, const std::string& body,
+                     const std::string& output)
+{
+  std::unique_ptr<ChunkList> tree(testing::program_parse(decs, body));
+  testing::program_check(*tree);
+
+  TailRec tail_rec(*tree);
+  tail_rec(*tree);
+  std::unique_ptr<ChunkList> res(
+    dynamic_cast<ChunkList*>(tail_rec.result_get()));
+  assertion(res);
+  testing::program_check(*res);
+  escapes::escapes_compute(*res);
+  testing::run_check(body, testing::program_interpret(*res), {0, output});
+}
+
+int main()
+{
+  // Functions and procedures.
+  test_tail_rec("function f(a : int, b : int) : int ="
+                "  if a = 0 then b else f(a - 1, a + b)",
+                1);
+  test_tail_rec("function loop(n : int) = if n > 0 then loop(n - 1)", 1);
+
+  // Each tail call has temporaries of its own.
+  test_tail_rec("function f(a : int, b : int) : int ="
+                "  if a = 0 then b"
+                "  else if a > 10 then f(a - 2, b + 1)"
+                "  else f(a - 1, a + b)",
+                1);
+
+  // Not in tail position.
+  test_tail_rec("function g(n : int) : int ="
+                "  if n = 0 then 0 else 1 + g(n - 1)",
+                0);
+
+  // The loops compute what the calls did, at a depth which would
+  // overflow the stack of the interpreter with the calls.
+  test_run("function f(a : int, b : int) : int ="
+           "  if a = 0 then b else f(a - 1, b + 1)",
+           "print_int(f(10, 0)); print_int(f(10000000, 0))",
+           "1010000000");
+  test_run("function loop(n : int) = if n > 0 then loop(n - 1)",
+           "(loop(10000000); print_int(1))", "1");
+  test_run("function f(a : int, b : int) : int ="
+           "  if a = 0 then b"
+           "  else if a > 10 then f(a - 2, b + 1)"
+           "  else f(a - 1, a + b)",
+           "print_int(f(15, 0)); print_int(f(2001, 0))",
+           "481041");
+}
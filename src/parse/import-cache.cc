@@ -0,0 +1,82 @@
+/**
+ ** \file parse/import-cache.cc
+ ** \brief Implementation of parse::ImportCache.
+ */
+
+#include <system_error>
+#include <utility>
+
+#include <ast/chunk-list.hh>
+#include <astclone/libastclone.hh>
+#include <parse/import-cache.hh>
+
+namespace parse
+{
+  ImportCache::~ImportCache() = default;
+
+  ImportCache::stamp ImportCache::stamp_get(const misc::path& path)
+  {
+    std::error_code ec;
+    stamp res{path, std::filesystem::last_write_time(path, ec),
+              std::filesystem::file_size(path, ec)};
+    if (ec)
+      res.size = static_cast<std::uintmax_t>(-1);
+    return res;
+  }
+
+  ast::ChunkList* ImportCache::find(const misc::path& path,
+                                    unsigned flags,
+                                    const misc::file_library& library,
+                                    stamps_type& deps)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto i = entries_.find(
+      key_type(path.lexically_normal(), flags, library.search_path_get()));
+    if (i != entries_.end())
+      {
+        for (const stamp& s : i->second.deps)
+          if (!(stamp_get(s.path) == s))
+            {
+              ++stats_.stale;
+              entries_.erase(i);
+              i = entries_.end();
+              break;
+            }
+      }
+    if (i == entries_.end())
+      {
+        ++stats_.misses;
+        return nullptr;
+      }
+    ++stats_.hits;
+    deps.insert(deps.end(), i->second.deps.begin(), i->second.deps.end());
+    return astclone::clone(*i->second.chunks);
+  }
+
+  void ImportCache::insert(const misc::path& path,
+                           unsigned flags,
+                           const misc::file_library& library,
+                           const ast::ChunkList& chunks,
+                           const stamps_type& deps)
+  {
+    // Clone before the caller binds and transforms its tree.
+    std::unique_ptr<ast::ChunkList> copy(astclone::clone(chunks));
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_[key_type(path.lexically_normal(), flags,
+                      library.search_path_get())] =
+      entry{std::move(copy), deps};
+  }
+
+  void ImportCache::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+  }
+
+  ImportCacheStats ImportCache::stats_get() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+} // namespace parse
@@ -0,0 +1,109 @@
+/**
+ ** \file parse/import-cache.hh
+ ** \brief Declaration of parse::ImportCache.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <ast/fwd.hh>
+#include <misc/file-library.hh>
+#include <misc/singleton.hh>
+
+namespace parse
+{
+  /// How the import cache fared.
+  struct ImportCacheStats
+  {
+    /// Imports served from the cache.
+    unsigned hits = 0;
+    /// Imports parsed, including the stale ones.
+    unsigned misses = 0;
+    /// Entries dropped because a file they read has changed.
+    unsigned stale = 0;
+  };
+
+  /** \brief The imported files already parsed, shared by all the
+      parsers of the process.
+
+      An entry is keyed by the normalized absolute path of the file,
+      by the extensions enabled, which change the parse, and by the
+      search path, which resolves the files it imports (the current
+      directory while parsing it is its own directory).  It keeps
+      a pristine copy of the chunks, whose clones are handed out, and
+      the stamps (modification time and size) of the files read to
+      produce them: the file itself, then the files it imports,
+      transitively.  An entry is valid as long as none of them
+      changed.  */
+  class ImportCache : public misc::Singleton<ImportCache>
+  {
+  public:
+    /// The identity of the contents of a file.
+    struct stamp
+    {
+      misc::path path;
+      std::filesystem::file_time_type mtime;
+      std::uintmax_t size = 0;
+
+      bool operator==(const stamp&) const = default;
+    };
+    using stamps_type = std::vector<stamp>;
+
+    /// The stamp of \a path, whose size is -1 if it cannot be read.
+    static stamp stamp_get(const misc::path& path);
+
+    /// A clone of the chunks parsed from \a path with the \a flags
+    /// extensions and the search path of \a library, if they are up to
+    /// date, null otherwise.  Add the stamps of the files they were
+    /// parsed from to \a deps.
+    ast::ChunkList* find(const misc::path& path,
+                         unsigned flags,
+                         const misc::file_library& library,
+                         stamps_type& deps);
+
+    /// Record that \a chunks were parsed from \a path with the \a flags
+    /// extensions and the search path of \a library, reading the files
+    /// of \a deps.
+    void insert(const misc::path& path,
+                unsigned flags,
+                const misc::file_library& library,
+                const ast::ChunkList& chunks,
+                const stamps_type& deps);
+
+    /// Forget all the entries.
+    void clear();
+
+    /// \name Getters.
+    /// \{
+    ImportCacheStats stats_get() const;
+    /// \}
+
+  private:
+    friend class misc::Singleton<ImportCache>;
+    ImportCache() = default;
+    ~ImportCache();
+
+    struct entry
+    {
+      std::unique_ptr<ast::ChunkList> chunks;
+      stamps_type deps;
+    };
+    using key_type =
+      std::tuple<misc::path, unsigned, misc::file_library::path_list_type>;
+
+    /// The entries.
+    std::map<key_type, entry> entries_;
+    /// The statistics.
+    ImportCacheStats stats_;
+    /// Serialize the accesses, for concurrent compilations.
+    mutable std::mutex mutex_;
+  };
+
+} // namespace parse
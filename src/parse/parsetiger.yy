@@ -414,7 +414,7 @@ tychunk:
 tydec:
   "type" ID "=" ty { $$ = tp.td_.make_TypeDec(@$, $2, $4);}
   | CLASS ID EXTENDS typeid LBRACE classfields RBRACE {$$ = tp.td_.make_TypeDec(@$, $2, tp.td_.make_ClassTy(@$, $4, $6));}
-  | CLASS ID LBRACE classfields RBRACE {$$ = tp.td_.make_TypeDec(@$, $2, tp.td_.make_ClassTy(@$, nullptr, $4));}
+  | CLASS ID LBRACE classfields RBRACE {$$ = tp.td_.make_TypeDec(@$, $2, tp.td_.make_ClassTy(@$, tp.td_.make_NameTy(@$, misc::symbol("Object")), $4));}
   ;
 
 ty:
@@ -422,7 +422,7 @@ ty:
 | "{" tyfields "}" {$$ = tp.td_.make_RecordTy(@$, $2); }
 | "array" "of" typeid {$$ = tp.td_.make_ArrayTy(@$, $3); }
 | CLASS EXTENDS typeid LBRACE classfields RBRACE {$$ = tp.td_.make_ClassTy(@$, $3, $5);}
-| CLASS LBRACE classfields RBRACE {$$ = tp.td_.make_ClassTy(@$, nullptr, $3);}
+| CLASS LBRACE classfields RBRACE {$$ = tp.td_.make_ClassTy(@$, tp.td_.make_NameTy(@$, misc::symbol("Object")), $3);}
 ;
 
 classfields:
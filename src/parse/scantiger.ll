@@ -185,6 +185,11 @@ int comments = 0;
     return TOKEN(NEW);
 }
 
+"_cast" {
+    CHECK_EXTENSION();
+    return TOKEN(CAST);
+}
+
  /* Symbol tokens. */
 
 "," {
@@ -309,8 +314,8 @@ int comments = 0;
   }
   {character} { grown_string += yytext; }
   {escape} { grown_string.append(yytext); }
-  {num} { grown_string.append(yytext + 3); }
-  {xnum} { grown_string.append(1, strtol(yytext + 2, 0, 16)); }
+  {num} { grown_string.append(yytext); }
+  {xnum} { grown_string.append(yytext); }
   {int} { grown_string += yytext; }
   "\\" { grown_string.append(yytext); }
   "\\\\" { grown_string.append(yytext); }
@@ -356,6 +361,12 @@ int comments = 0;
 
 {identifier} { return TOKEN_VAL(ID, yytext); }
 
+ /* Reserved identifiers, used by the code the compiler generates. */
+"_"[a-zA-Z0-9_]* {
+    CHECK_EXTENSION();
+    return TOKEN_VAL(ID, yytext);
+}
+
  /* Error. */
 . { tp.error_ << misc::error::error_type::scan 
                 << tp.location_ << ": Invalid character " << yytext << "\n"; }
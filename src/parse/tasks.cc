@@ -37,6 +37,8 @@ namespace parse::tasks
     if (!result.first)
       task_error().exit();
 
+    // A new compilation: the types of the previous one go too.
+    ast::tasks::program_drop();
     ast::tasks::the_program.reset(result.first);
   }
 
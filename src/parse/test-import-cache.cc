@@ -0,0 +1,77 @@
+/**
+ ** Test the cache of the parsed imports.
+ */
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+#include <ast/chunk-list.hh>
+#include <ast/libast.hh>
+#include <misc/contract.hh>
+#include <misc/file-library.hh>
+#include <parse/import-cache.hh>
+#include <parse/libparse.hh>
+
+namespace fs = std::filesystem;
+
+const char* program_name = "test-import-cache";
+
+// Parse \a file with \a library, and check that it prints \a expected.
+static void test_import(const fs::path& file,
+                        misc::file_library& library,
+                        const std::string& expected)
+{
+  auto [chunks, error] = parse::parse("", file, library, false, false);
+  assertion(!error);
+  std::unique_ptr<ast::ChunkList> tree(chunks);
+
+  std::ostringstream o;
+  o << *tree;
+  std::cout << file << " with " << library << ":\n" << o.str() << '\n';
+  assertion(o.str().find(expected) != std::string::npos);
+}
+
+int main()
+{
+  fs::path dir = fs::temp_directory_path()
+    / ("test-import-cache-" + std::to_string(getpid()));
+  fs::create_directories(dir / "one");
+  fs::create_directories(dir / "two");
+  std::ofstream(dir / "main.tig") << "import \"a.tih\"\n";
+  std::ofstream(dir / "a.tih") << "import \"b.tih\"\n";
+  std::ofstream(dir / "one" / "b.tih") << "function one() = ()\n";
+  std::ofstream(dir / "two" / "b.tih") << "function two() = ()\n";
+
+  parse::ImportCache& cache = parse::ImportCache::instance();
+  cache.clear();
+  misc::file_library one(dir / "one");
+  misc::file_library two(dir / "two");
+
+  // The first parse fills the cache, the second one hits.
+  test_import(dir / "main.tig", one, "one");
+  parse::ImportCacheStats stats = cache.stats_get();
+  assertion(stats.hits == 0 && stats.misses == 2);
+  test_import(dir / "main.tig", one, "one");
+  assertion(cache.stats_get().hits == stats.hits + 1);
+
+  // Another search path resolves the nested import differently.
+  stats = cache.stats_get();
+  test_import(dir / "main.tig", two, "two");
+  assertion(cache.stats_get().hits == stats.hits);
+  assertion(cache.stats_get().misses == stats.misses + 2);
+
+  // A change of a nested import makes the entries that read it stale.
+  stats = cache.stats_get();
+  std::ofstream(dir / "one" / "b.tih") << "function eins() = ()\n";
+  test_import(dir / "main.tig", one, "eins");
+  assertion(cache.stats_get().stale == stats.stale + 2);
+  assertion(cache.stats_get().hits == stats.hits);
+
+  cache.clear();
+  fs::remove_all(dir);
+}
@@ -6,6 +6,7 @@
 #include <cstdlib>
 #include <fstream>
 
+#include <parse/import-cache.hh>
 #include <parse/parsetiger.hh>
 #include <parse/scantiger.hh>
 #include <parse/tiger-parser.hh>
@@ -178,30 +179,50 @@ namespace parse
         return nullptr;
       }
 
-    library_.push_current_directory(directory_path);
-    open_files_[absolute_path] = loc;
-    // Save the inputs, and reset them.
-    input_type saved_input = input_;
-    location saved_location = location_;
-    // Parse the imported file.
-    ast::ChunkList* res = nullptr;
-    try
+    // Reuse a previous parse of the same file, unless it changed.
+    const unsigned flags =
+      enable_extensions_p_ | enable_object_extensions_p_ << 1;
+    ImportCache& cache = ImportCache::instance();
+    ImportCache::stamps_type deps;
+    ast::ChunkList* res = cache.find(absolute_path, flags, library_, deps);
+    if (!res)
       {
-        res = parse_file(absolute_path);
+        library_.push_current_directory(directory_path);
+        open_files_[absolute_path] = loc;
+        // Stamp the file before reading it, so that a change during the
+        // parse invalidates the entry.
+        imports_.emplace_back(1, ImportCache::stamp_get(absolute_path));
+        // Save the inputs, and reset them.
+        input_type saved_input = input_;
+        location saved_location = location_;
+        // Parse the imported file.
+        try
+          {
+            res = parse_file(absolute_path);
+          }
+        catch (const std::bad_variant_access& e)
+          {
+            error_ << misc::error::error_type::parse << absolute_path
+                   << ": imported from " << loc
+                   << ": syntax error, unexpected exp, expecting chunks.\n";
+            error_.exit();
+          }
+        // Set the inputs back to their original values.
+        input_ = saved_input;
+        location_ = saved_location;
+
+        deps = std::move(imports_.back());
+        imports_.pop_back();
+        open_files_.erase(absolute_path);
+        library_.pop_current_directory();
+
+        if (res && !error_)
+          cache.insert(absolute_path, flags, library_, *res, deps);
       }
-    catch (const std::bad_variant_access& e)
-      {
-        error_ << misc::error::error_type::parse << absolute_path
-               << ": imported from " << loc
-               << ": syntax error, unexpected exp, expecting chunks.\n";
-        error_.exit();
-      }
-    // Set the inputs back to their original values.
-    input_ = saved_input;
-    location_ = saved_location;
 
-    open_files_.erase(absolute_path);
-    library_.pop_current_directory();
+    // The enclosing import depends on the files read by this one.
+    if (!imports_.empty())
+      imports_.back().insert(imports_.back().end(), deps.begin(), deps.end());
     return res;
   }
 
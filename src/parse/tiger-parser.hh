@@ -8,11 +8,13 @@
 #include <map>
 #include <memory>
 #include <stack>
+#include <vector>
 
 #include <ast/fwd.hh>
 #include <common.hh>
 #include <misc/error.hh>
 #include <misc/file-library.hh>
+#include <parse/import-cache.hh>
 #include <parse/parsetiger.hh>
 #include <parse/tiger-driver.hh>
 #include <parse/tweast.hh>
@@ -81,6 +83,9 @@ namespace parse
 
     /// The list of open files, and the location of their request.
     std::map<misc::path, location> open_files_;
+    /// The stamps of the files read by each import being parsed, for
+    /// the import cache.
+    std::vector<ImportCache::stamps_type> imports_;
     /// \}
 
     /// \name Running the parse.
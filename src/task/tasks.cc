@@ -6,6 +6,7 @@
 #include <iostream>
 
 #include <common.hh>
+#include <misc/file-library.hh>
 #include <task/task-register.hh>
 #define DEFINE_TASKS 1
 #include <task/tasks.hh>
@@ -14,6 +15,8 @@
 // Task module related tasks' implementation.
 namespace task::tasks
 {
+  int jobs = 1;
+
   void tasks_list() { TaskRegister::instance().print_task_list(std::cout); }
 
   void tasks_graph() { TaskRegister::instance().print_task_graph(std::cout); }
@@ -23,6 +26,10 @@ namespace task::tasks
     TaskRegister::instance().print_task_order(std::cout);
   }
 
-  void time_report() { task_timer.dump_on_destruction(std::cerr); }
+  void time_report()
+  {
+    task_timer.counter("filesystem probes", misc::file_library::probes_get);
+    task_timer.dump_on_destruction(std::cerr);
+  }
 
 } // namespace task::tasks
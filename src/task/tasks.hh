@@ -5,12 +5,18 @@
 
 #pragma once
 
+#include <limits>
+
+#include <misc/error.hh>
 #include <task/libtask.hh>
 
 namespace task::tasks
 {
   TASK_GROUP("0. Tasks");
 
+  /// Number of threads used by the passes able to run in parallel.
+  extern int jobs;
+
   /// List all the existing tasks.
   TASK_DECLARE("task-list", "list registered tasks", tasks_list, "");
   /// Dump task graph.
@@ -19,5 +25,19 @@ namespace task::tasks
   TASK_DECLARE("task-selection", "list tasks to be run", tasks_selection, "");
   /// Ask for a time report at the end of the execution.
   TASK_DECLARE("time-report", "report execution times", time_report, "");
+  /// Set the number of threads of the parallel passes.
+  INT_TASK_DECLARE("j|jobs",
+                   1,
+                   1024,
+                   "run the parallel passes on NUM threads",
+                   jobs,
+                   "");
+  /// Bound the number of diagnostics of a pass.
+  INT_TASK_DECLARE("max-errors",
+                   0,
+                   std::numeric_limits<int>::max(),
+                   "stop a pass after NUM errors (0: no limit)",
+                   misc::error::max_errors,
+                   "");
 
 } // namespace task::tasks
@@ -0,0 +1,128 @@
+/**
+ ** \file testing.hh
+ ** \brief Helpers shared by the unit tests of the modules.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <bind/libbind.hh>
+#include <escapes/libescapes.hh>
+#include <interpret/libinterpret.hh>
+#include <misc/contract.hh>
+#include <misc/set.hh>
+#include <parse/libparse.hh>
+#include <type/libtype.hh>
+
+namespace testing
+{
+  /// The program declaring print_int and \a decs, whose body is \a body.
+  inline ast::ChunkList* program_parse(const std::string& decs,
+                                       const std::string& body)
+  {
+    return parse::parse_unit("let primitive print_int(i : int) " + decs
+                             + " in " + body + " end");
+  }
+
+  /// Bind, rename and type-check \a tree, whose bindings must be
+  /// correct.  The types are computed for the passes which need them.
+  inline void program_check(ast::Ast& tree)
+  {
+    assertion(!bind::bind_compute(tree));
+    bind::name_compute(tree);
+    type::types_check(tree);
+  }
+
+  /// The program whose body is \a body, which may print, and whose
+  /// bindings, types and escapes are computed, ready to run.
+  inline ast::ChunkList* program_compute(const std::string& body)
+  {
+    ast::ChunkList* res =
+      parse::parse_unit("let primitive print(s : string)"
+                        "    primitive print_int(i : int)"
+                        "    primitive size(s : string) : int"
+                        "    primitive exit(status : int) "
+                        "in "
+                        + body + " end");
+    program_check(*res);
+    escapes::escapes_compute(*res);
+    return res;
+  }
+
+  /// What a run of a program did.
+  struct run_type
+  {
+    /// Its exit status.
+    int status;
+    /// What it printed on its standard output.
+    std::string out;
+
+    bool operator==(const run_type&) const = default;
+  };
+
+  /// Run \a tree with \a executor, whose signature is that of
+  /// interpret::interpret, on an empty input.
+  template <typename Executor>
+  run_type program_run(Executor executor, const ast::ChunkList& tree)
+  {
+    std::istringstream in;
+    std::ostringstream out;
+    std::ostringstream err;
+    int status = executor(tree, in, out, err);
+    return {status, out.str()};
+  }
+
+  /// Run \a tree with the interpreter, the reference executor.
+  inline run_type program_interpret(const ast::ChunkList& tree)
+  {
+    return program_run(interpret::interpret, tree);
+  }
+
+  /// Report the \a run of \a body, and check that it is \a expected.
+  inline void run_check(const std::string& body,
+                        const run_type& run,
+                        const run_type& expected)
+  {
+    std::cout << body << ": " << run.status << '\n' << run.out << '\n';
+    if (run == expected)
+      return;
+    std::cerr << "expected: " << expected.status << '\n'
+              << expected.out << '\n';
+    assertion(run == expected);
+  }
+
+  /// Count the variable declarations, and their distinct names.
+  class VarDecCounter
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    using super_type = ast::DefaultConstVisitor;
+    using super_type::operator();
+
+    void operator()(const ast::VarDec& e) override
+    {
+      super_type::operator()(e);
+      ++decs;
+      names.insert(e.name_get());
+    }
+
+    unsigned decs = 0;
+    misc::set<misc::symbol> names;
+  };
+
+  /// Whether no two variables of \a tree have the same name.
+  inline bool unique_names_p(const ast::Ast& tree)
+  {
+    VarDecCounter count;
+    tree.accept(count);
+    return count.names.size() == count.decs;
+  }
+
+} // namespace testing
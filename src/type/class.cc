@@ -3,10 +3,13 @@
  ** \brief Implementation for type/class.hh.
  */
 
+#include <map>
 #include <ostream>
+#include <utility>
 
 #include <range/v3/algorithm/find.hpp>
 #include <type/class.hh>
+#include <type/nil.hh>
 #include <type/visitor.hh>
 
 namespace type
@@ -44,8 +47,9 @@ namespace type
 
   const Class* Class::common_root(const Class& other) const
   {
-    if (super_->id_get() == other.super_get()->id_get())
-      return super_;
+    for (const Class* c = this; c; c = c->super_get())
+      if (c->compatible_with(other))
+        return c;
     return nullptr;
   }
 
@@ -58,9 +62,46 @@ namespace type
     }
     return true;
   }
+  // The objects of the subclasses, and nil, fit in this class.  The
+  // preorder ids may not be computed yet: walk up the super classes.
   bool Class::compatible_with(const Type& other) const
   {
-    return this->actual() == other;
+    const Type& actual = other.actual();
+    if (dynamic_cast<const Nil*>(&actual))
+      return true;
+    for (auto c = dynamic_cast<const Class*>(&actual); c; c = c->super_get())
+      if (c == this)
+        return true;
+    return false;
+  }
+
+  void Class::preorder_compute() const
+  {
+    // The direct subclasses of each class, in order of declaration.
+    std::map<const Class*, subclasses_type> children;
+    for (const Class* c : subclasses_)
+      children[c->super_get()].emplace_back(c);
+
+    // Iterative DFS: deep hierarchies must not overflow the stack.
+    unsigned next = 0;
+    preorder_id_ = next++;
+    std::vector<std::pair<const Class*, std::size_t>> stack = {{this, 0}};
+    while (!stack.empty())
+      {
+        auto& [c, i] = stack.back();
+        const subclasses_type& kids = children[c];
+        if (i < kids.size())
+          {
+            const Class* kid = kids[i++];
+            kid->preorder_id_ = next++;
+            stack.emplace_back(kid, 0);
+          }
+        else
+          {
+            c->preorder_last_ = next - 1;
+            stack.pop_back();
+          }
+      }
   }
 
   const Class& Class::object_instance()
@@ -122,6 +122,24 @@ namespace type
     void subclasses_clear() const;
     /** \} */
 
+    /** \name Preorder numbering.
+     ** \{ */
+    /// \brief Number this class and its subclasses in depth-first
+    /// preorder, starting from 0.
+    ///
+    /// Afterwards, the subclasses of a class C are exactly the classes
+    /// whose preorder id is in ]C.preorder_id_get(), C.preorder_last_get()],
+    /// so that subtyping is an interval test.  This method is const
+    /// for the same reason as type::Class::subclass_add.
+    void preorder_compute() const;
+    /// Return the preorder id of the class.
+    unsigned preorder_id_get() const;
+    /// Return the largest preorder id among the class and its subclasses.
+    unsigned preorder_last_get() const;
+    /// Whether this class is \a other, or one of its subclasses.
+    bool is_a(const Class& other) const;
+    /** \} */
+
     /** \name Type resolution.
      ** \{ */
     /** \brief Find the common super class.  */
@@ -147,6 +165,10 @@ namespace type
     const Class* super_;
     /// Sub classes.
     mutable subclasses_type subclasses_;
+    /// Preorder id.
+    mutable unsigned preorder_id_ = 0;
+    /// Largest preorder id of the subclasses.
+    mutable unsigned preorder_last_ = 0;
     /// Attributes list.
     attrs_type attrs_;
     /// Methods list.
@@ -85,4 +85,14 @@ namespace type
 
   inline void Class::subclasses_clear() const { subclasses_.clear(); }
 
+  inline unsigned Class::preorder_id_get() const { return preorder_id_; }
+
+  inline unsigned Class::preorder_last_get() const { return preorder_last_; }
+
+  inline bool Class::is_a(const Class& other) const
+  {
+    return other.preorder_id_ <= preorder_id_
+      && preorder_id_ <= other.preorder_last_;
+  }
+
 } // namespace type
@@ -19,7 +19,11 @@ namespace type
     formals_ = formals;
   }
 
-  Function::~Function() { delete formals_; }
+  Function::~Function()
+  {
+    if (formals_owned_)
+      delete formals_;
+  }
 
   void Function::accept(ConstVisitor& v) const { v(*this); }
 
@@ -19,7 +19,8 @@ namespace type
   public:
     /** \brief Construct a Function.
      **
-     ** \param formals type structures of formal arguments.
+     ** \param formals type structures of formal arguments, owned
+     **                unless the function is allocated in a TypeArena.
      ** \param result type structure of what function returns. */
     Function(const Record* formals, const Type& result);
 
@@ -50,6 +51,10 @@ namespace type
   protected:
     /// Formals' types.
     const Record* formals_;
+    /// Whether formals_ is to be deleted with the function.  The
+    /// arena owns the formals of the functions it allocates.
+    bool formals_owned_ = true;
+    friend class TypeArena;
 
     /// Result's type.
     const Type& result_;
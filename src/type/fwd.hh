@@ -21,6 +21,7 @@ namespace type
   class Record;
   class String;
   class Type;
+  class TypeArena;
   class Void;
 
   // From visitor.hh
@@ -9,9 +9,14 @@
 
 namespace type
 {
-  misc::error types_check(ast::Ast& tree)
+  misc::error types_check(ast::Ast& tree, unsigned jobs)
   {
-    TypeChecker type;
+    return types_check(tree, default_arena(), jobs);
+  }
+
+  misc::error types_check(ast::Ast& tree, TypeArena& arena, unsigned jobs)
+  {
+    TypeChecker type(arena, jobs);
     type(tree);
     return type.error_get();
   }
@@ -7,13 +7,24 @@
 
 #include <ast/fwd.hh>
 #include <misc/error.hh>
+#include <type/type-arena.hh>
 
 /// Type-checking an ast::Ast.
 namespace type
 {
   /** \brief Check types in a (bound) AST.
    ** \param tree   abstract syntax tree's root.
+   ** \param jobs   number of threads checking function bodies.
    ** \return       synthesis of the errors possibly found. */
-  misc::error types_check(::ast::Ast& tree);
+  misc::error types_check(::ast::Ast& tree, unsigned jobs = 1);
+
+  /** \brief Check types in a (bound) AST, allocating the types in an
+   **        arena.
+   ** \param tree   abstract syntax tree's root.
+   ** \param arena  the owner of the types created for \a tree.
+   ** \param jobs   number of threads checking function bodies.
+   ** \return       synthesis of the errors possibly found. */
+  misc::error types_check(::ast::Ast& tree, TypeArena& arena,
+                          unsigned jobs = 1);
 
 } // namespace type
@@ -33,9 +33,7 @@ namespace type
 
   bool Named::compatible_with(const Type& other) const
   {
-    if (*this->type_get() == other.actual())
-      return true;
-    return false;
+    return actual().compatible_with(other);
   }
 
 } // namespace type
\ No newline at end of file
@@ -21,11 +21,12 @@ namespace type
   void Nil::accept(Visitor& v) { v(*this); }
 
 
+  // nil is a value of the records and of the classes.
   bool Nil::compatible_with(const Type& other) const
   {
-    if (other == this->actual())
-      return false;
-    return true;
+    const Type& actual = other.actual();
+    return dynamic_cast<const Record*>(&actual)
+      || dynamic_cast<const Class*>(&actual);
   }
 
   const Type* Nil::record_type_get() const { return record_type_; }
@@ -35,18 +35,12 @@ namespace type
         return count; 
       count++;
     }
+    return -1;
   }
 
   bool Record::compatible_with(const Type& other) const
   {
-    auto fields_vec = this->fields_get();
-
-    for (auto &f : fields_vec)
-    {
-      if (f.type_get() != other.actual())
-        return false;
-    }
-    return true;
+    return *this == other || dynamic_cast<const Nil*>(&other.actual());
   }
 
 } // namespace type
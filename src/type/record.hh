@@ -34,7 +34,8 @@ namespace type
     const Type* field_type(misc::symbol key) const;
     /** \brief Return the index of the field associated to \a key.
      **
-     ** The index of a field is its position in the list. */
+     ** The index of a field is its position in the list, -1 if there
+     ** is no such field. */
     int field_index(misc::symbol key) const;
     /** \} */
 
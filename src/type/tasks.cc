@@ -3,8 +3,11 @@
  ** \brief Type module task implementations.
  */
 
+#include <iostream>
+
 #include <ast/tasks.hh>
 #include <common.hh>
+#include <task/tasks.hh>
 #include <type/libtype.hh>
 #define DEFINE_TASKS 1
 #include <type/tasks.hh>
@@ -15,8 +18,11 @@ namespace type::tasks
 {
   void types_check()
   {
-    task_error() << ::type::types_check(*ast::tasks::the_program)
+    task_error() << ::type::types_check(*ast::tasks::the_program,
+                                        ::task::tasks::jobs)
                  << &misc::error::exit_on_error;
   }
 
+  void type_arena_stats() { std::cout << default_arena().stats_get(); }
+
 } // namespace type::tasks
@@ -24,4 +24,10 @@ namespace type::tasks
                types_check,
                "bindings-compute");
 
+  /// Report the allocations of types.
+  TASK_DECLARE("type-arena-stats",
+               "report the allocations of types",
+               type_arena_stats,
+               "types-compute");
+
 } // namespace type::tasks
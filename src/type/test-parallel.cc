@@ -0,0 +1,134 @@
+/**
+ ** Checking the concurrent type checking of the function bodies.
+ */
+
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <ast/all.hh>
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <bind/libbind.hh>
+#include <misc/contract.hh>
+#include <parse/libparse.hh>
+#include <type/libtype.hh>
+#include <type/pretty-printer.hh>
+#include <type/type.hh>
+
+using namespace ast;
+
+const char* program_name = "test-parallel";
+
+// Report the types of the declarations and of the calls, but not the
+// addresses of the named types.
+class TypeDumper
+  : public DefaultConstVisitor
+  , public NonObjectConstVisitor
+{
+public:
+  using super_type = DefaultConstVisitor;
+  using super_type::operator();
+
+  explicit TypeDumper(std::ostream& ostr)
+    : ostr_(ostr)
+  {}
+
+  void operator()(const FunctionDec& e) override
+  {
+    dump(e.name_get(), e.type_get());
+    super_type::operator()(e);
+  }
+
+  void operator()(const VarDec& e) override
+  {
+    dump(e.name_get(), e.type_get());
+    super_type::operator()(e);
+  }
+
+  void operator()(const CallExp& e) override
+  {
+    dump(e.name_get(), e.type_get());
+    super_type::operator()(e);
+  }
+
+private:
+  void dump(misc::symbol name, const type::Type* type)
+  {
+    ostr_ << name << ": ";
+    if (type)
+      ostr_ << type->actual();
+    else
+      ostr_ << "?";
+    ostr_ << '\n';
+  }
+
+  std::ostream& ostr_;
+};
+
+// A chunk of \a n functions, some of which are ill-typed.
+static std::string program(unsigned n)
+{
+  std::ostringstream o;
+  o << "let\n"
+    << "  primitive concat(a : string, b : string) : string\n";
+  for (unsigned i = 0; i < n; ++i)
+    {
+      o << "  function f" << i << "(i : int, s : string) : string =\n    ";
+      switch (i % 4)
+        {
+        case 0:
+          o << "if i > 0 then f" << (i ? i - 1 : i) << "(i - 1, concat(s, \""
+            << i << "\")) else s";
+          break;
+        case 1:
+          o << "let type t" << i << " = {a" << i << " : int, b" << i
+            << " : string} var r" << i << " := t" << i << " {a" << i
+            << " = i, b" << i << " = s} in r" << i << ".b" << i << " end";
+          break;
+        case 2:
+          // A type mismatch in this body.
+          o << "i";
+          break;
+        default:
+          o << "let var v" << i << " : int := i in v" << i << " + 1 end";
+        }
+      o << '\n';
+    }
+  o << "in f0(3, \"x\") end\n";
+  return o.str();
+}
+
+// Type-check \a input with \a jobs threads, and return the errors and
+// the types computed.
+static std::string check(const std::string& input, unsigned jobs)
+{
+  std::unique_ptr<ChunkList> tree(parse::parse_unit(input));
+  assertion(tree);
+  assertion(!bind::bind_compute(*tree));
+
+  std::ostringstream o;
+  o << type::types_check(*tree, jobs);
+  TypeDumper dump(o);
+  dump(*tree);
+  return o.str();
+}
+
+int main()
+{
+  const std::string input = program(64);
+  const std::string sequential = check(input, 1);
+  assertion(sequential.find("type mismatch") != std::string::npos);
+
+  // Several times, to give a race a chance to show.
+  for (unsigned i = 0; i < 10; ++i)
+    {
+      const std::string parallel = check(input, 4);
+      if (parallel != sequential)
+        {
+          std::cerr << "-j 1:\n" << sequential << "-j 4:\n" << parallel;
+          assertion(false);
+        }
+    }
+}
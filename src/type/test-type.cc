@@ -2,6 +2,7 @@
 #include <iostream>
 
 #include <misc/contract.hh>
+#include <type/class.hh>
 #include <type/types.hh>
 
 using namespace type;
@@ -56,4 +57,20 @@ int main()
   ASSERT(!Rec.compatible_with(Int::instance()));
   ASSERT(!Int::instance().compatible_with(Rec));
   */
+
+  // Preorder numbering of the hierarchy A { B { D }, C }.
+  const Class a;
+  const Class b(&a);
+  const Class c(&a);
+  const Class d(&b);
+  a.subclass_add(&b);
+  a.subclass_add(&c);
+  a.subclass_add(&d);
+  b.subclass_add(&d);
+  a.preorder_compute();
+  ASSERT(a.preorder_id_get() == 0 && a.preorder_last_get() == 3);
+  ASSERT(b.preorder_id_get() == 1 && b.preorder_last_get() == 2);
+  ASSERT(d.preorder_id_get() == 2 && c.preorder_id_get() == 3);
+  ASSERT(d.is_a(b) && d.is_a(a) && b.is_a(b));
+  ASSERT(!c.is_a(b) && !a.is_a(b));
 }
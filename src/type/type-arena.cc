@@ -0,0 +1,106 @@
+/**
+ ** \file type/type-arena.cc
+ ** \brief Implementation of type::TypeArena.
+ */
+
+#include <algorithm>
+#include <ostream>
+
+#include <type/type-arena.hh>
+#include <type/type.hh>
+
+namespace type
+{
+  std::ostream& operator<<(std::ostream& ostr, const TypeArenaStats& s)
+  {
+    return ostr << "/* Type arena statistics.  */\n"
+                << "types:     " << s.objects << '\n'
+                << "  named:     " << s.named << '\n'
+                << "  records:   " << s.records << '\n'
+                << "  arrays:    " << s.arrays << '\n'
+                << "  functions: " << s.functions << '\n'
+                << "  classes:   " << s.classes << '\n'
+                << "  methods:   " << s.methods << '\n'
+                << "  nils:      " << s.nils << '\n'
+                << "bytes:     " << s.bytes << '\n'
+                << "blocks:    " << s.blocks << '\n'
+                << "capacity:  " << s.capacity << '\n'
+                << "freed:     " << s.freed << '\n';
+  }
+
+  TypeArena::TypeArena(std::size_t block_size)
+    : block_size_(block_size)
+  {}
+
+  TypeArena::~TypeArena() { clear(); }
+
+  void* TypeArena::allocate(std::size_t size, std::size_t align)
+  {
+    auto space = static_cast<std::size_t>(end_ - next_);
+    void* res = next_;
+    if (!next_ || !std::align(align, size, res, space))
+      {
+        // A new block, large enough for oversized types.
+        std::size_t block = std::max(block_size_, size + align);
+        blocks_.emplace_back(std::make_unique<std::byte[]>(block), block);
+        ++stats_.blocks;
+        stats_.capacity += block;
+        next_ = blocks_.back().first.get();
+        end_ = next_ + block;
+        res = next_;
+        space = block;
+        std::align(align, size, res, space);
+      }
+    next_ = static_cast<std::byte*>(res) + size;
+    return res;
+  }
+
+  void TypeArena::clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Destroy in the reverse order of construction.
+    for (auto i = objects_.rbegin(); i != objects_.rend(); ++i)
+      (*i)->~Type();
+    unsigned freed = stats_.freed + objects_.size();
+    objects_.clear();
+
+    // Keep the first block for the next compilation.
+    if (blocks_.size() > 1)
+      blocks_.resize(1);
+    stats_ = TypeArenaStats();
+    stats_.freed = freed;
+    if (blocks_.empty())
+      next_ = end_ = nullptr;
+    else
+      {
+        stats_.blocks = 1;
+        stats_.capacity = blocks_.front().second;
+        next_ = blocks_.front().first.get();
+        end_ = next_ + blocks_.front().second;
+      }
+  }
+
+  TypeArenaStats TypeArena::stats_get() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  namespace
+  {
+    /// The arena of the current compilation, if one was set.
+    TypeArena* current = nullptr;
+
+  } // namespace
+
+  TypeArena& default_arena()
+  {
+    if (current)
+      return *current;
+    static TypeArena arena;
+    return arena;
+  }
+
+  void default_arena_set(TypeArena* arena) { current = arena; }
+
+} // namespace type
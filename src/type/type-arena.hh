@@ -0,0 +1,114 @@
+/**
+ ** \file type/type-arena.hh
+ ** \brief Declaration of type::TypeArena.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <type/fwd.hh>
+
+namespace type
+{
+  /// Statistics of the allocations of a TypeArena.
+  struct TypeArenaStats
+  {
+    /// \name The live types, by kind.
+    /// \{
+    unsigned named = 0;
+    unsigned records = 0;
+    unsigned arrays = 0;
+    unsigned functions = 0;
+    unsigned classes = 0;
+    unsigned methods = 0;
+    unsigned nils = 0;
+    /// \}
+
+    /// The number of live types.
+    unsigned objects = 0;
+    /// The number of bytes used by the live types.
+    std::size_t bytes = 0;
+    /// The number of blocks.
+    unsigned blocks = 0;
+    /// The number of bytes of the blocks.
+    std::size_t capacity = 0;
+    /// The number of types freed so far.
+    unsigned freed = 0;
+  };
+
+  /// Report \a s on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const TypeArenaStats& s);
+
+  /** \brief Own the types created during a compilation.
+
+      The types are allocated one after the other in large blocks, and
+      are all destroyed at once, when the arena is cleared or destroyed.
+      The types built by the type checker point to one another (a
+      Function to its formals, a Named to its definition...): none of
+      them owns another, the arena owns them all.
+
+      A Function allocated in an arena does not own its formals, which
+      live there too (see Function).
+
+      The bodies of the functions may be checked concurrently, so the
+      allocations are serialized.  */
+  class TypeArena
+  {
+  public:
+    /// Build an empty arena, whose blocks are \a block_size bytes long.
+    explicit TypeArena(std::size_t block_size = 16 * 1024);
+    /// Destroy the types, and free the blocks.
+    ~TypeArena();
+
+    TypeArena(const TypeArena&) = delete;
+    TypeArena& operator=(const TypeArena&) = delete;
+
+    /// Allocate and construct a T from \a args.
+    template <typename T, typename... Args> T* make(Args&&... args);
+
+    /// Destroy all the types, and free the blocks but the first one.
+    ///
+    /// \pre Nothing refers to these types anymore.
+    void clear();
+
+    /// The statistics.
+    TypeArenaStats stats_get() const;
+
+  private:
+    /// Return \a size bytes aligned on \a align, in the current block.
+    void* allocate(std::size_t size, std::size_t align);
+
+    /// Count a new T.
+    template <typename T> void count();
+
+    /// The size of the blocks.
+    std::size_t block_size_;
+    /// The blocks, and their size.
+    std::vector<std::pair<std::unique_ptr<std::byte[]>, std::size_t>> blocks_;
+    /// The free space in the last block.
+    std::byte* next_ = nullptr;
+    std::byte* end_ = nullptr;
+    /// The types, in the order of their construction.
+    std::vector<Type*> objects_;
+    /// The statistics.
+    TypeArenaStats stats_;
+    /// Serialize the allocations.
+    mutable std::mutex mutex_;
+  };
+
+  /// The arena of the current compilation, used when no other is given:
+  /// the one given to default_arena_set, or else one of the process.
+  TypeArena& default_arena();
+
+  /// Make \a arena the one of the current compilation, or go back to
+  /// the one of the process if it is null.
+  void default_arena_set(TypeArena* arena);
+
+} // namespace type
+
+#include <type/type-arena.hxx>
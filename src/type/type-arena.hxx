@@ -0,0 +1,50 @@
+/**
+ ** \file type/type-arena.hxx
+ ** \brief Inline methods of type::TypeArena.
+ */
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <type/function.hh>
+#include <type/type-arena.hh>
+
+namespace type
+{
+  template <typename T, typename... Args> T* TypeArena::make(Args&&... args)
+  {
+    static_assert(std::is_base_of_v<Type, T>, "only types live in the arena");
+    std::lock_guard<std::mutex> lock(mutex_);
+    void* place = allocate(sizeof (T), alignof (T));
+    T* res = new (place) T(std::forward<Args>(args)...);
+    if constexpr (std::is_base_of_v<Function, T>)
+      res->formals_owned_ = false;
+    objects_.emplace_back(res);
+    count<T>();
+    stats_.bytes += sizeof (T);
+    return res;
+  }
+
+  template <typename T> void TypeArena::count()
+  {
+    ++stats_.objects;
+    if constexpr (std::is_same_v<T, Named>)
+      ++stats_.named;
+    else if constexpr (std::is_same_v<T, Record>)
+      ++stats_.records;
+    else if constexpr (std::is_same_v<T, Array>)
+      ++stats_.arrays;
+    else if constexpr (std::is_same_v<T, Function>)
+      ++stats_.functions;
+    else if constexpr (std::is_same_v<T, Class>)
+      ++stats_.classes;
+    else if constexpr (std::is_same_v<T, Method>)
+      ++stats_.methods;
+    else if constexpr (std::is_same_v<T, Nil>)
+      ++stats_.nils;
+  }
+
+} // namespace type
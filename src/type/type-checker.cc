@@ -4,9 +4,12 @@
  */
 
 #include <memory>
+#include <utility>
 
 #include <ast/all.hh>
+#include <ast/libast.hh>
 #include <range/v3/view/iota.hpp>
+#include <type/type-arena.hh>
 #include <type/type-checker.hh>
 #include <type/types.hh>
 
@@ -26,9 +29,15 @@ namespace type
 
   } // namespace
 
-  TypeChecker::TypeChecker()
+  TypeChecker::TypeChecker(unsigned jobs)
+    : TypeChecker(default_arena(), jobs)
+  {}
+
+  TypeChecker::TypeChecker(TypeArena& arena, unsigned jobs)
     : super_type()
     , error_()
+    , arena_(arena)
+    , jobs_(jobs)
   {}
 
   const Type* TypeChecker::type(ast::Typable& e)
@@ -40,7 +49,7 @@ namespace type
 
   const Record* TypeChecker::type(const ast::fields_type& e)
   {
-    auto res = new Record;
+    auto res = arena_.make<Record>();
     for (const auto var : e)
       res->field_add(var->name_get(), *(type(var->type_name_get())));
     return res;
@@ -48,7 +57,7 @@ namespace type
 
   const Record* TypeChecker::type(const ast::VarChunk& e)
   {
-    auto res = new Record;
+    auto res = arena_.make<Record>();
     for (const auto& var : e)
       res->field_add(var->name_get(), *type(*var));
 
@@ -57,6 +66,11 @@ namespace type
 
   const misc::error& TypeChecker::error_get() const { return error_; }
 
+  size_t TypeChecker::errors_count() const
+  {
+    return error_.diagnostics_get().size() + error_.dropped_get();
+  }
+
   /*-----------------.
   | Error handling.  |
   `-----------------*/
@@ -97,6 +111,26 @@ namespace type
     check_types(ast, exp1, *type(type1), exp2, *type(type2));
   }
 
+  void TypeChecker::check_actuals(const ast::Ast& loc,
+                                  const ast::exps_type& actuals,
+                                  const Record& formals)
+  {
+    auto actual = actuals.begin();
+    for (const Field& formal : formals)
+      {
+        if (actual == actuals.end())
+          return error(loc, "missing argument", formal.name_get());
+        check_types(**actual, "formal", formal.type_get(), "actual",
+                    *type(**actual));
+        ++actual;
+      }
+    for (; actual != actuals.end(); ++actual)
+      {
+        type(**actual);
+        error(**actual, "too many arguments");
+      }
+  }
+
   /*--------------------------.
   | The core of the visitor.  |
   `--------------------------*/
@@ -112,20 +146,31 @@ namespace type
 
   void TypeChecker::operator()(ast::FieldVar& e)
   {
-    type_default(e, type(e.var_get()));
+    const Type* var_type = type(e.var_get());
+    auto record =
+      dynamic_cast<const Record*>(var_type ? &var_type->actual() : nullptr);
+    if (!record)
+      return error_and_recover(e, "record expected", e.name_get());
+    const Type* field_type = record->field_type(e.name_get());
+    if (!field_type)
+      return error_and_recover(e, "unknown field", e.name_get());
+    type_default(e, field_type);
   }
 
   void TypeChecker::operator()(ast::SubscriptVar& e)
   {
-    type_default(e, type(e.var_get()));
-    type_default(e, type(e.index_get()));
+    const Type* var_type = type(e.var_get());
+    type(e.index_get());
 
     auto type_exp = e.index_get().type_get();
     auto int_instance = &Int::instance();
     check_types(e, "index type", *type_exp, "expected type", *int_instance);
 
-    if (error_)
-      error(e, "type mismatch in subscript var");
+    auto array =
+      dynamic_cast<const Array*>(var_type ? &var_type->actual() : nullptr);
+    if (!array)
+      return error_and_recover(e, "array expected", e.var_get());
+    type_default(e, &array->type_get());
   }
 
   /*-----------------.
@@ -135,9 +180,9 @@ namespace type
   // Literals.
   void TypeChecker::operator()(ast::NilExp& e)
   {
-    auto nil_ptr = std::make_unique<Nil>();
-    type_default(e, nil_ptr.get());
-    created_type_default(e, nil_ptr.release());
+    auto nil_ptr = arena_.make<Nil>();
+    type_default(e, nil_ptr);
+    created_type_default(e, nil_ptr);
   }
 
   void TypeChecker::operator()(ast::IntExp& e)
@@ -172,6 +217,7 @@ namespace type
     }
 
     auto count = 0;
+    const size_t errors = errors_count();
 
     for (auto &f_rec : e.get_fields())
     {
@@ -194,8 +240,8 @@ namespace type
       count++;
     }
 
-    if (error_)
-      type_default(e, std::make_unique<Nil>().get());
+    if (errors_count() != errors)
+      type_default(e, arena_.make<Nil>());
 
     type_default(e, e.def_get()->type_get());
 
@@ -210,6 +256,7 @@ namespace type
     // check le type pour savoir si c'est des int
     // Ce sera a changer parce qu'on peut avoir des records et des type_dec
     auto oper = e.oper_get();
+    const size_t errors = errors_count();
     type(e.left_get());
     type(e.right_get());
     auto type_left = e.left_get().type_get();
@@ -220,7 +267,7 @@ namespace type
         && dynamic_cast<const Nil*>(type_right))
       {
         error(e, "Can't compare two Nil expressions.");
-        return;
+        return type_default(e, &Int::instance());
       }
 
     if (oper == ast::OpExp::Oper::eq || oper == ast::OpExp::Oper::ne
@@ -256,11 +303,14 @@ namespace type
         type_default(e, int_ptr);
       }
 
-    if (error_)
+    if (errors_count() != errors)
       error(e, "type mismatch");
 
     // If any of the operands are of type Nil, set the `record_type_` to the
     // type of the opposite operand.
+
+    // The comparisons are worth 0 or 1.
+    type_default(e, &Int::instance());
   }
 
   void TypeChecker::operator()(ast::IfExp& e)
@@ -272,38 +322,49 @@ namespace type
     // apres avoir accept, les noeuds ont recup leur types grace au parcours
     // on peut check_types le then et else pour savoir si c'est le meme type
     // si il n'y a pas de else on doit check le then avec un void
-    type(e.get_test());
-    type(e.get_thenclause());
+    check_types(e, "condition type", *type(e.get_test()), "expected type",
+                Int::instance());
+    const Type* then_type = type(e.get_thenclause());
     if (&e.get_elseclause())
       {
-        type(e.get_elseclause());
-        check_types(e, "then clause type", *e.get_thenclause().type_get(),
-                    "else clause type", *e.get_elseclause().type_get());
+        const Type* else_type = type(e.get_elseclause());
+        // With a nil branch, the type of the other one is the type of E.
+        if (to_nil(*then_type))
+          {
+            check_types(e, "else clause type", *else_type,
+                        "then clause type", *then_type);
+            then_type = else_type;
+          }
+        else
+          check_types(e, "then clause type", *then_type,
+                      "else clause type", *else_type);
       }
     else
       {
         auto void_ptr = &Void::instance();
-        check_types(e, "then clause type", *e.get_thenclause().type_get(),
+        check_types(e, "then clause type", *then_type,
                     "else clause type", *void_ptr);
       }
-    type_default(e, e.get_thenclause().type_get());
+    type_default(e, then_type);
   }
   void TypeChecker::operator()(ast::ForExp& e)
   {
     type(e.vardec_get());
+    var_read_only_.insert(&e.vardec_get());
     if (dynamic_cast<const Int*>(e.vardec_get().type_get()))
       {
         auto int_ptr = &Int::instance();
+        const size_t errors = errors_count();
         check_types(e, "index type", *e.vardec_get().type_get(),
                     "expected type", *int_ptr);
 
         type(e.hi_get());
         check_types(e, "high bound", *e.hi_get().type_get(), "expected",
                     *int_ptr);
-        if (error_)
+        if (errors_count() != errors)
           {
             error(e, "type mismatch");
-            return;
+            return type_default(e, &Void::instance());
           }
       }
     auto int_ptr = &Int::instance();
@@ -347,44 +408,27 @@ namespace type
 
   void TypeChecker::operator()(ast::CallExp& e)
   {
-    // INFORMATION
-    // recuperer le type de la fonction de deifnition
-    // accept la liste d'arguments
-    type_default(e, type(*(e.def_get())));
-    auto exps = e.args_get();
-    for (auto exp : exps)
-      exp->accept(*this);
+    // The headers of the chunk of the callee are already checked.
+    auto fun = dynamic_cast<const Function*>(e.def_get()->type_get());
+    assertion(fun);
+    check_actuals(e, e.args_get(), fun->formals_get());
+    type_default(e, &fun->result_get());
   }
 
   void TypeChecker::operator()(ast::LetExp& e)
   {
-    // INFORMATION
-    // visit la chunklist
-    // visit les expressions qu'il y a dans 'in'
-    // check si le in est bien un void puisque un letExp doit rien return
-    //type(e.chunklist_get());
+    // A let is worth its body.
     e.chunklist_get().accept(*this);
-    type(e.exp_get());
-
-    auto void_ptr = &Void::instance();
-
-    check_types(e, "in type", *e.exp_get().type_get(), "expected type",
-                *void_ptr);
-    type_default(e, void_ptr);
+    type_default(e, type(e.exp_get()));
   }
 
   void TypeChecker::operator()(ast::SeqExp& e)
   {
-    // INFORMATION
-    // visit les expressions
-    // le type default est void je crois mais info a verifier
-    auto exps = e.exps_get();
-    for (auto exp : exps)
-      {
-        exp->accept(*this);
-      }
-    auto void_ptr = &Void::instance();
-    type_default(e, void_ptr);
+    // A sequence is worth its last expression, `()' is void.
+    const Type* last = &Void::instance();
+    for (ast::Exp* exp : e.exps_get())
+      last = type(*exp);
+    type_default(e, last);
   }
 
   void TypeChecker::operator()(ast::AssignExp& e)
@@ -397,9 +441,13 @@ namespace type
     type(e.var_get());
     type(e.exp_get());
 
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e.var_get());
+        var && var_read_only_.has(var->def_get()))
+      error(e, "variable is read only", var->name_get());
+
     check_types(e, "left operand type", *e.var_get().type_get(),
                 "right operand type", *e.exp_get().type_get());
-    type_default(e, e.var_get().type_get());
+    type_default(e, &Void::instance());
   }
 
   void TypeChecker::operator()(ast::ArrayExp& e)
@@ -464,7 +512,49 @@ namespace type
 
   void TypeChecker::operator()(ast::FunctionChunk& e)
   {
-    chunk_visit<ast::FunctionDec>(e);
+    if (jobs_ <= 1 || e.decs_get().size() < 2)
+      return chunk_visit<ast::FunctionDec>(e);
+
+    for (ast::FunctionDec* f : e)
+      visit_dec_header(*f);
+    bodies_visit_parallel(e);
+  }
+
+  void TypeChecker::bodies_visit_parallel(ast::FunctionChunk& e)
+  {
+    if (!pool_)
+      pool_ = std::make_shared<misc::thread_pool>(jobs_);
+
+    // One checker per body, so that they do not share errors.
+    std::vector<std::unique_ptr<TypeChecker>> checkers;
+    checkers.reserve(e.decs_get().size());
+    for (size_t i = 0; i < e.decs_get().size(); ++i)
+      {
+        auto checker = std::make_unique<TypeChecker>(arena_, jobs_);
+        checker->pool_ = pool_;
+        checker->var_read_only_ = var_read_only_;
+        checkers.emplace_back(std::move(checker));
+      }
+
+    pool_->parallel_for(e.decs_get().size(), [&e, &checkers](size_t i) {
+      try
+        {
+          checkers[i]->visit_dec_body(*e[i]);
+        }
+      catch (const misc::error&)
+        {
+          // The body reached --max-errors.  Its handler still holds
+          // its diagnostics, and the limit is enforced below.
+        }
+    });
+
+    // Merge the diagnostics in source order.
+    for (const auto& checker : checkers)
+      error_ << std::move(checker->error_);
+    // The limit is on all the diagnostics, not on those of each body:
+    // stop as a sequential check would have, with the merged handler.
+    if (error_.dropped_get())
+      error_.exit();
   }
 
   void TypeChecker::operator()(ast::FunctionDec& e)
@@ -483,11 +573,11 @@ namespace type
     if (e.result_get())
       {
         auto res = type(*e.result_get());
-        fun = new Function(form_ty, *res);
+        fun = arena_.make<Function>(form_ty, *res);
       }
     else
       {
-        fun = new Function(form_ty, Void::instance());
+        fun = arena_.make<Function>(form_ty, Void::instance());
       }
     type_default(e, fun);
     // INFORMATION
@@ -531,12 +621,18 @@ namespace type
       unreachable();
 
     if (!type_name)
-      type_default(e, type(*(init)));
+      {
+        // Without a type name, nothing tells which record `nil' is.
+        if (to_nil(*type(*init)))
+          error(*init, "nil expression not constrained by a record type");
+        type_default(e, type(*(init)));
+      }
     else
       {
+        const size_t errors = errors_count();
         if (init)
           check_types(e, "type name", *type_name, "init type", *init);
-        if (!error_)
+        if (errors_count() == errors)
           type_default(e, type(*(type_name)));
         else
           error(e, "type mismatch");
@@ -565,7 +661,7 @@ namespace type
     // name in E.  A declaration has no type in itself; here we store
     // the type declared by E.
 
-    auto named = new Named(e.name_get());
+    auto named = arena_.make<Named>(e.name_get());
     e.create_type_set(named);
     e.type_set(e.created_type_get());
   }
@@ -584,11 +680,12 @@ namespace type
 
   template <class D> void TypeChecker::chunk_visit(ast::Chunk<D>& e)
   {
+    // All the headers first, so that the bodies may refer to any
+    // declaration of the chunk (mutual recursion).
     for (const auto& dec : e)
-      {
-        visit_dec_header(*dec);
-        visit_dec_body(*dec);
-      }
+      visit_dec_header(*dec);
+    for (const auto& dec : e)
+      visit_dec_body(*dec);
   }
 
   /*-------------.
@@ -629,7 +726,7 @@ namespace type
 
   void TypeChecker::operator()(ast::ArrayTy& e)
   {
-    auto array_type = new Array(*e.base_type_get().type_get());
+    auto array_type = arena_.make<Array>(*type(e.base_type_get()));
     type_default(e, array_type);
   }
 
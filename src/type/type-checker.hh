@@ -6,12 +6,14 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 #include <string>
 
 #include <ast/default-visitor.hh>
 #include <ast/non-object-visitor.hh>
 #include <misc/error.hh>
 #include <misc/set.hh>
+#include <misc/thread-pool.hh>
 #include <type/fwd.hh>
 
 namespace type
@@ -25,7 +27,12 @@ namespace type
     using super_type::operator();
 
     /// Construction.
-    TypeChecker();
+    ///
+    /// \param jobs  number of threads checking the bodies of the
+    ///              functions of a chunk; 1 means sequential.
+    explicit TypeChecker(unsigned jobs = 1);
+    /// Construction, allocating the types in \a arena.
+    explicit TypeChecker(TypeArena& arena, unsigned jobs = 1);
     /// The error handler.
     const misc::error& error_get() const;
 
@@ -78,6 +85,13 @@ namespace type
                        const Type& type1,
                        const std::string& exp2,
                        const Type& type2);
+
+    /// The number of errors reported so far.
+    ///
+    /// Compare it before and after some checks to know whether they
+    /// failed: the bodies of a chunk may be checked by several
+    /// checkers, so error_ itself says nothing about the current node.
+    size_t errors_count() const;
     /// \}
 
     /// \name Checking types.
@@ -116,6 +130,12 @@ namespace type
                      ast::Typable& type1,
                      const std::string& exp2,
                      ast::Typable& type2);
+
+    /// Check the actual arguments \a actuals of a call \a loc against
+    /// the \a formals of the routine.
+    void check_actuals(const ast::Ast& loc,
+                       const ast::exps_type& actuals,
+                       const Record& formals);
     /// \}
 
   protected:
@@ -213,6 +233,15 @@ namespace type
     template <typename Routine_Type, typename Routine_Node>
     void visit_routine_body(Routine_Node& e);
 
+    /// \brief Check the bodies of a chunk of functions concurrently.
+    ///
+    /// Once the headers of the chunk are typed, the bodies only read
+    /// shared type information and annotate their own subtree.  Each
+    /// body is therefore checked by its own TypeChecker, on the pool,
+    /// and the errors are merged back in source order.  The limit of
+    /// misc::error::max_errors applies to the merged diagnostics.
+    void bodies_visit_parallel(ast::FunctionChunk& e);
+
     /// Visit a chunk of function declarations.
     void operator()(ast::FunctionChunk& e) override;
     /// No longer used.
@@ -240,6 +269,12 @@ namespace type
     misc::error error_;
     /// Set of for index variable definitions, which are read only.
     misc::set<const ast::VarDec*> var_read_only_;
+    /// The owner of the created types.
+    TypeArena& arena_;
+    /// Number of threads allowed to check function bodies.
+    unsigned jobs_;
+    /// The workers, shared with the checkers of nested chunks.
+    std::shared_ptr<misc::thread_pool> pool_;
   };
 
   /// Visit the lhs of an ast::FunctionDec.
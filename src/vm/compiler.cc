@@ -0,0 +1,460 @@
+/**
+ ** \file vm/compiler.cc
+ ** \brief Implementation of vm::Compiler.
+ */
+
+#include <algorithm>
+#include <string>
+
+#include <ast/all.hh>
+#include <misc/contract.hh>
+#include <misc/escape.hh>
+#include <vm/compiler.hh>
+
+namespace vm
+{
+  namespace
+  {
+    /// Whether evaluating \a e cannot change a variable.
+    bool leaf_p(const ast::Exp& e)
+    {
+      return dynamic_cast<const ast::IntExp*>(&e)
+        || dynamic_cast<const ast::StringExp*>(&e)
+        || dynamic_cast<const ast::NilExp*>(&e)
+        || dynamic_cast<const ast::SimpleVar*>(&e);
+    }
+
+    /// The opcode of the binary operator \a oper.
+    opcode opcode_get(ast::OpExp::Oper oper)
+    {
+      using Oper = ast::OpExp::Oper;
+      switch (oper)
+        {
+        case Oper::add:
+          return opcode::add;
+        case Oper::sub:
+          return opcode::sub;
+        case Oper::mul:
+          return opcode::mul;
+        case Oper::div:
+          return opcode::div;
+        case Oper::eq:
+          return opcode::eq;
+        case Oper::ne:
+          return opcode::ne;
+        case Oper::lt:
+          return opcode::lt;
+        case Oper::le:
+          return opcode::le;
+        case Oper::gt:
+          return opcode::gt;
+        case Oper::ge:
+          return opcode::ge;
+        default:
+          unreachable();
+        }
+    }
+
+  } // namespace
+
+  Compiler::Compiler(program& prog)
+    : program_(prog)
+  {}
+
+  void Compiler::operator()(const ast::ChunkList& e)
+  {
+    layout_ = interpret::layout_compute(e);
+    for (const layout::function& fun : layout_.functions)
+      {
+        if (fun.dec->name_get() == "_main")
+          program_.main = program_.functions.size();
+        code& c = program_.functions.emplace_back();
+        c.name = fun.dec->name_get();
+        c.parent = fun.parent;
+        c.arity = fun.dec->formals_get().decs_get().size();
+        c.escaping = fun.escaping.size();
+        c.depth = fun.depth;
+      }
+    for (unsigned i = 0; i < layout_.functions.size(); ++i)
+      compile(*layout_.functions[i].dec, i);
+  }
+
+  void Compiler::compile(const ast::FunctionDec& fun, int index)
+  {
+    code_ = &program_.functions[index];
+    current_ = index;
+    next_ = code_->arity;
+    code_->registers = std::max<unsigned>(code_->registers, next_);
+
+    // The arguments come in the first registers: move the escaping ones
+    // to the frame.
+    int arg = 0;
+    for (const ast::VarDec* formal : fun.formals_get())
+      {
+        const layout::slot& s = layout_.slots.at(formal);
+        if (s.escapes)
+          emit(opcode::store, arg, 0, s.index);
+        else
+          registers_[formal] = arg;
+        ++arg;
+      }
+
+    int res = temp();
+    compile(*fun.body_get(), res);
+    emit(opcode::ret, res);
+    code_ = nullptr;
+  }
+
+  /*------------.
+  | Emission.   |
+  `------------*/
+
+  unsigned Compiler::emit(opcode op, int a, int b, int c)
+  {
+    code_->instructions.push_back(instruction{op, a, b, c});
+    return code_->instructions.size() - 1;
+  }
+
+  void Compiler::patch(unsigned pc)
+  {
+    instruction& jump = code_->instructions[pc];
+    (jump.op == opcode::jump ? jump.a : jump.b) =
+      code_->instructions.size();
+  }
+
+  int Compiler::temp()
+  {
+    int res = next_++;
+    code_->registers = std::max<unsigned>(code_->registers, next_);
+    return res;
+  }
+
+  void Compiler::compile(const ast::Exp& e, int dst)
+  {
+    int outer = dst_;
+    dst_ = dst;
+    e.accept(*this);
+    dst_ = outer;
+  }
+
+  void Compiler::discard(const ast::Exp& e)
+  {
+    int mark = next_;
+    compile(e, temp());
+    next_ = mark;
+  }
+
+  int Compiler::operand(const ast::Exp& e, bool direct)
+  {
+    int res = direct ? register_get(e) : -1;
+    if (res == -1)
+      {
+        res = temp();
+        compile(e, res);
+      }
+    return res;
+  }
+
+  int Compiler::register_get(const ast::Exp& e) const
+  {
+    if (auto var = dynamic_cast<const ast::SimpleVar*>(&e))
+      {
+        if (!layout_.slots.at(var->def_get()).escapes)
+          return registers_.at(var->def_get());
+      }
+    return -1;
+  }
+
+  int Compiler::hops(const layout::slot& s) const
+  {
+    return code_->depth - program_.functions[s.function].depth;
+  }
+
+  int Compiler::integer(int i)
+  {
+    auto [it, inserted] = integers_.try_emplace(i, program_.integers.size());
+    if (inserted)
+      program_.integers.emplace_back(i);
+    return it->second;
+  }
+
+  /*-------------------.
+  | Visiting methods.  |
+  `-------------------*/
+
+  void Compiler::operator()(const ast::ArrayExp& e)
+  {
+    int mark = next_;
+    int size = operand(e.size_get(), leaf_p(e.init_get()));
+    int init = operand(e.init_get());
+    emit(opcode::array, dst_, size, init);
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::AssignExp& e)
+  {
+    int mark = next_;
+    const ast::Var& var = e.var_get();
+    if (auto simple = dynamic_cast<const ast::SimpleVar*>(&var))
+      {
+        const layout::slot& s = layout_.slots.at(simple->def_get());
+        if (s.escapes)
+          emit(opcode::store, operand(e.exp_get()), hops(s), s.index);
+        else
+          compile(e.exp_get(), registers_.at(simple->def_get()));
+      }
+    else if (auto field = dynamic_cast<const ast::FieldVar*>(&var))
+      {
+        int record = operand(field->var_get(), leaf_p(e.exp_get()));
+        int value = operand(e.exp_get());
+        emit(opcode::set_field, record, layout_.fields.at(field), value);
+      }
+    else
+      {
+        auto& subscript = dynamic_cast<const ast::SubscriptVar&>(var);
+        bool leaves = leaf_p(subscript.index_get()) && leaf_p(e.exp_get());
+        int array = operand(subscript.var_get(), leaves);
+        int index = operand(subscript.index_get(), leaf_p(e.exp_get()));
+        int value = operand(e.exp_get());
+        emit(opcode::set_element, array, index, value);
+      }
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::BreakExp&)
+  {
+    precondition(!breaks_.empty());
+    breaks_.back().emplace_back(emit(opcode::jump));
+  }
+
+  void Compiler::operator()(const ast::CallExp& e)
+  {
+    int mark = next_;
+    // The arguments go to consecutive registers.
+    int first = next_;
+    for (unsigned i = 0; i < e.args_get().size(); ++i)
+      temp();
+    int arg = first;
+    for (const ast::Exp* exp : e.args_get())
+      compile(*exp, arg++);
+
+    const ast::FunctionDec* fun = e.def_get();
+    if (auto i = layout_.indices.find(fun); i != layout_.indices.end())
+      emit(opcode::call, dst_, i->second, first);
+    else
+      {
+        auto prim = layout_.primitives.find(fun);
+        precondition(prim != layout_.primitives.end());
+        emit(opcode::primitive, dst_, static_cast<int>(prim->second), first);
+      }
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::CastExp& e)
+  {
+    compile(e.exp_get(), dst_);
+  }
+
+  void Compiler::operator()(const ast::FieldVar& e)
+  {
+    int mark = next_;
+    int record = operand(e.var_get());
+    emit(opcode::field, dst_, record, layout_.fields.at(&e));
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::ForExp& e)
+  {
+    /* Compile
+
+         for i := lo to hi do body
+
+       as
+
+             i := lo
+             _hi := hi
+             if i > _hi goto end
+         loop:
+             body
+             if i = _hi goto end
+             i := i + 1
+             goto loop
+         end:
+
+       so that i does not overflow when hi is the largest integer.  */
+    int mark = next_;
+    const ast::VarDec& var = e.vardec_get();
+    const layout::slot& s = layout_.slots.at(&var);
+    int index = temp();
+    if (!s.escapes)
+      registers_[&var] = index;
+    compile(*var.init_get(), index);
+    int hi = operand(e.hi_get(), false);
+    int test = temp();
+    int one = temp();
+    emit(opcode::integer, one, integer(1));
+    emit(opcode::gt, test, index, hi);
+    unsigned enter = emit(opcode::jump_if, test);
+
+    breaks_.emplace_back();
+    unsigned loop = code_->instructions.size();
+    if (s.escapes)
+      emit(opcode::store, index, 0, s.index);
+    discard(e.body_get());
+    emit(opcode::eq, test, index, hi);
+    unsigned leave = emit(opcode::jump_if, test);
+    emit(opcode::add, index, index, one);
+    emit(opcode::jump, loop);
+
+    patch(enter);
+    patch(leave);
+    for (unsigned jump : breaks_.back())
+      patch(jump);
+    breaks_.pop_back();
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::FunctionChunk&)
+  {
+    // The functions are compiled on their own.
+  }
+
+  void Compiler::operator()(const ast::IfExp& e)
+  {
+    int mark = next_;
+    int test = operand(e.get_test());
+    next_ = mark;
+    unsigned skip = emit(opcode::jump_unless, test);
+    compile(e.get_thenclause(), dst_);
+    if (&e.get_elseclause())
+      {
+        unsigned end = emit(opcode::jump);
+        patch(skip);
+        compile(e.get_elseclause(), dst_);
+        patch(end);
+      }
+    else
+      patch(skip);
+  }
+
+  void Compiler::operator()(const ast::IntExp& e)
+  {
+    emit(opcode::integer, dst_, integer(e.value_get()));
+  }
+
+  void Compiler::operator()(const ast::LetExp& e)
+  {
+    // The registers of the variables are free after the `let'.
+    int mark = next_;
+    // Not operator()(const ast::ChunkList&), which compiles a program.
+    super_type::operator()(e.chunklist_get());
+    compile(e.exp_get(), dst_);
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::NilExp&) { emit(opcode::nil, dst_); }
+
+  void Compiler::operator()(const ast::OpExp& e)
+  {
+    int mark = next_;
+    int left = operand(e.left_get(), leaf_p(e.right_get()));
+    int right = operand(e.right_get());
+    emit(opcode_get(e.oper_get()), dst_, left, right);
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::RecordExp& e)
+  {
+    int mark = next_;
+    // The fields go to consecutive registers.
+    int first = next_;
+    for (unsigned i = 0; i < e.get_fields().size(); ++i)
+      temp();
+    int field = first;
+    for (const ast::FieldInit* init : e.get_fields())
+      compile(init->init_get(), field++);
+    emit(opcode::record, dst_, e.get_fields().size(), first);
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::SeqExp& e)
+  {
+    const ast::exps_type& exps = e.exps_get();
+    for (unsigned i = 0; i < exps.size(); ++i)
+      if (i + 1 < exps.size())
+        discard(*exps[i]);
+      else
+        compile(*exps[i], dst_);
+  }
+
+  void Compiler::operator()(const ast::SimpleVar& e)
+  {
+    const layout::slot& s = layout_.slots.at(e.def_get());
+    if (s.escapes)
+      emit(opcode::load, dst_, hops(s), s.index);
+    else if (int reg = registers_.at(e.def_get()); reg != dst_)
+      emit(opcode::move, dst_, reg);
+  }
+
+  void Compiler::operator()(const ast::StringExp& e)
+  {
+    std::string str = misc::unescape(e.string_get());
+    auto [i, inserted] = strings_.try_emplace(str, program_.strings.size());
+    if (inserted)
+      program_.strings.emplace_back(string_type::intern(str));
+    emit(opcode::string, dst_, i->second);
+  }
+
+  void Compiler::operator()(const ast::SubscriptVar& e)
+  {
+    int mark = next_;
+    int array = operand(e.var_get(), leaf_p(e.index_get()));
+    int index = operand(e.index_get());
+    emit(opcode::element, dst_, array, index);
+    next_ = mark;
+  }
+
+  void Compiler::operator()(const ast::TypeChunk&)
+  {
+    // Declaring types produces no code.
+  }
+
+  void Compiler::operator()(const ast::VarChunk& e)
+  {
+    for (const ast::VarDec* var : e)
+      {
+        const layout::slot& s = layout_.slots.at(var);
+        if (s.escapes)
+          {
+            int mark = next_;
+            emit(opcode::store, operand(*var->init_get()), 0, s.index);
+            next_ = mark;
+          }
+        else
+          {
+            // Stays allocated until the end of the `let'.
+            int reg = temp();
+            registers_[var] = reg;
+            compile(*var->init_get(), reg);
+          }
+      }
+  }
+
+  void Compiler::operator()(const ast::WhileExp& e)
+  {
+    breaks_.emplace_back();
+    unsigned loop = code_->instructions.size();
+    int mark = next_;
+    int test = operand(e.test_get());
+    next_ = mark;
+    unsigned leave = emit(opcode::jump_unless, test);
+    discard(e.body_get());
+    emit(opcode::jump, loop);
+
+    patch(leave);
+    for (unsigned jump : breaks_.back())
+      patch(jump);
+    breaks_.pop_back();
+  }
+
+} // namespace vm
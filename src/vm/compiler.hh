@@ -0,0 +1,121 @@
+/**
+ ** \file vm/compiler.hh
+ ** \brief Compile an AST into bytecode.
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ast/default-visitor.hh>
+#include <ast/non-object-visitor.hh>
+#include <interpret/layout.hh>
+#include <vm/program.hh>
+
+namespace vm
+{
+  /** \brief Compile a program into the bytecode of the virtual machine.
+
+      Each function with a body is compiled into its own sequence of
+      instructions.  Its formals come in its first registers, and its
+      non escaping variables and temporaries in the following ones; the
+      registers of a `let' are reused once it is left.  Its escaping
+      variables live in its frame (see interpret::layout).
+
+      The desugared AST is expected, but the `for' loops are compiled
+      too, and the comparisons apply to any operands.  */
+  class Compiler
+    : public ast::DefaultConstVisitor
+    , public ast::NonObjectConstVisitor
+  {
+  public:
+    /// Super class type.
+    using super_type = ast::DefaultConstVisitor;
+    /// Import all the overloaded visit methods.
+    using super_type::operator();
+
+    /// Compile into \a prog.
+    explicit Compiler(program& prog);
+
+    /// Compile the program \a e, whose bindings, types and escapes are
+    /// computed.
+    void operator()(const ast::ChunkList& e) override;
+
+    /// \name Visit methods.
+    /// \{
+    void operator()(const ast::ArrayExp& e) override;
+    void operator()(const ast::AssignExp& e) override;
+    void operator()(const ast::BreakExp& e) override;
+    void operator()(const ast::CallExp& e) override;
+    void operator()(const ast::CastExp& e) override;
+    void operator()(const ast::FieldVar& e) override;
+    void operator()(const ast::ForExp& e) override;
+    void operator()(const ast::FunctionChunk& e) override;
+    void operator()(const ast::IfExp& e) override;
+    void operator()(const ast::IntExp& e) override;
+    void operator()(const ast::LetExp& e) override;
+    void operator()(const ast::NilExp& e) override;
+    void operator()(const ast::OpExp& e) override;
+    void operator()(const ast::RecordExp& e) override;
+    void operator()(const ast::SeqExp& e) override;
+    void operator()(const ast::SimpleVar& e) override;
+    void operator()(const ast::StringExp& e) override;
+    void operator()(const ast::SubscriptVar& e) override;
+    void operator()(const ast::TypeChunk& e) override;
+    void operator()(const ast::VarChunk& e) override;
+    void operator()(const ast::WhileExp& e) override;
+    /// \}
+
+  private:
+    using layout = interpret::layout;
+
+    /// Compile the body of the function \a fun.
+    void compile(const ast::FunctionDec& fun, int index);
+
+    /// Append an instruction, and return its index.
+    unsigned emit(opcode op, int a = 0, int b = 0, int c = 0);
+    /// Make the jump at \a pc go to the next instruction.
+    void patch(unsigned pc);
+    /// A fresh register.
+    int temp();
+
+    /// Compile \a e so that its value goes to the register \a dst.
+    void compile(const ast::Exp& e, int dst);
+    /// Compile \a e, whose value is not used.
+    void discard(const ast::Exp& e);
+    /// The register holding the value of \a e: the register of a non
+    /// escaping variable if \a direct, otherwise a fresh one.
+    int operand(const ast::Exp& e, bool direct = true);
+    /// The register of \a e if it is a non escaping variable, or -1.
+    int register_get(const ast::Exp& e) const;
+    /// The number of static links from the current function to the
+    /// frame of the variable \a s.
+    int hops(const layout::slot& s) const;
+
+    /// The index of \a i in the integer pool.
+    int integer(int i);
+
+    /// The program.
+    program& program_;
+    /// Its functions, variables and fields.
+    layout layout_;
+    /// The registers of the non escaping variables.
+    std::unordered_map<const ast::VarDec*, int> registers_;
+    /// The pools of constants.
+    std::unordered_map<int, int> integers_;
+    std::unordered_map<std::string, int> strings_;
+
+    /// The function being compiled, and its index.
+    code* code_ = nullptr;
+    int current_ = -1;
+    /// The next free register.
+    int next_ = 0;
+    /// The register receiving the value of the visited expression.
+    int dst_ = 0;
+    /// The jumps of the `break's of the enclosing loops.
+    std::vector<std::vector<unsigned>> breaks_;
+  };
+
+} // namespace vm
@@ -0,0 +1,27 @@
+/**
+ ** \file vm/instruction.cc
+ ** \brief Implementation of the instructions of the virtual machine.
+ */
+
+#include <ostream>
+
+#include <vm/instruction.hh>
+
+namespace vm
+{
+  const char* name_get(opcode op)
+  {
+    static const char* const names[] = {
+#define VM_OPCODE(Name) #Name,
+      VM_OPCODES(VM_OPCODE)
+#undef VM_OPCODE
+    };
+    return names[static_cast<unsigned>(op)];
+  }
+
+  std::ostream& operator<<(std::ostream& ostr, opcode op)
+  {
+    return ostr << name_get(op);
+  }
+
+} // namespace vm
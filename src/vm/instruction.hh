@@ -0,0 +1,104 @@
+/**
+ ** \file vm/instruction.hh
+ ** \brief The instructions of the virtual machine.
+ */
+
+#pragma once
+
+#include <iosfwd>
+
+#include <interpret/runtime.hh>
+
+namespace vm
+{
+  using interpret::primitive;
+
+  /** \brief The opcodes, with the meaning of their operands.
+
+      The machine has registers: `rN' is the register N of the current
+      activation.  The non escaping variables live in registers, the
+      escaping ones in the frame of their function, `hops' static links
+      away from the frame of the current function.  Targets of jumps
+      are indices in the instructions of the function.  */
+#define VM_OPCODES(X)                                                   \
+  /* ra := rb.  */                                                      \
+  X(move)                                                               \
+  /* ra := the integer b of the pool.  */                               \
+  X(integer)                                                            \
+  /* ra := the string b of the pool.  */                                \
+  X(string)                                                             \
+  /* ra := nil.  */                                                     \
+  X(nil)                                                                \
+  /* ra := rb op rc, on integers.  */                                   \
+  X(add)                                                                \
+  X(sub)                                                                \
+  X(mul)                                                                \
+  X(div)                                                                \
+  /* ra := rb cmp rc, on integers, strings, or the addresses of         \
+     records and arrays.  */                                            \
+  X(eq)                                                                 \
+  X(ne)                                                                 \
+  X(lt)                                                                 \
+  X(le)                                                                 \
+  X(gt)                                                                 \
+  X(ge)                                                                 \
+  /* Go to a.  */                                                       \
+  X(jump)                                                               \
+  /* Go to b if ra is not 0.  */                                        \
+  X(jump_if)                                                            \
+  /* Go to b if ra is 0.  */                                            \
+  X(jump_unless)                                                        \
+  /* ra := the variable c of the frame b hops away.  */                 \
+  X(load)                                                               \
+  /* The variable c of the frame b hops away := ra.  */                 \
+  X(store)                                                              \
+  /* ra := an array of rb elements rc.  */                              \
+  X(array)                                                              \
+  /* ra := a record of b fields, which are rc...  */                   \
+  X(record)                                                             \
+  /* ra := the field c of the record rb.  */                            \
+  X(field)                                                              \
+  /* The field b of the record ra := rc.  */                            \
+  X(set_field)                                                          \
+  /* ra := rb[rc].  */                                                  \
+  X(element)                                                            \
+  /* ra[rb] := rc.  */                                                  \
+  X(set_element)                                                        \
+  /* ra := the function b applied to rc...  */                          \
+  X(call)                                                               \
+  /* ra := the primitive b applied to rc...  */                         \
+  X(primitive)                                                          \
+  /* Return ra.  */                                                     \
+  X(ret)
+
+  /// An opcode.
+  enum class opcode : unsigned char
+  {
+#define VM_OPCODE(Name) Name,
+    VM_OPCODES(VM_OPCODE)
+#undef VM_OPCODE
+  };
+
+  /// The number of opcodes.
+  constexpr unsigned opcodes =
+#define VM_OPCODE(Name) +1
+    VM_OPCODES(VM_OPCODE)
+#undef VM_OPCODE
+    ;
+
+  /// The name of \a op.
+  const char* name_get(opcode op);
+
+  /// Report \a op on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, opcode op);
+
+  /// An instruction: an opcode, and up to three operands.
+  struct instruction
+  {
+    opcode op;
+    int a = 0;
+    int b = 0;
+    int c = 0;
+  };
+
+} // namespace vm
@@ -0,0 +1,27 @@
+/**
+ ** \file vm/libvm.cc
+ ** \brief Define exported vm functions.
+ */
+
+#include <ast/chunk-list.hh>
+#include <vm/compiler.hh>
+#include <vm/libvm.hh>
+
+namespace vm
+{
+  std::unique_ptr<program> compile(const ast::ChunkList& tree)
+  {
+    auto res = std::make_unique<program>();
+    Compiler compile(*res);
+    compile(tree);
+    return res;
+  }
+
+  int run(const program& prog, std::istream& in, std::ostream& out,
+          std::ostream& err, profile* prof)
+  {
+    Machine machine(prog, in, out, err, prof);
+    return machine.run();
+  }
+
+} // namespace vm
@@ -0,0 +1,38 @@
+/**
+ ** \file vm/libvm.hh
+ ** \brief Declare functions and variables exported by vm module.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+
+#include <ast/fwd.hh>
+#include <vm/machine.hh>
+#include <vm/program.hh>
+
+/// Compiling a program into bytecode, and running it.
+namespace vm
+{
+  /** \brief Compile the program \a tree into bytecode.
+
+      \param tree  the program, whose bindings, types and escapes have
+                   been computed.  */
+  std::unique_ptr<program> compile(const ast::ChunkList& tree);
+
+  /** \brief Run the bytecode \a prog.
+
+      \param prog  the program.
+      \param in    the standard input of the program.
+      \param out   the standard output of the program.
+      \param err   the standard error output of the program.
+      \param prof  where to count the instructions and the calls, if
+                   not null.
+
+      \return the exit status of the program: the argument of `exit',
+              120 on a runtime error, and 0 otherwise.  */
+  int run(const program& prog, std::istream& in, std::ostream& out,
+          std::ostream& err, profile* prof = nullptr);
+
+} // namespace vm
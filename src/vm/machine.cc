@@ -0,0 +1,351 @@
+/**
+ ** \file vm/machine.cc
+ ** \brief Implementation of vm::Machine.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+
+#include <misc/contract.hh>
+#include <vm/machine.hh>
+
+#if defined __GNUC__
+# define VM_THREADED 1
+#else
+# define VM_THREADED 0
+#endif
+
+namespace vm
+{
+  using interpret::failure;
+  using interpret::order;
+
+  namespace
+  {
+    /// The object \a v, which must not be nil.
+    object& deref(const value& v, const char* what)
+    {
+      object* res = std::get<object*>(v);
+      if (!res)
+        throw failure{std::string("nil ") + what + " dereference"};
+      return *res;
+    }
+
+    /// The element \a index of \a array.
+    value& element_get(const value& array, const value& index)
+    {
+      object& a = deref(array, "array");
+      int i = std::get<int>(index);
+      if (i < 0 || static_cast<unsigned>(i) >= a.slots.size())
+        throw failure{"index out of bounds"};
+      return a.slots[i];
+    }
+
+    /// The field \a index of \a record.
+    value& field_get(const value& record, int index)
+    {
+      return deref(record, "record").slots[index];
+    }
+
+  } // namespace
+
+  std::ostream& operator<<(std::ostream& ostr, const profile& p)
+  {
+    unsigned long total =
+      std::accumulate(p.instructions.begin(), p.instructions.end(), 0UL);
+    ostr << "/* VM profile.  */\n"
+         << "instructions: " << total << '\n';
+    std::vector<unsigned> ops(opcodes);
+    std::iota(ops.begin(), ops.end(), 0);
+    std::stable_sort(ops.begin(), ops.end(), [&p](unsigned l, unsigned r) {
+      return p.instructions[l] > p.instructions[r];
+    });
+    for (unsigned op : ops)
+      if (p.instructions[op])
+        ostr << "  " << std::left << std::setw(12)
+             << name_get(static_cast<opcode>(op)) << std::right << ' '
+             << p.instructions[op] << '\n';
+
+    ostr << "calls:        "
+         << std::accumulate(p.calls.begin(), p.calls.end(), 0UL) << '\n';
+    std::vector<unsigned> funs(p.calls.size());
+    std::iota(funs.begin(), funs.end(), 0);
+    std::stable_sort(funs.begin(), funs.end(), [&p](unsigned l, unsigned r) {
+      return p.calls[l] > p.calls[r];
+    });
+    for (unsigned fun : funs)
+      if (p.calls[fun])
+        ostr << "  " << std::left << std::setw(12) << p.names[fun]
+             << std::right << ' ' << p.calls[fun] << '\n';
+    return ostr;
+  }
+
+  Machine::Machine(const program& prog, std::istream& in, std::ostream& out,
+                   std::ostream& err, profile* prof)
+    : program_(prog)
+    , runtime_(in, out, err)
+    , profile_(prof)
+  {
+    if (profile_)
+      {
+        profile_->calls.assign(program_.functions.size(), 0);
+        profile_->names.clear();
+        for (const code& fun : program_.functions)
+          profile_->names.emplace_back(fun.name);
+      }
+  }
+
+  int Machine::run()
+  {
+    // A file of declarations does nothing.
+    if (program_.main == -1)
+      return 0;
+    const code& main = program_.functions[program_.main];
+    return runtime_.run([this, &main] {
+      if (profile_)
+        execute<true>(main, 0, nullptr);
+      else
+        execute<false>(main, 0, nullptr);
+    });
+  }
+
+  /*-------------.
+  | Execution.   |
+  `-------------*/
+
+  template <bool Profile>
+  value Machine::execute(const code& fun, size_t bottom, frame* link)
+  {
+    if constexpr (Profile)
+      ++profile_->calls[&fun - program_.functions.data()];
+
+    // The registers past the arguments are written before they are
+    // read: what the previous calls left there does not matter.
+    if (stack_.size() < bottom + fun.registers)
+      stack_.resize(std::max(bottom + fun.registers, 2 * stack_.size()));
+    // Reloaded after each call, which may grow the stack.
+    value* regs = stack_.data() + bottom;
+    frame own;
+    frame* fp = link;
+    if (fun.escaping)
+      {
+        own.link = link;
+        own.slots.resize(fun.escaping);
+        fp = &own;
+      }
+
+    const instruction* const base = fun.instructions.data();
+    const instruction* pc = base;
+
+    // The frame \a hops static links away.
+    auto reach = [fp](int hops) {
+      frame* res = fp;
+      for (; hops; --hops)
+        res = res->link;
+      return res;
+    };
+
+#define VM_COUNT()                                                      \
+    do {                                                                \
+      if constexpr (Profile)                                            \
+        ++profile_->instructions[static_cast<unsigned>(pc->op)];        \
+    } while (0)
+
+#define A regs[pc->a]
+#define B regs[pc->b]
+#define C regs[pc->c]
+// The registers from c on, for the arguments and the fields.
+#define ARGS (regs + pc->c)
+#define INT(R) std::get<int>(R)
+
+#if VM_THREADED
+    static void* const targets[] = {
+# define VM_OPCODE(Name) &&op_##Name,
+      VM_OPCODES(VM_OPCODE)
+# undef VM_OPCODE
+    };
+# define VM_CASE(Name) op_##Name
+# define VM_DISPATCH()                                                  \
+    {                                                                   \
+      VM_COUNT();                                                       \
+      goto *targets[static_cast<unsigned>(pc->op)];                     \
+    }
+# define VM_NEXT()                                                      \
+    {                                                                   \
+      ++pc;                                                             \
+      VM_DISPATCH();                                                    \
+    }
+# define VM_GOTO(Target)                                                \
+    {                                                                   \
+      pc = base + (Target);                                             \
+      VM_DISPATCH();                                                    \
+    }
+
+    VM_DISPATCH();
+    {
+#else
+# define VM_CASE(Name) case opcode::Name
+# define VM_NEXT()                                                      \
+    {                                                                   \
+      ++pc;                                                             \
+      continue;                                                         \
+    }
+# define VM_GOTO(Target)                                                \
+    {                                                                   \
+      pc = base + (Target);                                             \
+      continue;                                                         \
+    }
+
+    for (;;)
+      {
+        VM_COUNT();
+        switch (pc->op)
+          {
+#endif
+          VM_CASE(move):
+            A = B;
+            VM_NEXT();
+          VM_CASE(integer):
+            A = program_.integers[pc->b];
+            VM_NEXT();
+          VM_CASE(string):
+            A = program_.strings[pc->b];
+            VM_NEXT();
+          VM_CASE(nil):
+            A = static_cast<object*>(nullptr);
+            VM_NEXT();
+
+            // Wrap around on overflow, as the compiled code does.
+          VM_CASE(add):
+            A = static_cast<int>(static_cast<unsigned>(INT(B))
+                                 + static_cast<unsigned>(INT(C)));
+            VM_NEXT();
+          VM_CASE(sub):
+            A = static_cast<int>(static_cast<unsigned>(INT(B))
+                                 - static_cast<unsigned>(INT(C)));
+            VM_NEXT();
+          VM_CASE(mul):
+            A = static_cast<int>(static_cast<unsigned>(INT(B))
+                                 * static_cast<unsigned>(INT(C)));
+            VM_NEXT();
+          VM_CASE(div):
+            {
+              int l = INT(B);
+              int r = INT(C);
+              if (!r)
+                throw failure{"division by zero"};
+              A = l == INT_MIN && r == -1 ? INT_MIN : l / r;
+            }
+            VM_NEXT();
+
+          VM_CASE(eq):
+            A = order(B, C) == 0;
+            VM_NEXT();
+          VM_CASE(ne):
+            A = order(B, C) != 0;
+            VM_NEXT();
+          VM_CASE(lt):
+            A = order(B, C) < 0;
+            VM_NEXT();
+          VM_CASE(le):
+            A = order(B, C) <= 0;
+            VM_NEXT();
+          VM_CASE(gt):
+            A = order(B, C) > 0;
+            VM_NEXT();
+          VM_CASE(ge):
+            A = order(B, C) >= 0;
+            VM_NEXT();
+
+          VM_CASE(jump):
+            VM_GOTO(pc->a);
+          VM_CASE(jump_if):
+            if (INT(A))
+              VM_GOTO(pc->b);
+            VM_NEXT();
+          VM_CASE(jump_unless):
+            if (!INT(A))
+              VM_GOTO(pc->b);
+            VM_NEXT();
+
+          VM_CASE(load):
+            A = reach(pc->b)->slots[pc->c];
+            VM_NEXT();
+          VM_CASE(store):
+            reach(pc->b)->slots[pc->c] = A;
+            VM_NEXT();
+
+          VM_CASE(array):
+            {
+              int size = INT(B);
+              if (size < 0)
+                throw failure{"negative array size"};
+              object* array = runtime_.allocate(size);
+              std::fill(array->slots.begin(), array->slots.end(), C);
+              A = array;
+            }
+            VM_NEXT();
+          VM_CASE(record):
+            {
+              object* record = runtime_.allocate(pc->b);
+              std::copy(ARGS, ARGS + record->slots.size(), record->slots.begin());
+              A = record;
+            }
+            VM_NEXT();
+          VM_CASE(field):
+            A = field_get(B, pc->c);
+            VM_NEXT();
+          VM_CASE(set_field):
+            field_get(A, pc->b) = C;
+            VM_NEXT();
+          VM_CASE(element):
+            A = element_get(B, C);
+            VM_NEXT();
+          VM_CASE(set_element):
+            element_get(A, B) = C;
+            VM_NEXT();
+
+          VM_CASE(call):
+            {
+              const code& callee = program_.functions[pc->b];
+              frame* callee_link = nullptr;
+              if (callee.parent != -1)
+                callee_link =
+                  reach(fun.depth - program_.functions[callee.parent].depth);
+              // The callee's registers start at its arguments: the
+              // registers from there on are free once it returns.
+              value res =
+                execute<Profile>(callee, bottom + pc->c, callee_link);
+              regs = stack_.data() + bottom;
+              A = std::move(res);
+            }
+            VM_NEXT();
+          VM_CASE(primitive):
+            A = runtime_.call(static_cast<primitive>(pc->b), ARGS);
+            VM_NEXT();
+          VM_CASE(ret):
+            return std::move(A);
+#if VM_THREADED
+    }
+#else
+          }
+      }
+#endif
+    unreachable();
+
+#undef VM_GOTO
+#undef VM_NEXT
+#undef VM_DISPATCH
+#undef VM_CASE
+#undef INT
+#undef ARGS
+#undef C
+#undef B
+#undef A
+#undef VM_COUNT
+  }
+
+} // namespace vm
@@ -0,0 +1,73 @@
+/**
+ ** \file vm/machine.hh
+ ** \brief Run the bytecode of a program.
+ */
+
+#pragma once
+
+#include <array>
+#include <iosfwd>
+#include <vector>
+
+#include <interpret/runtime.hh>
+#include <vm/program.hh>
+
+namespace vm
+{
+  using interpret::frame;
+  using interpret::object;
+  using interpret::value;
+
+  /// The number of instructions run, and of calls.
+  struct profile
+  {
+    /// The instructions run, per opcode.
+    std::array<unsigned long, opcodes> instructions = {};
+    /// The calls, per function.
+    std::vector<unsigned long> calls;
+    /// The names of the functions.
+    std::vector<misc::symbol> names;
+  };
+
+  /// Report \a p on \a ostr, the most frequent first.
+  std::ostream& operator<<(std::ostream& ostr, const profile& p);
+
+  /** \brief A register machine running the bytecode of a program.
+
+      The instructions are dispatched by jumping from one to the next
+      (the `labels as values' of GCC), or by a switch with the other
+      compilers.  The registers of all the active calls are on one
+      stack: those of a call start at its bottom, where its caller put
+      its arguments, in its own last registers.
+
+      The values, the primitives, the heap and the exit status are
+      those of the interpreter (see interpret::Runtime).  */
+  class Machine
+  {
+  public:
+    /// Prepare the execution of \a prog, on the given standard streams.
+    /// Count the instructions in \a prof if not null.
+    Machine(const program& prog, std::istream& in, std::ostream& out,
+            std::ostream& err, profile* prof = nullptr);
+
+    /// Run the program, and return its exit status.
+    int run();
+
+  private:
+    /// Run \a fun, whose registers start at \a bottom on the stack, with
+    /// its arguments in the first ones, its enclosing function having
+    /// the frame \a link.
+    template <bool Profile>
+    value execute(const code& fun, size_t bottom, frame* link);
+
+    /// The program.
+    const program& program_;
+    /// The primitives and the heap.
+    interpret::Runtime runtime_;
+    /// The profile, if requested.
+    profile* profile_;
+    /// The registers of the active calls.
+    std::vector<value> stack_;
+  };
+
+} // namespace vm
@@ -0,0 +1,120 @@
+/**
+ ** \file vm/program.cc
+ ** \brief Disassembling the bytecode of a program.
+ */
+
+#include <iomanip>
+#include <ostream>
+
+#include <misc/escape.hh>
+#include <vm/program.hh>
+
+namespace vm
+{
+  namespace
+  {
+    /// The registers from \a first, for \a count arguments.
+    std::ostream&
+    arguments(std::ostream& ostr, int first, unsigned count)
+    {
+      ostr << '(';
+      for (unsigned i = 0; i < count; ++i)
+        ostr << (i ? ", " : "") << 'r' << first + i;
+      return ostr << ')';
+    }
+
+    /// Disassemble \a fun.
+    void disassemble(std::ostream& ostr, const program& prog, const code& fun)
+    {
+      ostr << "function " << fun.name << " (arity " << fun.arity
+           << ", registers " << fun.registers << ", escaping " << fun.escaping
+           << ", depth " << fun.depth;
+      if (fun.parent != -1)
+        ostr << ", in " << prog.functions[fun.parent].name;
+      ostr << ")\n";
+
+      for (unsigned pc = 0; pc < fun.instructions.size(); ++pc)
+        {
+          const instruction& i = fun.instructions[pc];
+          ostr << std::setw(6) << pc << "  " << std::left << std::setw(12)
+               << i.op << std::right;
+          switch (i.op)
+            {
+            case opcode::move:
+            case opcode::array:
+              ostr << 'r' << i.a << ", r" << i.b;
+              if (i.op == opcode::array)
+                ostr << ", r" << i.c;
+              break;
+            case opcode::integer:
+              ostr << 'r' << i.a << ", " << prog.integers[i.b];
+              break;
+            case opcode::string:
+              ostr << 'r' << i.a << ", \""
+                   << misc::escape(prog.strings[i.b].str()) << '"';
+              break;
+            case opcode::nil:
+            case opcode::ret:
+              ostr << 'r' << i.a;
+              break;
+            case opcode::jump:
+              ostr << '@' << i.a;
+              break;
+            case opcode::jump_if:
+            case opcode::jump_unless:
+              ostr << 'r' << i.a << ", @" << i.b;
+              break;
+            case opcode::load:
+            case opcode::store:
+              ostr << 'r' << i.a << ", ^" << i.b << '.' << i.c;
+              break;
+            case opcode::record:
+              ostr << 'r' << i.a;
+              arguments(ostr, i.c, i.b);
+              break;
+            case opcode::field:
+              ostr << 'r' << i.a << ", r" << i.b << '.' << i.c;
+              break;
+            case opcode::set_field:
+              ostr << 'r' << i.a << '.' << i.b << ", r" << i.c;
+              break;
+            case opcode::element:
+              ostr << 'r' << i.a << ", r" << i.b << "[r" << i.c << ']';
+              break;
+            case opcode::set_element:
+              ostr << 'r' << i.a << "[r" << i.b << "], r" << i.c;
+              break;
+            case opcode::call:
+              ostr << 'r' << i.a << ", " << prog.functions[i.b].name;
+              arguments(ostr, i.c, prog.functions[i.b].arity);
+              break;
+            case opcode::primitive:
+              {
+                auto prim = static_cast<primitive>(i.b);
+                ostr << 'r' << i.a << ", " << name_get(prim);
+                arguments(ostr, i.c, arity_get(prim));
+              }
+              break;
+            default:
+              ostr << 'r' << i.a << ", r" << i.b << ", r" << i.c;
+            }
+          ostr << '\n';
+        }
+    }
+
+  } // namespace
+
+  std::ostream& operator<<(std::ostream& ostr, const program& prog)
+  {
+    ostr << "/* Bytecode: " << prog.functions.size() << " functions, "
+         << prog.integers.size() << " integers, " << prog.strings.size()
+         << " strings.  */\n";
+    for (const code& fun : prog.functions)
+      {
+        ostr << '\n';
+        disassemble(ostr, prog, fun);
+      }
+    return ostr;
+  }
+
+} // namespace vm
@@ -0,0 +1,56 @@
+/**
+ ** \file vm/program.hh
+ ** \brief The bytecode of a program.
+ */
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include <interpret/value.hh>
+#include <misc/symbol.hh>
+#include <vm/instruction.hh>
+
+namespace vm
+{
+  using interpret::string_type;
+
+  /// The bytecode of a function.
+  struct code
+  {
+    /// The name of the function.
+    misc::symbol name;
+    /// The enclosing function, if any.
+    int parent = -1;
+    /// The number of formal arguments, passed in the first registers.
+    unsigned arity = 0;
+    /// The number of registers.
+    unsigned registers = 0;
+    /// The number of escaping variables.
+    unsigned escaping = 0;
+    /// The number of frames on the chain of static links, its own
+    /// included.
+    unsigned depth = 0;
+    /// The instructions.
+    std::vector<instruction> instructions;
+  };
+
+  /// The bytecode of a program.
+  struct program
+  {
+    /// The integer constants.
+    std::vector<int> integers;
+    /// The string constants.
+    std::vector<string_type> strings;
+    /// The functions.
+    std::vector<code> functions;
+    /// The index of `_main'.
+    int main = -1;
+  };
+
+  /// Disassemble \a prog on \a ostr.
+  std::ostream& operator<<(std::ostream& ostr, const program& prog);
+
+} // namespace vm
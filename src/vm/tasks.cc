@@ -0,0 +1,48 @@
+/**
+ ** \file vm/tasks.cc
+ ** \brief Vm module related tasks' implementation.
+ */
+
+#include <cstdlib>
+#include <iostream>
+
+#include <ast/tasks.hh>
+#include <vm/libvm.hh>
+#define DEFINE_TASKS 1
+#include <vm/tasks.hh>
+#undef DEFINE_TASKS
+
+namespace vm::tasks
+{
+  std::unique_ptr<program> the_program = nullptr;
+
+  /*------------.
+    | Bytecode.   |
+    `------------*/
+
+  void vm_compute() { the_program = ::vm::compile(*ast::tasks::the_program); }
+
+  void vm_display() { std::cout << *the_program; }
+
+  /*------------.
+    | Execution.  |
+    `------------*/
+
+  void vm()
+  {
+    int status = run(*the_program, std::cin, std::cout, std::cerr);
+    // Exit as the program did.
+    if (status)
+      std::exit(status);
+  }
+
+  void vm_profile()
+  {
+    profile prof;
+    int status = run(*the_program, std::cin, std::cout, std::cerr, &prof);
+    std::cerr << prof;
+    if (status)
+      std::exit(status);
+  }
+
+} // namespace vm::tasks
@@ -0,0 +1,47 @@
+/**
+ ** \file vm/tasks.hh
+ ** \brief Vm module related tasks.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <task/libtask.hh>
+#include <vm/program.hh>
+
+/// The Tasks of the vm module.
+namespace vm::tasks
+{
+  /// The bytecode of the program.
+  extern std::unique_ptr<program> the_program;
+
+  TASK_GROUP("Virtual Machine");
+
+  /// Compile the program into bytecode.
+  TASK_DECLARE("vm-compute",
+               "compile the program into bytecode",
+               vm_compute,
+               "types-compute escapes-compute");
+
+  /// Disassemble the bytecode.
+  TASK_DECLARE("vm-display",
+               "display the bytecode of the program",
+               vm_display,
+               "vm-compute");
+
+  /// Run the bytecode.
+  TASK_DECLARE("vm",
+               "run the bytecode of the program (the heap is not "
+               "collected, and is bounded to 1 GB)",
+               vm,
+               "vm-compute");
+
+  /// Run the bytecode, counting the instructions and the calls.
+  TASK_DECLARE("vm-profile",
+               "run the bytecode of the program, and report "
+               "the instructions and the calls",
+               vm_profile,
+               "vm-compute");
+
+} // namespace vm::tasks
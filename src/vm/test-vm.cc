@@ -0,0 +1,121 @@
+/**
+ ** Checking the bytecode compiler and machine against the interpreter.
+ */
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include <ast/all.hh>
+#include <misc/contract.hh>
+#include <testing.hh>
+#include <vm/libvm.hh>
+
+using namespace ast;
+
+const char* program_name = "test-vm";
+
+// Compile and run \a tree.
+static int vm_run(const ChunkList& tree, std::istream& in, std::ostream& out,
+                  std::ostream& err)
+{
+  std::unique_ptr<vm::program> prog = vm::compile(tree);
+  return vm::run(*prog, in, out, err);
+}
+
+// Compile and run \a body, and check that it prints what the
+// interpreter prints, and exits with the same status.
+static void test_vm(const std::string& body)
+{
+  std::unique_ptr<ChunkList> tree(testing::program_compute(body));
+  testing::run_check(body, testing::program_run(vm_run, *tree),
+                     testing::program_interpret(*tree));
+}
+
+int main()
+{
+  // The escapes are decoded once, when the literal is compiled.
+  test_vm("print(\"a\\tb\\n\\\\\\\"\\101\\x42\\n\")");
+  test_vm("print_int(size(\"\\n\\\\\\x41\"))");
+
+  // The fields are compiled to their index in the type of the record.
+  test_vm("let type p = {x : int, y : int}"
+          "    type q = {n : string, p : p}"
+          "    var v := q{n = \"n\", p = p{x = 1, y = 2}} "
+          "in v.p.y := v.p.y + 3; print_int(v.p.y); print_int(v.p.x);"
+          "   print(v.n) end");
+  test_vm("let type l = {x : int, n : l} var v := l{x = 1, n = nil} "
+          "in print_int(v.x); print_int(v.n.x) end");
+
+  // The callee's registers start at the arguments of the call, above
+  // the live registers of the caller: the calls nested in the
+  // arguments, and the temporaries live across a call, must survive.
+  test_vm("let function f(a : int, b : int, c : int) : int ="
+          "      a * 100 + b * 10 + c"
+          "    function g(x : int) : int = let var y := x + 1 in y * 2 end "
+          "in print_int(f(g(1), f(0, g(0), 1), g(2)));"
+          "   print_int(1 + g(3) * (2 + g(4)) - f(1, 2, 3)) end");
+  test_vm("let function sum(n : int, acc : int) : int ="
+          "      if n = 0 then acc"
+          "      else let var here := n * 2"
+          "           in sum(n - 1, acc + here) + here - here end "
+          "in print_int(sum(50, 0)) end");
+  test_vm("let function fib(n : int) : int ="
+          "      if n < 2 then n else fib(n - 1) + fib(n - 2) "
+          "in print_int(fib(20)) end");
+
+  // Deep enough for the register stack to be reallocated under the
+  // active calls.
+  test_vm("let function down(n : int) : int ="
+          "      if n = 0 then 0 else 1 + down(n - 1) "
+          "in print_int(down(10000)) end");
+
+  // The static links, several levels up, to escaping frames.
+  test_vm("let function f(x : int) : int ="
+          "      let function g(y : int) : int ="
+          "            let function h() : int = x * 10 + y"
+          "            in h() end"
+          "      in g(x + 1) end "
+          "in print_int(f(1)); print_int(f(4)) end");
+  test_vm("let function count(n : int) : int ="
+          "      let var calls := 0"
+          "          function down(i : int) ="
+          "            (calls := calls + 1;"
+          "             if i > 0 then down(i - 1))"
+          "      in down(n); calls end "
+          "in print_int(count(3)); print_int(count(5)) end");
+
+  // The jumps of the breaks, between the dispatched instructions.
+  test_vm("for i := 1 to 10 do (if i = 4 then break; print_int(i))");
+  test_vm("for i := 1 to 3 do"
+          "  (for j := 1 to 3 do"
+          "     (if j > i then break; print_int(j));"
+          "   print(\"/\"))");
+  test_vm("let var i := 0 "
+          "in while 1 do"
+          "     (i := i + 1;"
+          "      while 1 do (if i > 2 then break; print_int(i); break);"
+          "      if i > 3 then break) end");
+  test_vm("while 1 do let var x := 1 in print_int(x); break end");
+  test_vm("for i := 1 to 0 do print_int(i)");
+
+  // Arrays, and their bounds.
+  test_vm("let type a = array of int"
+          "    var v := a [5] of 1 "
+          "in v[2] := 7; for i := 0 to 4 do print_int(v[i]) end");
+  test_vm("let type a = array of int"
+          "    type m = array of a"
+          "    var v := m [2] of a [2] of 0 "
+          "in v[1][1] := 3; print_int(v[0][1]); print_int(v[1][1]) end");
+  test_vm("let type a = array of int"
+          "    var v := a [3] of 0 "
+          "in print_int(v[2]); print_int(v[3]) end");
+  test_vm("let type a = array of int"
+          "    var v := a [3] of 0 "
+          "in print_int(v[-1]) end");
+  test_vm("let type a = array of int"
+          "    var v := a [-1] of 0 "
+          "in end");
+
+  test_vm("(print_int(1); exit(3); print_int(2))");
+}
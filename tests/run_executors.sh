@@ -0,0 +1,71 @@
+#! /bin/sh
+
+# Run the good programs with the interpreter, the reference executor,
+# and check that the other back ends print the same output and exit
+# with the same status.  The programs which the front end rejects, and
+# those which do not end within a few seconds, or overflow the stack of
+# the interpreter in an endless recursion, are skipped.
+
+: ${TC=../src/tc}
+: ${CC=cc}
+: ${SRCDIR=.}
+
+tmp=${TMPDIR-/tmp}/run_executors.$$
+mkdir -p "$tmp" || exit 1
+trap 'rm -rf "$tmp"' 0
+
+ran=0
+skipped=0
+failed=0
+
+# compare NAME EXECUTOR STATUS
+# ----------------------------
+# Compare the run of NAME by EXECUTOR, which exited with STATUS and
+# printed $tmp/EXECUTOR.out, with the one of the interpreter.
+compare ()
+{
+  if test "$3" -ne "$ref" || ! cmp -s "$tmp/ref.out" "$tmp/$2.out"; then
+    echo "FAIL $1: $2 exits with $3, the interpreter with $ref"
+    diff "$tmp/ref.out" "$tmp/$2.out" | head -n 10
+    failed=$((failed + 1))
+  fi
+}
+
+for f in "$SRCDIR"/all_tests/good/*.tig
+do
+  name=$(basename "$f" .tig)
+  if ! "$TC" -T "$f" >/dev/null 2>&1; then
+    skipped=$((skipped + 1))
+    continue
+  fi
+
+  timeout 10 "$TC" --interpret "$f" </dev/null >"$tmp/ref.out" 2>/dev/null
+  ref=$?
+  if test $ref -eq 124 || test $ref -eq 139; then
+    skipped=$((skipped + 1))
+    continue
+  fi
+  ran=$((ran + 1))
+  if test $ref -ne 0; then
+    echo "FAIL $name: the interpreter exits with $ref"
+    failed=$((failed + 1))
+    continue
+  fi
+
+  # The bytecode machine.
+  timeout 10 "$TC" --vm "$f" </dev/null >"$tmp/vm.out" 2>/dev/null
+  compare "$name" vm $?
+
+  # The C back end.
+  if "$TC" --c-emit "$f" >"$tmp/c.c" 2>/dev/null \
+     && $CC -std=c99 -pedantic-errors -o "$tmp/c.exe" "$tmp/c.c" 2>/dev/null; then
+    timeout 10 "$tmp/c.exe" </dev/null >"$tmp/c.out" 2>/dev/null
+    compare "$name" c $?
+  else
+    echo "FAIL $name: the C back end does not compile it"
+    failed=$((failed + 1))
+  fi
+done
+
+echo "run_executors: $ran run, $skipped skipped, $failed failed"
+test $failed -eq 0